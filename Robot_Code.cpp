@@ -1,42 +1,222 @@
 #include <Romi32U4.h>
 #include <PololuRPiSlave.h>
 
-#define I2C_ADDRESS 0x14
-
-struct Commands {
-  int16_t left_speed, right_speed;
-  int16_t left_dist, right_dist;
-  bool r_led, g_led, y_led;
-} __attribute__((packed));
-
-struct Telemetry {
-  int16_t l_enc, r_enc;
-  int16_t rem_left;
-  int16_t rem_right;
-  int16_t cmd_left_dist;
-  int16_t cmd_right_dist;
-  int16_t cmd_left_speed;
-  int16_t cmd_right_speed;
-  int16_t set_left_speed;
-  int16_t set_right_speed;
-  uint16_t batteryMillivolts;
-  bool button_A;
-  bool button_B;
-  bool button_C;
-} __attribute__((packed));
-
-struct Data {
-  Commands cmd;
-  Telemetry telem;
-} __attribute__((packed));
-
-PololuRPiSlave<Data,5> slave;
-Romi32U4Motors motors;
+#include "protocol/romi_protocol.h"
+
+#define I2C_ADDRESS ROMI_I2C_ADDRESS
+
+// The register map is generated from protocol/romi_protocol.json, so the
+// host side reads the same layout.  The AVR is little-endian like the wire
+// format, so the slave buffer is used in place.
+typedef I2C_Command_Packet Commands;
+typedef I2C_Telem_Packet Telemetry;
+typedef I2C_Data Data;
+
+// PololuRPiSlave waits this long before every byte it transmits, to work
+// around the Raspberry Pi's broken I2C clock stretching.  Other masters do
+// not need it, so the delay follows the host the robot is built for, e.g.
+// with arduino-cli:
+//   --build-property "compiler.cpp.extra_flags=-DROMI_HOST_PROFILE=ROMI_HOST_BEAGLEBONE"
+// ROMI_SLAVE_BYTE_DELAY_US can also be set directly.  The default keeps the
+// Raspberry Pi setting so an unconfigured build works with any master.
+#define ROMI_HOST_RASPBERRY_PI 1
+#define ROMI_HOST_BEAGLEBONE   2
+
+#ifndef ROMI_HOST_PROFILE
+#define ROMI_HOST_PROFILE ROMI_HOST_RASPBERRY_PI
+#endif
+
+#ifndef ROMI_SLAVE_BYTE_DELAY_US
+#if ROMI_HOST_PROFILE == ROMI_HOST_BEAGLEBONE
+#define ROMI_SLAVE_BYTE_DELAY_US 0
+#elif ROMI_HOST_PROFILE == ROMI_HOST_RASPBERRY_PI
+#define ROMI_SLAVE_BYTE_DELAY_US 5
+#else
+#error "unknown ROMI_HOST_PROFILE"
+#endif
+#endif
+
 Romi32U4Encoders encoders;
+
+// Where the current move on one wheel ends, published by loop() for the
+// snapshot taken in the TWI interrupt.  dir is 0 once the move is done.
+struct MoveEnd {
+  int16_t target_enc;
+  int8_t dir;
+};
+
+// Romi32U4Encoders::getCounts*() end in sei(), which inside the TWI
+// interrupt would let the still-pending TWI interrupt nest, so mask it
+// (without acknowledging it) while they run.
+static void isr_read_encoders(int16_t &left, int16_t &right) {
+#ifdef TWCR
+  uint8_t twcr = TWCR & ~_BV(TWINT);
+  TWCR = twcr & ~_BV(TWIE);
+  left = encoders.getCountsLeft();
+  right = encoders.getCountsRight();
+  cli();
+  TWCR = twcr;
+#else
+  left = encoders.getCountsLeft();
+  right = encoders.getCountsRight();
+#endif
+}
+
+static int16_t remaining(const MoveEnd &m, int16_t enc) {
+  int16_t rem = m.target_enc - enc;
+
+  if (m.dir > 0) {
+    return max(rem, (int16_t)0);
+  }
+  if (m.dir < 0) {
+    return min(rem, (int16_t)0);
+  }
+  return 0;
+}
+
+typedef PololuRPiSlave<Data, ROMI_SLAVE_BYTE_DELAY_US> SlaveBase;
+
+// The slave with a command latch and read-triggered snapshots.  The
+// start()/receive()/transmit()/stop() callbacks run in the TWI interrupt.
+// A master write that reaches the command block raises cmd_pending and
+// stamps its arrival when the transfer ends, so loop() can act on it at its
+// next service point instead of a full iteration later.  Setting the
+// pointer to the telemetry or snapshot block captures the encoders there
+// and then.
+class RomiSlave : public SlaveBase {
+public:
+  virtual void start() {
+    rx_offset_set = false;
+    rx_data = false;
+    rx_cmd = false;
+    SlaveBase::start();
+  }
+
+  virtual void receive(uint8_t b) {
+    if (!rx_offset_set) {
+      rx_ptr = b;
+      rx_offset_set = true;
+      snap_valid = (b == ROMI_TELEM_OFFSET || b == ROMI_SNAP_OFFSET);
+      if (snap_valid) {
+        capture();
+      }
+    }
+    else {
+      rx_data = true;
+      if (rx_ptr++ < sizeof(Commands)) {
+        rx_cmd = true;
+      }
+    }
+    SlaveBase::receive(b);
+  }
+
+  // Reads that start at the telemetry or snapshot block are served the
+  // encoder counts and remaining distances captured when the pointer was
+  // set, rather than the ones packed at the last loop.
+  virtual uint8_t transmit() {
+    uint8_t b = SlaveBase::transmit();
+    uint8_t i = rx_ptr++;
+
+    if (snap_valid) {
+      if (i >= ROMI_SNAP_OFFSET && i < ROMI_SNAP_OFFSET + ROMI_SNAP_SIZE) {
+        b = ((const uint8_t *)&snap)[i - ROMI_SNAP_OFFSET];
+      }
+      else if (i >= ROMI_TELEM_L_ENC_OFFSET && i < ROMI_TELEM_REM_RIGHT_OFFSET + ROMI_TELEM_REM_RIGHT_SIZE) {
+        b = ((const uint8_t *)&snap.l_enc)[i - ROMI_TELEM_L_ENC_OFFSET];
+      }
+    }
+    return b;
+  }
+
+  // A snapshot serves only the read that follows its pointer write: any
+  // transfer other than a bare pointer write ends it, so a later read that
+  // does not set the pointer again gets the packed buffer.
+  virtual void stop() {
+    SlaveBase::stop();
+    if (!rx_offset_set || rx_data) {
+      snap_valid = false;
+    }
+    if (rx_cmd) {
+      rx_cmd = false;
+      cmd_rx_us = micros();
+      cmd_pending = true;
+    }
+  }
+
+  // True, with the arrival time, if a command was written since the last
+  // call.  Take it before updateBuffer() so a write landing in between is
+  // seen again rather than lost.
+  bool takeCommand(uint32_t &rx_us) {
+    noInterrupts();
+    bool pending = cmd_pending;
+    cmd_pending = false;
+    rx_us = cmd_rx_us;
+    interrupts();
+    return pending;
+  }
+
+  void publishMoves(const MoveEnd &left, const MoveEnd &right) {
+    noInterrupts();
+    move_left = left;
+    move_right = right;
+    interrupts();
+  }
+
+private:
+  void capture() {
+    int16_t l, r;
+
+    isr_read_encoders(l, r);
+    snap.capture_us = micros();
+    snap.l_enc = l;
+    snap.r_enc = r;
+    snap.rem_left = remaining(move_left, l);
+    snap.rem_right = remaining(move_right, r);
+  }
+
+  // The telemetry fields are served from snap.l_enc on, in the same order.
+  static_assert(ROMI_TELEM_R_ENC_OFFSET - ROMI_TELEM_L_ENC_OFFSET == ROMI_SNAP_R_ENC_OFFSET - ROMI_SNAP_L_ENC_OFFSET &&
+                ROMI_TELEM_REM_LEFT_OFFSET - ROMI_TELEM_L_ENC_OFFSET == ROMI_SNAP_REM_LEFT_OFFSET - ROMI_SNAP_L_ENC_OFFSET &&
+                ROMI_TELEM_REM_RIGHT_OFFSET - ROMI_TELEM_L_ENC_OFFSET == ROMI_SNAP_REM_RIGHT_OFFSET - ROMI_SNAP_L_ENC_OFFSET,
+                "snapshot and telemetry encoder fields differ in layout");
+
+  I2C_Snap_Packet snap = {};
+  MoveEnd move_left = {0, 0};
+  MoveEnd move_right = {0, 0};
+  bool snap_valid = false;
+  volatile bool cmd_pending = false;
+  volatile uint32_t cmd_rx_us = 0;
+  uint8_t rx_ptr = 0;
+  bool rx_offset_set = false;
+  bool rx_data = false;
+  bool rx_cmd = false;
+};
+
+RomiSlave slave;
+
+// Reported in the identity block so hosts can tell builds apart, e.g.
+// -DROMI_BUILD_ID=0x$(git rev-parse --short=8 HEAD)
+#ifndef ROMI_BUILD_ID
+#define ROMI_BUILD_ID 0
+#endif
+
+#if ROMI_SLAVE_BYTE_DELAY_US == 0
+#define ROMI_FEATURES (ROMI_FEATURE_COMBINED_XFER | ROMI_FEATURE_FRESH_SNAPSHOT)
+#else
+#define ROMI_FEATURES ROMI_FEATURE_FRESH_SNAPSHOT
+#endif
+
+Romi32U4Motors motors;
 Romi32U4ButtonA button_A;
 Romi32U4ButtonB button_B;
 Romi32U4ButtonC button_C;
 
+int16_t applied_left = 0;
+int16_t applied_right = 0;
+uint16_t cmd_latency_us = 0;
+uint16_t cmd_latency_max_us = 0;
+uint16_t cmd_count = 0;
+
 int16_t prev_left_dist = 0;
 int16_t prev_right_dist = 0;
 int16_t start_l_enc = 0;
@@ -158,38 +338,133 @@ int16_t update_right_motor(int16_t dist, int16_t speed) {
   return set_speed;
 }
 
-void setup() {
-  slave.init(I2C_ADDRESS);
-}
-
-void loop() {
-  slave.updateBuffer();
+void pack_command_echo(int16_t set_left, int16_t set_right) {
   auto &c = slave.buffer.cmd;
   auto &t = slave.buffer.telem;
 
-  int16_t set_left = update_left_motor( c.left_dist, c.left_speed);
-  int16_t set_right = update_right_motor(c.right_dist, c.right_speed);
+  t.cmd_left_dist = c.left_dist;
+  t.cmd_right_dist = c.right_dist;
+  t.cmd_left_speed = c.left_speed;
+  t.cmd_right_speed = c.right_speed;
+  t.set_left_speed = set_left;
+  t.set_right_speed = set_right;
+}
 
-  ledRed(c.r_led);
-  ledGreen(c.g_led);
-  ledYellow(c.y_led);
+void pack_telemetry(int16_t set_left, int16_t set_right) {
+  auto &t = slave.buffer.telem;
 
   t.l_enc = encoders.getCountsLeft();
   t.r_enc = encoders.getCountsRight();
   t.rem_left = rem_l_dist;
   t.rem_right = rem_r_dist;
 
-  t.cmd_left_dist = c.left_dist;
-  t.cmd_right_dist = c.right_dist;
-  t.cmd_left_speed = c.left_speed;
-  t.cmd_right_speed = c.right_speed;
-  t.set_left_speed = set_left;
-  t.set_right_speed = set_right;
+  pack_command_echo(set_left, set_right);
 
   t.batteryMillivolts = readBatteryMillivolts();
   t.button_A = button_A.getSingleDebouncedPress();
   t.button_B = button_B.getSingleDebouncedPress();
   t.button_C = button_C.getSingleDebouncedPress();
+}
+
+// Rewritten every loop: finalizeWrites() then puts back anything the host
+// wrote over it, which keeps the block read-only.
+void pack_identity() {
+  auto &id = slave.buffer.ident;
+
+  id.magic = ROMI_IDENT_MAGIC;
+  id.protocol_version = ROMI_PROTOCOL_VERSION;
+  id.data_size = sizeof(Data);
+  id.features = ROMI_FEATURES;
+  id.build_id = ROMI_BUILD_ID;
+}
+
+// The loop's own copy, for reads that do not start at telem or snap.
+void pack_snapshot() {
+  auto &t = slave.buffer.telem;
+  auto &n = slave.buffer.snap;
+
+  n.capture_us = micros();
+  n.l_enc = t.l_enc;
+  n.r_enc = t.r_enc;
+  n.rem_left = t.rem_left;
+  n.rem_right = t.rem_right;
+}
+
+void pack_diagnostics() {
+  auto &d = slave.buffer.diag;
+
+  d.cmd_latency_us = cmd_latency_us;
+  d.cmd_latency_max_us = cmd_latency_max_us;
+  d.cmd_count = cmd_count;
+}
+
+void apply_commands() {
+  auto &c = slave.buffer.cmd;
+
+  applied_left = update_left_motor( c.left_dist, c.left_speed);
+  applied_right = update_right_motor(c.right_dist, c.right_speed);
+
+  ledRed(c.r_led);
+  ledGreen(c.g_led);
+  ledYellow(c.y_led);
+
+  MoveEnd left = {(int16_t)(start_l_enc + prev_left_dist), (int8_t)((rem_l_dist > 0) - (rem_l_dist < 0))};
+  MoveEnd right = {(int16_t)(start_r_enc + prev_right_dist), (int8_t)((rem_r_dist > 0) - (rem_r_dist < 0))};
+  slave.publishMoves(left, right);
+}
+
+// Time from the end of the command write to the motor update, in us.
+void record_latency(uint32_t rx_us) {
+  uint32_t latency = micros() - rx_us;
 
+  cmd_latency_us = latency > 0xFFFF ? 0xFFFF : (uint16_t)latency;
+  if (cmd_latency_us > cmd_latency_max_us) {
+    cmd_latency_max_us = cmd_latency_us;
+  }
+  cmd_count++;
+}
+
+// Mid-loop service point: if a command has landed since the top of the
+// loop, publish what has been packed so far, pick the command up and apply
+// it now rather than after the rest of the iteration.
+void service_commands() {
+  uint32_t rx_us;
+
+  if (!slave.takeCommand(rx_us)) {
+    return;
+  }
   slave.finalizeWrites();
-}
\ No newline at end of file
+  slave.updateBuffer();
+  apply_commands();
+  record_latency(rx_us);
+  pack_command_echo(applied_left, applied_right);
+}
+
+void setup() {
+  slave.init(I2C_ADDRESS);
+  slave.updateBuffer();
+  pack_identity();
+  pack_diagnostics();
+  slave.finalizeWrites();
+}
+
+void loop() {
+  uint32_t rx_us;
+  bool fresh = slave.takeCommand(rx_us);
+
+  slave.updateBuffer();
+  apply_commands();
+  if (fresh) {
+    record_latency(rx_us);
+  }
+
+  // the battery read blocks on the ADC for most of the loop
+  pack_telemetry(applied_left, applied_right);
+  service_commands();
+
+  pack_snapshot();
+  pack_identity();
+  pack_diagnostics();
+
+  slave.finalizeWrites();
+}
@@ -25,6 +25,7 @@
 #ifndef I2C_APP_PERFIDS_H
 #define I2C_APP_PERFIDS_H
 
-#define I2C_APP_PERF_ID 91
+#define I2C_APP_PERF_ID           91
+#define I2C_APP_BUS_START_PERF_ID 92 /* fast boot child task opening and probing the bus */
 
 #endif /* SAMPLE_APP_PERFIDS_H */
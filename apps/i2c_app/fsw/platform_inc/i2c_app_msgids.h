@@ -30,7 +30,13 @@
 /* V1 Command Message IDs must be 0x18xx */
 #define I2C_APP_CMD_MID     0x1889
 #define I2C_APP_SEND_HK_MID 0x1886
+#define I2C_APP_WAKEUP_MID  0x1888
+#define I2C_APP_ESTOP_MID   0x188A
 /* V1 Telemetry Message IDs must be 0x08xx */
-#define I2C_APP_HK_TLM_MID 0x0887
+#define I2C_APP_HK_TLM_MID    0x0887
+#define I2C_APP_ROBOT_TLM_MID 0x0888
+
+/* Rate sch_lab sends I2C_APP_WAKEUP_MID at; each wakeup runs one control cycle */
+#define I2C_APP_WAKEUP_RATE_HZ 50
 
 #endif /* I2C_APP_MSGIDS_H */
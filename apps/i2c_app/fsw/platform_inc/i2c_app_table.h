@@ -19,19 +19,56 @@
 /**
  * @file
  *
- * Define sample app table
+ * Define the I2C app configuration table
  */
 
 #ifndef I2C_APP_TABLE_H
 #define I2C_APP_TABLE_H
 
+#define I2C_APP_TBL_MAX_DEVICES 4 /* Bus/address pairs the robot may be found at */
+
+/*
+** One place the robot may be attached
+*/
+typedef struct
+{
+    uint8 BusNum;  /* Linux I2C bus, /dev/i2c-N */
+    uint8 Address; /* 7-bit slave address */
+} I2C_APP_TblDevice_t;
+
 /*
 ** Table structure
+**
+** A new image is validated by I2C_APP_TblValidationFunc when it is loaded
+** and takes effect at the next housekeeping request, without a restart.
 */
 typedef struct
 {
-    uint16 Int1;
-    uint16 Int2;
+    /*
+    ** Where to look for the robot: the first NumDevices entries are tried
+    ** in turn whenever the bus connection has to be (re)opened.  With
+    ** Discover set, robots found on the buses of these entries are tried
+    ** first.  The search runs once, when the bus starts or, if discovery
+    ** was off then, when a table that turns it on is applied.
+    */
+    uint16              NumDevices;
+    uint16              Discover; /* 1 = search the Devices' buses at startup, 0 = only Devices */
+    I2C_APP_TblDevice_t Devices[I2C_APP_TBL_MAX_DEVICES];
+
+    uint16 PollDivider;      /* Read telemetry every Nth control cycle, 1 = every cycle */
+    uint16 TransferFeatures; /* ROMI_FEATURE_* transfers allowed, if the robot offers them too */
+
+    uint16 ReopenHoldoffCycles; /* Control cycles to wait after a failed reopen, 0 = retry at once */
+    uint16 Spare2;
+
+    /*
+    ** Motion command gains: encoder counts per metre of travel, effective
+    ** wheel base and the wheel speed limit
+    */
+    uint16 CountsPerM;
+    uint16 WheelBaseMm;
+    uint16 MaxWheelSpeed;
+    uint16 Spare3;
 } I2C_APP_Table_t;
 
 #endif /* I2C_APP_TABLE_H */
@@ -31,6 +31,7 @@
 
 
 /* The sample_lib module provides the SAMPLE_LIB_Function() prototype */
+#include <stddef.h>
 #include <string.h>
 #include <linux/i2c-dev.h>
 
@@ -40,7 +41,7 @@
 I2C_APP_Data_t I2C_APP_Data;
 
 
-CFE_Status_t I2C_OPEN_BUS(int bus_num, int* fd) {
+CFE_Status_t I2C_OPEN_BUS(int bus_num, int address, int* fd) {
     char filename[20];
     snprintf(filename, sizeof(filename), "/dev/i2c-%d", bus_num);
     *fd = open(filename, O_RDWR);
@@ -48,8 +49,9 @@ CFE_Status_t I2C_OPEN_BUS(int bus_num, int* fd) {
         perror("Opening I2C bus");
         return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
     } 
-    OS_TaskDelay(100);
-    if (ioctl(*fd, I2C_SLAVE, 14) < 0){
+    if (ioctl(*fd, I2C_SLAVE, (long)address) < 0){
+        close(*fd);
+        *fd = -1;
         return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
     }
     CFE_EVS_SendEvent(I2C_APP_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "I2C BUS: %d", *fd);
@@ -59,18 +61,768 @@ CFE_Status_t I2C_OPEN_BUS(int bus_num, int* fd) {
 }
 
 CFE_Status_t I2C_APP_Send(int fd, I2C_Command_Packet* packet) {
-    uint8_t buffer[I2C_CMD_PACKET_SIZE + 1] = {0};
-    memcpy(buffer + 1, packet, I2C_CMD_PACKET_SIZE);
+    uint8_t buffer[I2C_CMD_PACKET_SIZE + 1];
+
+    buffer[0] = ROMI_CMD_OFFSET;
+    romi_cmd_pack(buffer + 1, packet);
     if (write(fd, buffer, I2C_CMD_PACKET_SIZE + 1) != I2C_CMD_PACKET_SIZE + 1) {
-        perror("I2C write of command");
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    /*
+    ** The write() above is a complete I2C transaction; there is nothing to
+    ** flush and no reason to block the command pipe behind it.
+    */
+    return CFE_SUCCESS;
+}
+
+/*
+** Read len bytes of registers starting at offset.
+**
+** Firmware that advertises ROMI_FEATURE_COMBINED_XFER takes the pointer
+** write and the read as one repeated-start transaction; everything else
+** gets the protocol v1 sequence of a write and a separate read.
+*/
+CFE_Status_t I2C_APP_ReadRegs(int fd, uint8 offset, uint8 *buf, size_t len) {
+    struct i2c_msg             msgs[2];
+    struct i2c_rdwr_ioctl_data xfer;
+
+    if (I2C_APP_Data.RobotFeatures & ROMI_FEATURE_COMBINED_XFER) {
+        msgs[0].addr  = (uint16)I2C_APP_Data.Address;
+        msgs[0].flags = 0;
+        msgs[0].len   = 1;
+        msgs[0].buf   = &offset;
+        msgs[1].addr  = (uint16)I2C_APP_Data.Address;
+        msgs[1].flags = I2C_M_RD;
+        msgs[1].len   = (uint16)len;
+        msgs[1].buf   = buf;
+        xfer.msgs     = msgs;
+        xfer.nmsgs    = 2;
+        if (ioctl(fd, I2C_RDWR, &xfer) != 2) {
+            return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+        return CFE_SUCCESS;
+    }
+
+    if (write(fd, &offset, 1) != 1) {
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+    if (read(fd, buf, len) != (ssize_t)len) {
+        return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    }
+
+    return CFE_SUCCESS;
+}
+
+/*
+** The telemetry block is read straight into the caller's packet, which
+** is the packed wire layout; romi_protocol.h checks every field offset.
+*/
+CompileTimeAssert(sizeof(I2C_Telem_Packet) == I2C_TELEM_PACKET_SIZE, I2cAppTelemSize);
+CompileTimeAssert(offsetof(I2C_Telem_Packet, button_C) == ROMI_TELEM_BUTTON_C_OFFSET - ROMI_TELEM_OFFSET,
+                  I2cAppTelemLayout);
+
+/*
+** Read the robot's telemetry block.
+**
+** The wire format is little-endian, so on a little-endian host the bytes
+** land in place with no staging buffer.  A big-endian host reads into one
+** and byte-swaps each field with romi_telem_unpack.
+*/
+CFE_Status_t I2C_APP_Receive(int fd, I2C_Telem_Packet* telem) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    return I2C_APP_ReadRegs(fd, I2C_TELEM_OFFSET, (uint8 *)telem, sizeof(*telem));
+#else
+    uint8_t      buffer[I2C_TELEM_PACKET_SIZE];
+    CFE_Status_t status;
+
+    status = I2C_APP_ReadRegs(fd, I2C_TELEM_OFFSET, buffer, sizeof(buffer));
+    if (status != CFE_SUCCESS) {
+        return status;
+    }
+    romi_telem_unpack(telem, buffer);
+
+    return CFE_SUCCESS;
+#endif
+}
+
+/*
+** Read the robot's identity block and pick the transfer strategies to use.
+**
+** The block is read the protocol v1 way, which every firmware answers.
+** Firmware without one returns whatever lies past its buffer, so a wrong
+** magic or a buffer too small to hold the block means an older unit, which
+** keeps the v1 transfers.  Feature bits this app does not know, or that the
+** configuration table does not allow, are ignored.
+*/
+CFE_Status_t I2C_APP_Identify(int fd) {
+    uint8_t          buffer[ROMI_IDENT_SIZE];
+    I2C_Ident_Packet ident;
+    CFE_Status_t     status;
+
+    memset(&I2C_APP_Data.RobotIdent, 0, sizeof(I2C_APP_Data.RobotIdent));
+    I2C_APP_Data.RobotFeatures = 0;
+
+    status = I2C_APP_ReadRegs(fd, ROMI_IDENT_OFFSET, buffer, sizeof(buffer));
+    if (status != CFE_SUCCESS) {
+        return status;
+    }
+    romi_ident_unpack(&ident, buffer);
+
+    if (ident.magic != ROMI_IDENT_MAGIC || ident.data_size < ROMI_IDENT_OFFSET + ROMI_IDENT_SIZE) {
+        CFE_EVS_SendEvent(I2C_APP_IDENT_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "I2C: robot has no identity block, using protocol v1 transfers");
+        return CFE_SUCCESS;
+    }
+
+    I2C_APP_Data.RobotIdent    = ident;
+    I2C_APP_Data.RobotFeatures = ident.features & I2C_APP_SUPPORTED_FEATURES & I2C_APP_Data.Config.TransferFeatures;
+    CFE_EVS_SendEvent(I2C_APP_IDENT_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "I2C: robot protocol v%u, build 0x%08lX, features 0x%04X, using 0x%04X",
+                      (unsigned int)ident.protocol_version, (unsigned long)ident.build_id,
+                      (unsigned int)ident.features, (unsigned int)I2C_APP_Data.RobotFeatures);
+
+    return CFE_SUCCESS;
+}
+
+/*
+** Open the robot at the first configured bus and address that opens,
+** starting from the one that worked last.  A connection that is still
+** open is closed first, so reopening never leaks a descriptor.
+*/
+CFE_Status_t I2C_APP_OpenDevice(void) {
+    const I2C_APP_TblDevice_t *dev;
+    CFE_Status_t               status = CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+    uint16                     n;
+
+    if (I2C_APP_Data.i2c_fd >= 0) {
+        close(I2C_APP_Data.i2c_fd);
+        I2C_APP_Data.i2c_fd = -1;
+    }
+
+    for (n = 0; n < I2C_APP_Data.Config.NumDevices; ++n) {
+        dev    = &I2C_APP_Data.Config.Devices[I2C_APP_Data.DeviceIndex];
+        status = I2C_OPEN_BUS(dev->BusNum, dev->Address, &I2C_APP_Data.i2c_fd);
+        if (status == CFE_SUCCESS) {
+            I2C_APP_Data.BusNum  = dev->BusNum;
+            I2C_APP_Data.Address = dev->Address;
+            break;
+        }
+        I2C_APP_Data.DeviceIndex = (uint16)((I2C_APP_Data.DeviceIndex + 1) % I2C_APP_Data.Config.NumDevices);
+    }
+
+    return status;
+}
+
+/*
+** Open the app's own bus connection if a fault has closed it.  After a
+** failed attempt the next one waits Config.ReopenHoldoffCycles control
+** cycles; commands in the meantime are left pending.
+*/
+CFE_Status_t I2C_APP_BusConnect(void) {
+    CFE_Status_t status = CFE_SUCCESS;
+
+    if (I2C_APP_Data.i2c_fd < 0) {
+        if (I2C_APP_Data.ReopenHoldoff > 0) {
+            return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
+        }
+        status = I2C_APP_OpenDevice();
+        if (status != CFE_SUCCESS) {
+            I2C_APP_Data.BusErrCounter++;
+            I2C_APP_Data.ReopenHoldoff = I2C_APP_Data.Config.ReopenHoldoffCycles;
+        }
+    }
+
+    return status;
+}
+
+/*
+** Quick identity read of the slave at address on an open bus.  The
+** address has to answer a one-byte read first, as with i2cdetect -r, so
+** nothing is written to a device that is not there.  Only then is it
+** sent the protocol v1 pointer write and read, which every firmware
+** answers, of the identity block; only a Romi with one counts as found.
+*/
+bool I2C_APP_ProbeAddress(int fd, uint8 address) {
+    uint8_t          offset = ROMI_IDENT_OFFSET;
+    uint8_t          buffer[ROMI_IDENT_SIZE];
+    I2C_Ident_Packet ident;
+
+    if (ioctl(fd, I2C_SLAVE, (long)address) < 0 || read(fd, buffer, 1) != 1) {
+        return false;
+    }
+    if (write(fd, &offset, 1) != 1 || read(fd, buffer, sizeof(buffer)) != (ssize_t)sizeof(buffer)) {
+        return false;
+    }
+    romi_ident_unpack(&ident, buffer);
+
+    return ident.magic == ROMI_IDENT_MAGIC && ident.data_size >= ROMI_IDENT_OFFSET + ROMI_IDENT_SIZE;
+}
+
+/*
+** Probe one bus/address pair on a descriptor of its own.
+*/
+bool I2C_APP_ProbeDevice(const I2C_APP_TblDevice_t* dev) {
+    char filename[20];
+    int  fd;
+    bool found;
+
+    snprintf(filename, sizeof(filename), "/dev/i2c-%u", (unsigned int)dev->BusNum);
+    fd = open(filename, O_RDWR);
+    if (fd < 0) {
+        return false;
+    }
+    found = I2C_APP_ProbeAddress(fd, dev->Address);
+    close(fd);
+
+    return found;
+}
+
+void I2C_APP_AddDiscovered(uint8 bus_num, uint8 address) {
+    I2C_APP_TblDevice_t* dev;
+
+    if (I2C_APP_Data.NumDiscovered < I2C_APP_TBL_MAX_DEVICES) {
+        dev          = &I2C_APP_Data.Discovered[I2C_APP_Data.NumDiscovered++];
+        dev->BusNum  = bus_num;
+        dev->Address = address;
+    }
+}
+
+/*
+** Look for robots on the buses the configured devices are on, lowest bus
+** and address first, until the device list is full.  No other bus is
+** touched, so the board's own devices (the PMIC and EEPROM on a
+** BeagleBone's i2c-0) are never probed.  An address that does not answer
+** costs one read, so a bus takes some 10-30 ms to scan.
+*/
+void I2C_APP_ScanBuses(void) {
+    uint8        buses[(I2C_APP_MAX_BUS_NUM + 1) / 8];
+    char         filename[20];
+    unsigned int bus;
+    unsigned int address;
+    uint16       i;
+    int          fd;
+
+    /* a bus may be listed more than once: collect them, then go in order */
+    memset(buses, 0, sizeof(buses));
+    for (i = 0; i < I2C_APP_Data.Config.NumDevices; ++i) {
+        bus = I2C_APP_Data.Config.Devices[i].BusNum;
+        buses[bus / 8] |= (uint8)(1 << (bus % 8));
+    }
+
+    for (bus = 0; bus <= I2C_APP_MAX_BUS_NUM && I2C_APP_Data.NumDiscovered < I2C_APP_TBL_MAX_DEVICES; ++bus) {
+        if ((buses[bus / 8] & (1 << (bus % 8))) == 0) {
+            continue;
+        }
+        snprintf(filename, sizeof(filename), "/dev/i2c-%u", bus);
+        fd = open(filename, O_RDWR);
+        if (fd < 0) {
+            continue;
+        }
+        for (address = I2C_APP_TBL_MIN_ADDRESS;
+             address <= I2C_APP_TBL_MAX_ADDRESS && I2C_APP_Data.NumDiscovered < I2C_APP_TBL_MAX_DEVICES; ++address) {
+            if (I2C_APP_ProbeAddress(fd, (uint8)address)) {
+                I2C_APP_AddDiscovered((uint8)bus, (uint8)address);
+            }
+        }
         close(fd);
+    }
+}
+
+/*
+** Read the device list a previous scan left.  A missing, short or foreign
+** file is simply not used.
+*/
+CFE_Status_t I2C_APP_ReadDeviceCache(I2C_APP_DeviceCache_t* cache) {
+    osal_id_t fd;
+    int32     status;
+
+    status = OS_OpenCreate(&fd, I2C_APP_DEVICE_CACHE_FILE, OS_FILE_FLAG_NONE, OS_READ_ONLY);
+    if (status != OS_SUCCESS) {
         return CFE_STATUS_EXTERNAL_RESOURCE_FAIL;
     }
-    fsync(fd);
-    sleep(1);
+    status = OS_read(fd, cache, sizeof(*cache));
+    OS_close(fd);
+
+    if (status != (int32)sizeof(*cache) || cache->Signature != I2C_APP_DEVICE_CACHE_SIGNATURE ||
+        cache->NumDevices == 0 || cache->NumDevices > I2C_APP_TBL_MAX_DEVICES) {
+        return CFE_STATUS_VALIDATION_FAILURE;
+    }
+
     return CFE_SUCCESS;
 }
 
+void I2C_APP_WriteDeviceCache(void) {
+    I2C_APP_DeviceCache_t cache;
+    osal_id_t             fd;
+    int32                 status;
+
+    memset(&cache, 0, sizeof(cache));
+    cache.Signature  = I2C_APP_DEVICE_CACHE_SIGNATURE;
+    cache.NumDevices = I2C_APP_Data.NumDiscovered;
+    memcpy(cache.Devices, I2C_APP_Data.Discovered, sizeof(cache.Devices));
+
+    status = OS_OpenCreate(&fd, I2C_APP_DEVICE_CACHE_FILE, OS_FILE_FLAG_CREATE | OS_FILE_FLAG_TRUNCATE,
+                           OS_WRITE_ONLY);
+    if (status == OS_SUCCESS) {
+        status = OS_write(fd, &cache, sizeof(cache)) == (int32)sizeof(cache) ? OS_SUCCESS : OS_ERROR;
+        OS_close(fd);
+    }
+    if (status != OS_SUCCESS) {
+        CFE_EVS_SendEvent(I2C_APP_DISCOVER_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "I2C: could not write %s, the next start scans again, RC = %ld",
+                          I2C_APP_DEVICE_CACHE_FILE, (long)status);
+    }
+}
+
+/*
+** Find out where the robots are: where the cache says, if they all still
+** answer there, else by scanning the configured buses.  A scan that finds nothing
+** leaves the configured devices to themselves, and the cache as it was.
+*/
+void I2C_APP_Discover(void) {
+    I2C_APP_DeviceCache_t cache;
+    I2C_APP_TblDevice_t   before[I2C_APP_TBL_MAX_DEVICES];
+    uint16                i;
+
+    I2C_APP_Data.NumDiscovered = 0;
+    I2C_APP_Data.DiscoverFlags = 0;
+
+    if (I2C_APP_ReadDeviceCache(&cache) == CFE_SUCCESS) {
+        for (i = 0; i < cache.NumDevices && I2C_APP_ProbeDevice(&cache.Devices[i]); ++i) {
+            I2C_APP_AddDiscovered(cache.Devices[i].BusNum, cache.Devices[i].Address);
+        }
+        if (i == cache.NumDevices) {
+            I2C_APP_Data.DiscoverFlags = I2C_APP_STARTUP_CACHED;
+        } else {
+            CFE_EVS_SendEvent(I2C_APP_DISCOVER_INF_EID, CFE_EVS_EventType_INFORMATION,
+                              "I2C: no robot at cached bus %u address 0x%02X, scanning",
+                              (unsigned int)cache.Devices[i].BusNum, (unsigned int)cache.Devices[i].Address);
+            I2C_APP_Data.NumDiscovered = 0;
+        }
+    }
+
+    if (I2C_APP_Data.DiscoverFlags == 0) {
+        I2C_APP_Data.DiscoverFlags = I2C_APP_STARTUP_SCANNED;
+        I2C_APP_ScanBuses();
+        if (I2C_APP_Data.NumDiscovered > 0) {
+            I2C_APP_WriteDeviceCache();
+        }
+    }
+
+    if (I2C_APP_Data.NumDiscovered == 0) {
+        CFE_EVS_SendEvent(I2C_APP_DISCOVER_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "I2C: no robot found on the configured buses, trying the configured devices");
+    } else {
+        CFE_EVS_SendEvent(I2C_APP_DISCOVER_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "I2C: %u robot(s) %s, first on bus %u at 0x%02X", (unsigned int)I2C_APP_Data.NumDiscovered,
+                          I2C_APP_Data.DiscoverFlags == I2C_APP_STARTUP_CACHED ? "where cached" : "found",
+                          (unsigned int)I2C_APP_Data.Discovered[0].BusNum,
+                          (unsigned int)I2C_APP_Data.Discovered[0].Address);
+    }
+
+    /* a device index restored from the CDS only holds for the same list */
+    memcpy(before, I2C_APP_Data.Config.Devices, sizeof(before));
+    I2C_APP_MergeDevices(&I2C_APP_Data.Config);
+    if (memcmp(before, I2C_APP_Data.Config.Devices, sizeof(before)) != 0 ||
+        I2C_APP_Data.DeviceIndex >= I2C_APP_Data.Config.NumDevices) {
+        I2C_APP_Data.DeviceIndex = 0;
+    }
+}
+
+/*
+** The devices to try: the robots discovered at startup if the
+** configuration asks for them, then its own entries that are not among
+** them, as many as fit.
+*/
+void I2C_APP_MergeDevices(I2C_APP_Table_t* config) {
+    I2C_APP_TblDevice_t devices[I2C_APP_TBL_MAX_DEVICES];
+    uint16              n = 0;
+    uint16              i;
+    uint16              j;
+
+    if (!config->Discover) {
+        return;
+    }
+    for (i = 0; i < I2C_APP_Data.NumDiscovered; ++i) {
+        devices[n++] = I2C_APP_Data.Discovered[i];
+    }
+    for (i = 0; i < config->NumDevices && n < I2C_APP_TBL_MAX_DEVICES; ++i) {
+        for (j = 0; j < n; ++j) {
+            if (devices[j].BusNum == config->Devices[i].BusNum && devices[j].Address == config->Devices[i].Address) {
+                break;
+            }
+        }
+        if (j == n) {
+            devices[n++] = config->Devices[i];
+        }
+    }
+
+    memset(config->Devices, 0, sizeof(config->Devices));
+    memcpy(config->Devices, devices, n * sizeof(devices[0]));
+    config->NumDevices = n;
+}
+
+/*
+** Microseconds from one local time to a later one, saturated to 32 bits.
+*/
+uint32 I2C_APP_ElapsedUs(OS_time_t from, OS_time_t to) {
+    int64 us = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(to, from));
+
+    if (us < 0) {
+        return 0;
+    }
+    return us > UINT32_MAX ? UINT32_MAX : (uint32)us;
+}
+
+/*
+** Charge the time since *mark to a startup phase, and move the mark on.
+** A phase that runs in two pieces adds up.
+*/
+void I2C_APP_EndPhase(uint16 phase, OS_time_t* mark) {
+    OS_time_t now;
+
+    OS_GetLocalTime(&now);
+    I2C_APP_Data.StartupPhaseUs[phase] += I2C_APP_ElapsedUs(*mark, now);
+    *mark = now;
+}
+
+/*
+** Open the bus at startup and find out what is on it: where the robots
+** are, if the configuration in effect asks (a fast boot runs on the
+** built-in one, and leaves a table's request to I2C_APP_ApplyConfig),
+** the robot's identity, and the command block it last saw.  After a warm
+** restart the last two came back from the CDS and only the open is left
+** to do.
+**
+** A serial start gives the robot I2C_APP_SETTLE_MS before reading it.
+** Fast boot reads it straight away and retries every
+** I2C_APP_PROBE_RETRY_MS while it does not answer, for no longer than the
+** settle time, so a robot that is already running costs one read.
+*/
+void I2C_APP_StartBus(void) {
+    I2C_Telem_Packet telem;
+    OS_time_t        start;
+    OS_time_t        end;
+    CFE_Status_t     status;
+    uint32           waited = 0;
+
+    OS_GetLocalTime(&start);
+
+    if (I2C_APP_Data.Config.Discover) {
+        I2C_APP_Discover();
+    }
+
+    status = I2C_APP_OpenDevice();
+    I2C_APP_Data.BusFaulted = (status != CFE_SUCCESS);
+    if (status != CFE_SUCCESS) {
+        CFE_EVS_SendEvent(I2C_APP_STARTUP_INF_EID, CFE_EVS_EventType_ERROR,
+                          "I2C App: Error opening I2C bus, RC = 0x%08lX", (unsigned long)status);
+    } else {
+        CFE_EVS_SendEvent(I2C_APP_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "I2C Connection Established");
+    }
+
+    if (status == CFE_SUCCESS && !I2C_APP_Data.WarmStart) {
+        if (!I2C_APP_Data.FastBoot) {
+            OS_TaskDelay(I2C_APP_SETTLE_MS);
+        }
+        status = I2C_APP_Identify(I2C_APP_Data.i2c_fd);
+        while (status != CFE_SUCCESS && I2C_APP_Data.FastBoot && waited < I2C_APP_SETTLE_MS) {
+            OS_TaskDelay(I2C_APP_PROBE_RETRY_MS);
+            waited += I2C_APP_PROBE_RETRY_MS;
+            status = I2C_APP_Identify(I2C_APP_Data.i2c_fd);
+        }
+        if (status != CFE_SUCCESS) {
+            CFE_EVS_SendEvent(I2C_APP_IDENT_INF_EID, CFE_EVS_EventType_ERROR,
+                              "I2C: identity read failed, using protocol v1 transfers, RC = 0x%08lX",
+                              (unsigned long)status);
+        }
+
+        /*
+        ** The robot keeps its command block across an app restart; start
+        ** from its echo so the first move is compared against what the
+        ** firmware last saw.
+        */
+        if (I2C_APP_Receive(I2C_APP_Data.i2c_fd, &telem) == CFE_SUCCESS) {
+            I2C_APP_Data.RobotCmd.left_speed  = telem.cmd_left_speed;
+            I2C_APP_Data.RobotCmd.right_speed = telem.cmd_right_speed;
+            I2C_APP_Data.RobotCmd.left_dist   = telem.cmd_left_dist;
+            I2C_APP_Data.RobotCmd.right_dist  = telem.cmd_right_dist;
+        }
+    }
+
+    OS_GetLocalTime(&end);
+    I2C_APP_Data.BusProbeUs = I2C_APP_ElapsedUs(start, end);
+    I2C_APP_Data.BusStarted = true;
+}
+
+/*
+** Fast boot child task: bring the bus up, then hand it back to the app.
+** Until the semaphore is given the bus and everything I2C_APP_StartBus
+** sets belong to this task.
+*/
+void I2C_APP_BusStartTask(void) {
+    CFE_ES_PerfLogEntry(I2C_APP_BUS_START_PERF_ID);
+    I2C_APP_StartBus();
+    CFE_ES_PerfLogExit(I2C_APP_BUS_START_PERF_ID);
+
+    OS_BinSemGive(I2C_APP_Data.BusStartSem);
+    CFE_ES_ExitChildTask();
+}
+
+/*
+** Account for a transaction on the app's own bus connection.
+**
+** A failed transaction closes the connection and marks it invalid, so the
+** next one reopens the bus rather than using a dangling descriptor.
+** Events are only raised on the transitions (first failure, first good
+** transaction afterwards); retries while the bus is still down are just
+** counted.
+*/
+void I2C_APP_BusResult(CFE_Status_t status, const char *op) {
+    if (status != CFE_SUCCESS) {
+        I2C_APP_Data.BusErrCounter++;
+        close(I2C_APP_Data.i2c_fd);
+        I2C_APP_Data.i2c_fd = -1;
+        if (!I2C_APP_Data.BusFaulted) {
+            I2C_APP_Data.BusFaulted = true;
+            CFE_EVS_SendEvent(I2C_APP_BUS_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "I2C: bus %s failed, connection closed, RC = 0x%08lX", op, (unsigned long)status);
+        }
+    } else if (I2C_APP_Data.BusFaulted) {
+        I2C_APP_Data.BusFaulted = false;
+        I2C_APP_Data.BusRecoveryCounter++;
+        CFE_EVS_SendEvent(I2C_APP_BUS_INF_EID, CFE_EVS_EventType_INFORMATION, "I2C: bus connection recovered");
+    }
+}
+
+/*
+** Leave a command block for the next control cycle to write.
+*/
+void I2C_APP_StageCommand(const I2C_Command_Packet* packet) {
+    I2C_APP_Data.RobotCmd   = *packet;
+    I2C_APP_Data.PendingCmd = *packet;
+    I2C_APP_Data.CmdPending = true;
+}
+
+/*
+** Send a command on the app's own bus connection.
+**
+** A command that does not make it onto the bus is kept as pending and
+** retried by the next control cycle; a newer command replaces it.
+*/
+CFE_Status_t I2C_APP_SendCommand(I2C_Command_Packet* packet) {
+    CFE_Status_t status;
+
+    status = I2C_APP_BusConnect();
+    if (status == CFE_SUCCESS) {
+        status = I2C_APP_Send(I2C_APP_Data.i2c_fd, packet);
+        I2C_APP_BusResult(status, "write");
+    }
+
+    if (status != CFE_SUCCESS) {
+        I2C_APP_StageCommand(packet);
+    } else {
+        I2C_APP_Data.RobotCmd   = *packet;
+        I2C_APP_Data.CmdPending = false;
+    }
+
+    return status;
+}
+
+/*
+** Start a distance move, with the speeds left to the firmware's ladder.
+**
+** The firmware only starts a move when a distance register changes, so a
+** move that repeats the last distance on a wheel writes zero distances
+** now and leaves the move itself for the next control cycle.  Either way
+** this is one bus write.
+*/
+CFE_Status_t I2C_APP_Move(int16 left_dist, int16 right_dist) {
+    I2C_Command_Packet packet = I2C_APP_Data.RobotCmd;
+    CFE_Status_t       status;
+    bool               repeat;
+
+    repeat = (left_dist != 0 && left_dist == packet.left_dist) ||
+             (right_dist != 0 && right_dist == packet.right_dist);
+
+    packet.left_speed  = 0;
+    packet.right_speed = 0;
+    packet.left_dist   = repeat ? 0 : left_dist;
+    packet.right_dist  = repeat ? 0 : right_dist;
+    status = I2C_APP_SendCommand(&packet);
+
+    if (repeat && status == CFE_SUCCESS) {
+        packet.left_dist  = left_dist;
+        packet.right_dist = right_dist;
+        I2C_APP_StageCommand(&packet);
+    }
+
+    return status;
+}
+
+/*
+** Zero both speeds and distances and drop the rest of any path; this also
+** supersedes a command still pending for the bus.
+*/
+CFE_Status_t I2C_APP_StopMotion(void) {
+    I2C_Command_Packet packet = I2C_APP_Data.RobotCmd;
+
+    I2C_APP_Data.PathActive = false;
+    packet.left_speed  = 0;
+    packet.right_speed = 0;
+    packet.left_dist   = 0;
+    packet.right_dist  = 0;
+
+    return I2C_APP_SendCommand(&packet);
+}
+
+/*
+** Service the e-stop pipe: any number of queued stops is one stop.  The
+** latency runs from the time the message the stop may have waited behind
+** came off the command pipe, so it covers at most one dispatch and the
+** stop's own bus write.
+*/
+void I2C_APP_CheckEStop(void) {
+    CFE_SB_Buffer_t *buf;
+    CFE_Status_t     status;
+    OS_time_t        now;
+    int64            latency;
+    uint16           found = 0;
+    int              i;
+
+    /* bounded: the pipe cannot hold more than its depth */
+    for (i = 0; i < I2C_APP_ESTOP_PIPE_DEPTH; ++i) {
+        status = CFE_SB_ReceiveBuffer(&buf, I2C_APP_Data.EStopPipe, CFE_SB_POLL);
+        if (status != CFE_SUCCESS) {
+            if (status != CFE_SB_NO_MESSAGE) {
+                CFE_EVS_SendEvent(I2C_APP_PIPE_ERR_EID, CFE_EVS_EventType_ERROR,
+                                  "I2C: e-stop pipe read error, RC = 0x%08lX", (unsigned long)status);
+            }
+            break;
+        }
+        ++found;
+    }
+    if (found == 0) {
+        return;
+    }
+
+    /* what was queued ahead of these stops must not move the robot again */
+    I2C_APP_Data.EStopFence       = (uint16)(I2C_APP_Data.EStopFence + found);
+    I2C_APP_Data.EStopFenceBudget = I2C_APP_Data.PipeDepth;
+
+    status = I2C_APP_StopMotion();
+
+    OS_GetLocalTime(&now);
+    latency = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(now, I2C_APP_Data.DispatchTime));
+    if (latency < 0) {
+        latency = 0;
+    }
+    I2C_APP_Data.EStopCounter++;
+    I2C_APP_Data.EStopLatencyUs = (uint32)latency;
+    if (I2C_APP_Data.EStopLatencyUs > I2C_APP_Data.EStopLatencyMaxUs) {
+        I2C_APP_Data.EStopLatencyMaxUs = I2C_APP_Data.EStopLatencyUs;
+    }
+
+    CFE_EVS_SendEvent(I2C_APP_ESTOP_INF_EID, CFE_EVS_EventType_INFORMATION, "I2C: EMERGENCY STOP, %lu us%s",
+                      (unsigned long)I2C_APP_Data.EStopLatencyUs,
+                      status == CFE_SUCCESS ? "" : ", bus down, retried every cycle");
+
+    /* a restart must not resume the path that was just stopped */
+    I2C_APP_SaveState();
+}
+
+/*
+** num / den rounded to the nearest encoder count, false if that does not
+** fit a distance register.
+*/
+bool I2C_APP_ScaleCounts(int64 num, int64 den, int16* counts) {
+    int64 q = (num >= 0 ? num + den / 2 : num - den / 2) / den;
+
+    if (q < -INT16_MAX || q > INT16_MAX) {
+        return false;
+    }
+    *counts = (int16)q;
+
+    return true;
+}
+
+/*
+** Encoder counts each wheel turns for a straight move.
+*/
+bool I2C_APP_DriveCounts(int16 mm, int16* counts) {
+    return I2C_APP_ScaleCounts((int64)mm * I2C_APP_Data.Config.CountsPerM, 1000, counts);
+}
+
+/*
+** Encoder counts each wheel turns, in opposite directions, for a turn in
+** place: angle * pi * wheel base / 360 of arc, with pi as 355/113.
+*/
+bool I2C_APP_SpinCounts(int16 degrees, int16* counts) {
+    return I2C_APP_ScaleCounts((int64)degrees * I2C_APP_Data.Config.WheelBaseMm * I2C_APP_Data.Config.CountsPerM * 355,
+                               (int64)360 * 1000 * 113, counts);
+}
+
+/*
+** Start the next path segment once the robot has finished the current one.
+**
+** The move is finished when the robot echoes the distances it was last
+** sent, has nothing left to travel and has stopped both motors.  Anything
+** still pending for the bus means the robot has not seen the move yet.
+*/
+void I2C_APP_AdvancePath(const I2C_Telem_Packet* telem) {
+    const I2C_APP_PathStep_t *step;
+
+    if (!I2C_APP_Data.PathActive || I2C_APP_Data.CmdPending) {
+        return;
+    }
+    if (telem->cmd_left_dist != I2C_APP_Data.RobotCmd.left_dist ||
+        telem->cmd_right_dist != I2C_APP_Data.RobotCmd.right_dist || telem->rem_left != 0 ||
+        telem->rem_right != 0 || telem->set_left_speed != 0 || telem->set_right_speed != 0) {
+        return;
+    }
+
+    if (I2C_APP_Data.PathNext >= I2C_APP_Data.PathLength) {
+        I2C_APP_Data.PathActive = false;
+        CFE_EVS_SendEvent(I2C_APP_PATH_INF_EID, CFE_EVS_EventType_INFORMATION, "I2C: path of %u segments complete",
+                          (unsigned int)I2C_APP_Data.PathLength);
+        return;
+    }
+
+    step = &I2C_APP_Data.Path[I2C_APP_Data.PathNext++];
+    I2C_APP_Move(step->LeftDist, step->RightDist);
+}
+
+/*
+** Add the wheel travel since the last reading to the odometry.  The
+** encoders are 16 bits and wrap, so only the difference between two
+** readings is used; the first reading only sets the reference.
+*/
+void I2C_APP_UpdateOdometry(const I2C_Telem_Packet* telem) {
+    if (I2C_APP_Data.OdomValid) {
+        I2C_APP_Data.OdomLeft += (int16)(uint16)((uint16)telem->l_enc - (uint16)I2C_APP_Data.LastLeftEnc);
+        I2C_APP_Data.OdomRight += (int16)(uint16)((uint16)telem->r_enc - (uint16)I2C_APP_Data.LastRightEnc);
+    }
+    I2C_APP_Data.LastLeftEnc  = telem->l_enc;
+    I2C_APP_Data.LastRightEnc = telem->r_enc;
+    I2C_APP_Data.OdomValid    = true;
+}
+
+/*
+** Read the robot's telemetry block on the app's own bus connection.
+*/
+CFE_Status_t I2C_APP_ReadTelemetry(I2C_Telem_Packet* telem) {
+    CFE_Status_t status;
+
+    status = I2C_APP_BusConnect();
+    if (status == CFE_SUCCESS) {
+        status = I2C_APP_Receive(I2C_APP_Data.i2c_fd, telem);
+        I2C_APP_BusResult(status, "read");
+    }
+
+    return status;
+}
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *  * *  * * * * **/
 /*                                                                            */
 /* Application entry point and main process loop                              */
@@ -117,7 +869,11 @@ void I2C_APP_Main(void)
 
         if (status == CFE_SUCCESS)
         {
+            OS_GetLocalTime(&I2C_APP_Data.DispatchTime);
             I2C_APP_ProcessCommandPacket(SBBufPtr);
+
+            /* a stop sent while that message ran goes out before the next one */
+            I2C_APP_CheckEStop();
         }
         else
         {
@@ -143,7 +899,21 @@ void I2C_APP_Main(void)
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 int32 I2C_APP_Init(void)
 {
-    int32 status;
+    int32           status;
+    OS_time_t       Mark;
+    CFE_ES_TaskId_t TaskId;
+    bool            TblLoaded;
+
+    /*
+    ** Everything below is timed from here, up to the first robot telemetry
+    */
+    OS_GetLocalTime(&I2C_APP_Data.StartTime);
+    Mark = I2C_APP_Data.StartTime;
+    memset(I2C_APP_Data.StartupPhaseUs, 0, sizeof(I2C_APP_Data.StartupPhaseUs));
+    I2C_APP_Data.StartupUs  = 0;
+    I2C_APP_Data.BusProbeUs = 0;
+    I2C_APP_Data.FirstTlmUs = 0;
+    I2C_APP_Data.FastBoot   = false;
 
     I2C_APP_Data.RunStatus = CFE_ES_RunStatus_APP_RUN;
 
@@ -152,11 +922,62 @@ int32 I2C_APP_Init(void)
     */
     I2C_APP_Data.CmdCounter = 0;
     I2C_APP_Data.ErrCounter = 0;
+    I2C_APP_Data.BusErrCounter      = 0;
+    I2C_APP_Data.BusRecoveryCounter = 0;
 
     /*
     ** Initialize app configuration data
     */
     I2C_APP_Data.PipeDepth = I2C_APP_PIPE_DEPTH;
+    I2C_APP_Data.BusNum    = I2C_APP_BUS_NUM;
+    I2C_APP_Data.Address   = I2C_ADDRESS;
+    I2C_APP_Data.i2c_fd    = -1;
+    I2C_APP_Data.BusStarted    = false;
+    I2C_APP_Data.DeviceIndex   = 0;
+    I2C_APP_Data.ReopenHoldoff = 0;
+    I2C_APP_Data.RobotFeatures = 0;
+    memset(&I2C_APP_Data.RobotIdent, 0, sizeof(I2C_APP_Data.RobotIdent));
+    I2C_APP_Data.OdomLeft     = 0;
+    I2C_APP_Data.OdomRight    = 0;
+    I2C_APP_Data.OdomValid    = false;
+    I2C_APP_Data.CdsEnabled   = false;
+    I2C_APP_Data.WarmStart    = false;
+    I2C_APP_Data.CdsSaveCycle = 0;
+
+    /*
+    ** Built-in configuration, in effect until the table loads
+    */
+    memset(&I2C_APP_Data.Config, 0, sizeof(I2C_APP_Data.Config));
+    I2C_APP_Data.Config.NumDevices         = 1;
+    I2C_APP_Data.Config.Discover           = I2C_APP_DISCOVER;
+    I2C_APP_Data.Config.Devices[0].BusNum  = I2C_APP_BUS_NUM;
+    I2C_APP_Data.Config.Devices[0].Address = I2C_ADDRESS;
+    I2C_APP_Data.Config.PollDivider        = 1;
+    I2C_APP_Data.Config.TransferFeatures   = I2C_APP_SUPPORTED_FEATURES;
+    I2C_APP_Data.Config.CountsPerM         = I2C_APP_COUNTS_PER_M;
+    I2C_APP_Data.Config.WheelBaseMm        = I2C_APP_WHEEL_BASE_MM;
+    I2C_APP_Data.Config.MaxWheelSpeed      = I2C_APP_MAX_WHEEL_SPEED;
+    I2C_APP_Data.ConfigLoadCounter         = 0;
+    I2C_APP_Data.NumDiscovered             = 0;
+    I2C_APP_Data.DiscoverFlags             = 0;
+
+    /*
+    ** Initialize control cycle state
+    */
+    I2C_APP_Data.CmdPending       = false;
+    memset(&I2C_APP_Data.RobotCmd, 0, sizeof(I2C_APP_Data.RobotCmd));
+    I2C_APP_Data.PathActive       = false;
+    I2C_APP_Data.PathLength       = 0;
+    I2C_APP_Data.PathNext         = 0;
+    I2C_APP_Data.CycleCounter     = 0;
+    I2C_APP_Data.CyclePeriodUs    = 0;
+    I2C_APP_Data.CycleJitterMaxUs = 0;
+    I2C_APP_Data.EStopCounter      = 0;
+    I2C_APP_Data.TlmDropCounter    = 0;
+    I2C_APP_Data.EStopLatencyUs    = 0;
+    I2C_APP_Data.EStopLatencyMaxUs = 0;
+    I2C_APP_Data.EStopFence        = 0;
+    I2C_APP_Data.EStopFenceBudget  = 0;
 
     strncpy(I2C_APP_Data.PipeName, "I2C_APP_CMD_PIPE", sizeof(I2C_APP_Data.PipeName));
     I2C_APP_Data.PipeName[sizeof(I2C_APP_Data.PipeName) - 1] = 0;
@@ -176,6 +997,42 @@ int32 I2C_APP_Init(void)
     */
     CFE_MSG_Init(CFE_MSG_PTR(I2C_APP_Data.HkTlm.TelemetryHeader), CFE_SB_ValueToMsgId(I2C_APP_HK_TLM_MID),
                  sizeof(I2C_APP_Data.HkTlm));
+    I2C_APP_EndPhase(I2C_APP_STARTUP_EVS, &Mark);
+
+    /*
+    ** Pick up where a previous run of the app left off, if ES restarted it.
+    ** This comes ahead of the bus start, which a warm restart cuts short.
+    */
+    I2C_APP_RestoreState();
+    I2C_APP_EndPhase(I2C_APP_STARTUP_CDS, &Mark);
+
+    /*
+    ** Fast boot: open and probe the bus on a child task while the pipes
+    ** and the table are set up below.  If the app fails to initialize
+    ** before it is done, ES deletes the child task along with the app.
+    */
+    if (I2C_APP_FAST_BOOT)
+    {
+        I2C_APP_Data.FastBoot = true;
+        status = OS_BinSemCreate(&I2C_APP_Data.BusStartSem, "I2C_APP_BUS_SEM", 0, 0);
+        if (status == OS_SUCCESS)
+        {
+            status = CFE_ES_CreateChildTask(&TaskId, I2C_APP_BUS_START_TASK_NAME, I2C_APP_BusStartTask,
+                                            CFE_ES_TASK_STACK_ALLOCATE, I2C_APP_BUS_START_STACK_SIZE,
+                                            I2C_APP_BUS_START_PRIORITY, 0);
+            if (status != CFE_SUCCESS)
+            {
+                OS_BinSemDelete(I2C_APP_Data.BusStartSem);
+            }
+        }
+        if (status != CFE_SUCCESS)
+        {
+            I2C_APP_Data.FastBoot = false;
+            CFE_EVS_SendEvent(I2C_APP_STARTUP_INF_EID, CFE_EVS_EventType_ERROR,
+                              "I2C App: fast boot unavailable, starting the bus serially, RC = 0x%08lX",
+                              (unsigned long)status);
+        }
+    }
 
     /*
     ** Create Software Bus message pipe.
@@ -208,22 +1065,49 @@ int32 I2C_APP_Init(void)
         return status;
     }
 
+    /*
+    ** Subscribe to the scheduler wakeup that drives the control cycle
+    */
+    status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(I2C_APP_WAKEUP_MID), I2C_APP_Data.CommandPipe);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("I2C App: Error Subscribing to wakeup, RC = 0x%08lX\n", (unsigned long)status);
+
+        return status;
+    }
+
+    /*
+    ** Emergency stops get a pipe of their own, so they never queue behind
+    ** the commands on the main one. They are also subscribed on the command
+    ** pipe, only so that one arriving while the app is idle wakes it.
+    */
+    status = CFE_SB_CreatePipe(&I2C_APP_Data.EStopPipe, I2C_APP_ESTOP_PIPE_DEPTH, "I2C_APP_ESTOP_PIPE");
+    if (status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("I2C App: Error creating e-stop pipe, RC = 0x%08lX\n", (unsigned long)status);
+
+        return status;
+    }
+
+    status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(I2C_APP_ESTOP_MID), I2C_APP_Data.EStopPipe);
     if (status == CFE_SUCCESS)
     {
-        /*
-        ** Open the I2C and set the corresponding file descriptor
-        */
-        status = I2C_OPEN_BUS(2, &I2C_APP_Data.i2c_fd);
-        if (status == -1) {
-            CFE_EVS_SendEvent(I2C_APP_STARTUP_INF_EID, CFE_EVS_EventType_ERROR,
-                "I2C App: Error Registering Example Table, RC = 0x%08lX", (unsigned long)status);
-        }
-        CFE_EVS_SendEvent(I2C_APP_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "I2C Connection Established");
+        status = CFE_SB_Subscribe(CFE_SB_ValueToMsgId(I2C_APP_ESTOP_MID), I2C_APP_Data.CommandPipe);
+    }
+    if (status != CFE_SUCCESS)
+    {
+        CFE_ES_WriteToSysLog("I2C App: Error Subscribing to e-stop, RC = 0x%08lX\n", (unsigned long)status);
+
+        return status;
     }
 
+    I2C_APP_EndPhase(I2C_APP_STARTUP_SB, &Mark);
 
     /*
-    ** Register Table(s)
+    ** Register Table(s).  In a serial start the configuration is loaded
+    ** ahead of the bus, so the first open already goes to the configured
+    ** robot.  In fast boot it is applied once the child task is done, and
+    ** moves the connection if the table puts the robot somewhere else.
     */
     status = CFE_TBL_Register(&I2C_APP_Data.TblHandles[0], "I2cAppTable", sizeof(I2C_APP_Table_t),
                               CFE_TBL_OPT_DEFAULT, I2C_APP_TblValidationFunc);
@@ -233,10 +1117,39 @@ int32 I2C_APP_Init(void)
 
         return status;
     }
-    else
+
+    /* without a table image the built-in configuration stays */
+    TblLoaded = (CFE_TBL_Load(I2C_APP_Data.TblHandles[0], CFE_TBL_SRC_FILE, I2C_APP_TABLE_FILE) == CFE_SUCCESS);
+
+    if (I2C_APP_Data.FastBoot)
+    {
+        I2C_APP_EndPhase(I2C_APP_STARTUP_TBL, &Mark);
+        OS_BinSemTake(I2C_APP_Data.BusStartSem);
+        OS_BinSemDelete(I2C_APP_Data.BusStartSem);
+        I2C_APP_EndPhase(I2C_APP_STARTUP_BUS, &Mark);
+    }
+    if (TblLoaded)
     {
-        status = CFE_TBL_Load(I2C_APP_Data.TblHandles[0], CFE_TBL_SRC_FILE, I2C_APP_TABLE_FILE);
+        I2C_APP_LoadConfig();
     }
+    I2C_APP_EndPhase(I2C_APP_STARTUP_TBL, &Mark);
+
+    if (!I2C_APP_Data.FastBoot)
+    {
+        I2C_APP_StartBus();
+        I2C_APP_EndPhase(I2C_APP_STARTUP_BUS, &Mark);
+    }
+
+    I2C_APP_Data.StartupUs = I2C_APP_ElapsedUs(I2C_APP_Data.StartTime, Mark);
+    CFE_EVS_SendEvent(I2C_APP_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "I2C App: started in %lu us (evs %lu, sb %lu, tbl %lu, cds %lu, bus %lu)%s",
+                      (unsigned long)I2C_APP_Data.StartupUs,
+                      (unsigned long)I2C_APP_Data.StartupPhaseUs[I2C_APP_STARTUP_EVS],
+                      (unsigned long)I2C_APP_Data.StartupPhaseUs[I2C_APP_STARTUP_SB],
+                      (unsigned long)I2C_APP_Data.StartupPhaseUs[I2C_APP_STARTUP_TBL],
+                      (unsigned long)I2C_APP_Data.StartupPhaseUs[I2C_APP_STARTUP_CDS],
+                      (unsigned long)I2C_APP_Data.StartupPhaseUs[I2C_APP_STARTUP_BUS],
+                      I2C_APP_Data.FastBoot ? ", fast boot" : "");
 
     CFE_EVS_SendEvent(I2C_APP_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION, "I2C App Initialized.%s",
                       I2C_APP_VERSION_STRING);
@@ -257,131 +1170,521 @@ void I2C_APP_ProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr)
 
     CFE_MSG_GetMsgId(&SBBufPtr->Msg, &MsgId);
 
+    if (I2C_APP_Data.EStopFence > 0)
+    {
+        if (I2C_APP_Data.EStopFenceBudget > 0)
+        {
+            I2C_APP_Data.EStopFenceBudget--;
+        }
+        else
+        {
+            I2C_APP_Data.EStopFence = 0;
+        }
+    }
+
     switch (CFE_SB_MsgIdToValue(MsgId))
     {
         case I2C_APP_CMD_MID:
             I2C_APP_ProcessGroundCommand(SBBufPtr);
             break;
 
-        case I2C_APP_SEND_HK_MID:
-            I2C_APP_ReportHousekeeping((CFE_MSG_CommandHeader_t *)SBBufPtr);
-            break;
+        case I2C_APP_SEND_HK_MID:
+            I2C_APP_ReportHousekeeping((CFE_MSG_CommandHeader_t *)SBBufPtr);
+            break;
+
+        case I2C_APP_WAKEUP_MID:
+            I2C_APP_Wakeup((CFE_MSG_CommandHeader_t *)SBBufPtr);
+            break;
+
+        /*
+        ** Only a wakeup: the stop itself is taken from the e-stop pipe.
+        ** This copy marks where the stop was sent, so the motion commands
+        ** from here on are the ones sent after it.
+        */
+        case I2C_APP_ESTOP_MID:
+            I2C_APP_CheckEStop();
+            if (I2C_APP_Data.EStopFence > 0)
+            {
+                I2C_APP_Data.EStopFence--;
+            }
+            break;
+
+        default:
+            CFE_EVS_SendEvent(I2C_APP_INVALID_MSGID_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "I2C: invalid command packet,MID = 0x%x", (unsigned int)CFE_SB_MsgIdToValue(MsgId));
+            break;
+    }
+
+    /* at most one CDS write per message, none if nothing changed, and odometry alone once a second */
+    I2C_APP_SaveState();
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* I2C ground commands                                                     */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+void I2C_APP_ProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr)
+{
+    CFE_MSG_FcnCode_t CommandCode = 0;
+
+    CFE_MSG_GetFcnCode(&SBBufPtr->Msg, &CommandCode);
+
+    /*
+    ** A motion command sent before a stop that has already been carried
+    ** out is dropped, not run after it
+    */
+    if (I2C_APP_Data.EStopFence > 0 &&
+        (CommandCode == I2C_APP_SET_WHEEL_SPEEDS_CC || CommandCode == I2C_APP_DRIVE_DISTANCE_CC ||
+         CommandCode == I2C_APP_SPIN_CC || CommandCode == I2C_APP_RUN_PATH_CC))
+    {
+        I2C_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(I2C_APP_ESTOP_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "I2C: motion command %u sent before the e-stop dropped", (unsigned int)CommandCode);
+        return;
+    }
+
+    /*
+    ** Process "known" I2C app ground commands
+    */
+    switch (CommandCode)
+    {
+        case I2C_APP_NOOP_CC:
+            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_NoopCmd_t)))
+            {
+                I2C_APP_Noop((I2C_APP_NoopCmd_t *)SBBufPtr);
+            }
+
+            break;
+
+        case I2C_APP_RESET_COUNTERS_CC:
+            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_ResetCountersCmd_t)))
+            {
+                I2C_APP_ResetCounters((I2C_APP_ResetCountersCmd_t *)SBBufPtr);
+            }
+
+            break;
+
+        case I2C_APP_REPORT_CONFIG_CC:
+            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_ReportConfigCmd_t)))
+            {
+                I2C_APP_ReportConfig((I2C_APP_ReportConfigCmd_t *)SBBufPtr);
+            }
+
+            break;
+
+        case I2C_APP_SET_WHEEL_SPEEDS_CC:
+            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_SetWheelSpeedsCmd_t)))
+            {
+                I2C_APP_SetWheelSpeeds((I2C_APP_SetWheelSpeedsCmd_t *)SBBufPtr);
+            }
+
+            break;
+
+        case I2C_APP_DRIVE_DISTANCE_CC:
+            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_DriveDistanceCmd_t)))
+            {
+                I2C_APP_DriveDistance((I2C_APP_DriveDistanceCmd_t *)SBBufPtr);
+            }
+
+            break;
+
+        case I2C_APP_SPIN_CC:
+            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_SpinCmd_t)))
+            {
+                I2C_APP_Spin((I2C_APP_SpinCmd_t *)SBBufPtr);
+            }
+
+            break;
+
+        case I2C_APP_SET_LEDS_CC:
+            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_SetLedsCmd_t)))
+            {
+                I2C_APP_SetLeds((I2C_APP_SetLedsCmd_t *)SBBufPtr);
+            }
+
+            break;
+
+        case I2C_APP_STOP_CC:
+            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_StopCmd_t)))
+            {
+                I2C_APP_Stop((I2C_APP_StopCmd_t *)SBBufPtr);
+            }
+
+            break;
+
+        case I2C_APP_RUN_PATH_CC:
+            if (I2C_APP_VerifyPathCmdLength(&SBBufPtr->Msg))
+            {
+                I2C_APP_RunPath((I2C_APP_RunPathCmd_t *)SBBufPtr);
+            }
+
+            break;
+
+        /* default case already found during FC vs length test */
+        default:
+            CFE_EVS_SendEvent(I2C_APP_COMMAND_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "Invalid ground command code: CC = %d", CommandCode);
+            break;
+    }
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/*  Purpose:                                                                  */
+/*         This function is triggered in response to a task telemetry request */
+/*         from the housekeeping task. This function will gather the Apps     */
+/*         telemetry, packetize it and send it to the housekeeping task via   */
+/*         the software bus                                                   */
+/* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
+int32 I2C_APP_ReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg)
+{
+    int i;
+
+    /*
+    ** Get command execution counters...
+    */
+    I2C_APP_Data.HkTlm.Payload.CommandErrorCounter = I2C_APP_Data.ErrCounter;
+    I2C_APP_Data.HkTlm.Payload.CommandCounter      = I2C_APP_Data.CmdCounter;
+    I2C_APP_Data.HkTlm.Payload.BusErrorCounter     = I2C_APP_Data.BusErrCounter;
+    I2C_APP_Data.HkTlm.Payload.BusRecoveryCounter  = I2C_APP_Data.BusRecoveryCounter;
+    I2C_APP_Data.HkTlm.Payload.RobotProtocolVersion = I2C_APP_Data.RobotIdent.protocol_version;
+    I2C_APP_Data.HkTlm.Payload.ConfigLoadCounter    = I2C_APP_Data.ConfigLoadCounter;
+    I2C_APP_Data.HkTlm.Payload.RobotFeatures        = I2C_APP_Data.RobotFeatures;
+    I2C_APP_Data.HkTlm.Payload.CycleCounter         = I2C_APP_Data.CycleCounter;
+    I2C_APP_Data.HkTlm.Payload.CyclePeriodUs        = I2C_APP_Data.CyclePeriodUs;
+    I2C_APP_Data.HkTlm.Payload.CycleJitterMaxUs     = I2C_APP_Data.CycleJitterMaxUs;
+    I2C_APP_Data.HkTlm.Payload.EStopLatencyUs       = I2C_APP_Data.EStopLatencyUs;
+    I2C_APP_Data.HkTlm.Payload.EStopLatencyMaxUs    = I2C_APP_Data.EStopLatencyMaxUs;
+    I2C_APP_Data.HkTlm.Payload.EStopCounter         = I2C_APP_Data.EStopCounter;
+    I2C_APP_Data.HkTlm.Payload.TlmDropCounter       = I2C_APP_Data.TlmDropCounter;
+
+    /*
+    ** Startup timing...
+    */
+    I2C_APP_Data.HkTlm.Payload.StartupUs  = I2C_APP_Data.StartupUs;
+    I2C_APP_Data.HkTlm.Payload.BusProbeUs = I2C_APP_Data.BusProbeUs;
+    I2C_APP_Data.HkTlm.Payload.FirstTlmUs = I2C_APP_Data.FirstTlmUs;
+    memcpy(I2C_APP_Data.HkTlm.Payload.StartupPhaseUs, I2C_APP_Data.StartupPhaseUs,
+           sizeof(I2C_APP_Data.HkTlm.Payload.StartupPhaseUs));
+    I2C_APP_Data.HkTlm.Payload.StartupFlags = (I2C_APP_Data.FastBoot ? I2C_APP_STARTUP_FAST_BOOT : 0) |
+                                              (I2C_APP_Data.WarmStart ? I2C_APP_STARTUP_WARM : 0) |
+                                              I2C_APP_Data.DiscoverFlags;
+
+    /*
+    ** Send housekeeping telemetry packet...
+    */
+    CFE_SB_TimeStampMsg(CFE_MSG_PTR(I2C_APP_Data.HkTlm.TelemetryHeader));
+    CFE_SB_TransmitMsg(CFE_MSG_PTR(I2C_APP_Data.HkTlm.TelemetryHeader), true);
+
+    /*
+    ** Manage any pending table loads, validations, etc.
+    */
+    for (i = 0; i < I2C_APP_NUMBER_OF_TABLES; i++)
+    {
+        if (CFE_TBL_Manage(I2C_APP_Data.TblHandles[i]) == CFE_TBL_INFO_UPDATED)
+        {
+            /* a new configuration image was just loaded: put it into effect */
+            I2C_APP_LoadConfig();
+        }
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/*  Purpose:                                                                  */
+/*         One control cycle, run for every wakeup from the scheduler:        */
+/*         measure the period since the last wakeup, flush a pending          */
+/*         command, read the robot's telemetry, start the next path segment   */
+/*         if the robot is done with the last one, and publish the telemetry. */
+/*                                                                            */
+/*         The telemetry is decoded straight into a message buffer taken      */
+/*         from the software bus and handed over with that buffer, so the     */
+/*         sample is not copied again on its way to the subscribers.          */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
+int32 I2C_APP_Wakeup(const CFE_MSG_CommandHeader_t *Msg)
+{
+    OS_time_t           Now;
+    int64               PeriodUs;
+    int64               JitterUs;
+    I2C_Command_Packet  Packet;
+    CFE_SB_Buffer_t    *BufPtr;
+    I2C_APP_RobotTlm_t *TlmPtr;
+    CFE_Status_t        status = CFE_SUCCESS;
+
+    /*
+    ** The period is taken before any bus traffic, so a slow transaction in
+    ** this cycle shows up as jitter on the next one rather than hiding it.
+    */
+    OS_GetLocalTime(&Now);
+    if (I2C_APP_Data.CycleCounter > 0)
+    {
+        PeriodUs = OS_TimeGetTotalMicroseconds(OS_TimeSubtract(Now, I2C_APP_Data.LastWakeup));
+        JitterUs = PeriodUs - I2C_APP_WAKEUP_PERIOD_US;
+        if (JitterUs < 0)
+        {
+            JitterUs = -JitterUs;
+        }
+        I2C_APP_Data.CyclePeriodUs = (PeriodUs < 0 || PeriodUs > UINT32_MAX) ? UINT32_MAX : (uint32)PeriodUs;
+        if (JitterUs > I2C_APP_Data.CycleJitterMaxUs)
+        {
+            I2C_APP_Data.CycleJitterMaxUs = JitterUs > UINT32_MAX ? UINT32_MAX : (uint32)JitterUs;
+        }
+    }
+    I2C_APP_Data.LastWakeup = Now;
+    I2C_APP_Data.CycleCounter++;
+
+    if (I2C_APP_Data.ReopenHoldoff > 0)
+    {
+        I2C_APP_Data.ReopenHoldoff--;
+    }
+
+    if (I2C_APP_Data.CmdPending)
+    {
+        Packet = I2C_APP_Data.PendingCmd;
+        status = I2C_APP_SendCommand(&Packet);
+    }
+
+    /* telemetry only every Config.PollDivider cycles */
+    if ((I2C_APP_Data.CycleCounter % I2C_APP_Data.Config.PollDivider) != 0)
+    {
+        return status;
+    }
+
+    /* with the bus down there is nothing to read; the next cycle retries */
+    if (status != CFE_SUCCESS)
+    {
+        return status;
+    }
+
+    BufPtr = CFE_SB_AllocateMessageBuffer(sizeof(I2C_APP_RobotTlm_t));
+    if (BufPtr == NULL)
+    {
+        I2C_APP_Data.TlmDropCounter++;
+        return CFE_SB_BUF_ALOC_ERR;
+    }
+    TlmPtr = (I2C_APP_RobotTlm_t *)BufPtr;
+    CFE_MSG_Init(CFE_MSG_PTR(TlmPtr->TelemetryHeader), CFE_SB_ValueToMsgId(I2C_APP_ROBOT_TLM_MID),
+                 sizeof(*TlmPtr));
+
+    status = I2C_APP_ReadTelemetry(&TlmPtr->Payload.Telem);
+    if (status != CFE_SUCCESS)
+    {
+        CFE_SB_ReleaseMessageBuffer(BufPtr);
+        return status;
+    }
+
+    I2C_APP_AdvancePath(&TlmPtr->Payload.Telem);
+    I2C_APP_UpdateOdometry(&TlmPtr->Payload.Telem);
+
+    TlmPtr->Payload.CycleCounter = I2C_APP_Data.CycleCounter;
+    TlmPtr->Payload.PathSegment  = I2C_APP_Data.PathNext;
+    TlmPtr->Payload.PathLength   = I2C_APP_Data.PathLength;
+    TlmPtr->Payload.OdomLeft     = I2C_APP_Data.OdomLeft;
+    TlmPtr->Payload.OdomRight    = I2C_APP_Data.OdomRight;
+    CFE_SB_TimeStampMsg(CFE_MSG_PTR(TlmPtr->TelemetryHeader));
+
+    /* the bus owns the buffer once it is sent; a refused one is still ours */
+    if (CFE_SB_TransmitBuffer(BufPtr, true) != CFE_SUCCESS)
+    {
+        CFE_SB_ReleaseMessageBuffer(BufPtr);
+        I2C_APP_Data.TlmDropCounter++;
+    }
+    else if (I2C_APP_Data.FirstTlmUs == 0)
+    {
+        /* as of the wakeup it was read in, and never 0 once it is set */
+        I2C_APP_Data.FirstTlmUs = I2C_APP_ElapsedUs(I2C_APP_Data.StartTime, Now);
+        if (I2C_APP_Data.FirstTlmUs == 0)
+        {
+            I2C_APP_Data.FirstTlmUs = 1;
+        }
+        CFE_EVS_SendEvent(I2C_APP_STARTUP_INF_EID, CFE_EVS_EventType_INFORMATION,
+                          "I2C App: first robot telemetry %lu us after startup",
+                          (unsigned long)I2C_APP_Data.FirstTlmUs);
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* I2C NOOP commands                                                       */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+int32 I2C_APP_Noop(const I2C_APP_NoopCmd_t *Msg)
+{
+    I2C_APP_Data.CmdCounter++;
+
+    CFE_EVS_SendEvent(I2C_APP_COMMANDNOP_INF_EID, CFE_EVS_EventType_INFORMATION, "I2C: NOOP command %s",
+                      I2C_APP_VERSION);
 
-        default:
-            CFE_EVS_SendEvent(I2C_APP_INVALID_MSGID_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "I2C: invalid command packet,MID = 0x%x", (unsigned int)CFE_SB_MsgIdToValue(MsgId));
-            break;
-    }
+    return CFE_SUCCESS;
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
-/* I2C ground commands                                                     */
+/* I2C motion commands                                                        */
+/*                                                                            */
+/*  Each accepted command is one write of the robot's command block.  A       */
+/*  write lost to a bus fault is counted as a bus error and retried by the    */
+/*  next control cycle, so the command itself still counts as accepted.      */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-void I2C_APP_ProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr)
+int32 I2C_APP_SetWheelSpeeds(const I2C_APP_SetWheelSpeedsCmd_t *Msg)
 {
-    CFE_MSG_FcnCode_t CommandCode = 0;
+    I2C_Command_Packet Packet = I2C_APP_Data.RobotCmd;
+    int16              Left   = Msg->Payload.LeftSpeed;
+    int16              Right  = Msg->Payload.RightSpeed;
 
-    CFE_MSG_GetFcnCode(&SBBufPtr->Msg, &CommandCode);
+    int16              Max    = (int16)I2C_APP_Data.Config.MaxWheelSpeed;
 
-    /*
-    ** Process "known" I2C app ground commands
-    */
-    switch (CommandCode)
+    if (Left < -Max || Left > Max || Right < -Max || Right > Max)
     {
-        case I2C_APP_NOOP_CC:
-            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_NoopCmd_t)))
-            {
-                I2C_APP_Noop((I2C_APP_NoopCmd_t *)SBBufPtr);
-            }
-
-            break;
+        I2C_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(I2C_APP_MOTION_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "I2C: wheel speeds %d, %d outside +/-%d", (int)Left, (int)Right, (int)Max);
+        return CFE_STATUS_RANGE_ERROR;
+    }
 
-        case I2C_APP_RESET_COUNTERS_CC:
-            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_ResetCountersCmd_t)))
-            {
-                I2C_APP_ResetCounters((I2C_APP_ResetCountersCmd_t *)SBBufPtr);
-            }
+    I2C_APP_Data.CmdCounter++;
+    I2C_APP_Data.PathActive = false;
+    CFE_EVS_SendEvent(I2C_APP_MOTION_DBG_EID, CFE_EVS_EventType_DEBUG, "I2C: wheel speeds %d, %d", (int)Left,
+                      (int)Right);
 
-            break;
+    Packet.left_speed  = Left;
+    Packet.right_speed = Right;
 
-        case I2C_APP_PROCESS_CC:
-            if (I2C_APP_VerifyCmdLength(&SBBufPtr->Msg, sizeof(I2C_APP_ProcessCmd_t)))
-            {
-                I2C_APP_Process((I2C_APP_ProcessCmd_t *)SBBufPtr);
-            }
+    return I2C_APP_SendCommand(&Packet);
+}
 
-            break;
+int32 I2C_APP_DriveDistance(const I2C_APP_DriveDistanceCmd_t *Msg)
+{
+    int16 Counts;
 
-        /* default case already found during FC vs length test */
-        default:
-            CFE_EVS_SendEvent(I2C_APP_COMMAND_ERR_EID, CFE_EVS_EventType_ERROR,
-                              "Invalid ground command code: CC = %d", CommandCode);
-            break;
+    if (!I2C_APP_DriveCounts(Msg->Payload.DistanceMm, &Counts))
+    {
+        I2C_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(I2C_APP_MOTION_ERR_EID, CFE_EVS_EventType_ERROR, "I2C: drive of %d mm is too long",
+                          (int)Msg->Payload.DistanceMm);
+        return CFE_STATUS_RANGE_ERROR;
     }
+
+    I2C_APP_Data.CmdCounter++;
+    I2C_APP_Data.PathActive = false;
+    CFE_EVS_SendEvent(I2C_APP_MOTION_DBG_EID, CFE_EVS_EventType_DEBUG, "I2C: drive %d mm, %d counts",
+                      (int)Msg->Payload.DistanceMm, (int)Counts);
+
+    return I2C_APP_Move(Counts, Counts);
 }
 
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-/*                                                                            */
-/*  Purpose:                                                                  */
-/*         This function is triggered in response to a task telemetry request */
-/*         from the housekeeping task. This function will gather the Apps     */
-/*         telemetry, packetize it and send it to the housekeeping task via   */
-/*         the software bus                                                   */
-/* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
-int32 I2C_APP_ReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg)
+int32 I2C_APP_Spin(const I2C_APP_SpinCmd_t *Msg)
 {
-    int i;
+    int16 Counts;
 
-    /*
-    ** Get command execution counters...
-    */
-    I2C_APP_Data.HkTlm.Payload.CommandErrorCounter = I2C_APP_Data.ErrCounter;
-    I2C_APP_Data.HkTlm.Payload.CommandCounter      = I2C_APP_Data.CmdCounter;
+    if (!I2C_APP_SpinCounts(Msg->Payload.AngleDeg, &Counts))
+    {
+        I2C_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(I2C_APP_MOTION_ERR_EID, CFE_EVS_EventType_ERROR, "I2C: spin of %d deg is too long",
+                          (int)Msg->Payload.AngleDeg);
+        return CFE_STATUS_RANGE_ERROR;
+    }
 
-    /*
-    ** Send housekeeping telemetry packet...
-    */
-    CFE_SB_TimeStampMsg(CFE_MSG_PTR(I2C_APP_Data.HkTlm.TelemetryHeader));
-    CFE_SB_TransmitMsg(CFE_MSG_PTR(I2C_APP_Data.HkTlm.TelemetryHeader), true);
+    I2C_APP_Data.CmdCounter++;
+    I2C_APP_Data.PathActive = false;
+    CFE_EVS_SendEvent(I2C_APP_MOTION_DBG_EID, CFE_EVS_EventType_DEBUG, "I2C: spin %d deg, %d counts",
+                      (int)Msg->Payload.AngleDeg, (int)Counts);
 
-    /*
-    ** Manage any pending table loads, validations, etc.
-    */
-    for (i = 0; i < I2C_APP_NUMBER_OF_TABLES; i++)
+    return I2C_APP_Move((int16)-Counts, Counts);
+}
+
+int32 I2C_APP_SetLeds(const I2C_APP_SetLedsCmd_t *Msg)
+{
+    I2C_Command_Packet Packet = I2C_APP_Data.RobotCmd;
+
+    if (Msg->Payload.Red > 1 || Msg->Payload.Green > 1 || Msg->Payload.Yellow > 1)
     {
-        CFE_TBL_Manage(I2C_APP_Data.TblHandles[i]);
+        I2C_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(I2C_APP_MOTION_ERR_EID, CFE_EVS_EventType_ERROR, "I2C: LED states %u %u %u must be 0 or 1",
+                          (unsigned int)Msg->Payload.Red, (unsigned int)Msg->Payload.Green,
+                          (unsigned int)Msg->Payload.Yellow);
+        return CFE_STATUS_RANGE_ERROR;
     }
 
-    return CFE_SUCCESS;
+    I2C_APP_Data.CmdCounter++;
+    CFE_EVS_SendEvent(I2C_APP_MOTION_DBG_EID, CFE_EVS_EventType_DEBUG, "I2C: LEDs %u %u %u",
+                      (unsigned int)Msg->Payload.Red, (unsigned int)Msg->Payload.Green,
+                      (unsigned int)Msg->Payload.Yellow);
+
+    Packet.r_led = Msg->Payload.Red != 0;
+    Packet.g_led = Msg->Payload.Green != 0;
+    Packet.y_led = Msg->Payload.Yellow != 0;
+
+    return I2C_APP_SendCommand(&Packet);
 }
 
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-/*                                                                            */
-/* I2C NOOP commands                                                       */
-/*                                                                            */
-/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
-int32 I2C_APP_Noop(const I2C_APP_NoopCmd_t *Msg)
+int32 I2C_APP_Stop(const I2C_APP_StopCmd_t *Msg)
 {
     I2C_APP_Data.CmdCounter++;
+    CFE_EVS_SendEvent(I2C_APP_MOTION_DBG_EID, CFE_EVS_EventType_DEBUG, "I2C: STOP");
 
-    CFE_EVS_SendEvent(I2C_APP_COMMANDNOP_INF_EID, CFE_EVS_EventType_INFORMATION, "I2C: NOOP command %s",
-                      I2C_APP_VERSION);
+    return I2C_APP_StopMotion();
+}
 
-        I2C_Command_Packet packet = {0};
-        packet.right_speed = 0xA0;
-        packet.left_speed = 0xA0;
+int32 I2C_APP_RunPath(const I2C_APP_RunPathCmd_t *Msg)
+{
+    const I2C_APP_PathSegment_t *Seg;
+    I2C_APP_PathStep_t           Steps[I2C_APP_MAX_PATH_SEGMENTS];
+    uint16                       Num = Msg->Payload.NumSegments;
+    int16                        Counts;
+    bool                         Ok;
+    uint16                       i;
 
-        int res = I2C_APP_Send(I2C_APP_Data.i2c_fd, &packet);
-        if (res == -1) {
-            printf("I2C Error");
-            exit(1);
+    /*
+    ** Every segment is converted before any of them runs, so a path with a
+    ** bad segment is refused whole rather than stopping part way.
+    */
+    for (i = 0; i < Num; ++i)
+    {
+        Seg = &Msg->Payload.Segments[i];
+        if (Seg->Kind == I2C_APP_SEGMENT_DRIVE)
+        {
+            Ok                 = I2C_APP_DriveCounts(Seg->Value, &Counts);
+            Steps[i].LeftDist  = Counts;
+            Steps[i].RightDist = Counts;
+        }
+        else if (Seg->Kind == I2C_APP_SEGMENT_SPIN)
+        {
+            Ok                 = I2C_APP_SpinCounts(Seg->Value, &Counts);
+            Steps[i].LeftDist  = (int16)-Counts;
+            Steps[i].RightDist = Counts;
+        }
+        else
+        {
+            Ok = false;
         }
 
-        return CFE_SUCCESS;
-                  
-    return CFE_SUCCESS;
+        if (!Ok)
+        {
+            I2C_APP_Data.ErrCounter++;
+            CFE_EVS_SendEvent(I2C_APP_MOTION_ERR_EID, CFE_EVS_EventType_ERROR,
+                              "I2C: path segment %u (kind %u, value %d) is invalid", (unsigned int)i,
+                              (unsigned int)Seg->Kind, (int)Seg->Value);
+            return CFE_STATUS_RANGE_ERROR;
+        }
+    }
+
+    I2C_APP_Data.CmdCounter++;
+    CFE_EVS_SendEvent(I2C_APP_MOTION_DBG_EID, CFE_EVS_EventType_DEBUG, "I2C: path of %u segments", (unsigned int)Num);
+
+    memcpy(I2C_APP_Data.Path, Steps, Num * sizeof(Steps[0]));
+    I2C_APP_Data.PathLength = Num;
+    I2C_APP_Data.PathNext   = 1;
+    I2C_APP_Data.PathActive = true;
+
+    return I2C_APP_Move(Steps[0].LeftDist, Steps[0].RightDist);
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
@@ -395,6 +1698,16 @@ int32 I2C_APP_ResetCounters(const I2C_APP_ResetCountersCmd_t *Msg)
 {
     I2C_APP_Data.CmdCounter = 0;
     I2C_APP_Data.ErrCounter = 0;
+    I2C_APP_Data.BusErrCounter      = 0;
+    I2C_APP_Data.BusRecoveryCounter = 0;
+    I2C_APP_Data.CycleCounter       = 0;
+    I2C_APP_Data.CyclePeriodUs      = 0;
+    I2C_APP_Data.CycleJitterMaxUs   = 0;
+    I2C_APP_Data.EStopCounter       = 0;
+    I2C_APP_Data.TlmDropCounter     = 0;
+    I2C_APP_Data.EStopLatencyUs     = 0;
+    I2C_APP_Data.EStopLatencyMaxUs  = 0;
+    I2C_APP_Data.ConfigLoadCounter  = 0;
 
     CFE_EVS_SendEvent(I2C_APP_COMMANDRST_INF_EID, CFE_EVS_EventType_INFORMATION, "I2C: RESET command");
 
@@ -404,39 +1717,34 @@ int32 I2C_APP_ResetCounters(const I2C_APP_ResetCountersCmd_t *Msg)
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
 /*                                                                            */
 /*  Purpose:                                                                  */
-/*         This function Process Ground Station Command                       */
+/*         Diagnostics: write the configuration in effect, and the CRC of     */
+/*         the table image it came from, to the system log                    */
 /*                                                                            */
 /* * * * * * * * * * * * * * * * * * * * * * * *  * * * * * * *  * *  * * * * */
-int32 I2C_APP_Process(const I2C_APP_ProcessCmd_t *Msg)
+int32 I2C_APP_ReportConfig(const I2C_APP_ReportConfigCmd_t *Msg)
 {
-    int32               status;
-    I2C_APP_Table_t *TblPtr;
-    const char *        TableName = "I2C_APP.I2cAppTable";
-
-    /* I2c Use of Table */
+    const I2C_APP_Table_t *Config    = &I2C_APP_Data.Config;
+    const char            *TableName = "I2C_APP.I2cAppTable";
+    uint16                 i;
 
-    status = CFE_TBL_GetAddress((void *)&TblPtr, I2C_APP_Data.TblHandles[0]);
+    I2C_APP_Data.CmdCounter++;
 
-    if (status < CFE_SUCCESS)
+    CFE_ES_WriteToSysLog("I2C App: Config: %u device(s), using bus %d at 0x%02X, poll every %u cycles, "
+                         "features 0x%04X, reopen holdoff %u cycles, %u loads\n",
+                         (unsigned int)Config->NumDevices, I2C_APP_Data.BusNum, (unsigned int)I2C_APP_Data.Address,
+                         (unsigned int)Config->PollDivider, (unsigned int)Config->TransferFeatures,
+                         (unsigned int)Config->ReopenHoldoffCycles, (unsigned int)I2C_APP_Data.ConfigLoadCounter);
+    for (i = 0; i < Config->NumDevices; i++)
     {
-        CFE_ES_WriteToSysLog("I2C App: Fail to get table address: 0x%08lx", (unsigned long)status);
-        return status;
+        CFE_ES_WriteToSysLog("I2C App: Config: device %u on bus %u at 0x%02X\n", (unsigned int)i,
+                             (unsigned int)Config->Devices[i].BusNum, (unsigned int)Config->Devices[i].Address);
     }
-
-    CFE_ES_WriteToSysLog("I2C App: Table Value 1: %d  Value 2: %d", TblPtr->Int1, TblPtr->Int2);
+    CFE_ES_WriteToSysLog("I2C App: Config: %u counts/m, wheel base %u mm, max wheel speed %u\n",
+                         (unsigned int)Config->CountsPerM, (unsigned int)Config->WheelBaseMm,
+                         (unsigned int)Config->MaxWheelSpeed);
 
     I2C_APP_GetCrc(TableName);
 
-    status = CFE_TBL_ReleaseAddress(I2C_APP_Data.TblHandles[0]);
-    if (status != CFE_SUCCESS)
-    {
-        CFE_ES_WriteToSysLog("I2C App: Fail to release table address: 0x%08lx", (unsigned long)status);
-        return status;
-    }
-
-    /* Invoke a function */
-    //I2C_LIB_Function();
-
     return CFE_SUCCESS;
 }
 
@@ -475,6 +1783,37 @@ bool I2C_APP_VerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength)
     return result;
 }
 
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+/*                                                                            */
+/* Verify a path command: the fixed part, then exactly NumSegments segments,  */
+/* with NumSegments between 1 and I2C_APP_MAX_PATH_SEGMENTS                   */
+/*                                                                            */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * **/
+bool I2C_APP_VerifyPathCmdLength(CFE_MSG_Message_t *MsgPtr)
+{
+    const I2C_APP_RunPathCmd_t *Cmd          = (const I2C_APP_RunPathCmd_t *)MsgPtr;
+    size_t                      FixedLength  = offsetof(I2C_APP_RunPathCmd_t, Payload.Segments);
+    size_t                      ActualLength = 0;
+    uint16                      Num;
+
+    CFE_MSG_GetSize(MsgPtr, &ActualLength);
+    if (ActualLength < FixedLength)
+    {
+        return I2C_APP_VerifyCmdLength(MsgPtr, FixedLength);
+    }
+
+    Num = Cmd->Payload.NumSegments;
+    if (Num == 0 || Num > I2C_APP_MAX_PATH_SEGMENTS)
+    {
+        I2C_APP_Data.ErrCounter++;
+        CFE_EVS_SendEvent(I2C_APP_MOTION_ERR_EID, CFE_EVS_EventType_ERROR, "I2C: path of %u segments, expected 1 to %u",
+                          (unsigned int)Num, (unsigned int)I2C_APP_MAX_PATH_SEGMENTS);
+        return false;
+    }
+
+    return I2C_APP_VerifyCmdLength(MsgPtr, FixedLength + Num * sizeof(I2C_APP_PathSegment_t));
+}
+
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 /*                                                                 */
 /* Verify contents of First Table buffer contents                  */
@@ -482,19 +1821,307 @@ bool I2C_APP_VerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength)
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
 int32 I2C_APP_TblValidationFunc(void *TblData)
 {
-    int32               ReturnCode = CFE_SUCCESS;
-    I2C_APP_Table_t *TblDataPtr = (I2C_APP_Table_t *)TblData;
+    const I2C_APP_Table_t *TblDataPtr = (const I2C_APP_Table_t *)TblData;
+    const char            *Field      = NULL;
+    uint16                 i;
+
+    /*
+    ** I2c Table Validation: every field the app would act on must be usable
+    */
+    if (TblDataPtr->NumDevices == 0 || TblDataPtr->NumDevices > I2C_APP_TBL_MAX_DEVICES)
+    {
+        Field = "NumDevices";
+    }
+    else if (TblDataPtr->Discover > 1)
+    {
+        Field = "Discover";
+    }
+    for (i = 0; Field == NULL && i < TblDataPtr->NumDevices; i++)
+    {
+        if (TblDataPtr->Devices[i].Address < I2C_APP_TBL_MIN_ADDRESS ||
+            TblDataPtr->Devices[i].Address > I2C_APP_TBL_MAX_ADDRESS)
+        {
+            Field = "Devices.Address";
+        }
+    }
+    if (Field != NULL)
+    {
+        /* already found */
+    }
+    else if (TblDataPtr->PollDivider == 0 || TblDataPtr->PollDivider > I2C_APP_TBL_MAX_POLL_DIVIDER)
+    {
+        Field = "PollDivider";
+    }
+    else if ((TblDataPtr->TransferFeatures & ~I2C_APP_SUPPORTED_FEATURES) != 0)
+    {
+        Field = "TransferFeatures";
+    }
+    else if (TblDataPtr->ReopenHoldoffCycles > I2C_APP_TBL_MAX_REOPEN_CYCLES)
+    {
+        Field = "ReopenHoldoffCycles";
+    }
+    else if (TblDataPtr->CountsPerM < I2C_APP_TBL_MIN_COUNTS_PER_M ||
+             TblDataPtr->CountsPerM > I2C_APP_TBL_MAX_COUNTS_PER_M)
+    {
+        Field = "CountsPerM";
+    }
+    else if (TblDataPtr->WheelBaseMm < I2C_APP_TBL_MIN_WHEEL_BASE_MM ||
+             TblDataPtr->WheelBaseMm > I2C_APP_TBL_MAX_WHEEL_BASE_MM)
+    {
+        Field = "WheelBaseMm";
+    }
+    else if (TblDataPtr->MaxWheelSpeed == 0 || TblDataPtr->MaxWheelSpeed > I2C_APP_MAX_WHEEL_SPEED)
+    {
+        Field = "MaxWheelSpeed";
+    }
+
+    if (Field != NULL)
+    {
+        CFE_EVS_SendEvent(I2C_APP_CONFIG_ERR_EID, CFE_EVS_EventType_ERROR, "I2C: config table rejected, bad %s",
+                          Field);
+        return I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE;
+    }
+
+    return CFE_SUCCESS;
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Take the configuration from the table image                     */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void I2C_APP_LoadConfig(void)
+{
+    I2C_APP_Table_t *TblPtr = NULL;
+    int32            status;
+
+    status = CFE_TBL_GetAddress((void *)&TblPtr, I2C_APP_Data.TblHandles[0]);
+    if (status < CFE_SUCCESS)
+    {
+        CFE_EVS_SendEvent(I2C_APP_CONFIG_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "I2C: config table not available, RC = 0x%08lX", (unsigned long)status);
+        return;
+    }
+
+    /*
+    ** cFE validated the image on load; checking again here is cheap and
+    ** keeps the cycle from ever dividing by a zero poll rate or device count.
+    */
+    if (I2C_APP_TblValidationFunc(TblPtr) == CFE_SUCCESS)
+    {
+        I2C_APP_ApplyConfig(TblPtr);
+    }
+
+    CFE_TBL_ReleaseAddress(I2C_APP_Data.TblHandles[0]);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Put a validated configuration into effect                       */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void I2C_APP_ApplyConfig(const I2C_APP_Table_t *Table)
+{
+    I2C_APP_Table_t *Config = &I2C_APP_Data.Config;
+    I2C_APP_Table_t  Before = I2C_APP_Data.Config;
+    bool             Moved;
+
+    /* the robots found at startup go ahead of the table's own devices */
+    *Config = *Table;
+    I2C_APP_MergeDevices(Config);
+    I2C_APP_Data.ConfigLoadCounter++;
+
+    /*
+    ** A table that asks for discovery once the bus is up, as after a fast
+    ** boot, which starts on the built-in configuration, or on a reload,
+    ** gets the scan the bus start did not do.
+    */
+    if (Config->Discover && I2C_APP_Data.BusStarted && I2C_APP_Data.DiscoverFlags == 0)
+    {
+        I2C_APP_Discover();
+    }
+
+    Moved = Config->NumDevices != Before.NumDevices ||
+            memcmp(Config->Devices, Before.Devices, sizeof(Config->Devices)) != 0;
+
+    if (Moved)
+    {
+        /*
+        ** The robot may be somewhere else now: drop the connection, and let
+        ** the next transaction open the new first device.  Its identity is
+        ** read before that, so the transfers match the robot found there.
+        ** During startup the bus is not open yet, and I2C_APP_StartBus
+        ** opens the new device itself, after the settle time.
+        */
+        if (I2C_APP_Data.i2c_fd >= 0)
+        {
+            close(I2C_APP_Data.i2c_fd);
+            I2C_APP_Data.i2c_fd = -1;
+        }
+        I2C_APP_Data.DeviceIndex   = 0;
+        I2C_APP_Data.ReopenHoldoff = 0;
+        if (I2C_APP_Data.BusStarted && I2C_APP_BusConnect() == CFE_SUCCESS)
+        {
+            I2C_APP_BusResult(I2C_APP_Identify(I2C_APP_Data.i2c_fd), "read");
+        }
+        else if (!I2C_APP_Data.BusStarted && I2C_APP_Data.WarmStart &&
+                 I2C_APP_Data.CdsState.DeviceIndex < Config->NumDevices)
+        {
+            /* the index the last run saved is into the table's list */
+            I2C_APP_Data.DeviceIndex = I2C_APP_Data.CdsState.DeviceIndex;
+        }
+    }
+    if (I2C_APP_Data.RobotIdent.magic == ROMI_IDENT_MAGIC)
+    {
+        I2C_APP_Data.RobotFeatures =
+            I2C_APP_Data.RobotIdent.features & I2C_APP_SUPPORTED_FEATURES & Config->TransferFeatures;
+    }
+
+    CFE_EVS_SendEvent(I2C_APP_CONFIG_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "I2C: config applied, robot at bus %u address 0x%02X, telemetry every %u cycles",
+                      (unsigned int)Config->Devices[I2C_APP_Data.DeviceIndex].BusNum,
+                      (unsigned int)Config->Devices[I2C_APP_Data.DeviceIndex].Address,
+                      (unsigned int)Config->PollDivider);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Register the CDS block and resume from it if it holds a state   */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void I2C_APP_RestoreState(void)
+{
+    const I2C_APP_CdsState_t *State = &I2C_APP_Data.CdsState;
+    int32                     status;
+
+    memset(&I2C_APP_Data.CdsState, 0, sizeof(I2C_APP_Data.CdsState));
+
+    status = CFE_ES_RegisterCDS(&I2C_APP_Data.CdsHandle, sizeof(I2C_APP_Data.CdsState), I2C_APP_CDS_NAME);
+    if (status != CFE_SUCCESS && status != CFE_ES_CDS_ALREADY_EXISTS)
+    {
+        CFE_EVS_SendEvent(I2C_APP_CDS_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "I2C: no critical data store, state will not survive a restart, RC = 0x%08lX",
+                          (unsigned long)status);
+        return;
+    }
+    I2C_APP_Data.CdsEnabled = true;
+
+    /* a new block: this is a cold start, and the first save fills it */
+    if (status == CFE_SUCCESS)
+    {
+        return;
+    }
+
+    status = CFE_ES_RestoreFromCDS(&I2C_APP_Data.CdsState, I2C_APP_Data.CdsHandle);
+    if (status != CFE_SUCCESS || State->Signature != I2C_APP_CDS_SIGNATURE ||
+        State->PathLength > I2C_APP_MAX_PATH_SEGMENTS || State->PathNext > State->PathLength)
+    {
+        CFE_EVS_SendEvent(I2C_APP_CDS_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "I2C: saved state unusable, starting cold, RC = 0x%08lX", (unsigned long)status);
+        memset(&I2C_APP_Data.CdsState, 0, sizeof(I2C_APP_Data.CdsState));
+        return;
+    }
+
+    I2C_APP_Data.RobotCmd   = State->RobotCmd;
+    I2C_APP_Data.PendingCmd = State->PendingCmd;
+    I2C_APP_Data.CmdPending = State->CmdPending;
+    I2C_APP_Data.PathActive = State->PathActive;
+    I2C_APP_Data.PathLength = State->PathLength;
+    I2C_APP_Data.PathNext   = State->PathNext;
+    memcpy(I2C_APP_Data.Path, State->Path, sizeof(I2C_APP_Data.Path));
+
+    I2C_APP_Data.OdomLeft     = State->OdomLeft;
+    I2C_APP_Data.OdomRight    = State->OdomRight;
+    I2C_APP_Data.LastLeftEnc  = State->LastLeftEnc;
+    I2C_APP_Data.LastRightEnc = State->LastRightEnc;
+    I2C_APP_Data.OdomValid    = State->OdomValid;
 
     /*
-    ** I2c Table Validation
+    ** Where the robot was found.  This runs before the table is loaded, so
+    ** the index is checked against the built-in device list here, and
+    ** I2C_APP_ApplyConfig takes it up again if the table has another.
     */
-    if (TblDataPtr->Int1 > I2C_APP_TBL_ELEMENT_1_MAX)
+    if (State->DeviceIndex < I2C_APP_Data.Config.NumDevices)
+    {
+        I2C_APP_Data.DeviceIndex = State->DeviceIndex;
+    }
+    I2C_APP_Data.RobotIdent = State->RobotIdent;
+    if (State->RobotIdent.magic == ROMI_IDENT_MAGIC)
+    {
+        I2C_APP_Data.RobotFeatures =
+            State->RobotIdent.features & I2C_APP_SUPPORTED_FEATURES & I2C_APP_Data.Config.TransferFeatures;
+    }
+
+    I2C_APP_Data.WarmStart = true;
+    CFE_EVS_SendEvent(I2C_APP_CDS_INF_EID, CFE_EVS_EventType_INFORMATION,
+                      "I2C: warm restart, path step %u of %u%s, odometry %ld/%ld counts",
+                      (unsigned int)State->PathNext, (unsigned int)State->PathLength,
+                      State->PathActive ? " running" : "", (long)State->OdomLeft, (long)State->OdomRight);
+}
+
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*                                                                 */
+/* Save the state a restart resumes from, if it changed            */
+/*                                                                 */
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+void I2C_APP_SaveState(void)
+{
+    I2C_APP_CdsState_t State;
+    I2C_APP_CdsState_t Other;
+    int32              status;
+
+    if (!I2C_APP_Data.CdsEnabled)
+    {
+        return;
+    }
+
+    /* zeroed first, so the padding compares equal too */
+    memset(&State, 0, sizeof(State));
+    State.Signature  = I2C_APP_CDS_SIGNATURE;
+    State.RobotCmd   = I2C_APP_Data.RobotCmd;
+    State.PendingCmd = I2C_APP_Data.PendingCmd;
+    State.CmdPending = I2C_APP_Data.CmdPending;
+    State.PathActive = I2C_APP_Data.PathActive;
+    State.PathLength = I2C_APP_Data.PathLength;
+    State.PathNext   = I2C_APP_Data.PathNext;
+    memcpy(State.Path, I2C_APP_Data.Path, sizeof(State.Path));
+    State.OdomLeft     = I2C_APP_Data.OdomLeft;
+    State.OdomRight    = I2C_APP_Data.OdomRight;
+    State.LastLeftEnc  = I2C_APP_Data.LastLeftEnc;
+    State.LastRightEnc = I2C_APP_Data.LastRightEnc;
+    State.OdomValid    = I2C_APP_Data.OdomValid;
+    State.DeviceIndex  = I2C_APP_Data.DeviceIndex;
+    State.RobotIdent   = I2C_APP_Data.RobotIdent;
+
+    if (memcmp(&State, &I2C_APP_Data.CdsState, sizeof(State)) == 0)
+    {
+        return;
+    }
+
+    /* a change in the odometry alone waits for its turn */
+    Other              = State;
+    Other.OdomLeft     = I2C_APP_Data.CdsState.OdomLeft;
+    Other.OdomRight    = I2C_APP_Data.CdsState.OdomRight;
+    Other.LastLeftEnc  = I2C_APP_Data.CdsState.LastLeftEnc;
+    Other.LastRightEnc = I2C_APP_Data.CdsState.LastRightEnc;
+    Other.OdomValid    = I2C_APP_Data.CdsState.OdomValid;
+    if (memcmp(&Other, &I2C_APP_Data.CdsState, sizeof(Other)) == 0 &&
+        I2C_APP_Data.CycleCounter - I2C_APP_Data.CdsSaveCycle < I2C_APP_CDS_ODOM_SAVE_CYCLES)
     {
-        /* First element is out of range, return an appropriate error code */
-        ReturnCode = I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE;
+        return;
     }
 
-    return ReturnCode;
+    status = CFE_ES_CopyToCDS(I2C_APP_Data.CdsHandle, &State);
+    if (status != CFE_SUCCESS)
+    {
+        I2C_APP_Data.CdsEnabled = false;
+        CFE_EVS_SendEvent(I2C_APP_CDS_ERR_EID, CFE_EVS_EventType_ERROR,
+                          "I2C: critical data store write failed, state no longer saved, RC = 0x%08lX",
+                          (unsigned long)status);
+        return;
+    }
+    I2C_APP_Data.CdsState     = State;
+    I2C_APP_Data.CdsSaveCycle = I2C_APP_Data.CycleCounter;
 }
 
 /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
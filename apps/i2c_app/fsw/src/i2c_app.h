@@ -37,7 +37,12 @@
 */
 #include "i2c_app_perfids.h"
 #include "i2c_app_msgids.h"
+
+/* Register map and wire structs shared with the robot firmware */
+#include "romi_protocol.h"
+
 #include "i2c_app_msg.h"
+#include "i2c_app_table.h"
 
 
 #include <fcntl.h>
@@ -46,25 +51,156 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <sys/ioctl.h>
+#include <linux/i2c.h>
 
-#define I2C_ADDRESS 0x14
+#define I2C_ADDRESS ROMI_I2C_ADDRESS
+#define I2C_APP_BUS_NUM 2 /* Linux I2C bus the robot is attached to (/dev/i2c-N), until the table loads */
 #define I2C_APP_PIPE_DEPTH 32 /* Depth of the Command Pipe for Application */
+#define I2C_APP_ESTOP_PIPE_DEPTH 4 /* Depth of the emergency stop pipe */
 
 #define I2C_APP_NUMBER_OF_TABLES 1 /* Number of Table(s) */
 
 /* Define filenames of default data images for tables */
-#define I2C_APP_TABLE_FILE "/cf/sample_app_tbl.tbl"
+#define I2C_APP_TABLE_FILE "/cf/i2c_app_tbl.tbl"
 
 #define I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE -1
 
-#define I2C_APP_TBL_ELEMENT_1_MAX 10
+/* Limits the configuration table is validated against */
+#define I2C_APP_TBL_MIN_ADDRESS       0x08 /* 0x00-0x07 and 0x78-0x7F are reserved */
+#define I2C_APP_TBL_MAX_ADDRESS       0x77
+#define I2C_APP_TBL_MAX_POLL_DIVIDER  I2C_APP_WAKEUP_RATE_HZ /* telemetry at least once a second */
+#define I2C_APP_TBL_MAX_REOPEN_CYCLES (60 * I2C_APP_WAKEUP_RATE_HZ)
+#define I2C_APP_TBL_MIN_COUNTS_PER_M  1000
+#define I2C_APP_TBL_MAX_COUNTS_PER_M  20000
+#define I2C_APP_TBL_MIN_WHEEL_BASE_MM 50
+#define I2C_APP_TBL_MAX_WHEEL_BASE_MM 500
+
+#define I2C_PACKET_SIZE       ROMI_DATA_SIZE
+#define I2C_CMD_PACKET_SIZE   ROMI_CMD_SIZE
+#define I2C_TELEM_PACKET_SIZE ROMI_TELEM_SIZE
+#define I2C_TELEM_OFFSET      ROMI_TELEM_OFFSET
+
+/*
+** Romi geometry for the motion commands: 1440 encoder counts per wheel
+** revolution on 70 mm wheels, 141 mm between the wheels.  These are the
+** defaults until the configuration table loads.
+*/
+#define I2C_APP_COUNTS_PER_M    6548
+#define I2C_APP_WHEEL_BASE_MM   141
+#define I2C_APP_MAX_WHEEL_SPEED 300 /* Motor driver full scale */
+
+/* Nominal time between control cycles, the reference for the jitter in HK */
+#define I2C_APP_WAKEUP_PERIOD_US (1000000 / I2C_APP_WAKEUP_RATE_HZ)
+
+/* ROMI_FEATURE_* transfer strategies this app knows how to use */
+#define I2C_APP_SUPPORTED_FEATURES ROMI_FEATURE_COMBINED_XFER
+
+/*
+** Startup.  A serial start waits I2C_APP_SETTLE_MS after opening the bus
+** before it reads the robot.  In fast boot a child task opens the bus
+** while the app sets up its pipes and table, and retries the identity
+** read every I2C_APP_PROBE_RETRY_MS until the robot answers, for at most
+** as long.  The app falls back to a serial start if the child task
+** cannot be created.
+*/
+#ifndef I2C_APP_FAST_BOOT
+#define I2C_APP_FAST_BOOT true
+#endif
+#define I2C_APP_SETTLE_MS            100
+#define I2C_APP_PROBE_RETRY_MS       10
+#define I2C_APP_BUS_START_TASK_NAME  "I2C_APP_BUS_START"
+#define I2C_APP_BUS_START_STACK_SIZE 16384
+#define I2C_APP_BUS_START_PRIORITY   55 /* the app's own, from cpu1_cfe_es_startup.scr */
 
-#define I2C_PACKET_SIZE 36
-#define I2C_CMD_PACKET_SIZE 11
+/*
+** Device discovery, off unless the table turns it on.  At startup the app
+** looks for robots on the buses of the configured devices, and no others,
+** sending each address in the valid range that answers a one-byte read
+** the identity read; the ones that answer with an identity block are
+** tried ahead of the configured devices.  The list is kept in
+** I2C_APP_DEVICE_CACHE_FILE, and a later start only probes the devices in
+** it, scanning the buses again if one of them does not answer.  A robot
+** without an identity block (protocol v1 firmware) is not found this way
+** and needs a table entry.
+*/
+#ifndef I2C_APP_DISCOVER
+#define I2C_APP_DISCOVER false
+#endif
+#define I2C_APP_DEVICE_CACHE_FILE      "/cf/i2c_app_devices.dat"
+#define I2C_APP_DEVICE_CACHE_SIGNATURE 0x49324401
+#define I2C_APP_MAX_BUS_NUM            255 /* BusNum is a uint8 in the table */
+
+/*
+** Critical Data Store block for warm restarts.  The signature is built
+** from the size of I2C_APP_CdsState_t and a version, to be bumped when
+** the layout changes at the same size, so a block written by another
+** version of the app is not taken for this one.
+**
+** The block is written when the state changes, but odometry that is
+** the only change is written no more than every
+** I2C_APP_CDS_ODOM_SAVE_CYCLES control cycles.  Nothing is lost by the
+** wait: the last encoder readings are saved with the odometry, so the
+** first reading after a restart adds the counts in between.
+*/
+#define I2C_APP_CDS_NAME             "I2cAppState"
+#define I2C_APP_CDS_VERSION          1
+#define I2C_APP_CDS_SIGNATURE        (0x49000000 | (I2C_APP_CDS_VERSION << 16) | (uint32)sizeof(I2C_APP_CdsState_t))
+#define I2C_APP_CDS_ODOM_SAVE_CYCLES I2C_APP_WAKEUP_RATE_HZ /* once a second */
 /************************************************************************
 ** Type Definitions
 *************************************************************************/
 
+/*
+** One path segment, converted to a move of each wheel
+*/
+typedef struct
+{
+    int16 LeftDist;
+    int16 RightDist;
+} I2C_APP_PathStep_t;
+
+/*
+** Contents of I2C_APP_DEVICE_CACHE_FILE: the robots the last scan found
+*/
+typedef struct
+{
+    uint32              Signature; /* I2C_APP_DEVICE_CACHE_SIGNATURE */
+    uint16              NumDevices;
+    uint16              Spare;
+    I2C_APP_TblDevice_t Devices[I2C_APP_TBL_MAX_DEVICES];
+} I2C_APP_DeviceCache_t;
+
+/*
+** What the app keeps in the Critical Data Store, so that after a restart
+** by ES it carries on from the last cycle instead of probing the robot
+** again: the move in progress, the odometry, and which device answered
+** and how it is best talked to.
+*/
+typedef struct
+{
+    uint32 Signature; /* I2C_APP_CDS_SIGNATURE */
+
+    I2C_Command_Packet RobotCmd;
+    I2C_Command_Packet PendingCmd;
+    bool               CmdPending;
+    bool               PathActive;
+    uint16             PathLength;
+    uint16             PathNext;
+    I2C_APP_PathStep_t Path[I2C_APP_MAX_PATH_SEGMENTS];
+
+    int32 OdomLeft;
+    int32 OdomRight;
+    int16 LastLeftEnc;
+    int16 LastRightEnc;
+    bool  OdomValid;
+
+    uint16           DeviceIndex;
+    I2C_Ident_Packet RobotIdent;
+} I2C_APP_CdsState_t;
+
+/* the size is the low 16 bits of I2C_APP_CDS_SIGNATURE */
+CompileTimeAssert(sizeof(I2C_APP_CdsState_t) <= 0xFFFF, I2cAppCdsStateTooLarge);
+
 /*
 ** Global Data
 */
@@ -76,6 +212,12 @@ typedef struct
     uint8 CmdCounter;
     uint8 ErrCounter;
 
+    /*
+    ** Bus health counters...
+    */
+    uint8 BusErrCounter;
+    uint8 BusRecoveryCounter;
+
     /*
     ** Housekeeping telemetry packet...
     */
@@ -90,6 +232,8 @@ typedef struct
     ** Operational data (not reported in housekeeping)...
     */
     CFE_SB_PipeId_t CommandPipe;
+    CFE_SB_PipeId_t EStopPipe; /* I2C_APP_ESTOP_MID only, polled after every message */
+    OS_time_t       DispatchTime; /* when the message being processed came off the command pipe */
 
     /*
     ** Initialization data (not reported in housekeeping)...
@@ -97,47 +241,115 @@ typedef struct
     char   PipeName[CFE_MISSION_MAX_API_LEN];
     uint16 PipeDepth;
 
-    int i2c_fd;
+    int    BusNum;        /* bus and address of the open connection, or the last one */
+    int    Address;
+    uint16 DeviceIndex;   /* Config.Devices entry to try first on the next open */
+    uint16 ReopenHoldoff; /* control cycles left before the next reopen attempt */
+    int    i2c_fd;        /* -1 while the bus connection is down */
+    bool   BusFaulted;    /* last bus transaction failed, not yet recovered */
 
-    CFE_TBL_Handle_t TblHandles[I2C_APP_NUMBER_OF_TABLES];
-} I2C_APP_Data_t;
+    /*
+    ** Configuration in effect: built-in defaults, replaced by each valid
+    ** table image as it is loaded.  This is the app's own copy, refreshed
+    ** only when CFE_TBL_Manage reports an update, so the cycle and the
+    ** command handlers read it without going through the table services.
+    */
+    I2C_APP_Table_t Config;
+    uint8           ConfigLoadCounter; /* table images applied since the last reset */
 
-typedef struct {
-    int16_t left_speed, right_speed;
-    int16_t left_dist, right_dist;
-    bool r_led, g_led, y_led;
-} I2C_Command_Packet;
+    /*
+    ** Control cycle state, driven by I2C_APP_WAKEUP_MID...
+    */
+    I2C_Command_Packet RobotCmd;         /* command block as last handed to the bus */
+    I2C_Command_Packet PendingCmd;       /* command block the next cycle has to write */
+    bool               CmdPending;       /* PendingCmd still has to reach the robot */
+    uint32             CycleCounter;
+    OS_time_t          LastWakeup;
+    uint32             CyclePeriodUs;
+    uint32             CycleJitterMaxUs;
+    uint16             TlmDropCounter; /* samples lost to SB buffer allocation or transmit */
 
+    /*
+    ** Emergency stops, and the time from the message they waited behind
+    ** to the stop reaching the robot...
+    */
+    uint16 EStopCounter;
+    uint32 EStopLatencyUs;
+    uint32 EStopLatencyMaxUs;
 
-typedef struct {
-    int fd;
-    int bus_num;
-} Open_I2C;
+    /*
+    ** Motion commands sent before a stop can still be queued on the
+    ** command pipe when the stop is taken from its own pipe.  Each stop
+    ** also lands on the command pipe, behind them, so until those copies
+    ** come off it motion commands are dropped.  A copy the command pipe
+    ** had no room for would hold the fence up for good, so it also falls
+    ** once a pipe depth of messages has gone by.
+    */
+    uint16 EStopFence;       /* e-stop copies still to come off the command pipe */
+    uint16 EStopFenceBudget; /* command pipe messages left before the fence falls anyway */
 
+    /*
+    ** Path being run, as per-wheel encoder counts; the control cycle
+    ** starts each step once the robot reports the previous one done
+    */
+    I2C_APP_PathStep_t Path[I2C_APP_MAX_PATH_SEGMENTS];
+    uint16             PathLength;
+    uint16             PathNext; /* next step to start; PathLength once the last one is running */
+    bool               PathActive;
 
-typedef struct {
-  int16_t l_enc, r_enc;
-  int16_t rem_left;
-  int16_t rem_right;
-  int16_t cmd_left_dist;
-  int16_t cmd_right_dist;
-  int16_t cmd_left_speed;
-  int16_t cmd_right_speed;
-  int16_t set_left_speed;
-  int16_t set_right_speed;
-  uint16_t batteryMillivolts;
-  bool button_A;
-  bool button_B;
-  bool button_C;
-} I2C_Telem_Packet;
+    I2C_Ident_Packet RobotIdent;    /* identity block read at startup, zero if none */
+    uint16           RobotFeatures; /* ROMI_FEATURE_* bits in use, 0 = protocol v1 transfers */
 
-typedef struct {
-    I2C_Command_Packet cmd;    // 11 bytes
-    I2C_Telem_Packet telem;  // 25 bytes
-} I2C_Data;            // sizeof == 36
+    /*
+    ** Odometry: encoder counts travelled by each wheel, accumulated from
+    ** the 16-bit encoders in the telemetry
+    */
+    int32 OdomLeft;
+    int32 OdomRight;
+    int16 LastLeftEnc;
+    int16 LastRightEnc;
+    bool  OdomValid; /* LastLeftEnc/LastRightEnc hold a reading */
 
+    /*
+    ** Critical Data Store: CdsState is what was last written to it
+    */
+    CFE_ES_CDSHandle_t CdsHandle;
+    bool               CdsEnabled; /* block registered and writable */
+    bool               WarmStart;  /* this run resumed from the block */
+    I2C_APP_CdsState_t CdsState;
+    uint32             CdsSaveCycle; /* CycleCounter at the last write */
 
+    /*
+    ** Startup timing, reported in housekeeping.  All of it is measured
+    ** from StartTime, the start of I2C_APP_Init.
+    */
+    OS_time_t StartTime;
+    uint32    StartupUs;
+    uint32    StartupPhaseUs[I2C_APP_STARTUP_NUM_PHASES];
+    uint32    BusProbeUs;
+    uint32    FirstTlmUs;  /* 0 until the first robot telemetry is sent */
+    bool      FastBoot;    /* the bus is being, or was, started on the child task */
+    bool      BusStarted;  /* I2C_APP_StartBus is done; a table update may reconnect */
+    osal_id_t BusStartSem; /* given by the child task once it is done with the bus */
 
+    /*
+    ** Robots found at startup, tried ahead of Config.Devices' own entries
+    */
+    I2C_APP_TblDevice_t Discovered[I2C_APP_TBL_MAX_DEVICES];
+    uint16              NumDiscovered;
+    uint8               DiscoverFlags; /* I2C_APP_STARTUP_SCANNED, I2C_APP_STARTUP_CACHED */
+
+    CFE_TBL_Handle_t TblHandles[I2C_APP_NUMBER_OF_TABLES];
+} I2C_APP_Data_t;
+
+/*
+** I2C_Command_Packet, I2C_Telem_Packet and I2C_Data come from romi_protocol.h,
+** generated from protocol/romi_protocol.json.
+*/
+typedef struct {
+    int fd;
+    int bus_num;
+} Open_I2C;
 
 
 /*
@@ -155,8 +367,37 @@ extern I2C_APP_Data_t I2C_APP_Data;
 */
 void         I2C_APP_Main(void);
 CFE_Status_t I2C_APP_Init(void);
-CFE_Status_t I2C_OPEN_BUS(int bus_num, int* fd);
+CFE_Status_t I2C_OPEN_BUS(int bus_num, int address, int* fd);
 CFE_Status_t I2C_APP_Send(int fd, I2C_Command_Packet* packet);
+CFE_Status_t I2C_APP_Receive(int fd, I2C_Telem_Packet* telem);
+CFE_Status_t I2C_APP_ReadRegs(int fd, uint8 offset, uint8 *buf, size_t len);
+CFE_Status_t I2C_APP_Identify(int fd);
+CFE_Status_t I2C_APP_OpenDevice(void);
+CFE_Status_t I2C_APP_BusConnect(void);
+bool         I2C_APP_ProbeAddress(int fd, uint8 address);
+bool         I2C_APP_ProbeDevice(const I2C_APP_TblDevice_t* dev);
+void         I2C_APP_AddDiscovered(uint8 bus_num, uint8 address);
+void         I2C_APP_ScanBuses(void);
+CFE_Status_t I2C_APP_ReadDeviceCache(I2C_APP_DeviceCache_t* cache);
+void         I2C_APP_WriteDeviceCache(void);
+void         I2C_APP_Discover(void);
+void         I2C_APP_MergeDevices(I2C_APP_Table_t* config);
+void         I2C_APP_StartBus(void);
+void         I2C_APP_BusStartTask(void);
+uint32       I2C_APP_ElapsedUs(OS_time_t from, OS_time_t to);
+void         I2C_APP_EndPhase(uint16 phase, OS_time_t* mark);
+void         I2C_APP_BusResult(CFE_Status_t status, const char *op);
+void         I2C_APP_StageCommand(const I2C_Command_Packet* packet);
+CFE_Status_t I2C_APP_SendCommand(I2C_Command_Packet* packet);
+CFE_Status_t I2C_APP_Move(int16 left_dist, int16 right_dist);
+CFE_Status_t I2C_APP_StopMotion(void);
+void         I2C_APP_CheckEStop(void);
+bool         I2C_APP_ScaleCounts(int64 num, int64 den, int16* counts);
+bool         I2C_APP_DriveCounts(int16 mm, int16* counts);
+bool         I2C_APP_SpinCounts(int16 degrees, int16* counts);
+void         I2C_APP_AdvancePath(const I2C_Telem_Packet* telem);
+void         I2C_APP_UpdateOdometry(const I2C_Telem_Packet* telem);
+CFE_Status_t I2C_APP_ReadTelemetry(I2C_Telem_Packet* telem);
 
 
 void  I2C_APP_Main(void);
@@ -164,12 +405,25 @@ int32 I2C_APP_Init(void);
 void  I2C_APP_ProcessCommandPacket(CFE_SB_Buffer_t *SBBufPtr);
 void  I2C_APP_ProcessGroundCommand(CFE_SB_Buffer_t *SBBufPtr);
 int32 I2C_APP_ReportHousekeeping(const CFE_MSG_CommandHeader_t *Msg);
+int32 I2C_APP_Wakeup(const CFE_MSG_CommandHeader_t *Msg);
 int32 I2C_APP_ResetCounters(const I2C_APP_ResetCountersCmd_t *Msg);
-int32 I2C_APP_Process(const I2C_APP_ProcessCmd_t *Msg);
+int32 I2C_APP_ReportConfig(const I2C_APP_ReportConfigCmd_t *Msg);
 int32 I2C_APP_Noop(const I2C_APP_NoopCmd_t *Msg);
+int32 I2C_APP_SetWheelSpeeds(const I2C_APP_SetWheelSpeedsCmd_t *Msg);
+int32 I2C_APP_DriveDistance(const I2C_APP_DriveDistanceCmd_t *Msg);
+int32 I2C_APP_Spin(const I2C_APP_SpinCmd_t *Msg);
+int32 I2C_APP_SetLeds(const I2C_APP_SetLedsCmd_t *Msg);
+int32 I2C_APP_Stop(const I2C_APP_StopCmd_t *Msg);
+int32 I2C_APP_RunPath(const I2C_APP_RunPathCmd_t *Msg);
 void  I2C_APP_GetCrc(const char *TableName);
 
 int32 I2C_APP_TblValidationFunc(void *TblData);
+void  I2C_APP_LoadConfig(void);
+void  I2C_APP_ApplyConfig(const I2C_APP_Table_t *Table);
+
+void I2C_APP_RestoreState(void);
+void I2C_APP_SaveState(void);
 
 bool I2C_APP_VerifyCmdLength(CFE_MSG_Message_t *MsgPtr, size_t ExpectedLength);
+bool I2C_APP_VerifyPathCmdLength(CFE_MSG_Message_t *MsgPtr);
 #endif /* I2C_APP_CMDS_H */
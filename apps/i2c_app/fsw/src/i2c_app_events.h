@@ -33,5 +33,18 @@
 #define I2C_APP_INVALID_MSGID_ERR_EID 5
 #define I2C_APP_LEN_ERR_EID           6
 #define I2C_APP_PIPE_ERR_EID          7
+#define I2C_APP_BUS_ERR_EID           8
+#define I2C_APP_BUS_INF_EID           9
+#define I2C_APP_IDENT_INF_EID         10
+#define I2C_APP_MOTION_DBG_EID        11
+#define I2C_APP_MOTION_ERR_EID        12
+#define I2C_APP_PATH_INF_EID          13
+#define I2C_APP_ESTOP_INF_EID         14
+#define I2C_APP_CONFIG_INF_EID        15
+#define I2C_APP_CONFIG_ERR_EID        16
+#define I2C_APP_CDS_INF_EID           17
+#define I2C_APP_CDS_ERR_EID           18
+#define I2C_APP_DISCOVER_INF_EID      19
+#define I2C_APP_DISCOVER_ERR_EID      20
 
 #endif /* I2C_APP_EVENTS_H */
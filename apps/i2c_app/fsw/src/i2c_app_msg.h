@@ -30,7 +30,13 @@
 */
 #define I2C_APP_NOOP_CC           0
 #define I2C_APP_RESET_COUNTERS_CC 1
-#define I2C_APP_PROCESS_CC        2
+#define I2C_APP_REPORT_CONFIG_CC  2
+#define I2C_APP_SET_WHEEL_SPEEDS_CC 3
+#define I2C_APP_DRIVE_DISTANCE_CC   4
+#define I2C_APP_SPIN_CC             5
+#define I2C_APP_SET_LEDS_CC         6
+#define I2C_APP_STOP_CC             7
+#define I2C_APP_RUN_PATH_CC         8
 
 /*************************************************************************/
 
@@ -51,18 +57,140 @@ typedef struct
 */
 typedef I2C_APP_NoArgsCmd_t I2C_APP_NoopCmd_t;
 typedef I2C_APP_NoArgsCmd_t I2C_APP_ResetCountersCmd_t;
-typedef I2C_APP_NoArgsCmd_t I2C_APP_ProcessCmd_t;
+typedef I2C_APP_NoArgsCmd_t I2C_APP_ReportConfigCmd_t;
+typedef I2C_APP_NoArgsCmd_t I2C_APP_StopCmd_t;
 
 /*************************************************************************/
+/*
+** Motion commands.  Each one becomes a single write of the robot's
+** command block; fields it does not name keep their last written value.
+*/
+typedef struct
+{
+    int16 LeftSpeed;  /**< \brief Motor speed, -I2C_APP_MAX_WHEEL_SPEED..I2C_APP_MAX_WHEEL_SPEED */
+    int16 RightSpeed; /**< \brief Motor speed, -I2C_APP_MAX_WHEEL_SPEED..I2C_APP_MAX_WHEEL_SPEED */
+} I2C_APP_SetWheelSpeeds_Payload_t;
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t          CmdHeader; /**< \brief Command header */
+    I2C_APP_SetWheelSpeeds_Payload_t Payload;   /**< \brief Command payload */
+} I2C_APP_SetWheelSpeedsCmd_t;
+
+typedef struct
+{
+    int16 DistanceMm; /**< \brief Straight move, negative drives backwards */
+    uint8 Spare[2];
+} I2C_APP_DriveDistance_Payload_t;
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t         CmdHeader; /**< \brief Command header */
+    I2C_APP_DriveDistance_Payload_t Payload;   /**< \brief Command payload */
+} I2C_APP_DriveDistanceCmd_t;
+
+typedef struct
+{
+    int16 AngleDeg; /**< \brief Turn in place, positive is counter-clockwise */
+    uint8 Spare[2];
+} I2C_APP_Spin_Payload_t;
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t CmdHeader; /**< \brief Command header */
+    I2C_APP_Spin_Payload_t  Payload;   /**< \brief Command payload */
+} I2C_APP_SpinCmd_t;
+
+typedef struct
+{
+    uint8 Red;    /**< \brief 0 = off, 1 = on */
+    uint8 Green;  /**< \brief 0 = off, 1 = on */
+    uint8 Yellow; /**< \brief 0 = off, 1 = on */
+    uint8 Spare;
+} I2C_APP_SetLeds_Payload_t;
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t   CmdHeader; /**< \brief Command header */
+    I2C_APP_SetLeds_Payload_t Payload;   /**< \brief Command payload */
+} I2C_APP_SetLedsCmd_t;
+
+/*
+** Path command: a sequence of moves run back to back, each one started by
+** the control cycle once the robot reports the previous one finished.
+** The message is variable length and carries NumSegments entries of
+** Segments; a path replaces any path still running.
+*/
+#define I2C_APP_MAX_PATH_SEGMENTS 64
+
+#define I2C_APP_SEGMENT_DRIVE 0 /* Value is a straight move in mm, as DRIVE_DISTANCE */
+#define I2C_APP_SEGMENT_SPIN  1 /* Value is a turn in degrees, as SPIN */
+
+typedef struct
+{
+    uint8 Kind;  /**< \brief I2C_APP_SEGMENT_* */
+    uint8 Spare;
+    int16 Value; /**< \brief Distance or angle, by Kind */
+} I2C_APP_PathSegment_t;
+
+typedef struct
+{
+    uint16                NumSegments; /**< \brief 1..I2C_APP_MAX_PATH_SEGMENTS, must match the message length */
+    uint8                 Spare[2];
+    I2C_APP_PathSegment_t Segments[I2C_APP_MAX_PATH_SEGMENTS];
+} I2C_APP_RunPath_Payload_t;
+
+typedef struct
+{
+    CFE_MSG_CommandHeader_t   CmdHeader; /**< \brief Command header */
+    I2C_APP_RunPath_Payload_t Payload;   /**< \brief Command payload, sent trimmed to NumSegments */
+} I2C_APP_RunPathCmd_t;
+
+/*************************************************************************/
+/*
+** Startup phases timed in housekeeping, in the order a serial start runs
+** them.  In fast boot the bus phase is only the time the app waited for
+** the child task that opened and probed the bus.
+*/
+#define I2C_APP_STARTUP_EVS        0 /* event registration */
+#define I2C_APP_STARTUP_SB         1 /* pipes and subscriptions */
+#define I2C_APP_STARTUP_TBL        2 /* table registration, load and apply */
+#define I2C_APP_STARTUP_CDS        3 /* critical data store restore */
+#define I2C_APP_STARTUP_BUS        4 /* bus open and robot probe */
+#define I2C_APP_STARTUP_NUM_PHASES 5
+
+/* StartupFlags bits */
+#define I2C_APP_STARTUP_FAST_BOOT 0x01 /* the bus was brought up on a child task */
+#define I2C_APP_STARTUP_WARM      0x02 /* resumed from the critical data store */
+#define I2C_APP_STARTUP_SCANNED   0x04 /* the buses were scanned for robots */
+#define I2C_APP_STARTUP_CACHED    0x08 /* the robots were where the device cache said */
+
 /*
 ** Type definition (I2C App housekeeping)
 */
 
 typedef struct
 {
-    uint8 CommandErrorCounter;
-    uint8 CommandCounter;
-    uint8 spare[2];
+    uint8  CommandErrorCounter;
+    uint8  CommandCounter;
+    uint8  BusErrorCounter;      /**< \brief Failed bus transactions and reopen attempts */
+    uint8  BusRecoveryCounter;   /**< \brief Bus connections reopened after a failure */
+    uint8  RobotProtocolVersion; /**< \brief From the robot's identity block, 0 if it has none */
+    uint8  ConfigLoadCounter;    /**< \brief Configuration table updates applied */
+    uint16 RobotFeatures;        /**< \brief ROMI_FEATURE_* transfer strategies in use */
+    uint32 CycleCounter;         /**< \brief Control cycles run since the last reset */
+    uint32 CyclePeriodUs;        /**< \brief Time between the last two wakeups */
+    uint32 CycleJitterMaxUs;     /**< \brief Worst deviation from the nominal wakeup period */
+    uint32 EStopLatencyUs;       /**< \brief Last emergency stop, from the message it waited behind to the bus write */
+    uint32 EStopLatencyMaxUs;    /**< \brief Worst EStopLatencyUs since the last reset */
+    uint16 EStopCounter;         /**< \brief Emergency stops serviced */
+    uint16 TlmDropCounter;       /**< \brief Robot telemetry samples lost: no SB buffer, or the SB refused it */
+    uint32 StartupUs;            /**< \brief Time I2C_APP_Init took */
+    uint32 StartupPhaseUs[I2C_APP_STARTUP_NUM_PHASES]; /**< \brief Of which each I2C_APP_STARTUP_* phase */
+    uint32 BusProbeUs;           /**< \brief Bus open and robot probe, on whichever task ran it */
+    uint32 FirstTlmUs;           /**< \brief From the start of I2C_APP_Init to the first robot telemetry, 0 until then */
+    uint8  StartupFlags;         /**< \brief I2C_APP_STARTUP_* flags */
+    uint8  spare[3];
 } I2C_APP_HkTlm_Payload_t;
 
 typedef struct
@@ -71,4 +199,23 @@ typedef struct
     I2C_APP_HkTlm_Payload_t Payload;         /**< \brief Telemetry payload */
 } I2C_APP_HkTlm_t;
 
+/*
+** Type definition (robot telemetry, one packet per control cycle)
+*/
+typedef struct
+{
+    uint32           CycleCounter; /**< \brief Control cycle the telemetry was read in */
+    uint16           PathSegment;  /**< \brief Path segments started so far, 0 when no path is loaded */
+    uint16           PathLength;   /**< \brief Segments in the current path */
+    int32            OdomLeft;     /**< \brief Left wheel encoder counts travelled, kept across app restarts */
+    int32            OdomRight;    /**< \brief Right wheel encoder counts travelled, kept across app restarts */
+    I2C_Telem_Packet Telem;        /**< \brief The robot's telemetry block, decoded */
+} I2C_APP_RobotTlm_Payload_t;
+
+typedef struct
+{
+    CFE_MSG_TelemetryHeader_t  TelemetryHeader; /**< \brief Telemetry header */
+    I2C_APP_RobotTlm_Payload_t Payload;         /**< \brief Telemetry payload */
+} I2C_APP_RobotTlm_t;
+
 #endif /* I2C_APP_MSG_H */
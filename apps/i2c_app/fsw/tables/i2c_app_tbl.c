@@ -17,13 +17,25 @@
  ************************************************************************/
 
 #include "cfe_tbl_filedef.h" /* Required to obtain the CFE_TBL_FILEDEF macro definition */
+#include "romi_protocol.h"
 #include "i2c_app_table.h"
 
 /*
-** The following is an example of the declaration statement that defines the desired
-** contents of the table image.
+** Default configuration: a Romi on /dev/i2c-2 with no startup scan,
+** telemetry every control cycle, combined transfers if the robot has them,
+** reopen at once after a bus fault, and the Romi's nominal geometry.
 */
-I2C_APP_Table_t SampleAppTable = {1, 2};
+I2C_APP_Table_t I2cAppTable = {
+    .NumDevices          = 1,
+    .Discover            = 0,
+    .Devices             = {{.BusNum = 2, .Address = ROMI_I2C_ADDRESS}},
+    .PollDivider         = 1,
+    .TransferFeatures    = ROMI_FEATURE_COMBINED_XFER,
+    .ReopenHoldoffCycles = 0,
+    .CountsPerM          = 6548,
+    .WheelBaseMm         = 141,
+    .MaxWheelSpeed       = 300,
+};
 
 /*
 ** The macro below identifies:
@@ -32,4 +44,4 @@ I2C_APP_Table_t SampleAppTable = {1, 2};
 **    3) a brief description of the contents of the file image
 **    4) the desired name of the table image binary file that is cFE compatible
 */
-CFE_TBL_FILEDEF(SampleAppTable, I2C_APP.SampleAppTable, Table Utility Test Table, sample_app_tbl.tbl)
+CFE_TBL_FILEDEF(I2cAppTable, I2C_APP.I2cAppTable, I2C robot configuration, i2c_app_tbl.tbl)
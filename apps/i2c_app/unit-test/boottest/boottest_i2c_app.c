@@ -0,0 +1,395 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+** File: boottest_i2c_app.c
+**
+** Purpose:
+** Startup benchmark for the I2C Application: time to first telemetry
+**
+** Notes:
+** Runs I2C_APP_Init against the simulated bus in ../sim, then feeds it
+** scheduler wakeups at I2C_APP_WAKEUP_RATE_HZ until the first robot
+** telemetry packet goes out, for a serial and a fast boot, cold and
+** warm, and with a robot that is still booting when the app starts.
+** The startup phases and the time to first telemetry are the app's own
+** figures, the same ones it reports in housekeeping, taken against the
+** simulator's virtual clock.  They start at I2C_APP_Init; the time ES
+** takes to get there is not modelled.
+**
+** Time is costed from two sources:
+**
+**   - bus time and the settle/probe delays, on the simulator's clock;
+**   - cFE service calls (SB, TBL, EVS, CDS), which are stubbed here, at
+**     a fixed cost per call.  These are rough figures; replace them with
+**     the phases from housekeeping on the target.
+**
+** In fast boot the child task runs, to the end, when it is created, on
+** the simulator's clock; the app task goes on from the same point on a
+** clock of its own, and the two are joined when the app waits for the
+** child.  That is the schedule of a target with a core to spare; on one
+** core the child only gets the time the app spends blocked.
+**
+** Environment:
+**
+**   I2C_APP_BOOT_TBL_LOAD_US     table file load and validation (default 5000)
+**   I2C_APP_BOOT_ROBOT_READY_MS  robot boot time in the "robot booting"
+**                                runs, from the start of I2C_APP_Init (default 40)
+*/
+
+/*
+ * Includes
+ */
+
+#include "i2c_app_coveragetest_common.h"
+#include "ut_i2c_app.h"
+#include "ut_i2c_bus_sim.h"
+
+#include <stdlib.h>
+
+#define UT_BOOT_DEFAULT_TBL_LOAD_US    5000
+#define UT_BOOT_DEFAULT_ROBOT_READY_MS 40
+
+/* Cost of the cFE service calls made during startup */
+#define UT_BOOT_EVS_REGISTER_NS 20000
+#define UT_BOOT_SB_CALL_NS      20000
+#define UT_BOOT_TBL_REGISTER_NS 50000
+#define UT_BOOT_CDS_CALL_NS     50000
+
+/* Firmware PololuRPiSlave delay before each transmitted byte */
+#define UT_BOOT_SLAVE_BYTE_DELAY_NS 5000
+
+/* Give up on first telemetry after this many wakeups */
+#define UT_BOOT_MAX_WAKEUPS (2 * I2C_APP_WAKEUP_RATE_HZ)
+
+typedef struct
+{
+    const char *Name;
+    bool        Fast;
+    bool        Warm;
+    bool        RobotBooting;
+} UT_Boot_Scenario_t;
+
+static const UT_Boot_Scenario_t UT_Boot_Scenarios[] = {
+    {"serial cold", false, false, false},       {"fast cold", true, false, false},
+    {"serial cold, robot booting", false, false, true}, {"fast cold, robot booting", true, false, true},
+    {"serial warm", false, true, false},        {"fast warm", true, true, false},
+};
+
+#define UT_BOOT_NUM_SCENARIOS (sizeof(UT_Boot_Scenarios) / sizeof(UT_Boot_Scenarios[0]))
+
+typedef struct
+{
+    uint32 StartupUs;
+    uint32 PhaseUs[I2C_APP_STARTUP_NUM_PHASES];
+    uint32 BusProbeUs;
+    uint32 FirstTlmUs;
+    uint32 Wakeups;
+    bool   Identified;
+} UT_Boot_Result_t;
+
+/*
+ * Two clocks while the fast boot child task is out: the child's is the
+ * simulator's, since it owns the bus, and the app task keeps its own.
+ */
+typedef struct
+{
+    bool      Forked;  /* the child has run; the app task is on MainNs */
+    bool      InChild; /* the child is running now */
+    uint64    MainNs;
+    uint64    ChildEndNs;
+    uint64    ReadyNs; /* robot answers from this time on, 0 once it does */
+    int32     SlaveId;
+    OS_time_t Now; /* handed out by the next OS_GetLocalTime */
+} UT_Boot_Clock_t;
+
+static UT_Boot_Clock_t UT_Boot_Clock;
+
+/* per-call costs, passed to UT_Boot_Cost_Hook */
+static uint64 UT_Boot_EvsRegisterNs = UT_BOOT_EVS_REGISTER_NS;
+static uint64 UT_Boot_SbCallNs      = UT_BOOT_SB_CALL_NS;
+static uint64 UT_Boot_TblRegisterNs = UT_BOOT_TBL_REGISTER_NS;
+static uint64 UT_Boot_TblLoadNs;
+static uint64 UT_Boot_CdsCallNs = UT_BOOT_CDS_CALL_NS;
+
+/* what the cold serial run left in the CDS, for the warm runs */
+static I2C_APP_CdsState_t UT_Boot_Saved;
+
+static uint32 UT_Boot_GetEnv(const char *Name, uint32 Default)
+{
+    const char *Value = getenv(Name);
+
+    return (Value != NULL && atol(Value) > 0) ? (uint32)atol(Value) : Default;
+}
+
+static uint64 UT_Boot_TaskNow(void)
+{
+    return (UT_Boot_Clock.Forked && !UT_Boot_Clock.InChild) ? UT_Boot_Clock.MainNs : UT_I2CBusSim_GetTime();
+}
+
+/* Move the bus clock on; a booting robot starts answering once it is ready */
+static void UT_Boot_AdvanceTo(uint64 Ns)
+{
+    UT_I2CBusSim_SetTime(Ns);
+    if (UT_Boot_Clock.ReadyNs != 0 && Ns >= UT_Boot_Clock.ReadyNs)
+    {
+        UT_I2CBusSim_SetSlaveFault(UT_Boot_Clock.SlaveId, UT_I2C_BUS_SIM_FAULT_NONE);
+        UT_Boot_Clock.ReadyNs = 0;
+    }
+}
+
+/* Spend time on the clock of whichever task is running */
+static void UT_Boot_Spend(uint64 Ns)
+{
+    if (UT_Boot_Clock.Forked && !UT_Boot_Clock.InChild)
+    {
+        UT_Boot_Clock.MainNs += Ns;
+        return;
+    }
+
+    UT_Boot_AdvanceTo(UT_I2CBusSim_GetTime() + Ns);
+}
+
+static int32 UT_Boot_Cost_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    UT_Boot_Spend(*(uint64 *)UserObj);
+
+    return StubRetcode;
+}
+
+static int32 UT_Boot_TaskDelay_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount,
+                                    const UT_StubContext_t *Context)
+{
+    UT_Boot_Spend((uint64)UT_Hook_GetArgValueByName(Context, "millisecond", uint32) * 1000000);
+
+    return StubRetcode;
+}
+
+/* OS_GetLocalTime copies UT_Boot_Clock.Now out of its data buffer after this */
+static int32 UT_Boot_GetLocalTime_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount,
+                                       const UT_StubContext_t *Context)
+{
+    UT_Boot_Clock.Now = OS_TimeFromTotalMicroseconds((int64)(UT_Boot_TaskNow() / 1000));
+
+    return StubRetcode;
+}
+
+static int32 UT_Boot_ChildTask_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount,
+                                    const UT_StubContext_t *Context)
+{
+    CFE_ES_ChildTaskMainFuncPtr_t FunctionPtr =
+        UT_Hook_GetArgValueByName(Context, "FunctionPtr", CFE_ES_ChildTaskMainFuncPtr_t);
+
+    if (StubRetcode == CFE_SUCCESS)
+    {
+        UT_Boot_Clock.MainNs  = UT_I2CBusSim_GetTime();
+        UT_Boot_Clock.InChild = true;
+        FunctionPtr();
+        UT_Boot_Clock.InChild    = false;
+        UT_Boot_Clock.ChildEndNs = UT_I2CBusSim_GetTime();
+        UT_Boot_Clock.Forked     = true;
+    }
+
+    return StubRetcode;
+}
+
+/* The app waits for the child: both clocks meet at the later of the two */
+static int32 UT_Boot_Join_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    if (UT_Boot_Clock.Forked)
+    {
+        if (UT_Boot_Clock.ChildEndNs > UT_Boot_Clock.MainNs)
+        {
+            UT_Boot_Clock.MainNs = UT_Boot_Clock.ChildEndNs;
+        }
+        UT_Boot_Clock.Forked = false;
+        UT_Boot_AdvanceTo(UT_Boot_Clock.MainNs);
+    }
+
+    return StubRetcode;
+}
+
+static void UT_Boot_Run(const UT_Boot_Scenario_t *Scenario, uint32 ReadyMs, UT_Boot_Result_t *Result)
+{
+    static I2C_APP_Table_t  DefaultTable = UT_I2C_APP_DEFAULT_TABLE;
+    static I2C_APP_Table_t *DefaultTablePtr;
+    static uint8            Regs[I2C_PACKET_SIZE];
+
+    I2C_Ident_Packet Ident = {ROMI_IDENT_MAGIC, ROMI_PROTOCOL_VERSION, ROMI_DATA_SIZE, ROMI_FEATURE_COMBINED_XFER,
+                              0x00b007ed};
+    CFE_SB_MsgId_t   WakeupMid = CFE_SB_ValueToMsgId(I2C_APP_WAKEUP_MID);
+    uint64           PeriodNs  = (uint64)I2C_APP_WAKEUP_PERIOD_US * 1000;
+    uint64           Tick;
+    uint32           i;
+
+    UT_ResetState(0);
+    memset(&UT_Boot_Clock, 0, sizeof(UT_Boot_Clock));
+    memset(Result, 0, sizeof(*Result));
+
+    DefaultTablePtr = &DefaultTable;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &DefaultTablePtr, sizeof(DefaultTablePtr), false);
+
+    memset(Regs, 0, sizeof(Regs));
+    romi_ident_pack(&Regs[ROMI_IDENT_OFFSET], &Ident);
+    UT_I2CBusSim_Init(NULL);
+    UT_Boot_Clock.SlaveId =
+        UT_I2CBusSim_AddSlave(I2C_APP_BUS_NUM, I2C_ADDRESS, Regs, sizeof(Regs), UT_BOOT_SLAVE_BYTE_DELAY_NS);
+    if (Scenario->RobotBooting)
+    {
+        UT_I2CBusSim_SetSlaveFault(UT_Boot_Clock.SlaveId, UT_I2C_BUS_SIM_FAULT_NACK);
+        UT_Boot_Clock.ReadyNs = (uint64)ReadyMs * 1000000;
+    }
+
+    UT_SetDataBuffer(UT_KEY(OS_GetLocalTime), &UT_Boot_Clock.Now, sizeof(UT_Boot_Clock.Now), false);
+    UT_SetHookFunction(UT_KEY(OS_GetLocalTime), UT_Boot_GetLocalTime_Hook, NULL);
+    UT_SetHookFunction(UT_KEY(OS_TaskDelay), UT_Boot_TaskDelay_Hook, NULL);
+    UT_SetHookFunction(UT_KEY(CFE_ES_CreateChildTask), UT_Boot_ChildTask_Hook, NULL);
+    UT_SetHookFunction(UT_KEY(OS_BinSemTake), UT_Boot_Join_Hook, NULL);
+    UT_SetHookFunction(UT_KEY(CFE_EVS_Register), UT_Boot_Cost_Hook, &UT_Boot_EvsRegisterNs);
+    UT_SetHookFunction(UT_KEY(CFE_SB_CreatePipe), UT_Boot_Cost_Hook, &UT_Boot_SbCallNs);
+    UT_SetHookFunction(UT_KEY(CFE_SB_Subscribe), UT_Boot_Cost_Hook, &UT_Boot_SbCallNs);
+    UT_SetHookFunction(UT_KEY(CFE_TBL_Register), UT_Boot_Cost_Hook, &UT_Boot_TblRegisterNs);
+    UT_SetHookFunction(UT_KEY(CFE_TBL_Load), UT_Boot_Cost_Hook, &UT_Boot_TblLoadNs);
+    UT_SetHookFunction(UT_KEY(CFE_ES_RegisterCDS), UT_Boot_Cost_Hook, &UT_Boot_CdsCallNs);
+    UT_SetHookFunction(UT_KEY(CFE_ES_RestoreFromCDS), UT_Boot_Cost_Hook, &UT_Boot_CdsCallNs);
+
+    /* a serial boot is what the app falls back to without the child task */
+    if (!Scenario->Fast)
+    {
+        UT_SetDefaultReturnValue(UT_KEY(CFE_ES_CreateChildTask), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    }
+    if (Scenario->Warm)
+    {
+        UT_SetDefaultReturnValue(UT_KEY(CFE_ES_RegisterCDS), CFE_ES_CDS_ALREADY_EXISTS);
+        UT_SetDataBuffer(UT_KEY(CFE_ES_RestoreFromCDS), &UT_Boot_Saved, sizeof(UT_Boot_Saved), false);
+    }
+
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.WarmStart == Scenario->Warm);
+
+    /* the scheduler ticks from time 0; the first wakeup is the next tick after Init */
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &WakeupMid, sizeof(WakeupMid), false);
+    Tick = (UT_I2CBusSim_GetTime() + PeriodNs - 1) / PeriodNs;
+    for (i = 0; i < UT_BOOT_MAX_WAKEUPS && I2C_APP_Data.FirstTlmUs == 0; ++i)
+    {
+        UT_Boot_AdvanceTo((Tick + i) * PeriodNs);
+        I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
+    }
+
+    Result->StartupUs  = I2C_APP_Data.StartupUs;
+    Result->BusProbeUs = I2C_APP_Data.BusProbeUs;
+    Result->FirstTlmUs = I2C_APP_Data.FirstTlmUs;
+    Result->Wakeups    = i;
+    Result->Identified = (I2C_APP_Data.RobotIdent.magic == ROMI_IDENT_MAGIC);
+    memcpy(Result->PhaseUs, I2C_APP_Data.StartupPhaseUs, sizeof(Result->PhaseUs));
+
+    if (!Scenario->Warm && !Scenario->Fast && !Scenario->RobotBooting)
+    {
+        UT_Boot_Saved = I2C_APP_Data.CdsState;
+    }
+
+    UtPrintf("BOOT %-26s startup %6lu us (evs %lu, sb %lu, tbl %lu, cds %lu, bus %lu) probe %6lu us"
+             " | first tlm %6lu us, wakeup %lu%s",
+             Scenario->Name, (unsigned long)Result->StartupUs, (unsigned long)Result->PhaseUs[I2C_APP_STARTUP_EVS],
+             (unsigned long)Result->PhaseUs[I2C_APP_STARTUP_SB], (unsigned long)Result->PhaseUs[I2C_APP_STARTUP_TBL],
+             (unsigned long)Result->PhaseUs[I2C_APP_STARTUP_CDS], (unsigned long)Result->PhaseUs[I2C_APP_STARTUP_BUS],
+             (unsigned long)Result->BusProbeUs, (unsigned long)Result->FirstTlmUs, (unsigned long)Result->Wakeups,
+             Result->Identified ? "" : ", no identity");
+}
+
+void Test_I2C_APP_Boot(void)
+{
+    UT_Boot_Result_t Results[UT_BOOT_NUM_SCENARIOS];
+    uint32           ReadyMs = UT_Boot_GetEnv("I2C_APP_BOOT_ROBOT_READY_MS", UT_BOOT_DEFAULT_ROBOT_READY_MS);
+    uint32           Bound;
+    uint32           k;
+
+    UT_Boot_TblLoadNs = (uint64)UT_Boot_GetEnv("I2C_APP_BOOT_TBL_LOAD_US", UT_BOOT_DEFAULT_TBL_LOAD_US) * 1000;
+
+    UtPrintf("BOOT table load %lu us, robot ready %lu ms after start in the booting runs, wakeups at %u Hz",
+             (unsigned long)(UT_Boot_TblLoadNs / 1000), (unsigned long)ReadyMs, (unsigned int)I2C_APP_WAKEUP_RATE_HZ);
+
+    /* the warm runs restore what the first one saved */
+    for (k = 0; k < UT_BOOT_NUM_SCENARIOS; ++k)
+    {
+        UT_Boot_Run(&UT_Boot_Scenarios[k], ReadyMs, &Results[k]);
+    }
+
+    /* every start gets to telemetry on the first wakeup after Init, or after the robot is up */
+    for (k = 0; k < UT_BOOT_NUM_SCENARIOS; ++k)
+    {
+        Bound = Results[k].StartupUs;
+        if (UT_Boot_Scenarios[k].RobotBooting && ReadyMs * 1000 > Bound)
+        {
+            Bound = ReadyMs * 1000;
+        }
+        UtAssert_True(Results[k].FirstTlmUs != 0 && Results[k].FirstTlmUs <= Bound + I2C_APP_WAKEUP_PERIOD_US,
+                      "%s: first telemetry %lu us, within a wakeup of %lu us", UT_Boot_Scenarios[k].Name,
+                      (unsigned long)Results[k].FirstTlmUs, (unsigned long)Bound);
+    }
+
+    if (!I2C_APP_FAST_BOOT)
+    {
+        return;
+    }
+
+    /* a fast boot of a running robot waits for neither the settle time nor the bus */
+    UtAssert_True(Results[1].StartupUs < I2C_APP_SETTLE_MS * 1000, "fast cold startup %lu us under the %u ms settle time",
+                  (unsigned long)Results[1].StartupUs, (unsigned int)I2C_APP_SETTLE_MS);
+    UtAssert_True(Results[1].FirstTlmUs < Results[0].FirstTlmUs, "fast cold first telemetry %lu us, serial %lu us",
+                  (unsigned long)Results[1].FirstTlmUs, (unsigned long)Results[0].FirstTlmUs);
+    UtAssert_True(Results[1].Identified, "fast cold identified the robot");
+
+    /* a booting robot is probed until it answers, for up to the settle time */
+    UtAssert_True(Results[3].StartupUs <= Results[2].StartupUs, "fast booting-robot startup %lu us, serial %lu us",
+                  (unsigned long)Results[3].StartupUs, (unsigned long)Results[2].StartupUs);
+    if (ReadyMs < I2C_APP_SETTLE_MS)
+    {
+        UtAssert_True(Results[3].Identified, "fast boot identified the booting robot");
+        UtAssert_True(Results[3].BusProbeUs <= (ReadyMs + I2C_APP_PROBE_RETRY_MS) * 1000,
+                      "probe %lu us, robot ready after %lu ms", (unsigned long)Results[3].BusProbeUs,
+                      (unsigned long)ReadyMs);
+    }
+
+    /* a warm restart skips the settle time either way */
+    UtAssert_True(Results[4].StartupUs < I2C_APP_SETTLE_MS * 1000, "serial warm startup %lu us",
+                  (unsigned long)Results[4].StartupUs);
+    UtAssert_True(Results[5].StartupUs < I2C_APP_SETTLE_MS * 1000, "fast warm startup %lu us",
+                  (unsigned long)Results[5].StartupUs);
+}
+
+/*
+ * Setup function prior to every test
+ */
+void I2C_UT_Setup(void)
+{
+    UT_ResetState(0);
+}
+
+/*
+ * Teardown function after every test
+ */
+void I2C_UT_TearDown(void) {}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(I2C_APP_Boot);
+}
@@ -17,28 +17,27 @@
  ************************************************************************/
 
 /*
-** File: coveragetest_sample_app.c
+** File: coveragetest_i2c_app.c
 **
 ** Purpose:
-** Coverage Unit Test cases for the SAMPLE Application
+** Coverage Unit Test cases for the I2C Application
 **
 ** Notes:
 ** This implements various test cases to exercise all code
-** paths through all functions defined in the SAMPLE application.
+** paths through all functions defined in the I2C application.
 **
-** It is primarily focused at providing examples of the various
-** stub configurations, hook functions, and wrapper calls that
-** are often needed when coercing certain code paths through
-** complex functions.
+** The bus syscalls (open/ioctl/read/write/...) are routed to the
+** OCS_ stubs in ../stubs, so besides coverage these tests also
+** check the cost of the command path: no blocking sleeps, and no
+** more than UT_I2C_APP_CMD_SYSCALL_BUDGET syscalls per command.
 */
 
 /*
  * Includes
  */
 
-#include "sample_lib.h" /* For SAMPLE_LIB_Function */
-#include "sample_app_coveragetest_common.h"
-#include "ut_sample_app.h"
+#include "i2c_app_coveragetest_common.h"
+#include "ut_i2c_app.h"
 
 /*
  * Unit test check event hook information
@@ -143,26 +142,26 @@ static void UT_CheckEvent_Setup_Impl(UT_CheckEvent_t *Evt, uint16 ExpectedEvent,
 **********************************************************************************
 */
 
-void Test_SAMPLE_APP_Main(void)
+void Test_I2C_APP_Main(void)
 {
     CFE_SB_MsgId_t MsgId = CFE_SB_INVALID_MSG_ID;
 
     /*
      * Test Case For:
-     * void SAMPLE_APP_Main( void )
+     * void I2C_APP_Main( void )
      */
 
     UT_CheckEvent_t EventTest;
 
     /*
-     * SAMPLE_APP_Main does not return a value,
+     * I2C_APP_Main does not return a value,
      * but it has several internal decision points
      * that need to be exercised here.
      *
      * First call it in "nominal" mode where all
      * dependent calls should be successful by default.
      */
-    SAMPLE_APP_Main();
+    I2C_APP_Main();
 
     /*
      * Confirm that CFE_ES_ExitApp() was called at the end of execution
@@ -171,7 +170,7 @@ void Test_SAMPLE_APP_Main(void)
 
     /*
      * Now set up individual cases for each of the error paths.
-     * The first is for SAMPLE_APP_Init().  As this is in the same
+     * The first is for I2C_APP_Init().  As this is in the same
      * code unit, it is not a stub where the return code can be
      * easily set.  In order to get this to fail, an underlying
      * call needs to fail, and the error gets propagated through.
@@ -184,15 +183,15 @@ void Test_SAMPLE_APP_Main(void)
      * Just call the function again.  It does not return
      * the value, so there is nothing to test for here directly.
      * However, it should show up in the coverage report that
-     * the SAMPLE_APP_Init() failure path was taken.
+     * the I2C_APP_Init() failure path was taken.
      */
-    SAMPLE_APP_Main();
+    I2C_APP_Main();
 
     /*
      * This can validate that the internal "RunStatus" was
      * set to CFE_ES_RunStatus_APP_ERROR, by querying the struct directly.
      */
-    UtAssert_UINT32_EQ(SAMPLE_APP_Data.RunStatus, CFE_ES_RunStatus_APP_ERROR);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RunStatus, CFE_ES_RunStatus_APP_ERROR);
 
     /*
      * Note that CFE_ES_RunLoop returns a boolean value,
@@ -208,15 +207,19 @@ void Test_SAMPLE_APP_Main(void)
     /* Set up buffer for command processing */
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
 
+    /* nothing on the e-stop pipe */
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_ReceiveBuffer), 2, CFE_SB_NO_MESSAGE);
+
     /*
      * Invoke again
      */
-    SAMPLE_APP_Main();
+    I2C_APP_Main();
 
     /*
-     * Confirm that CFE_SB_ReceiveBuffer() (inside the loop) was called
+     * Confirm that CFE_SB_ReceiveBuffer() (inside the loop) was called,
+     * once for the command pipe and once for the e-stop pipe
      */
-    UtAssert_STUB_COUNT(CFE_SB_ReceiveBuffer, 1);
+    UtAssert_STUB_COUNT(CFE_SB_ReceiveBuffer, 2);
 
     /*
      * Now also make the CFE_SB_ReceiveBuffer call fail,
@@ -225,12 +228,12 @@ void Test_SAMPLE_APP_Main(void)
      */
     UT_SetDeferredRetcode(UT_KEY(CFE_ES_RunLoop), 1, true);
     UT_SetDeferredRetcode(UT_KEY(CFE_SB_ReceiveBuffer), 1, CFE_SB_PIPE_RD_ERR);
-    UT_CHECKEVENT_SETUP(&EventTest, SAMPLE_APP_PIPE_ERR_EID, "SAMPLE APP: SB Pipe Read Error, App Will Exit");
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_PIPE_ERR_EID, "I2C APP: SB Pipe Read Error, App Will Exit");
 
     /*
      * Invoke again
      */
-    SAMPLE_APP_Main();
+    I2C_APP_Main();
 
     /*
      * Confirm that the event was generated
@@ -238,52 +241,845 @@ void Test_SAMPLE_APP_Main(void)
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
 }
 
-void Test_SAMPLE_APP_Init(void)
+void Test_I2C_APP_Init(void)
 {
     /*
      * Test Case For:
-     * int32 SAMPLE_APP_Init( void )
+     * int32 I2C_APP_Init( void )
      */
 
     /* nominal case should return CFE_SUCCESS */
-    UtAssert_INT32_EQ(SAMPLE_APP_Init(), CFE_SUCCESS);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
 
     /* trigger a failure for each of the sub-calls,
      * and confirm a write to syslog for each.
      * Note that this count accumulates, because the status
      * is _not_ reset between these test cases. */
     UT_SetDeferredRetcode(UT_KEY(CFE_EVS_Register), 1, CFE_EVS_INVALID_PARAMETER);
-    UtAssert_INT32_EQ(SAMPLE_APP_Init(), CFE_EVS_INVALID_PARAMETER);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_EVS_INVALID_PARAMETER);
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 1);
 
     UT_SetDeferredRetcode(UT_KEY(CFE_SB_CreatePipe), 1, CFE_SB_BAD_ARGUMENT);
-    UtAssert_INT32_EQ(SAMPLE_APP_Init(), CFE_SB_BAD_ARGUMENT);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SB_BAD_ARGUMENT);
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 2);
 
     UT_SetDeferredRetcode(UT_KEY(CFE_SB_Subscribe), 1, CFE_SB_BAD_ARGUMENT);
-    UtAssert_INT32_EQ(SAMPLE_APP_Init(), CFE_SB_BAD_ARGUMENT);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SB_BAD_ARGUMENT);
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 3);
 
     UT_SetDeferredRetcode(UT_KEY(CFE_SB_Subscribe), 2, CFE_SB_BAD_ARGUMENT);
-    UtAssert_INT32_EQ(SAMPLE_APP_Init(), CFE_SB_BAD_ARGUMENT);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SB_BAD_ARGUMENT);
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 4);
 
-    UT_SetDeferredRetcode(UT_KEY(CFE_TBL_Register), 1, CFE_TBL_ERR_INVALID_OPTIONS);
-    UtAssert_INT32_EQ(SAMPLE_APP_Init(), CFE_TBL_ERR_INVALID_OPTIONS);
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_Subscribe), 3, CFE_SB_BAD_ARGUMENT);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SB_BAD_ARGUMENT);
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 5);
+
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_CreatePipe), 2, CFE_SB_BAD_ARGUMENT);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SB_BAD_ARGUMENT);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 6);
+
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_Subscribe), 4, CFE_SB_BAD_ARGUMENT);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SB_BAD_ARGUMENT);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 7);
+
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_Subscribe), 5, CFE_SB_BAD_ARGUMENT);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SB_BAD_ARGUMENT);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 8);
+
+    UT_SetDeferredRetcode(UT_KEY(CFE_TBL_Register), 1, CFE_TBL_ERR_INVALID_OPTIONS);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_TBL_ERR_INVALID_OPTIONS);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 9);
+}
+
+void Test_I2C_APP_Init_BusFailure(void)
+{
+    /*
+     * Test Case For:
+     * int32 I2C_APP_Init( void ), with no I2C bus present
+     */
+    UT_CheckEvent_t EventTest;
+
+    /*
+     * A missing bus is reported but does not stop the app from
+     * coming up, so it can still answer HK and ground commands.
+     */
+    UT_SetDefaultReturnValue(UT_KEY(OCS_open), -1);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_STARTUP_INF_EID, "I2C App: Error opening I2C bus, RC = 0x%08lX");
+
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+}
+
+/*
+ * Hook to capture the slave address handed to ioctl(I2C_SLAVE)
+ */
+static int32 UT_IoctlCapture_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    *(unsigned long *)UserObj = UT_Hook_GetArgValueByName(Context, "arg", unsigned long);
+
+    return StubRetcode;
+}
+
+void Test_I2C_APP_Startup(void)
+{
+    /*
+     * Test Case For:
+     * int32 I2C_APP_Init( void ), startup phases and fast boot
+     * void I2C_APP_StartBus( void )
+     * void I2C_APP_BusStartTask( void )
+     */
+    I2C_APP_CdsState_t      State;
+    CFE_MSG_CommandHeader_t HkReq;
+    UT_CheckEvent_t         EventTest;
+    OS_time_t               Now[9];
+    I2C_APP_Table_t         Table = UT_I2C_APP_DEFAULT_TABLE;
+    I2C_APP_Table_t         Moved;
+    I2C_APP_Table_t        *TablePtr;
+    unsigned long           Address = 0;
+    uint32                  i;
+
+    static const int64 At[9] = {0, 100, 150, 250, 1250, 1350, 1850, 1950, 2050};
+
+    memset(&HkReq, 0, sizeof(HkReq));
+
+    /*
+     * Fast boot: the child task runs to the end while the pipes are set
+     * up (see UT_ChildTask_Hook), and a robot that answers right away is
+     * not waited for.  The times are: start, ends of the event setup and
+     * of the CDS, the child's probe start and end, then the ends of the SB
+     * and table setup, of the wait for the child and of the table apply.
+     */
+    for (i = 0; i < 9; ++i)
+    {
+        Now[i] = OS_TimeFromTotalMicroseconds(1000000 + At[i]);
+    }
+    UT_SetDataBuffer(UT_KEY(OS_GetLocalTime), Now, sizeof(Now), false);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_STARTUP_INF_EID,
+                        "I2C App: started in %lu us (evs %lu, sb %lu, tbl %lu, cds %lu, bus %lu)%s");
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.FastBoot);
+    UtAssert_STUB_COUNT(CFE_ES_CreateChildTask, 1);
+    UtAssert_STUB_COUNT(OS_BinSemGive, 1);
+    UtAssert_STUB_COUNT(OS_BinSemTake, 1);
+    UtAssert_STUB_COUNT(OS_BinSemDelete, 1);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 0);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+    UtAssert_UINT32_EQ(I2C_APP_Data.StartupPhaseUs[I2C_APP_STARTUP_EVS], 100);
+    UtAssert_UINT32_EQ(I2C_APP_Data.StartupPhaseUs[I2C_APP_STARTUP_SB], 1200);
+    UtAssert_UINT32_EQ(I2C_APP_Data.StartupPhaseUs[I2C_APP_STARTUP_TBL], 600);
+    UtAssert_UINT32_EQ(I2C_APP_Data.StartupPhaseUs[I2C_APP_STARTUP_BUS], 100);
+    UtAssert_UINT32_EQ(I2C_APP_Data.StartupPhaseUs[I2C_APP_STARTUP_CDS], 50);
+    UtAssert_UINT32_EQ(I2C_APP_Data.StartupUs, 2050);
+    UtAssert_UINT32_EQ(I2C_APP_Data.BusProbeUs, 1000);
+    UtAssert_UINT32_EQ(I2C_APP_Data.FirstTlmUs, 0);
+
+    /* the first telemetry sent is timed from the start, once */
+    Now[0] = OS_TimeFromTotalMicroseconds(1000000 + 20000);
+    Now[1] = OS_TimeFromTotalMicroseconds(1000000 + 40000);
+    UT_SetDataBuffer(UT_KEY(OS_GetLocalTime), Now, 2 * sizeof(Now[0]), false);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_STARTUP_INF_EID, "I2C App: first robot telemetry %lu us after startup");
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitBuffer, 2);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.FirstTlmUs, 20000);
+
+    /* all of it in housekeeping */
+    I2C_APP_ReportHousekeeping(&HkReq);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.StartupUs, 2050);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.StartupPhaseUs[I2C_APP_STARTUP_SB], 1200);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.BusProbeUs, 1000);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.FirstTlmUs, 20000);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.StartupFlags, I2C_APP_STARTUP_FAST_BOOT);
+
+    /* a robot still settling is read again until it answers */
+    UT_ResetState(UT_KEY(OS_GetLocalTime));
+    UT_SetDeferredRetcode(UT_KEY(OCS_write), 1, -1);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 1);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+
+    /* one that never answers costs the settle time and no more */
+    UT_SetDefaultReturnValue(UT_KEY(OCS_write), -1);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_IDENT_INF_EID,
+                        "I2C: identity read failed, using protocol v1 transfers, RC = 0x%08lX");
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 1 + I2C_APP_SETTLE_MS / I2C_APP_PROBE_RETRY_MS);
+    UT_ClearDefaultReturnValue(UT_KEY(OCS_write));
+
+    /* without the child task the start is serial, settle delay and all */
+    UT_SetDeferredRetcode(UT_KEY(CFE_ES_CreateChildTask), 1, CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_STARTUP_INF_EID,
+                        "I2C App: fast boot unavailable, starting the bus serially, RC = 0x%08lX");
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.FastBoot);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 2 + I2C_APP_SETTLE_MS / I2C_APP_PROBE_RETRY_MS);
+    UtAssert_STUB_COUNT(OS_BinSemTake, 3);
+    UtAssert_STUB_COUNT(OS_BinSemDelete, 4);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+
+    UT_SetDeferredRetcode(UT_KEY(OS_BinSemCreate), 1, OS_ERROR);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.FastBoot);
+    UtAssert_STUB_COUNT(CFE_ES_CreateChildTask, 4);
+
+    /*
+     * A warm restart after a fast boot keeps the move, the odometry and
+     * the robot's identity, and the child task only opens the bus: no
+     * identity probe, and no echo read to overwrite the saved command
+     */
+    memset(&State, 0, sizeof(State));
+    State.Signature             = I2C_APP_CDS_SIGNATURE;
+    State.OdomLeft              = 42;
+    State.RobotCmd.left_dist    = 123;
+    State.RobotIdent.magic      = ROMI_IDENT_MAGIC;
+    State.RobotIdent.features   = ROMI_FEATURE_COMBINED_XFER;
+    UT_ResetState(UT_KEY(OCS_write));
+    UT_ResetState(UT_KEY(OCS_read));
+    UT_SetDeferredRetcode(UT_KEY(CFE_ES_RegisterCDS), 1, CFE_ES_CDS_ALREADY_EXISTS);
+    UT_SetDataBuffer(UT_KEY(CFE_ES_RestoreFromCDS), &State, sizeof(State), false);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.FastBoot);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.WarmStart);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+    UtAssert_STUB_COUNT(OCS_write, 0);
+    UtAssert_STUB_COUNT(OCS_read, 0);
+    UtAssert_INT32_EQ(I2C_APP_Data.OdomLeft, 42);
+    UtAssert_INT32_EQ(I2C_APP_Data.RobotCmd.left_dist, 123);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotIdent.magic, ROMI_IDENT_MAGIC);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotFeatures, ROMI_FEATURE_COMBINED_XFER);
+    I2C_APP_ReportHousekeeping(&HkReq);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.StartupFlags,
+                       I2C_APP_STARTUP_FAST_BOOT | I2C_APP_STARTUP_WARM);
+
+    /*
+     * A serial start with a table that moves the robot: the table load
+     * does not connect ahead of the settle time, and the bus start opens
+     * the new device once, so exactly one descriptor is left open.
+     */
+    Moved                    = Table;
+    Moved.Devices[0].BusNum  = 1;
+    Moved.Devices[0].Address = 0x10;
+    Moved.Discover           = 0;
+    TablePtr                 = &Moved;
+    UT_ResetState(0);
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TablePtr, sizeof(TablePtr), false);
+    UT_SetDefaultReturnValue(UT_KEY(CFE_ES_CreateChildTask), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UT_SetHookFunction(UT_KEY(OCS_ioctl), UT_IoctlCapture_Hook, &Address);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.FastBoot);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.BusStarted);
+    UtAssert_STUB_COUNT(OCS_open, 1);
+    UtAssert_STUB_COUNT(OCS_ioctl, 1);
+    UtAssert_STUB_COUNT(OCS_close, 0);
+    UtAssert_UINT32_EQ(Address, 0x10);
+    UtAssert_UINT32_EQ(I2C_APP_Data.BusNum, 1);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+
+    /* back on the default table for the tests after this one */
+    UT_ClearDefaultReturnValue(UT_KEY(CFE_ES_CreateChildTask));
+    TablePtr = &Table;
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(I2C_APP_Data.BusNum, Table.Devices[0].BusNum);
+}
+
+void Test_I2C_OPEN_BUS(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t I2C_OPEN_BUS(int bus_num, int address, int* fd)
+     */
+    int           fd      = -1;
+    unsigned long Address = 0;
+
+    UT_SetHookFunction(UT_KEY(OCS_ioctl), UT_IoctlCapture_Hook, &Address);
+
+    /* nominal: bus opened and the robot's slave address selected */
+    UtAssert_INT32_EQ(I2C_OPEN_BUS(2, I2C_ADDRESS, &fd), CFE_SUCCESS);
+    UtAssert_INT32_EQ(fd, 3);
+    UtAssert_STUB_COUNT(OCS_open, 1);
+    UtAssert_STUB_COUNT(OCS_ioctl, 1);
+    UtAssert_STUB_COUNT(OCS_close, 0);
+    UtAssert_UINT32_EQ(Address, I2C_ADDRESS);
+
+    /* open failure */
+    UT_SetDeferredRetcode(UT_KEY(OCS_open), 1, -1);
+    UtAssert_INT32_EQ(I2C_OPEN_BUS(2, I2C_ADDRESS, &fd), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(OCS_ioctl, 1);
+
+    /* slave address selection failure closes the descriptor again */
+    UT_SetDeferredRetcode(UT_KEY(OCS_ioctl), 1, -1);
+    UtAssert_INT32_EQ(I2C_OPEN_BUS(2, I2C_ADDRESS, &fd), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(OCS_close, 1);
+    UtAssert_INT32_EQ(fd, -1);
+}
+
+/*
+ * Hook to capture the bytes handed to write()
+ */
+typedef struct
+{
+    size_t Length;
+    uint8  Data[I2C_PACKET_SIZE + 1];
+} UT_WriteCapture_t;
+
+static int32 UT_WriteCapture_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    UT_WriteCapture_t *Capture = UserObj;
+    const void *       Buf     = UT_Hook_GetArgValueByName(Context, "buf", const void *);
+    size_t             Count   = UT_Hook_GetArgValueByName(Context, "count", size_t);
+
+    Capture->Length = Count;
+    if (Count > sizeof(Capture->Data))
+    {
+        Count = sizeof(Capture->Data);
+    }
+    memcpy(Capture->Data, Buf, Count);
+
+    return StubRetcode;
+}
+
+void Test_I2C_APP_Send(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t I2C_APP_Send(int fd, I2C_Command_Packet* packet)
+     */
+    I2C_Command_Packet Packet;
+    UT_WriteCapture_t  Capture;
+
+    memset(&Packet, 0, sizeof(Packet));
+    memset(&Capture, 0, sizeof(Capture));
+    Packet.left_speed  = 0x1234;
+    Packet.right_speed = 0x0056;
+
+    UT_SetHookFunction(UT_KEY(OCS_write), UT_WriteCapture_Hook, &Capture);
+
+    UtAssert_INT32_EQ(I2C_APP_Send(3, &Packet), CFE_SUCCESS);
+
+    /* one write: register offset 0 followed by the command block */
+    UtAssert_STUB_COUNT(OCS_write, 1);
+    UtAssert_UINT32_EQ(Capture.Length, I2C_CMD_PACKET_SIZE + 1);
+    UtAssert_UINT32_EQ(Capture.Data[0], 0);
+    UtAssert_MemCmp(&Capture.Data[1], &Packet, I2C_CMD_PACKET_SIZE, "Command block follows the register offset");
+
+    /* the command path must not block */
+    UtAssert_UINT32_EQ(UT_PosixStubs_GetSleepCount(), 0);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 0);
+    UtAssert_STUB_COUNT(OCS_fsync, 0);
+
+    /* short write is reported as a failure */
+    UT_SetDeferredRetcode(UT_KEY(OCS_write), 1, 4);
+    UtAssert_INT32_EQ(I2C_APP_Send(3, &Packet), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+}
+
+void Test_I2C_APP_Receive(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t I2C_APP_Receive(int fd, I2C_Telem_Packet* telem)
+     */
+    I2C_Telem_Packet  Telem;
+    UT_WriteCapture_t Capture;
+    uint8             Block[I2C_TELEM_PACKET_SIZE];
+    uint32            i;
+
+    for (i = 0; i < sizeof(Block); ++i)
+    {
+        Block[i] = (uint8)(i + 1);
+    }
+    Block[ROMI_TELEM_BUTTON_A_OFFSET - ROMI_TELEM_OFFSET] = 1;
+    Block[ROMI_TELEM_BUTTON_B_OFFSET - ROMI_TELEM_OFFSET] = 0;
+    Block[ROMI_TELEM_BUTTON_C_OFFSET - ROMI_TELEM_OFFSET] = 1;
+    memset(&Telem, 0, sizeof(Telem));
+    memset(&Capture, 0, sizeof(Capture));
+
+    UT_SetHookFunction(UT_KEY(OCS_write), UT_WriteCapture_Hook, &Capture);
+    UT_SetDataBuffer(UT_KEY(OCS_read), Block, sizeof(Block), false);
+
+    /* register pointer set to the telemetry block, then the block read in one go */
+    UtAssert_INT32_EQ(I2C_APP_Receive(3, &Telem), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(Capture.Length, 1);
+    UtAssert_UINT32_EQ(Capture.Data[0], I2C_TELEM_OFFSET);
+    UtAssert_STUB_COUNT(OCS_read, 1);
+    UtAssert_MemCmp(&Telem, Block, I2C_TELEM_PACKET_SIZE, "Telemetry block copied out");
+
+    /* fields are decoded little-endian whatever the host byte order */
+    UtAssert_INT32_EQ(Telem.l_enc, 0x0201);
+    UtAssert_INT32_EQ(Telem.set_right_speed, 0x1413);
+    UtAssert_UINT32_EQ(Telem.batteryMillivolts, 0x1615);
+    UtAssert_BOOL_TRUE(Telem.button_A);
+    UtAssert_BOOL_FALSE(Telem.button_B);
+    UtAssert_BOOL_TRUE(Telem.button_C);
+    UtAssert_UINT32_EQ(UT_PosixStubs_GetSleepCount(), 0);
+
+    /* either half failing is reported */
+    UT_SetDeferredRetcode(UT_KEY(OCS_write), 1, -1);
+    UtAssert_INT32_EQ(I2C_APP_Receive(3, &Telem), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UT_SetDeferredRetcode(UT_KEY(OCS_read), 1, 3);
+    UtAssert_INT32_EQ(I2C_APP_Receive(3, &Telem), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+}
+
+/*
+ * Hook standing in for the robot on an I2C_RDWR ioctl: checks the shape
+ * of the combined transfer and answers the read half from UserObj
+ */
+typedef struct
+{
+    uint8  Offset;
+    uint16 Address;
+    uint8  Regs[ROMI_DATA_SIZE];
+} UT_RdwrCapture_t;
+
+static int32 UT_RdwrCapture_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    UT_RdwrCapture_t *                     Capture = UserObj;
+    const struct OCS_i2c_rdwr_ioctl_data *Xfer =
+        (const struct OCS_i2c_rdwr_ioctl_data *)UT_Hook_GetArgValueByName(Context, "arg", unsigned long);
+
+    if (StubRetcode != 0 || UT_Hook_GetArgValueByName(Context, "request", unsigned long) != OCS_I2C_RDWR ||
+        Xfer->nmsgs != 2 || Xfer->msgs[0].len != 1 || Xfer->msgs[1].flags != OCS_I2C_M_RD)
+    {
+        return -1;
+    }
+
+    Capture->Address = Xfer->msgs[0].addr;
+    Capture->Offset  = Xfer->msgs[0].buf[0];
+    memcpy(Xfer->msgs[1].buf, &Capture->Regs[Capture->Offset], Xfer->msgs[1].len);
+
+    return 2;
+}
+
+void Test_I2C_APP_ReadRegs(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t I2C_APP_ReadRegs(int fd, uint8 offset, uint8 *buf, size_t len)
+     */
+    UT_RdwrCapture_t Capture;
+    uint8            Buf[4];
+    uint32           i;
+
+    memset(&Capture, 0, sizeof(Capture));
+    for (i = 0; i < sizeof(Capture.Regs); ++i)
+    {
+        Capture.Regs[i] = (uint8)(0xA0 + i);
+    }
+    UT_SetHookFunction(UT_KEY(OCS_ioctl), UT_RdwrCapture_Hook, &Capture);
+
+    /* robot takes combined transfers: pointer write and read in one ioctl */
+    I2C_APP_Data.RobotFeatures = ROMI_FEATURE_COMBINED_XFER;
+    UtAssert_INT32_EQ(I2C_APP_ReadRegs(3, 10, Buf, sizeof(Buf)), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_ioctl, 1);
+    UtAssert_STUB_COUNT(OCS_write, 0);
+    UtAssert_STUB_COUNT(OCS_read, 0);
+    UtAssert_UINT32_EQ(Capture.Address, I2C_ADDRESS);
+    UtAssert_UINT32_EQ(Capture.Offset, 10);
+    UtAssert_MemCmp(Buf, &Capture.Regs[10], sizeof(Buf), "Registers read back");
+
+    UT_SetDeferredRetcode(UT_KEY(OCS_ioctl), 1, -1);
+    UtAssert_INT32_EQ(I2C_APP_ReadRegs(3, 10, Buf, sizeof(Buf)), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+
+    /* protocol v1 robot: separate write and read */
+    I2C_APP_Data.RobotFeatures = 0;
+    UT_SetDefaultReturnValue(UT_KEY(OCS_write), 1);
+    UT_SetDefaultReturnValue(UT_KEY(OCS_read), sizeof(Buf));
+    UtAssert_INT32_EQ(I2C_APP_ReadRegs(3, 10, Buf, sizeof(Buf)), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_ioctl, 2);
+    UtAssert_STUB_COUNT(OCS_write, 1);
+    UtAssert_STUB_COUNT(OCS_read, 1);
+}
+
+void Test_I2C_APP_Identify(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t I2C_APP_Identify(int fd)
+     */
+    I2C_Ident_Packet Ident;
+    uint8            Block[ROMI_IDENT_SIZE];
+    UT_CheckEvent_t  EventTest;
+
+    memset(&Ident, 0, sizeof(Ident));
+    Ident.magic            = ROMI_IDENT_MAGIC;
+    Ident.protocol_version = ROMI_PROTOCOL_VERSION;
+    Ident.data_size        = ROMI_DATA_SIZE;
+    Ident.features         = ROMI_FEATURE_COMBINED_XFER | 0x8000;
+    Ident.build_id         = 0x12345678;
+    romi_ident_pack(Block, &Ident);
+
+    /* current firmware: read the v1 way, known features taken up */
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_IDENT_INF_EID, NULL);
+    UT_SetDefaultReturnValue(UT_KEY(OCS_write), 1);
+    UT_SetDataBuffer(UT_KEY(OCS_read), Block, sizeof(Block), false);
+    I2C_APP_Data.RobotFeatures = 0;
+    UtAssert_INT32_EQ(I2C_APP_Identify(3), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_ioctl, 0);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotFeatures, ROMI_FEATURE_COMBINED_XFER);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotIdent.build_id, 0x12345678);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+
+    /* and they show up in HK */
+    I2C_APP_ReportHousekeeping(NULL);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.RobotProtocolVersion, ROMI_PROTOCOL_VERSION);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.RobotFeatures, ROMI_FEATURE_COMBINED_XFER);
+
+    /* older firmware answers past its buffer with 0xFF */
+    memset(Block, 0xFF, sizeof(Block));
+    UT_SetDataBuffer(UT_KEY(OCS_read), Block, sizeof(Block), false);
+    UtAssert_INT32_EQ(I2C_APP_Identify(3), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotFeatures, 0);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotIdent.protocol_version, 0);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 2);
+
+    /* right magic but a buffer too short to hold the block */
+    Ident.data_size = ROMI_IDENT_OFFSET;
+    romi_ident_pack(Block, &Ident);
+    UT_SetDataBuffer(UT_KEY(OCS_read), Block, sizeof(Block), false);
+    UtAssert_INT32_EQ(I2C_APP_Identify(3), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotFeatures, 0);
+
+    /* bus failure leaves the v1 transfers in place */
+    I2C_APP_Data.RobotFeatures = ROMI_FEATURE_COMBINED_XFER;
+    UT_SetDeferredRetcode(UT_KEY(OCS_write), 1, -1);
+    UtAssert_INT32_NEQ(I2C_APP_Identify(3), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotFeatures, 0);
+}
+
+/*
+ * A bus with a robot at one address, the same on every adapter: reads
+ * after ioctl(I2C_SLAVE) selects that address return its identity block,
+ * and reads from any other address are not acknowledged
+ */
+typedef struct
+{
+    unsigned long Selected;
+    unsigned long RobotAt; /* 0 = no robot anywhere */
+    uint8         Block[ROMI_IDENT_SIZE];
+} UT_DiscoverBus_t;
+
+static int32 UT_DiscoverIoctl_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount,
+                                   const UT_StubContext_t *Context)
+{
+    ((UT_DiscoverBus_t *)UserObj)->Selected = UT_Hook_GetArgValueByName(Context, "arg", unsigned long);
+
+    return StubRetcode;
+}
+
+static int32 UT_DiscoverRead_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    UT_DiscoverBus_t *Bus   = UserObj;
+    void             *Buf   = UT_Hook_GetArgValueByName(Context, "buf", void *);
+    size_t            Count = UT_Hook_GetArgValueByName(Context, "count", size_t);
+
+    if (Bus->RobotAt == 0 || Bus->Selected != Bus->RobotAt)
+    {
+        return -1;
+    }
+    memcpy(Buf, Bus->Block, Count < sizeof(Bus->Block) ? Count : sizeof(Bus->Block));
+
+    return StubRetcode;
+}
+
+void Test_I2C_APP_Discover(void)
+{
+    /*
+     * Test Case For:
+     * void I2C_APP_Discover(void)
+     */
+    UT_DiscoverBus_t      Bus;
+    I2C_Ident_Packet      Ident;
+    I2C_APP_DeviceCache_t Written;
+    I2C_APP_DeviceCache_t Cache;
+    I2C_APP_Table_t       Table    = UT_I2C_APP_DEFAULT_TABLE;
+    I2C_APP_Table_t       Defaults = UT_I2C_APP_DEFAULT_TABLE;
+    I2C_APP_Table_t      *TablePtr = &Table;
+    UT_CheckEvent_t       EventTest;
+    uint32                Addresses = I2C_APP_TBL_MAX_ADDRESS - I2C_APP_TBL_MIN_ADDRESS + 1;
+
+    memset(&Ident, 0, sizeof(Ident));
+    Ident.magic     = ROMI_IDENT_MAGIC;
+    Ident.data_size = ROMI_DATA_SIZE;
+    memset(&Bus, 0, sizeof(Bus));
+    Bus.RobotAt = I2C_ADDRESS;
+    romi_ident_pack(Bus.Block, &Ident);
+    UT_SetHookFunction(UT_KEY(OCS_ioctl), UT_DiscoverIoctl_Hook, &Bus);
+    UT_SetHookFunction(UT_KEY(OCS_read), UT_DiscoverRead_Hook, &Bus);
+
+    /* buses 2 and 1 are configured, bus 2 twice */
+    Table.Discover              = 1;
+    Table.NumDevices            = 3;
+    Table.Devices[0].BusNum     = 2;
+    Table.Devices[1].BusNum     = 1;
+    Table.Devices[1].Address    = 0x20;
+    Table.Devices[2].BusNum     = 2;
+    Table.Devices[2].Address    = 0x21;
+    I2C_APP_Data.Config         = Table;
+    I2C_APP_Data.DeviceIndex    = 0;
+    I2C_APP_Data.NumDiscovered  = 0;
+
+    /*
+     * No cache: the configured buses alone are scanned, lowest first, and
+     * only the address that answers a read is written to.  What is found
+     * goes ahead of the configured devices and into the cache.
+     */
+    UT_SetDataBuffer(UT_KEY(OS_write), &Written, sizeof(Written), false);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_DISCOVER_INF_EID, "I2C: %u robot(s) %s, first on bus %u at 0x%02X");
+    I2C_APP_Discover();
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.DiscoverFlags, I2C_APP_STARTUP_SCANNED);
+    UtAssert_STUB_COUNT(OCS_open, 2);
+    UtAssert_STUB_COUNT(OCS_close, 2);
+    UtAssert_STUB_COUNT(OCS_ioctl, 2 * Addresses);
+    UtAssert_STUB_COUNT(OCS_read, 2 * Addresses + 2);
+    UtAssert_STUB_COUNT(OCS_write, 2);
+    UtAssert_UINT32_EQ(I2C_APP_Data.NumDiscovered, 2);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.NumDevices, 4);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.Devices[0].BusNum, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.Devices[0].Address, I2C_ADDRESS);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.Devices[1].BusNum, 2);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.Devices[2].Address, 0x20);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.Devices[3].Address, 0x21);
+    UtAssert_STUB_COUNT(OS_write, 1);
+    UtAssert_UINT32_EQ(Written.Signature, I2C_APP_DEVICE_CACHE_SIGNATURE);
+    UtAssert_UINT32_EQ(Written.NumDevices, 2);
+
+    /* the table, reloaded as it was, keeps them first and the connection where it is */
+    I2C_APP_Data.i2c_fd = 3;
+    I2C_APP_ApplyConfig(&Table);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.NumDevices, 4);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+
+    /* the next start finds both where the cache says, without a scan */
+    Cache = Written;
+    UT_ResetState(UT_KEY(OCS_ioctl));
+    UT_SetHookFunction(UT_KEY(OCS_ioctl), UT_DiscoverIoctl_Hook, &Bus);
+    UT_SetDataBuffer(UT_KEY(OS_read), &Cache, sizeof(Cache), false);
+    I2C_APP_Data.Config = Table;
+    I2C_APP_Discover();
+    UtAssert_UINT32_EQ(I2C_APP_Data.DiscoverFlags, I2C_APP_STARTUP_CACHED);
+    UtAssert_STUB_COUNT(OCS_ioctl, 2);
+    UtAssert_STUB_COUNT(OS_write, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.NumDevices, 4);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 2);
+
+    /* moved to another address: the cached one does not answer, so scan again */
+    Bus.RobotAt = I2C_ADDRESS + 1;
+    UT_SetDataBuffer(UT_KEY(OS_read), &Cache, sizeof(Cache), false);
+    I2C_APP_Data.Config = Table;
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_DISCOVER_INF_EID, "I2C: no robot at cached bus %u address 0x%02X, scanning");
+    I2C_APP_Discover();
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.DiscoverFlags, I2C_APP_STARTUP_SCANNED);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Discovered[0].Address, I2C_ADDRESS + 1);
+    UtAssert_STUB_COUNT(OS_write, 2);
+    UtAssert_UINT32_EQ(Written.Devices[1].Address, I2C_ADDRESS + 1);
+
+    /* nothing anywhere: nothing is written, the configured devices alone, and the cache kept */
+    Bus.RobotAt = 0;
+    UT_ResetState(UT_KEY(OCS_write));
+    I2C_APP_Data.Config      = Table;
+    I2C_APP_Data.DeviceIndex = 0;
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_DISCOVER_ERR_EID,
+                        "I2C: no robot found on the configured buses, trying the configured devices");
+    I2C_APP_Discover();
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_STUB_COUNT(OCS_write, 0);
+    UtAssert_UINT32_EQ(I2C_APP_Data.NumDiscovered, 0);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.NumDevices, 3);
+    UtAssert_STUB_COUNT(OS_write, 2);
+
+    /* a cache from another layout, or with no devices, is not used */
+    Bus.RobotAt     = I2C_ADDRESS;
+    Cache.Signature = 0;
+    UT_SetDataBuffer(UT_KEY(OS_read), &Cache, sizeof(Cache), false);
+    UtAssert_INT32_EQ(I2C_APP_ReadDeviceCache(&Cache), CFE_STATUS_VALIDATION_FAILURE);
+    Cache.Signature  = I2C_APP_DEVICE_CACHE_SIGNATURE;
+    Cache.NumDevices = 0;
+    UT_SetDataBuffer(UT_KEY(OS_read), &Cache, sizeof(Cache), false);
+    UtAssert_INT32_EQ(I2C_APP_ReadDeviceCache(&Cache), CFE_STATUS_VALIDATION_FAILURE);
+    UT_SetDeferredRetcode(UT_KEY(OS_OpenCreate), 1, OS_ERROR);
+    UtAssert_INT32_EQ(I2C_APP_ReadDeviceCache(&Cache), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+
+    /* a cache that cannot be written only costs a scan next time */
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_DISCOVER_ERR_EID,
+                        "I2C: could not write %s, the next start scans again, RC = %ld");
+    I2C_APP_Data.NumDiscovered = 1;
+    UT_SetDeferredRetcode(UT_KEY(OS_OpenCreate), 1, OS_ERROR);
+    I2C_APP_WriteDeviceCache();
+    UT_SetDeferredRetcode(UT_KEY(OS_write), 1, 0);
+    I2C_APP_WriteDeviceCache();
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 2);
+
+    /* an adapter that does not open: nothing found there */
+    I2C_APP_Data.NumDiscovered = 0;
+    UT_SetDefaultReturnValue(UT_KEY(OCS_open), -1);
+    I2C_APP_ScanBuses();
+    UtAssert_UINT32_EQ(I2C_APP_Data.NumDiscovered, 0);
+    UtAssert_BOOL_FALSE(I2C_APP_ProbeDevice(&Table.Devices[0]));
+    UT_ClearDefaultReturnValue(UT_KEY(OCS_open));
+
+    /* the scan stops once the device list is full */
+    Bus.RobotAt = I2C_APP_TBL_MIN_ADDRESS;
+    I2C_APP_Data.NumDiscovered = I2C_APP_TBL_MAX_DEVICES - 1;
+    UT_ResetState(UT_KEY(OCS_ioctl));
+    UT_SetHookFunction(UT_KEY(OCS_ioctl), UT_DiscoverIoctl_Hook, &Bus);
+    I2C_APP_ScanBuses();
+    UtAssert_UINT32_EQ(I2C_APP_Data.NumDiscovered, I2C_APP_TBL_MAX_DEVICES);
+    UtAssert_STUB_COUNT(OCS_ioctl, 1);
+    I2C_APP_AddDiscovered(3, I2C_ADDRESS);
+    UtAssert_UINT32_EQ(I2C_APP_Data.NumDiscovered, I2C_APP_TBL_MAX_DEVICES);
+
+    /* merged lists are capped, and a table without Discover is taken as it is */
+    I2C_APP_Data.Config = Table;
+    I2C_APP_MergeDevices(&I2C_APP_Data.Config);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.NumDevices, I2C_APP_TBL_MAX_DEVICES);
+    Table.Discover = 0;
+    I2C_APP_ApplyConfig(&Table);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.NumDevices, 3);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.Devices[0].BusNum, 2);
+
+    /*
+     * A fast boot starts the bus on the built-in configuration, which does
+     * not discover.  A table that does gets its scan once the child task
+     * is back, and the connection moves to the robot it found.
+     */
+    Table                    = Defaults;
+    Table.Discover           = 1;
+    Table.Devices[0].Address = 0x20;
+    Bus.RobotAt              = I2C_ADDRESS;
+    UT_ResetState(UT_KEY(OCS_ioctl));
+    UT_SetHookFunction(UT_KEY(OCS_ioctl), UT_DiscoverIoctl_Hook, &Bus);
+    UT_SetDeferredRetcode(UT_KEY(OS_OpenCreate), 1, OS_ERROR);
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TablePtr, sizeof(TablePtr), false);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.FastBoot);
+    UtAssert_UINT32_EQ(I2C_APP_Data.DiscoverFlags, I2C_APP_STARTUP_SCANNED);
+    UtAssert_STUB_COUNT(OCS_ioctl, 2 + Addresses);
+    UtAssert_UINT32_EQ(I2C_APP_Data.NumDiscovered, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.NumDevices, 2);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.Devices[0].Address, I2C_ADDRESS);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.Devices[1].Address, 0x20);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Address, I2C_ADDRESS);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+
+    /* that scan is done once: a reload of the same table does not repeat it */
+    I2C_APP_ApplyConfig(&Table);
+    UtAssert_STUB_COUNT(OCS_ioctl, 2 + Addresses);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.NumDevices, 2);
+
+    I2C_APP_Data.NumDiscovered = 0;
+    I2C_APP_Data.Config        = Defaults;
+}
+
+void Test_I2C_APP_SendCommand(void)
+{
+    /*
+     * Test Case For:
+     * CFE_Status_t I2C_APP_SendCommand(I2C_Command_Packet* packet)
+     */
+    I2C_Command_Packet Packet;
+    UT_CheckEvent_t    ErrEvent;
+    UT_CheckEvent_t    InfEvent;
+
+    memset(&Packet, 0, sizeof(Packet));
+    I2C_APP_Data.BusNum             = I2C_APP_BUS_NUM;
+    I2C_APP_Data.i2c_fd             = 3;
+    I2C_APP_Data.BusFaulted         = false;
+    I2C_APP_Data.BusErrCounter      = 0;
+    I2C_APP_Data.BusRecoveryCounter = 0;
+
+    /* nominal: written on the existing connection, nothing reopened */
+    UtAssert_INT32_EQ(I2C_APP_SendCommand(&Packet), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_open, 0);
+    UtAssert_STUB_COUNT(OCS_write, 1);
+
+    /* failed write: connection is closed and invalidated, not left dangling */
+    UT_CHECKEVENT_SETUP(&ErrEvent, I2C_APP_BUS_ERR_EID, NULL);
+    UT_SetDeferredRetcode(UT_KEY(OCS_write), 1, -1);
+    UtAssert_INT32_EQ(I2C_APP_SendCommand(&Packet), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(OCS_close, 1);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, -1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.BusErrCounter, 1);
+    UtAssert_UINT32_EQ(ErrEvent.MatchCount, 1);
+
+    /* bus still down: the reopen failure is counted but raises no new event */
+    UT_SetDeferredRetcode(UT_KEY(OCS_open), 1, -1);
+    UtAssert_INT32_EQ(I2C_APP_SendCommand(&Packet), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(OCS_write, 2);
+    UtAssert_UINT32_EQ(I2C_APP_Data.BusErrCounter, 2);
+    UtAssert_UINT32_EQ(ErrEvent.MatchCount, 1);
+
+    /* bus back: the next command reopens it without blocking and reports recovery once */
+    UT_CHECKEVENT_SETUP(&InfEvent, I2C_APP_BUS_INF_EID, NULL);
+    UtAssert_INT32_EQ(I2C_APP_SendCommand(&Packet), CFE_SUCCESS);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+    UtAssert_UINT32_EQ(I2C_APP_Data.BusRecoveryCounter, 1);
+    UtAssert_UINT32_EQ(InfEvent.MatchCount, 1);
+    UtAssert_STUB_COUNT(OCS_write, 3);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 0);
+
+    UtAssert_INT32_EQ(I2C_APP_SendCommand(&Packet), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(I2C_APP_Data.BusRecoveryCounter, 1);
+    UtAssert_UINT32_EQ(InfEvent.MatchCount, 1);
 }
 
-void Test_SAMPLE_APP_ProcessCommandPacket(void)
+void Test_I2C_APP_CommandPathBudget(void)
 {
     /*
      * Test Case For:
-     * void SAMPLE_APP_ProcessCommandPacket
+     * The full ground command path for a motion command, from the
+     * software bus buffer through to the bus write.
+     */
+    union
+    {
+        CFE_SB_Buffer_t             SBBuf;
+        I2C_APP_SetWheelSpeedsCmd_t Speeds;
+    } TestMsg;
+    CFE_SB_MsgId_t    TestMsgId = CFE_SB_ValueToMsgId(I2C_APP_CMD_MID);
+    CFE_MSG_FcnCode_t FcnCode   = I2C_APP_SET_WHEEL_SPEEDS_CC;
+    size_t            MsgSize   = sizeof(TestMsg.Speeds);
+    uint32            i;
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    TestMsg.Speeds.Payload.LeftSpeed  = 100;
+    TestMsg.Speeds.Payload.RightSpeed = -100;
+    I2C_APP_Data.i2c_fd = 3;
+
+    for (i = 0; i < 10; ++i)
+    {
+        UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
+        UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
+        UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &MsgSize, sizeof(MsgSize), false);
+        I2C_APP_ProcessCommandPacket(&TestMsg.SBBuf);
+    }
+
+    /* every command reached the bus */
+    UtAssert_STUB_COUNT(OCS_write, 10);
+
+    /* no blocking sleeps anywhere on the command path */
+    UtAssert_UINT32_EQ(UT_PosixStubs_GetSleepCount(), 0);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 0);
+
+    /* and the syscall cost per command stays within budget */
+    UtAssert_UINT32_LTEQ(UT_PosixStubs_GetSyscallCount(), 10 * UT_I2C_APP_CMD_SYSCALL_BUDGET);
+}
+
+void Test_I2C_APP_ProcessCommandPacket(void)
+{
+    /*
+     * Test Case For:
+     * void I2C_APP_ProcessCommandPacket
      */
     /* a buffer large enough for any command message */
     union
     {
         CFE_SB_Buffer_t      SBBuf;
-        SAMPLE_APP_NoopCmd_t Noop;
+        I2C_APP_NoopCmd_t Noop;
     } TestMsg;
     CFE_SB_MsgId_t    TestMsgId;
     CFE_MSG_FcnCode_t FcnCode;
@@ -291,28 +1087,28 @@ void Test_SAMPLE_APP_ProcessCommandPacket(void)
     UT_CheckEvent_t   EventTest;
 
     memset(&TestMsg, 0, sizeof(TestMsg));
-    UT_CHECKEVENT_SETUP(&EventTest, SAMPLE_APP_INVALID_MSGID_ERR_EID, "SAMPLE: invalid command packet,MID = 0x%x");
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_INVALID_MSGID_ERR_EID, "I2C: invalid command packet,MID = 0x%x");
 
     /*
      * The CFE_MSG_GetMsgId() stub uses a data buffer to hold the
      * message ID values to return.
      */
-    TestMsgId = CFE_SB_ValueToMsgId(SAMPLE_APP_CMD_MID);
-    FcnCode   = SAMPLE_APP_NOOP_CC;
+    TestMsgId = CFE_SB_ValueToMsgId(I2C_APP_CMD_MID);
+    FcnCode   = I2C_APP_NOOP_CC;
     MsgSize   = sizeof(TestMsg.Noop);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &MsgSize, sizeof(MsgSize), false);
-    SAMPLE_APP_ProcessCommandPacket(&TestMsg.SBBuf);
+    I2C_APP_ProcessCommandPacket(&TestMsg.SBBuf);
 
-    TestMsgId = CFE_SB_ValueToMsgId(SAMPLE_APP_SEND_HK_MID);
+    TestMsgId = CFE_SB_ValueToMsgId(I2C_APP_SEND_HK_MID);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
-    SAMPLE_APP_ProcessCommandPacket(&TestMsg.SBBuf);
+    I2C_APP_ProcessCommandPacket(&TestMsg.SBBuf);
 
     /* invalid message id */
     TestMsgId = CFE_SB_INVALID_MSG_ID;
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
-    SAMPLE_APP_ProcessCommandPacket(&TestMsg.SBBuf);
+    I2C_APP_ProcessCommandPacket(&TestMsg.SBBuf);
 
     /*
      * Confirm that the event was generated only _once_
@@ -320,11 +1116,11 @@ void Test_SAMPLE_APP_ProcessCommandPacket(void)
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
 }
 
-void Test_SAMPLE_APP_ProcessGroundCommand(void)
+void Test_I2C_APP_ProcessGroundCommand(void)
 {
     /*
      * Test Case For:
-     * void SAMPLE_APP_ProcessGroundCommand
+     * void I2C_APP_ProcessGroundCommand
      */
     CFE_MSG_FcnCode_t FcnCode;
     size_t            Size;
@@ -333,11 +1129,27 @@ void Test_SAMPLE_APP_ProcessGroundCommand(void)
     union
     {
         CFE_SB_Buffer_t               SBBuf;
-        SAMPLE_APP_NoopCmd_t          Noop;
-        SAMPLE_APP_ResetCountersCmd_t Reset;
-        SAMPLE_APP_ProcessCmd_t       Process;
+        I2C_APP_NoopCmd_t          Noop;
+        I2C_APP_ResetCountersCmd_t Reset;
+        I2C_APP_ReportConfigCmd_t  ReportConfig;
+        I2C_APP_SetWheelSpeedsCmd_t Speeds;
+        I2C_APP_DriveDistanceCmd_t  Drive;
+        I2C_APP_SpinCmd_t           Spin;
+        I2C_APP_SetLedsCmd_t        Leds;
+        I2C_APP_StopCmd_t           Stop;
+        I2C_APP_RunPathCmd_t        Path;
     } TestMsg;
     UT_CheckEvent_t EventTest;
+    struct
+    {
+        CFE_MSG_FcnCode_t FcnCode;
+        size_t            Size;
+    } Motion[] = {{I2C_APP_SET_WHEEL_SPEEDS_CC, sizeof(TestMsg.Speeds)},
+                  {I2C_APP_DRIVE_DISTANCE_CC, sizeof(TestMsg.Drive)},
+                  {I2C_APP_SPIN_CC, sizeof(TestMsg.Spin)},
+                  {I2C_APP_SET_LEDS_CC, sizeof(TestMsg.Leds)},
+                  {I2C_APP_STOP_CC, sizeof(TestMsg.Stop)}};
+    uint32 i;
 
     memset(&TestMsg, 0, sizeof(TestMsg));
 
@@ -351,43 +1163,80 @@ void Test_SAMPLE_APP_ProcessGroundCommand(void)
      */
 
     /* test dispatch of NOOP */
-    FcnCode = SAMPLE_APP_NOOP_CC;
+    FcnCode = I2C_APP_NOOP_CC;
     Size    = sizeof(TestMsg.Noop);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
-    UT_CHECKEVENT_SETUP(&EventTest, SAMPLE_APP_COMMANDNOP_INF_EID, NULL);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_COMMANDNOP_INF_EID, NULL);
 
-    SAMPLE_APP_ProcessGroundCommand(&TestMsg.SBBuf);
+    I2C_APP_ProcessGroundCommand(&TestMsg.SBBuf);
 
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
 
     /* test dispatch of RESET */
-    FcnCode = SAMPLE_APP_RESET_COUNTERS_CC;
+    FcnCode = I2C_APP_RESET_COUNTERS_CC;
     Size    = sizeof(TestMsg.Reset);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
-    UT_CHECKEVENT_SETUP(&EventTest, SAMPLE_APP_COMMANDRST_INF_EID, NULL);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_COMMANDRST_INF_EID, NULL);
 
-    SAMPLE_APP_ProcessGroundCommand(&TestMsg.SBBuf);
+    I2C_APP_ProcessGroundCommand(&TestMsg.SBBuf);
 
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
 
-    /* test dispatch of PROCESS */
-    /* note this will end up calling SAMPLE_APP_Process(), and as such it needs to
-     * avoid dereferencing a table which does not exist. */
-    FcnCode = SAMPLE_APP_PROCESS_CC;
-    Size    = sizeof(TestMsg.Process);
-    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
+    /* test dispatch of REPORT_CONFIG */
+    FcnCode = I2C_APP_REPORT_CONFIG_CC;
+    Size    = sizeof(TestMsg.ReportConfig);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
 
-    SAMPLE_APP_ProcessGroundCommand(&TestMsg.SBBuf);
+    I2C_APP_ProcessGroundCommand(&TestMsg.SBBuf);
+
+    /* test dispatch of each motion command: one bus write each, and a wrong length is refused */
+    I2C_APP_Data.i2c_fd = 3;
+    for (i = 0; i < sizeof(Motion) / sizeof(Motion[0]); ++i)
+    {
+        UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &Motion[i].FcnCode, sizeof(Motion[i].FcnCode), false);
+        UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Motion[i].Size, sizeof(Motion[i].Size), false);
+        UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_MOTION_DBG_EID, NULL);
+        I2C_APP_ProcessGroundCommand(&TestMsg.SBBuf);
+        UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+        UtAssert_STUB_COUNT(OCS_write, i + 1);
+
+        Size = Motion[i].Size + 2;
+        UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &Motion[i].FcnCode, sizeof(Motion[i].FcnCode), false);
+        UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+        UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_LEN_ERR_EID, NULL);
+        I2C_APP_ProcessGroundCommand(&TestMsg.SBBuf);
+        UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+        UtAssert_STUB_COUNT(OCS_write, i + 1);
+    }
+
+    /* test dispatch of RUN_PATH, sized by its segment count */
+    FcnCode                           = I2C_APP_RUN_PATH_CC;
+    Size                              = offsetof(I2C_APP_RunPathCmd_t, Payload.Segments[1]);
+    TestMsg.Path.Payload.NumSegments  = 1;
+    TestMsg.Path.Payload.Segments[0].Value = 50;
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_MOTION_DBG_EID, NULL);
+    I2C_APP_ProcessGroundCommand(&TestMsg.SBBuf);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_STUB_COUNT(OCS_write, i + 1);
+
+    Size = sizeof(TestMsg.Path);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_LEN_ERR_EID, NULL);
+    I2C_APP_ProcessGroundCommand(&TestMsg.SBBuf);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_STUB_COUNT(OCS_write, i + 1);
 
     /* test an invalid CC */
     FcnCode = 1000;
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
-    UT_CHECKEVENT_SETUP(&EventTest, SAMPLE_APP_COMMAND_ERR_EID, "Invalid ground command code: CC = %d");
-    SAMPLE_APP_ProcessGroundCommand(&TestMsg.SBBuf);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_COMMAND_ERR_EID, "Invalid ground command code: CC = %d");
+    I2C_APP_ProcessGroundCommand(&TestMsg.SBBuf);
 
     /*
      * Confirm that the event was generated only _once_
@@ -395,17 +1244,17 @@ void Test_SAMPLE_APP_ProcessGroundCommand(void)
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
 }
 
-void Test_SAMPLE_APP_ReportHousekeeping(void)
+void Test_I2C_APP_ReportHousekeeping(void)
 {
     /*
      * Test Case For:
-     * void SAMPLE_APP_ReportHousekeeping( const CFE_SB_CmdHdr_t *Msg )
+     * void I2C_APP_ReportHousekeeping( const CFE_SB_CmdHdr_t *Msg )
      */
     CFE_MSG_Message_t *MsgSend;
     CFE_MSG_Message_t *MsgTimestamp;
-    CFE_SB_MsgId_t     MsgId = CFE_SB_ValueToMsgId(SAMPLE_APP_SEND_HK_MID);
+    CFE_SB_MsgId_t     MsgId = CFE_SB_ValueToMsgId(I2C_APP_SEND_HK_MID);
 
-    /* Set message id to return so SAMPLE_APP_Housekeeping will be called */
+    /* Set message id to return so I2C_APP_Housekeeping will be called */
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
 
     /* Set up to capture send message address */
@@ -415,15 +1264,15 @@ void Test_SAMPLE_APP_ReportHousekeeping(void)
     UT_SetDataBuffer(UT_KEY(CFE_SB_TimeStampMsg), &MsgTimestamp, sizeof(MsgTimestamp), false);
 
     /* Call unit under test, NULL pointer confirms command access is through APIs */
-    SAMPLE_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
+    I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
 
     /* Confirm message sent*/
     UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 1);
-    UtAssert_ADDRESS_EQ(MsgSend, &SAMPLE_APP_Data.HkTlm);
+    UtAssert_ADDRESS_EQ(MsgSend, &I2C_APP_Data.HkTlm);
 
     /* Confirm timestamp msg address */
     UtAssert_STUB_COUNT(CFE_SB_TimeStampMsg, 1);
-    UtAssert_ADDRESS_EQ(MsgTimestamp, &SAMPLE_APP_Data.HkTlm);
+    UtAssert_ADDRESS_EQ(MsgTimestamp, &I2C_APP_Data.HkTlm);
 
     /*
      * Confirm that the CFE_TBL_Manage() call was done
@@ -431,92 +1280,672 @@ void Test_SAMPLE_APP_ReportHousekeeping(void)
     UtAssert_STUB_COUNT(CFE_TBL_Manage, 1);
 }
 
-void Test_SAMPLE_APP_NoopCmd(void)
+/*
+ * Hook to capture the robot telemetry handed to CFE_SB_TransmitBuffer()
+ */
+typedef struct
+{
+    const CFE_SB_Buffer_t *BufPtr;
+    I2C_APP_RobotTlm_t     Tlm;
+} UT_TlmCapture_t;
+
+static int32 UT_TlmCapture_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    UT_TlmCapture_t *Capture = UserObj;
+
+    Capture->BufPtr = UT_Hook_GetArgValueByName(Context, "BufPtr", const CFE_SB_Buffer_t *);
+    memcpy(&Capture->Tlm, Capture->BufPtr, sizeof(Capture->Tlm));
+
+    return StubRetcode;
+}
+
+void Test_I2C_APP_Wakeup(void)
 {
     /*
      * Test Case For:
-     * void SAMPLE_APP_NoopCmd( const SAMPLE_APP_Noop_t *Msg )
+     * int32 I2C_APP_Wakeup( const CFE_MSG_CommandHeader_t *Msg )
      */
-    SAMPLE_APP_NoopCmd_t TestMsg;
+    I2C_Command_Packet Packet;
+    UT_WriteCapture_t  Capture;
+    UT_TlmCapture_t    Sent;
+    OS_time_t          Wakeups[8];
+    uint8              Block[I2C_TELEM_PACKET_SIZE];
+    CFE_SB_MsgId_t     MsgId = CFE_SB_ValueToMsgId(I2C_APP_WAKEUP_MID);
+
+    memset(&Packet, 0, sizeof(Packet));
+    memset(&Capture, 0, sizeof(Capture));
+    memset(&Sent, 0, sizeof(Sent));
+    memset(Block, 0, sizeof(Block));
+    Block[ROMI_TELEM_BATTERYMILLIVOLTS_OFFSET - ROMI_TELEM_OFFSET] = 0x10;
+    Block[ROMI_TELEM_BATTERYMILLIVOLTS_OFFSET - ROMI_TELEM_OFFSET + 1] = 0x27;
+
+    /* one on time, one 150 us late, one 50 us early, then two on time */
+    Wakeups[0] = OS_TimeFromTotalMicroseconds(1000000);
+    Wakeups[1] = OS_TimeFromTotalMicroseconds(1000000 + I2C_APP_WAKEUP_PERIOD_US + 150);
+    Wakeups[2] = OS_TimeFromTotalMicroseconds(1000000 + 2 * I2C_APP_WAKEUP_PERIOD_US + 100);
+    Wakeups[3] = OS_TimeFromTotalMicroseconds(1000000 + 3 * I2C_APP_WAKEUP_PERIOD_US + 100);
+    Wakeups[4] = OS_TimeFromTotalMicroseconds(1000000 + 4 * I2C_APP_WAKEUP_PERIOD_US + 100);
+    Wakeups[5] = OS_TimeFromTotalMicroseconds(1000000 + 5 * I2C_APP_WAKEUP_PERIOD_US + 100);
+    Wakeups[6] = OS_TimeFromTotalMicroseconds(1000000 + 6 * I2C_APP_WAKEUP_PERIOD_US + 100);
+    Wakeups[7] = OS_TimeFromTotalMicroseconds(1000000 + 7 * I2C_APP_WAKEUP_PERIOD_US + 100);
+    UT_SetDataBuffer(UT_KEY(OS_GetLocalTime), Wakeups, sizeof(Wakeups), false);
+    UT_SetDataBuffer(UT_KEY(OCS_read), Block, sizeof(Block), false);
+    UT_SetHookFunction(UT_KEY(CFE_SB_TransmitBuffer), UT_TlmCapture_Hook, &Sent);
+
+    I2C_APP_Data.i2c_fd           = 3;
+    I2C_APP_Data.BusFaulted       = false;
+    I2C_APP_Data.CmdPending       = false;
+    I2C_APP_Data.CycleCounter     = 0;
+    I2C_APP_Data.ReopenHoldoff    = 0;
+    I2C_APP_Data.CyclePeriodUs    = 0;
+    I2C_APP_Data.CycleJitterMaxUs = 0;
+    I2C_APP_Data.RobotFeatures    = 0;
+    I2C_APP_Data.TlmDropCounter   = 0;
+
+    /* dispatched from the command pipe; NULL confirms access is through the APIs */
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
+    I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
+
+    /*
+     * nothing pending: one telemetry read, decoded into a buffer from the
+     * software bus and handed over in that buffer, with the cycle number
+     */
+    UtAssert_STUB_COUNT(OCS_write, 1);
+    UtAssert_STUB_COUNT(OCS_read, 1);
+    UtAssert_STUB_COUNT(CFE_SB_AllocateMessageBuffer, 1);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitBuffer, 1);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitMsg, 0);
+    UtAssert_STUB_COUNT(CFE_SB_ReleaseMessageBuffer, 0);
+    UtAssert_NOT_NULL(Sent.BufPtr);
+    UtAssert_UINT32_EQ(Sent.Tlm.Payload.CycleCounter, 1);
+    UtAssert_UINT32_EQ(Sent.Tlm.Payload.Telem.batteryMillivolts, 10000);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CyclePeriodUs, 0);
+
+    /* the period and the worst deviation from nominal are tracked */
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CyclePeriodUs, I2C_APP_WAKEUP_PERIOD_US + 150);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CycleJitterMaxUs, 150);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CyclePeriodUs, I2C_APP_WAKEUP_PERIOD_US - 50);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CycleJitterMaxUs, 150);
+
+    /* a command lost to a bus fault is kept for the next cycle */
+    UT_SetDeferredRetcode(UT_KEY(OCS_write), 1, -1);
+    Packet.left_speed = 0x55;
+    UtAssert_INT32_EQ(I2C_APP_SendCommand(&Packet), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.CmdPending);
+
+    /* bus still down: no read, nothing published, still pending */
+    UT_SetDeferredRetcode(UT_KEY(OCS_open), 1, -1);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(OCS_read, 3);
+    UtAssert_STUB_COUNT(CFE_SB_AllocateMessageBuffer, 3);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitBuffer, 3);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.CmdPending);
+
+    /* bus back: the command goes out ahead of the telemetry read */
+    UT_SetHookFunction(UT_KEY(OCS_write), UT_WriteCapture_Hook, &Capture);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.CmdPending);
+    UtAssert_STUB_COUNT(OCS_write, 6);
+    UtAssert_STUB_COUNT(OCS_read, 4);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitBuffer, 4);
+    UtAssert_UINT32_EQ(Sent.Tlm.Payload.CycleCounter, 5);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CycleJitterMaxUs, 150);
+
+    /* a failed read gives its buffer back */
+    UT_SetDeferredRetcode(UT_KEY(OCS_read), 1, -1);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(CFE_SB_ReleaseMessageBuffer, 1);
+    UtAssert_STUB_COUNT(CFE_SB_TransmitBuffer, 4);
+    UtAssert_UINT32_EQ(I2C_APP_Data.TlmDropCounter, 0);
+
+    /* no buffer to be had: the sample is not read, and counted as lost */
+    I2C_APP_Data.i2c_fd = 3;
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_AllocateMessageBuffer), 1, -1);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SB_BUF_ALOC_ERR);
+    UtAssert_STUB_COUNT(OCS_read, 5);
+    UtAssert_UINT32_EQ(I2C_APP_Data.TlmDropCounter, 1);
+
+    /* a buffer the bus refuses is released and counted */
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_TransmitBuffer), 1, CFE_SB_BUF_ALOC_ERR);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(CFE_SB_ReleaseMessageBuffer, 2);
+    UtAssert_UINT32_EQ(I2C_APP_Data.TlmDropCounter, 2);
+
+    /* the cycle never sleeps */
+    UtAssert_UINT32_EQ(UT_PosixStubs_GetSleepCount(), 0);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 0);
+}
+
+void Test_I2C_APP_NoopCmd(void)
+{
+    /*
+     * Test Case For:
+     * void I2C_APP_NoopCmd( const I2C_APP_Noop_t *Msg )
+     */
+    I2C_APP_NoopCmd_t TestMsg;
     UT_CheckEvent_t      EventTest;
 
     memset(&TestMsg, 0, sizeof(TestMsg));
 
     /* test dispatch of NOOP */
-    UT_CHECKEVENT_SETUP(&EventTest, SAMPLE_APP_COMMANDNOP_INF_EID, NULL);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_COMMANDNOP_INF_EID, NULL);
 
-    UtAssert_INT32_EQ(SAMPLE_APP_Noop(&TestMsg), CFE_SUCCESS);
+    UtAssert_INT32_EQ(I2C_APP_Noop(&TestMsg), CFE_SUCCESS);
 
     /*
      * Confirm that the event was generated
      */
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+
+    /*
+     * Confirm the NOOP no longer touches the robot
+     */
+    UtAssert_STUB_COUNT(OCS_write, 0);
+}
+
+/*
+ * Decode the command block from the last captured write
+ */
+static I2C_Command_Packet UT_LastCommand(const UT_WriteCapture_t *Capture)
+{
+    I2C_Command_Packet Packet;
+
+    UtAssert_UINT32_EQ(Capture->Length, I2C_CMD_PACKET_SIZE + 1);
+    romi_cmd_unpack(&Packet, &Capture->Data[1]);
+
+    return Packet;
 }
 
-void Test_SAMPLE_APP_ResetCounters(void)
+void Test_I2C_APP_MotionCmds(void)
 {
     /*
      * Test Case For:
-     * void SAMPLE_APP_ResetCounters( const SAMPLE_APP_ResetCounters_t *Msg )
+     * int32 I2C_APP_SetWheelSpeeds, I2C_APP_DriveDistance, I2C_APP_Spin,
+     *       I2C_APP_SetLeds and I2C_APP_Stop
      */
-    SAMPLE_APP_ResetCountersCmd_t TestMsg;
-    UT_CheckEvent_t               EventTest;
+    I2C_APP_SetWheelSpeedsCmd_t Speeds;
+    I2C_APP_DriveDistanceCmd_t  Drive;
+    I2C_APP_SpinCmd_t           Spin;
+    I2C_APP_SetLedsCmd_t        Leds;
+    I2C_APP_StopCmd_t           Stop;
+    I2C_Command_Packet          Packet;
+    UT_WriteCapture_t           Capture;
+    UT_CheckEvent_t             ErrEvent;
+
+    memset(&Speeds, 0, sizeof(Speeds));
+    memset(&Drive, 0, sizeof(Drive));
+    memset(&Spin, 0, sizeof(Spin));
+    memset(&Leds, 0, sizeof(Leds));
+    memset(&Stop, 0, sizeof(Stop));
+    memset(&Capture, 0, sizeof(Capture));
+    memset(&I2C_APP_Data.RobotCmd, 0, sizeof(I2C_APP_Data.RobotCmd));
+    I2C_APP_Data.i2c_fd     = 3;
+    I2C_APP_Data.BusFaulted = false;
+    I2C_APP_Data.CmdPending = false;
+    I2C_APP_Data.CmdCounter = 0;
+    I2C_APP_Data.ErrCounter = 0;
+    UT_SetHookFunction(UT_KEY(OCS_write), UT_WriteCapture_Hook, &Capture);
+    UT_CHECKEVENT_SETUP(&ErrEvent, I2C_APP_MOTION_ERR_EID, NULL);
+
+    /* LEDs first, so the later commands can be seen to keep them */
+    Leds.Payload.Red    = 1;
+    Leds.Payload.Yellow = 1;
+    UtAssert_INT32_EQ(I2C_APP_SetLeds(&Leds), CFE_SUCCESS);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_BOOL_TRUE(Packet.r_led);
+    UtAssert_BOOL_FALSE(Packet.g_led);
+    UtAssert_BOOL_TRUE(Packet.y_led);
+
+    /* fixed wheel speeds */
+    Speeds.Payload.LeftSpeed  = 150;
+    Speeds.Payload.RightSpeed = -I2C_APP_MAX_WHEEL_SPEED;
+    UtAssert_INT32_EQ(I2C_APP_SetWheelSpeeds(&Speeds), CFE_SUCCESS);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_speed, 150);
+    UtAssert_INT32_EQ(Packet.right_speed, -I2C_APP_MAX_WHEEL_SPEED);
+    UtAssert_BOOL_TRUE(Packet.r_led);
+
+    /* a distance move hands the speed back to the firmware's ladder */
+    Drive.Payload.DistanceMm = 100;
+    UtAssert_INT32_EQ(I2C_APP_DriveDistance(&Drive), CFE_SUCCESS);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_speed, 0);
+    UtAssert_INT32_EQ(Packet.right_speed, 0);
+    UtAssert_INT32_EQ(Packet.left_dist, 655);
+    UtAssert_INT32_EQ(Packet.right_dist, 655);
+    UtAssert_BOOL_TRUE(Packet.y_led);
+
+    /* a quarter turn counter-clockwise: left wheel back, right forward */
+    Spin.Payload.AngleDeg = 90;
+    UtAssert_INT32_EQ(I2C_APP_Spin(&Spin), CFE_SUCCESS);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_dist, -725);
+    UtAssert_INT32_EQ(Packet.right_dist, 725);
+    UtAssert_STUB_COUNT(OCS_write, 4);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.CmdPending);
+
+    /* the same spin again: distances cleared now, the move left for the next cycle */
+    UtAssert_INT32_EQ(I2C_APP_Spin(&Spin), CFE_SUCCESS);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_dist, 0);
+    UtAssert_INT32_EQ(Packet.right_dist, 0);
+    UtAssert_STUB_COUNT(OCS_write, 5);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.CmdPending);
+    UtAssert_INT32_EQ(I2C_APP_Data.PendingCmd.left_dist, -725);
+    UtAssert_INT32_EQ(I2C_APP_Data.PendingCmd.right_dist, 725);
+
+    /* stop zeroes speeds and distances and drops the pending move */
+    UtAssert_INT32_EQ(I2C_APP_Stop(&Stop), CFE_SUCCESS);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_speed, 0);
+    UtAssert_INT32_EQ(Packet.right_speed, 0);
+    UtAssert_INT32_EQ(Packet.left_dist, 0);
+    UtAssert_INT32_EQ(Packet.right_dist, 0);
+    UtAssert_BOOL_TRUE(Packet.r_led);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.CmdPending);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CmdCounter, 6);
+    UtAssert_UINT32_EQ(ErrEvent.MatchCount, 0);
+
+    /* out of range arguments are refused without touching the bus */
+    Speeds.Payload.LeftSpeed = I2C_APP_MAX_WHEEL_SPEED + 1;
+    UtAssert_INT32_EQ(I2C_APP_SetWheelSpeeds(&Speeds), CFE_STATUS_RANGE_ERROR);
+    Speeds.Payload.LeftSpeed  = 0;
+    Speeds.Payload.RightSpeed = I2C_APP_MAX_WHEEL_SPEED + 1;
+    UtAssert_INT32_EQ(I2C_APP_SetWheelSpeeds(&Speeds), CFE_STATUS_RANGE_ERROR);
+    Drive.Payload.DistanceMm = 5005;
+    UtAssert_INT32_EQ(I2C_APP_DriveDistance(&Drive), CFE_STATUS_RANGE_ERROR);
+    Drive.Payload.DistanceMm = -5005;
+    UtAssert_INT32_EQ(I2C_APP_DriveDistance(&Drive), CFE_STATUS_RANGE_ERROR);
+    Spin.Payload.AngleDeg = 4100;
+    UtAssert_INT32_EQ(I2C_APP_Spin(&Spin), CFE_STATUS_RANGE_ERROR);
+    Leds.Payload.Green = 2;
+    UtAssert_INT32_EQ(I2C_APP_SetLeds(&Leds), CFE_STATUS_RANGE_ERROR);
+    UtAssert_STUB_COUNT(OCS_write, 6);
+    UtAssert_UINT32_EQ(I2C_APP_Data.ErrCounter, 6);
+    UtAssert_UINT32_EQ(ErrEvent.MatchCount, 6);
+
+    /* the longest moves that still fit a distance register */
+    Drive.Payload.DistanceMm = 5004;
+    UtAssert_INT32_EQ(I2C_APP_DriveDistance(&Drive), CFE_SUCCESS);
+    UtAssert_INT32_EQ(UT_LastCommand(&Capture).left_dist, 32766);
+    Drive.Payload.DistanceMm = -5004;
+    UtAssert_INT32_EQ(I2C_APP_DriveDistance(&Drive), CFE_SUCCESS);
+    UtAssert_INT32_EQ(UT_LastCommand(&Capture).right_dist, -32766);
+
+    /* a write lost to the bus still counts the command, and is left pending */
+    UT_SetDeferredRetcode(UT_KEY(OCS_write), 1, -1);
+    UtAssert_INT32_EQ(I2C_APP_Stop(&Stop), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.CmdPending);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CmdCounter, 9);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 0);
+}
+
+/*
+ * Queue a telemetry block reporting the given move as finished, or still
+ * running if Remaining is nonzero
+ */
+static void UT_SetTelemMove(uint8 *Block, int16 LeftDist, int16 RightDist, int16 Remaining)
+{
+    I2C_Telem_Packet Telem;
+
+    memset(&Telem, 0, sizeof(Telem));
+    Telem.cmd_left_dist  = LeftDist;
+    Telem.cmd_right_dist = RightDist;
+    Telem.rem_left       = Remaining;
+    Telem.rem_right      = Remaining;
+    romi_telem_pack(Block, &Telem);
+    UT_SetDataBuffer(UT_KEY(OCS_read), Block, I2C_TELEM_PACKET_SIZE, false);
+}
+
+void Test_I2C_APP_RunPath(void)
+{
+    /*
+     * Test Case For:
+     * int32 I2C_APP_RunPath( const I2C_APP_RunPathCmd_t *Msg ),
+     * bool I2C_APP_VerifyPathCmdLength( CFE_MSG_Message_t *MsgPtr ),
+     * void I2C_APP_AdvancePath( const I2C_Telem_Packet *telem )
+     */
+    I2C_APP_RunPathCmd_t TestMsg;
+    I2C_APP_StopCmd_t    Stop;
+    I2C_Command_Packet   Packet;
+    UT_WriteCapture_t    Capture;
+    UT_TlmCapture_t      Sent;
+    UT_CheckEvent_t      ErrEvent;
+    UT_CheckEvent_t      DoneEvent;
+    uint8                Block[I2C_TELEM_PACKET_SIZE];
+    size_t               Size;
 
     memset(&TestMsg, 0, sizeof(TestMsg));
+    memset(&Stop, 0, sizeof(Stop));
+    memset(&Capture, 0, sizeof(Capture));
+    memset(&Sent, 0, sizeof(Sent));
+    memset(&I2C_APP_Data.RobotCmd, 0, sizeof(I2C_APP_Data.RobotCmd));
+    I2C_APP_Data.i2c_fd        = 3;
+    I2C_APP_Data.BusFaulted    = false;
+    I2C_APP_Data.CmdPending    = false;
+    I2C_APP_Data.RobotFeatures = 0;
+    I2C_APP_Data.PathActive    = false;
+    UT_SetHookFunction(UT_KEY(CFE_SB_TransmitBuffer), UT_TlmCapture_Hook, &Sent);
+    I2C_APP_Data.CmdCounter    = 0;
+    I2C_APP_Data.ErrCounter    = 0;
+    UT_SetHookFunction(UT_KEY(OCS_write), UT_WriteCapture_Hook, &Capture);
+    UT_CHECKEVENT_SETUP(&ErrEvent, I2C_APP_MOTION_ERR_EID, NULL);
+
+    /* a square corner: forward, quarter turn, forward the same distance again */
+    TestMsg.Payload.NumSegments       = 3;
+    TestMsg.Payload.Segments[0].Kind  = I2C_APP_SEGMENT_DRIVE;
+    TestMsg.Payload.Segments[0].Value = 100;
+    TestMsg.Payload.Segments[1].Kind  = I2C_APP_SEGMENT_SPIN;
+    TestMsg.Payload.Segments[1].Value = 90;
+    TestMsg.Payload.Segments[2].Kind  = I2C_APP_SEGMENT_DRIVE;
+    TestMsg.Payload.Segments[2].Value = 100;
+
+    /* the length must carry exactly NumSegments segments */
+    Size = offsetof(I2C_APP_RunPathCmd_t, Payload.Segments[3]);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UtAssert_BOOL_TRUE(I2C_APP_VerifyPathCmdLength(CFE_MSG_PTR(TestMsg.CmdHeader)));
+    Size = offsetof(I2C_APP_RunPathCmd_t, Payload.Segments[2]);
+    UtAssert_BOOL_FALSE(I2C_APP_VerifyPathCmdLength(CFE_MSG_PTR(TestMsg.CmdHeader)));
+    Size = offsetof(I2C_APP_RunPathCmd_t, Payload.Segments) - 1;
+    UtAssert_BOOL_FALSE(I2C_APP_VerifyPathCmdLength(CFE_MSG_PTR(TestMsg.CmdHeader)));
+    UtAssert_UINT32_EQ(I2C_APP_Data.ErrCounter, 2);
+
+    Size                        = sizeof(TestMsg);
+    TestMsg.Payload.NumSegments = 0;
+    UtAssert_BOOL_FALSE(I2C_APP_VerifyPathCmdLength(CFE_MSG_PTR(TestMsg.CmdHeader)));
+    TestMsg.Payload.NumSegments = I2C_APP_MAX_PATH_SEGMENTS + 1;
+    UtAssert_BOOL_FALSE(I2C_APP_VerifyPathCmdLength(CFE_MSG_PTR(TestMsg.CmdHeader)));
+    UtAssert_UINT32_EQ(ErrEvent.MatchCount, 2);
+    TestMsg.Payload.NumSegments = 3;
+
+    /* the first segment goes out at once */
+    UtAssert_INT32_EQ(I2C_APP_RunPath(&TestMsg), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_write, 1);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_dist, 655);
+    UtAssert_INT32_EQ(Packet.right_dist, 655);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.PathActive);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CmdCounter, 1);
+
+    /* still moving: the cycle only reads telemetry */
+    UT_SetTelemMove(Block, 655, 655, 200);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_write, 2);
+    UtAssert_UINT32_EQ(Sent.Tlm.Payload.PathSegment, 1);
+    UtAssert_UINT32_EQ(Sent.Tlm.Payload.PathLength, 3);
+
+    /* a stale echo is not taken as done */
+    UT_SetTelemMove(Block, 0, 0, 0);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_write, 3);
+
+    /* done: the turn follows in the same cycle */
+    UT_SetTelemMove(Block, 655, 655, 0);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_write, 5);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_dist, -725);
+    UtAssert_INT32_EQ(Packet.right_dist, 725);
+    UtAssert_UINT32_EQ(Sent.Tlm.Payload.PathSegment, 2);
+
+    UT_SetTelemMove(Block, -725, 725, 0);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_dist, 655);
+    UtAssert_INT32_EQ(Packet.right_dist, 655);
+
+    /* the end of the path is reported once */
+    UT_CHECKEVENT_SETUP(&DoneEvent, I2C_APP_PATH_INF_EID, "I2C: path of %u segments complete");
+    UT_SetTelemMove(Block, 655, 655, 0);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(DoneEvent.MatchCount, 1);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.PathActive);
+    UtAssert_STUB_COUNT(OCS_write, 9);
+    UtAssert_UINT32_EQ(Sent.Tlm.Payload.PathSegment, 3);
+
+    /* repeating the last distance: cleared now, the move flushed by the next cycle */
+    TestMsg.Payload.NumSegments = 1;
+    TestMsg.Payload.Segments[0] = TestMsg.Payload.Segments[2];
+    UtAssert_INT32_EQ(I2C_APP_RunPath(&TestMsg), CFE_SUCCESS);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.CmdPending);
+    UT_SetTelemMove(Block, 655, 655, 655);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.CmdPending);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.PathActive);
+
+    /* stop abandons the rest of the path */
+    UtAssert_INT32_EQ(I2C_APP_Stop(&Stop), CFE_SUCCESS);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.PathActive);
+
+    /* any bad segment refuses the whole path, before anything moves */
+    UT_CHECKEVENT_SETUP(&ErrEvent, I2C_APP_MOTION_ERR_EID, NULL);
+    UtAssert_STUB_COUNT(OCS_write, 13);
+    TestMsg.Payload.NumSegments       = 2;
+    TestMsg.Payload.Segments[1].Kind  = 7;
+    UtAssert_INT32_EQ(I2C_APP_RunPath(&TestMsg), CFE_STATUS_RANGE_ERROR);
+    TestMsg.Payload.Segments[1].Kind  = I2C_APP_SEGMENT_DRIVE;
+    TestMsg.Payload.Segments[1].Value = 5005;
+    UtAssert_INT32_EQ(I2C_APP_RunPath(&TestMsg), CFE_STATUS_RANGE_ERROR);
+    TestMsg.Payload.Segments[1].Kind = I2C_APP_SEGMENT_SPIN;
+    UtAssert_INT32_EQ(I2C_APP_RunPath(&TestMsg), CFE_STATUS_RANGE_ERROR);
+    UtAssert_STUB_COUNT(OCS_write, 13);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.PathActive);
+    UtAssert_UINT32_EQ(ErrEvent.MatchCount, 3);
+    UtAssert_UINT32_EQ(I2C_APP_Data.ErrCounter, 7);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 0);
+}
+
+void Test_I2C_APP_EStop(void)
+{
+    /*
+     * Test Case For:
+     * void I2C_APP_CheckEStop( void )
+     */
+    I2C_Command_Packet         Packet;
+    UT_WriteCapture_t          Capture;
+    UT_CheckEvent_t            StopEvent;
+    UT_CheckEvent_t            PipeEvent;
+    OS_time_t                  Now[3];
+    CFE_SB_MsgId_t             MsgId = CFE_SB_ValueToMsgId(I2C_APP_ESTOP_MID);
+    I2C_APP_DriveDistanceCmd_t Drive;
+    CFE_MSG_FcnCode_t          FcnCode;
+    size_t                     Size;
+
+    memset(&Capture, 0, sizeof(Capture));
+    memset(&I2C_APP_Data.RobotCmd, 0, sizeof(I2C_APP_Data.RobotCmd));
+    I2C_APP_Data.RobotCmd.left_speed = 200;
+    I2C_APP_Data.RobotCmd.g_led      = true;
+    I2C_APP_Data.i2c_fd              = 3;
+    I2C_APP_Data.BusFaulted          = false;
+    I2C_APP_Data.PathActive          = true;
+    I2C_APP_Data.CmdPending          = true;
+    I2C_APP_Data.EStopCounter        = 0;
+    I2C_APP_Data.EStopLatencyUs      = 0;
+    I2C_APP_Data.EStopLatencyMaxUs   = 0;
+    I2C_APP_Data.DispatchTime        = OS_TimeFromTotalMicroseconds(1000000);
+    Now[0]                           = OS_TimeFromTotalMicroseconds(1000850);
+    Now[1]                           = OS_TimeFromTotalMicroseconds(1000300);
+    Now[2]                           = OS_TimeFromTotalMicroseconds(999000);
+    UT_SetDataBuffer(UT_KEY(OS_GetLocalTime), Now, sizeof(Now), false);
+    UT_SetHookFunction(UT_KEY(OCS_write), UT_WriteCapture_Hook, &Capture);
+
+    /* two stops queued are one stop: one write, the pending move and the path dropped */
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_ReceiveBuffer), 3, CFE_SB_NO_MESSAGE);
+    UT_CHECKEVENT_SETUP(&StopEvent, I2C_APP_ESTOP_INF_EID, "I2C: EMERGENCY STOP, %lu us%s");
+    I2C_APP_CheckEStop();
+    UtAssert_STUB_COUNT(CFE_SB_ReceiveBuffer, 3);
+    UtAssert_STUB_COUNT(OCS_write, 1);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_speed, 0);
+    UtAssert_INT32_EQ(Packet.left_dist, 0);
+    UtAssert_BOOL_TRUE(Packet.g_led);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.PathActive);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.CmdPending);
+    UtAssert_UINT32_EQ(StopEvent.MatchCount, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopCounter, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopLatencyUs, 850);
+
+    /* an empty pipe costs one poll and nothing else */
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_ReceiveBuffer), 1, CFE_SB_NO_MESSAGE);
+    I2C_APP_CheckEStop();
+    UtAssert_STUB_COUNT(CFE_SB_ReceiveBuffer, 4);
+    UtAssert_STUB_COUNT(OCS_write, 1);
+
+    /* a full pipe is drained no further than its depth */
+    I2C_APP_CheckEStop();
+    UtAssert_STUB_COUNT(CFE_SB_ReceiveBuffer, 4 + I2C_APP_ESTOP_PIPE_DEPTH);
+    UtAssert_STUB_COUNT(OCS_write, 2);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopLatencyUs, 300);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopLatencyMaxUs, 850);
+
+    /* arriving on the command pipe only wakes the app; the stop comes off the e-stop pipe */
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_ReceiveBuffer), 2, CFE_SB_NO_MESSAGE);
+    UT_SetDeferredRetcode(UT_KEY(OCS_write), 1, -1);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
+    I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopCounter, 3);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopLatencyUs, 0);
 
-    UT_CHECKEVENT_SETUP(&EventTest, SAMPLE_APP_COMMANDRST_INF_EID, "SAMPLE: RESET command");
+    /* lost to the bus: left pending for the next cycle */
+    UtAssert_BOOL_TRUE(I2C_APP_Data.CmdPending);
+    UtAssert_INT32_EQ(I2C_APP_Data.PendingCmd.left_speed, 0);
 
-    UtAssert_INT32_EQ(SAMPLE_APP_ResetCounters(&TestMsg), CFE_SUCCESS);
+    /* a pipe error is reported, and nothing is stopped */
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_ReceiveBuffer), 1, CFE_SB_PIPE_RD_ERR);
+    UT_CHECKEVENT_SETUP(&PipeEvent, I2C_APP_PIPE_ERR_EID, NULL);
+    I2C_APP_CheckEStop();
+    UtAssert_UINT32_EQ(PipeEvent.MatchCount, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopCounter, 3);
+
+    /* reported in housekeeping */
+    MsgId = CFE_SB_ValueToMsgId(I2C_APP_SEND_HK_MID);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
+    I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.EStopCounter, 3);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.EStopLatencyUs, 0);
+    UtAssert_UINT32_EQ(I2C_APP_Data.HkTlm.Payload.EStopLatencyMaxUs, 850);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 0);
 
     /*
-     * Confirm that the event was generated
+     * A drive sent before the stop, but still queued on the command pipe
+     * when the stop was taken, is dropped: nothing goes to the motors
+     * after the stop until the stop's own copy comes off the command pipe.
      */
-    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    memset(&Drive, 0, sizeof(Drive));
+    Drive.Payload.DistanceMm  = 100;
+    I2C_APP_Data.EStopFence   = 0;
+    I2C_APP_Data.ErrCounter   = 0;
+    I2C_APP_Data.PathActive   = false;
+    I2C_APP_Data.CmdPending   = false;
+    I2C_APP_Data.BusFaulted   = false;
+    I2C_APP_Data.PipeDepth    = I2C_APP_PIPE_DEPTH;
+    UT_ResetState(UT_KEY(CFE_SB_ReceiveBuffer));
+    UT_ResetState(UT_KEY(OCS_write));
+    UT_SetHookFunction(UT_KEY(OCS_write), UT_WriteCapture_Hook, &Capture);
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_ReceiveBuffer), 2, CFE_SB_NO_MESSAGE);
+    I2C_APP_CheckEStop();
+    UtAssert_STUB_COUNT(OCS_write, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopFence, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopFenceBudget, I2C_APP_PIPE_DEPTH);
+
+    MsgId   = CFE_SB_ValueToMsgId(I2C_APP_CMD_MID);
+    FcnCode = I2C_APP_DRIVE_DISTANCE_CC;
+    Size    = sizeof(Drive);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    UT_CHECKEVENT_SETUP(&StopEvent, I2C_APP_ESTOP_INF_EID, "I2C: motion command %u sent before the e-stop dropped");
+    I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)&Drive);
+    UtAssert_STUB_COUNT(OCS_write, 1);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.CmdPending);
+    UtAssert_UINT32_EQ(StopEvent.MatchCount, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.ErrCounter, 1);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_dist, 0);
+
+    /* the stop's copy on the command pipe lets the drives sent after it through */
+    MsgId = CFE_SB_ValueToMsgId(I2C_APP_ESTOP_MID);
+    UT_SetDeferredRetcode(UT_KEY(CFE_SB_ReceiveBuffer), 1, CFE_SB_NO_MESSAGE);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
+    I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopFence, 0);
+
+    MsgId = CFE_SB_ValueToMsgId(I2C_APP_CMD_MID);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)&Drive);
+    UtAssert_STUB_COUNT(OCS_write, 2);
+    UtAssert_UINT32_EQ(I2C_APP_Data.ErrCounter, 1);
+
+    /* a copy the command pipe had no room for holds the fence for one pipe depth at most */
+    I2C_APP_Data.EStopFence       = 1;
+    I2C_APP_Data.EStopFenceBudget = 0;
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &Size, sizeof(Size), false);
+    I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)&Drive);
+    UtAssert_STUB_COUNT(OCS_write, 3);
+    UtAssert_UINT32_EQ(I2C_APP_Data.EStopFence, 0);
 }
 
-void Test_SAMPLE_APP_ProcessCC(void)
+void Test_I2C_APP_ResetCounters(void)
 {
     /*
      * Test Case For:
-     * void  SAMPLE_APP_ProcessCC( const SAMPLE_APP_Process_t *Msg )
+     * void I2C_APP_ResetCounters( const I2C_APP_ResetCounters_t *Msg )
      */
-    SAMPLE_APP_ProcessCmd_t TestMsg;
-    SAMPLE_APP_Table_t      TestTblData;
-    void *                  TblPtr = &TestTblData;
+    I2C_APP_ResetCountersCmd_t TestMsg;
+    UT_CheckEvent_t               EventTest;
 
-    memset(&TestTblData, 0, sizeof(TestTblData));
     memset(&TestMsg, 0, sizeof(TestMsg));
 
-    /* Provide some table data for the SAMPLE_APP_Process() function to use */
-    TestTblData.Int1 = 40;
-    TestTblData.Int2 = 50;
-    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
-    UtAssert_INT32_EQ(SAMPLE_APP_Process(&TestMsg), CFE_SUCCESS);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_COMMANDRST_INF_EID, "I2C: RESET command");
 
-    /*
-     * Confirm that the CFE_TBL_GetAddress() call was done
-     */
-    UtAssert_STUB_COUNT(CFE_TBL_GetAddress, 1);
+    UtAssert_INT32_EQ(I2C_APP_ResetCounters(&TestMsg), CFE_SUCCESS);
 
     /*
-     * Confirm that the SAMPLE_LIB_Function() call was done
-     * NOTE: This stub is provided by the sample_lib library
+     * Confirm that the event was generated
      */
-    UtAssert_STUB_COUNT(SAMPLE_LIB_Function, 1);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+}
 
+void Test_I2C_APP_ReportConfig(void)
+{
     /*
-     * Configure the CFE_TBL_GetAddress function to return an error
-     * Exercise the error return path
+     * Test Case For:
+     * int32 I2C_APP_ReportConfig( const I2C_APP_ReportConfigCmd_t *Msg )
      */
-    UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetAddress), CFE_TBL_ERR_UNREGISTERED);
-    UtAssert_INT32_EQ(SAMPLE_APP_Process(&TestMsg), CFE_TBL_ERR_UNREGISTERED);
+    I2C_APP_ReportConfigCmd_t TestMsg;
+    I2C_APP_Table_t           Config = UT_I2C_APP_DEFAULT_TABLE;
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    Config.NumDevices = 2;
+    Config.Devices[1] = Config.Devices[0];
+    I2C_APP_Data.Config     = Config;
+    I2C_APP_Data.CmdCounter = 0;
+
+    /* summary, one line per device, calibration, then the CRC */
+    UtAssert_INT32_EQ(I2C_APP_ReportConfig(&TestMsg), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 5);
+    UtAssert_STUB_COUNT(CFE_TBL_GetInfo, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CmdCounter, 1);
+
+    /* the report is of the app's own copy: the table itself is never touched */
+    UtAssert_STUB_COUNT(CFE_TBL_GetAddress, 0);
+    UtAssert_STUB_COUNT(CFE_TBL_ReleaseAddress, 0);
+
+    I2C_APP_Data.Config.NumDevices = 1;
 }
 
-void Test_SAMPLE_APP_VerifyCmdLength(void)
+void Test_I2C_APP_VerifyCmdLength(void)
 {
     /*
      * Test Case For:
-     * bool SAMPLE_APP_VerifyCmdLength
+     * bool I2C_APP_VerifyCmdLength
      */
     UT_CheckEvent_t   EventTest;
     size_t            size    = 1;
@@ -527,10 +1956,10 @@ void Test_SAMPLE_APP_VerifyCmdLength(void)
      * test a match case
      */
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &size, sizeof(size), false);
-    UT_CHECKEVENT_SETUP(&EventTest, SAMPLE_APP_LEN_ERR_EID,
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_LEN_ERR_EID,
                         "Invalid Msg length: ID = 0x%X,  CC = %u, Len = %u, Expected = %u");
 
-    SAMPLE_APP_VerifyCmdLength(NULL, size);
+    I2C_APP_VerifyCmdLength(NULL, size);
 
     /*
      * Confirm that the event was NOT generated
@@ -543,7 +1972,7 @@ void Test_SAMPLE_APP_VerifyCmdLength(void)
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &size, sizeof(size), false);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &msgid, sizeof(msgid), false);
     UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &fcncode, sizeof(fcncode), false);
-    SAMPLE_APP_VerifyCmdLength(NULL, size + 1);
+    I2C_APP_VerifyCmdLength(NULL, size + 1);
 
     /*
      * Confirm that the event WAS generated
@@ -551,29 +1980,394 @@ void Test_SAMPLE_APP_VerifyCmdLength(void)
     UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
 }
 
-void Test_SAMPLE_APP_TblValidationFunc(void)
+void Test_I2C_APP_TblValidationFunc(void)
+{
+    /*
+     * Test Case For:
+     * int32 I2C_APP_TblValidationFunc( void *TblData )
+     */
+    I2C_APP_Table_t Nominal = UT_I2C_APP_DEFAULT_TABLE;
+    I2C_APP_Table_t TestTblData;
+    UT_CheckEvent_t EventTest;
+
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_CONFIG_ERR_EID, "I2C: config table rejected, bad %s");
+
+    /* the defaults, and the widest legal settings, are accepted */
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&Nominal), CFE_SUCCESS);
+    TestTblData                     = Nominal;
+    TestTblData.NumDevices          = I2C_APP_TBL_MAX_DEVICES;
+    TestTblData.Devices[1].Address  = I2C_APP_TBL_MIN_ADDRESS;
+    TestTblData.Devices[2].Address  = I2C_APP_TBL_MAX_ADDRESS;
+    TestTblData.Devices[3].Address  = I2C_ADDRESS;
+    TestTblData.PollDivider         = I2C_APP_TBL_MAX_POLL_DIVIDER;
+    TestTblData.TransferFeatures    = 0;
+    TestTblData.ReopenHoldoffCycles = I2C_APP_TBL_MAX_REOPEN_CYCLES;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 0);
+
+    /* each field out of range is rejected on its own */
+    TestTblData            = Nominal;
+    TestTblData.NumDevices = 0;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.NumDevices = I2C_APP_TBL_MAX_DEVICES + 1;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+
+    TestTblData          = Nominal;
+    TestTblData.Discover = 2;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+
+    TestTblData                    = Nominal;
+    TestTblData.NumDevices         = 2;
+    TestTblData.Devices[1].Address = I2C_APP_TBL_MIN_ADDRESS - 1;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.Devices[1].Address = I2C_APP_TBL_MAX_ADDRESS + 1;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+
+    TestTblData             = Nominal;
+    TestTblData.PollDivider = 0;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.PollDivider = I2C_APP_TBL_MAX_POLL_DIVIDER + 1;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+
+    TestTblData                  = Nominal;
+    TestTblData.TransferFeatures = 0x8000;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+
+    TestTblData                     = Nominal;
+    TestTblData.ReopenHoldoffCycles = I2C_APP_TBL_MAX_REOPEN_CYCLES + 1;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+
+    TestTblData            = Nominal;
+    TestTblData.CountsPerM = I2C_APP_TBL_MIN_COUNTS_PER_M - 1;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.CountsPerM = I2C_APP_TBL_MAX_COUNTS_PER_M + 1;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+
+    TestTblData             = Nominal;
+    TestTblData.WheelBaseMm = I2C_APP_TBL_MIN_WHEEL_BASE_MM - 1;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.WheelBaseMm = I2C_APP_TBL_MAX_WHEEL_BASE_MM + 1;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+
+    TestTblData               = Nominal;
+    TestTblData.MaxWheelSpeed = 0;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    TestTblData.MaxWheelSpeed = I2C_APP_MAX_WHEEL_SPEED + 1;
+    UtAssert_INT32_EQ(I2C_APP_TblValidationFunc(&TestTblData), I2C_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 15);
+}
+
+void Test_I2C_APP_Config(void)
 {
     /*
      * Test Case For:
-     * int32 SAMPLE_APP_TblValidationFunc( void *TblData )
+     * void I2C_APP_LoadConfig( void ), void I2C_APP_ApplyConfig( const I2C_APP_Table_t *Config )
+     * and the use of the configuration on the bus and in the cycle
      */
-    SAMPLE_APP_Table_t TestTblData;
+    I2C_APP_Table_t        Defaults = UT_I2C_APP_DEFAULT_TABLE;
+    I2C_APP_Table_t        Config   = UT_I2C_APP_DEFAULT_TABLE;
+    I2C_APP_Table_t       *TblPtr   = &Config;
+    I2C_APP_DriveDistanceCmd_t Drive;
+    I2C_Command_Packet     Packet;
+    UT_WriteCapture_t      Capture;
+    unsigned long          Address = 0;
+    uint8                  Ident[ROMI_IDENT_SIZE];
+    uint8                  Block[I2C_TELEM_PACKET_SIZE];
+    I2C_Ident_Packet       Id = {ROMI_IDENT_MAGIC, ROMI_PROTOCOL_VERSION, ROMI_DATA_SIZE, ROMI_FEATURE_COMBINED_XFER, 0};
+    UT_CheckEvent_t        InfEvent;
+    UT_CheckEvent_t        ErrEvent;
+    CFE_SB_MsgId_t         MsgId = CFE_SB_ValueToMsgId(I2C_APP_SEND_HK_MID);
+
+    memset(&Drive, 0, sizeof(Drive));
+    memset(&Capture, 0, sizeof(Capture));
+    memset(Block, 0, sizeof(Block));
+    romi_ident_pack(Ident, &Id);
+    I2C_APP_ApplyConfig(&Defaults);
+    I2C_APP_Data.i2c_fd         = 3;
+    I2C_APP_Data.BusStarted     = true;
+    I2C_APP_Data.BusFaulted     = false;
+    I2C_APP_Data.CmdPending     = false;
+    I2C_APP_Data.PathActive     = false;
+    I2C_APP_Data.ReopenHoldoff  = 0;
+    I2C_APP_Data.RobotIdent     = Id;
+    I2C_APP_Data.RobotFeatures  = ROMI_FEATURE_COMBINED_XFER;
+    UT_ResetState(0);
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UT_CHECKEVENT_SETUP(&InfEvent, I2C_APP_CONFIG_INF_EID, NULL);
 
-    memset(&TestTblData, 0, sizeof(TestTblData));
+    /* nothing new from the table services: nothing changes */
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &MsgId, sizeof(MsgId), false);
+    I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
+    UtAssert_STUB_COUNT(CFE_TBL_GetAddress, 0);
+
+    /* a new load with the same robot only changes the settings in place */
+    I2C_APP_Data.ConfigLoadCounter = 0;
+    Config.TransferFeatures = 0;
+    Config.PollDivider      = 2;
+    Config.CountsPerM       = 2 * I2C_APP_COUNTS_PER_M;
+    UT_SetDeferredRetcode(UT_KEY(CFE_TBL_Manage), 1, CFE_TBL_INFO_UPDATED);
+    I2C_APP_ProcessCommandPacket((CFE_SB_Buffer_t *)NULL);
+    UtAssert_STUB_COUNT(CFE_TBL_GetAddress, 1);
+    UtAssert_STUB_COUNT(CFE_TBL_ReleaseAddress, 1);
+    UtAssert_UINT32_EQ(InfEvent.MatchCount, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.ConfigLoadCounter, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.PollDivider, 2);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotFeatures, 0);
+    UtAssert_STUB_COUNT(OCS_close, 0);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+
+    /* the calibration scales the moves */
+    UT_SetHookFunction(UT_KEY(OCS_write), UT_WriteCapture_Hook, &Capture);
+    Drive.Payload.DistanceMm = 100;
+    UtAssert_INT32_EQ(I2C_APP_DriveDistance(&Drive), CFE_SUCCESS);
+    Packet = UT_LastCommand(&Capture);
+    UtAssert_INT32_EQ(Packet.left_dist, 1310);
+
+    /* the poll divider skips the telemetry read on the cycles in between */
+    I2C_APP_Data.CycleCounter = 0;
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_read, 0);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_read, 1);
+
+    /* none of that went back to the table services */
+    UtAssert_STUB_COUNT(CFE_TBL_GetAddress, 1);
+    UtAssert_STUB_COUNT(CFE_TBL_GetInfo, 0);
+    UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 0);
+
+    /* an image that fails validation is never applied */
+    Config.PollDivider = 0;
+    UT_CHECKEVENT_SETUP(&ErrEvent, I2C_APP_CONFIG_ERR_EID, NULL);
+    I2C_APP_LoadConfig();
+    UtAssert_UINT32_EQ(ErrEvent.MatchCount, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.Config.PollDivider, 2);
+    UtAssert_UINT32_EQ(I2C_APP_Data.ConfigLoadCounter, 1);
+
+    /* and a table the services cannot hand over is reported */
+    UT_SetDeferredRetcode(UT_KEY(CFE_TBL_GetAddress), 1, CFE_TBL_ERR_UNREGISTERED);
+    I2C_APP_LoadConfig();
+    UtAssert_UINT32_EQ(ErrEvent.MatchCount, 2);
+    UtAssert_STUB_COUNT(CFE_TBL_ReleaseAddress, 2);
 
-    /* nominal case (0) should succeed */
-    UtAssert_INT32_EQ(SAMPLE_APP_TblValidationFunc(&TestTblData), CFE_SUCCESS);
+    /*
+     * A new device list moves the connection: the old descriptor is
+     * closed, the first device that opens is used, and the robot found
+     * there is identified before anything else goes out.
+     */
+    UT_ResetState(0);
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TblPtr, sizeof(TblPtr), false);
+    UT_SetHookFunction(UT_KEY(OCS_ioctl), UT_IoctlCapture_Hook, &Address);
+    UT_SetDataBuffer(UT_KEY(OCS_read), Ident, sizeof(Ident), false);
+    UT_CHECKEVENT_SETUP(&InfEvent, I2C_APP_CONFIG_INF_EID,
+                        "I2C: config applied, robot at bus %u address 0x%02X, telemetry every %u cycles");
+    Config                     = Defaults;
+    Config.NumDevices          = 2;
+    Config.Devices[0].BusNum   = 1;
+    Config.Devices[0].Address  = 0x10;
+    Config.Devices[1].BusNum   = 3;
+    Config.Devices[1].Address  = 0x20;
+    Config.ReopenHoldoffCycles = 2;
+    UT_SetDeferredRetcode(UT_KEY(OCS_open), 1, -1);
+    I2C_APP_LoadConfig();
+    UtAssert_STUB_COUNT(OCS_close, 1);
+    UtAssert_STUB_COUNT(OCS_open, 2);
+    UtAssert_UINT32_EQ(Address, 0x20);
+    UtAssert_UINT32_EQ(I2C_APP_Data.BusNum, 3);
+    UtAssert_UINT32_EQ(I2C_APP_Data.DeviceIndex, 1);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+    UtAssert_STUB_COUNT(OCS_read, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotFeatures, ROMI_FEATURE_COMBINED_XFER);
+    UtAssert_UINT32_EQ(InfEvent.MatchCount, 1);
 
-    /* error case should return SAMPLE_APP_TABLE_OUT_OF_RANGE_ERR_CODE */
-    TestTblData.Int1 = 1 + SAMPLE_APP_TBL_ELEMENT_1_MAX;
-    UtAssert_INT32_EQ(SAMPLE_APP_TblValidationFunc(&TestTblData), SAMPLE_APP_TABLE_OUT_OF_RANGE_ERR_CODE);
+    /*
+     * With no device answering, the retry is held off for the configured
+     * number of cycles instead of reopening the bus on every transaction.
+     */
+    I2C_APP_Data.BusFaulted = true;
+    I2C_APP_Data.i2c_fd     = -1;
+    UT_SetDefaultReturnValue(UT_KEY(OCS_open), -1);
+    UtAssert_INT32_EQ(I2C_APP_BusConnect(), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(OCS_open, 4);
+    UtAssert_UINT32_EQ(I2C_APP_Data.ReopenHoldoff, 2);
+    UtAssert_INT32_EQ(I2C_APP_BusConnect(), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(OCS_open, 4);
+    UT_ClearDefaultReturnValue(UT_KEY(OCS_open));
+    UT_SetDataBuffer(UT_KEY(OCS_read), Block, sizeof(Block), false);
+    I2C_APP_Data.RobotFeatures = 0;
+    I2C_APP_Data.CycleCounter  = 1;
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+    UtAssert_STUB_COUNT(OCS_open, 4);
+    UtAssert_INT32_EQ(I2C_APP_Wakeup(NULL), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_open, 5);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+
+    /* reopening over a live connection closes it first */
+    UtAssert_INT32_EQ(I2C_APP_OpenDevice(), CFE_SUCCESS);
+    UtAssert_STUB_COUNT(OCS_open, 6);
+    UtAssert_STUB_COUNT(OCS_close, 2);
+    UtAssert_INT32_EQ(I2C_APP_Data.i2c_fd, 3);
+
+    I2C_APP_ApplyConfig(&Defaults);
 }
 
-void Test_SAMPLE_APP_GetCrc(void)
+void Test_I2C_APP_Cds(void)
 {
     /*
      * Test Case For:
-     * void SAMPLE_APP_GetCrc( const char *TableName )
+     * void I2C_APP_RestoreState( void )
+     * void I2C_APP_SaveState( void )
+     * void I2C_APP_UpdateOdometry( const I2C_Telem_Packet* telem )
+     */
+    I2C_APP_CdsState_t State;
+    I2C_Telem_Packet   Telem;
+    UT_CheckEvent_t    EventTest;
+    I2C_APP_Table_t    Table = UT_I2C_APP_DEFAULT_TABLE;
+    I2C_APP_Table_t   *TablePtr;
+
+    /* a serial start, where a warm restart goes without the settle delay and the probe */
+    UT_SetDefaultReturnValue(UT_KEY(CFE_ES_CreateChildTask), CFE_STATUS_EXTERNAL_RESOURCE_FAIL);
+
+    /* no CDS: the app still comes up, and nothing is saved */
+    UT_SetDeferredRetcode(UT_KEY(CFE_ES_RegisterCDS), 1, CFE_ES_BAD_ARGUMENT);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_CDS_ERR_EID,
+                        "I2C: no critical data store, state will not survive a restart, RC = 0x%08lX");
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.CdsEnabled);
+    I2C_APP_SaveState();
+    UtAssert_STUB_COUNT(CFE_ES_CopyToCDS, 0);
+
+    /* a new block is a cold start; the first save fills it, an unchanged state is not written again */
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.CdsEnabled);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.WarmStart);
+    UtAssert_STUB_COUNT(CFE_ES_RestoreFromCDS, 0);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 2);
+    I2C_APP_SaveState();
+    I2C_APP_SaveState();
+    UtAssert_STUB_COUNT(CFE_ES_CopyToCDS, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.CdsState.Signature, I2C_APP_CDS_SIGNATURE);
+    UtAssert_UINT32_EQ(I2C_APP_CDS_SIGNATURE & 0xFFFF, sizeof(I2C_APP_CdsState_t));
+
+    /* odometry alone is written once every I2C_APP_CDS_ODOM_SAVE_CYCLES cycles, not every cycle */
+    I2C_APP_Data.OdomLeft     = 5;
+    I2C_APP_Data.CycleCounter = I2C_APP_Data.CdsSaveCycle + I2C_APP_CDS_ODOM_SAVE_CYCLES - 1;
+    I2C_APP_SaveState();
+    UtAssert_STUB_COUNT(CFE_ES_CopyToCDS, 1);
+    UtAssert_INT32_EQ(I2C_APP_Data.CdsState.OdomLeft, 0);
+    I2C_APP_Data.CycleCounter++;
+    I2C_APP_SaveState();
+    UtAssert_STUB_COUNT(CFE_ES_CopyToCDS, 2);
+    UtAssert_INT32_EQ(I2C_APP_Data.CdsState.OdomLeft, 5);
+
+    /* any other change is written at once, odometry and all */
+    I2C_APP_Data.OdomLeft   = 6;
+    I2C_APP_Data.PathActive = true;
+    I2C_APP_SaveState();
+    UtAssert_STUB_COUNT(CFE_ES_CopyToCDS, 3);
+    UtAssert_INT32_EQ(I2C_APP_Data.CdsState.OdomLeft, 6);
+    I2C_APP_Data.PathActive = false;
+
+    /* a saved state resumes the move and the odometry without the settle delay or a probe */
+    memset(&State, 0, sizeof(State));
+    State.Signature           = I2C_APP_CDS_SIGNATURE;
+    State.RobotCmd.left_dist  = 400;
+    State.PathActive          = true;
+    State.PathLength          = 3;
+    State.PathNext            = 1;
+    State.OdomLeft            = 100000;
+    State.OdomRight           = -50;
+    State.OdomValid           = true;
+    State.RobotIdent.magic    = ROMI_IDENT_MAGIC;
+    State.RobotIdent.features = ROMI_FEATURE_COMBINED_XFER;
+    UT_SetDeferredRetcode(UT_KEY(CFE_ES_RegisterCDS), 1, CFE_ES_CDS_ALREADY_EXISTS);
+    UT_SetDataBuffer(UT_KEY(CFE_ES_RestoreFromCDS), &State, sizeof(State), false);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_CDS_INF_EID,
+                        "I2C: warm restart, path step %u of %u%s, odometry %ld/%ld counts");
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.WarmStart);
+    UtAssert_STUB_COUNT(OS_TaskDelay, 2);
+    UtAssert_INT32_EQ(I2C_APP_Data.RobotCmd.left_dist, 400);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.PathActive);
+    UtAssert_UINT32_EQ(I2C_APP_Data.PathNext, 1);
+    UtAssert_INT32_EQ(I2C_APP_Data.OdomLeft, 100000);
+    UtAssert_INT32_EQ(I2C_APP_Data.OdomRight, -50);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotFeatures, ROMI_FEATURE_COMBINED_XFER);
+
+    /* what was just restored is not written back */
+    I2C_APP_SaveState();
+    UtAssert_STUB_COUNT(CFE_ES_CopyToCDS, 3);
+
+    /*
+     * The state is restored ahead of the table, so the saved device index
+     * is taken up again against the table's list, and its transfer mask
+     * applies to the saved identity
+     */
+    Table.NumDevices         = 2;
+    Table.Devices[1].BusNum  = 1;
+    Table.Devices[1].Address = 0x10;
+    Table.TransferFeatures   = 0;
+    TablePtr                 = &Table;
+    State.DeviceIndex        = 1;
+    UT_SetDeferredRetcode(UT_KEY(CFE_ES_RegisterCDS), 1, CFE_ES_CDS_ALREADY_EXISTS);
+    UT_SetDataBuffer(UT_KEY(CFE_ES_RestoreFromCDS), &State, sizeof(State), false);
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &TablePtr, sizeof(TablePtr), false);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_BOOL_TRUE(I2C_APP_Data.WarmStart);
+    UtAssert_UINT32_EQ(I2C_APP_Data.DeviceIndex, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.BusNum, 1);
+    UtAssert_UINT32_EQ(I2C_APP_Data.RobotFeatures, 0);
+    State.DeviceIndex = 0;
+
+    /* a block from another layout, or one ES found corrupt, is a cold start */
+    State.Signature = I2C_APP_CDS_SIGNATURE + 1;
+    UT_SetDeferredRetcode(UT_KEY(CFE_ES_RegisterCDS), 1, CFE_ES_CDS_ALREADY_EXISTS);
+    UT_SetDataBuffer(UT_KEY(CFE_ES_RestoreFromCDS), &State, sizeof(State), false);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_CDS_ERR_EID, "I2C: saved state unusable, starting cold, RC = 0x%08lX");
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.WarmStart);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.PathActive);
+    UtAssert_INT32_EQ(I2C_APP_Data.OdomLeft, 0);
+
+    UT_SetDeferredRetcode(UT_KEY(CFE_ES_RegisterCDS), 1, CFE_ES_CDS_ALREADY_EXISTS);
+    UT_SetDeferredRetcode(UT_KEY(CFE_ES_RestoreFromCDS), 1, CFE_ES_CDS_BLOCK_CRC_ERR);
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.WarmStart);
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 2);
+
+    /* a failed write stops the saving, rather than failing every cycle */
+    UT_SetDeferredRetcode(UT_KEY(CFE_ES_CopyToCDS), 1, CFE_ES_ERR_RESOURCEID_NOT_VALID);
+    UT_CHECKEVENT_SETUP(&EventTest, I2C_APP_CDS_ERR_EID, NULL);
+    I2C_APP_SaveState();
+    UtAssert_UINT32_EQ(EventTest.MatchCount, 1);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.CdsEnabled);
+    I2C_APP_Data.OdomLeft = 7;
+    I2C_APP_SaveState();
+    UtAssert_STUB_COUNT(CFE_ES_CopyToCDS, 4);
+
+    /* odometry starts at the first reading and follows the encoders across their wrap */
+    I2C_APP_Data.OdomLeft  = 0;
+    I2C_APP_Data.OdomRight = 0;
+    I2C_APP_Data.OdomValid = false;
+    memset(&Telem, 0, sizeof(Telem));
+    Telem.l_enc = 32760;
+    Telem.r_enc = -32760;
+    I2C_APP_UpdateOdometry(&Telem);
+    UtAssert_INT32_EQ(I2C_APP_Data.OdomLeft, 0);
+    Telem.l_enc = -32766;
+    Telem.r_enc = 32766;
+    I2C_APP_UpdateOdometry(&Telem);
+    UtAssert_INT32_EQ(I2C_APP_Data.OdomLeft, 10);
+    UtAssert_INT32_EQ(I2C_APP_Data.OdomRight, -10);
+}
+
+void Test_I2C_APP_GetCrc(void)
+{
+    /*
+     * Test Case For:
+     * void I2C_APP_GetCrc( const char *TableName )
      */
 
     /*
@@ -586,41 +2380,81 @@ void Test_SAMPLE_APP_GetCrc(void)
      */
 
     UT_SetDefaultReturnValue(UT_KEY(CFE_TBL_GetInfo), CFE_TBL_ERR_INVALID_NAME);
-    SAMPLE_APP_GetCrc("UT");
+    I2C_APP_GetCrc("UT");
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 1);
 
     UT_ClearDefaultReturnValue(UT_KEY(CFE_TBL_GetInfo));
-    SAMPLE_APP_GetCrc("UT");
+    I2C_APP_GetCrc("UT");
     UtAssert_STUB_COUNT(CFE_ES_WriteToSysLog, 2);
 }
 
+/*
+ * Hook that runs a child task to the end as soon as it is created, as if
+ * it had finished before its parent next looked
+ */
+static int32 UT_ChildTask_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    CFE_ES_ChildTaskMainFuncPtr_t FunctionPtr =
+        UT_Hook_GetArgValueByName(Context, "FunctionPtr", CFE_ES_ChildTaskMainFuncPtr_t);
+
+    if (StubRetcode == CFE_SUCCESS)
+    {
+        FunctionPtr();
+    }
+
+    return StubRetcode;
+}
+
 /*
  * Setup function prior to every test
  */
-void Sample_UT_Setup(void)
+void I2C_UT_Setup(void)
 {
+    static I2C_APP_Table_t  DefaultTable = UT_I2C_APP_DEFAULT_TABLE;
+    static I2C_APP_Table_t *DefaultTablePtr;
+
     UT_ResetState(0);
+
+    DefaultTablePtr = &DefaultTable;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &DefaultTablePtr, sizeof(DefaultTablePtr), false);
+    UT_SetHookFunction(UT_KEY(CFE_ES_CreateChildTask), UT_ChildTask_Hook, NULL);
 }
 
 /*
  * Teardown function after every test
  */
-void Sample_UT_TearDown(void) {}
+void I2C_UT_TearDown(void) {}
 
 /*
  * Register the test cases to execute with the unit test tool
  */
 void UtTest_Setup(void)
 {
-    ADD_TEST(SAMPLE_APP_Main);
-    ADD_TEST(SAMPLE_APP_Init);
-    ADD_TEST(SAMPLE_APP_ProcessCommandPacket);
-    ADD_TEST(SAMPLE_APP_ProcessGroundCommand);
-    ADD_TEST(SAMPLE_APP_ReportHousekeeping);
-    ADD_TEST(SAMPLE_APP_NoopCmd);
-    ADD_TEST(SAMPLE_APP_ResetCounters);
-    ADD_TEST(SAMPLE_APP_ProcessCC);
-    ADD_TEST(SAMPLE_APP_VerifyCmdLength);
-    ADD_TEST(SAMPLE_APP_TblValidationFunc);
-    ADD_TEST(SAMPLE_APP_GetCrc);
+    ADD_TEST(I2C_APP_Main);
+    ADD_TEST(I2C_APP_Init);
+    ADD_TEST(I2C_APP_Init_BusFailure);
+    ADD_TEST(I2C_APP_Startup);
+    ADD_TEST(I2C_OPEN_BUS);
+    ADD_TEST(I2C_APP_Send);
+    ADD_TEST(I2C_APP_Receive);
+    ADD_TEST(I2C_APP_ReadRegs);
+    ADD_TEST(I2C_APP_Identify);
+    ADD_TEST(I2C_APP_Discover);
+    ADD_TEST(I2C_APP_SendCommand);
+    ADD_TEST(I2C_APP_CommandPathBudget);
+    ADD_TEST(I2C_APP_ProcessCommandPacket);
+    ADD_TEST(I2C_APP_ProcessGroundCommand);
+    ADD_TEST(I2C_APP_ReportHousekeeping);
+    ADD_TEST(I2C_APP_Wakeup);
+    ADD_TEST(I2C_APP_NoopCmd);
+    ADD_TEST(I2C_APP_MotionCmds);
+    ADD_TEST(I2C_APP_RunPath);
+    ADD_TEST(I2C_APP_EStop);
+    ADD_TEST(I2C_APP_ResetCounters);
+    ADD_TEST(I2C_APP_ReportConfig);
+    ADD_TEST(I2C_APP_VerifyCmdLength);
+    ADD_TEST(I2C_APP_TblValidationFunc);
+    ADD_TEST(I2C_APP_Config);
+    ADD_TEST(I2C_APP_Cds);
+    ADD_TEST(I2C_APP_GetCrc);
 }
@@ -19,11 +19,11 @@
 /**
  * @file
  *
- * Common definitions for all sample_app coverage tests
+ * Common definitions for all i2c_app coverage tests
  */
 
-#ifndef SAMPLE_APP_COVERAGETEST_COMMON_H
-#define SAMPLE_APP_COVERAGETEST_COMMON_H
+#ifndef I2C_APP_COVERAGETEST_COMMON_H
+#define I2C_APP_COVERAGETEST_COMMON_H
 
 /*
  * Includes
@@ -34,23 +34,44 @@
 #include "utstubs.h"
 
 #include "cfe.h"
-#include "sample_app_events.h"
-#include "sample_app.h"
-#include "sample_app_table.h"
+#include "i2c_app_events.h"
+#include "i2c_app.h"
+#include "i2c_app_table.h"
+#include "ut_posix_stubs.h"
 
 /*
  * Macro to add a test case to the list of tests to execute
  */
-#define ADD_TEST(test) UtTest_Add((Test_##test), Sample_UT_Setup, Sample_UT_TearDown, #test)
+#define ADD_TEST(test) UtTest_Add((Test_##test), I2C_UT_Setup, I2C_UT_TearDown, #test)
+
+/*
+ * Maximum number of bus syscalls (see UT_PosixStubs_GetSyscallCount) that
+ * one motion command may cost on the command path.  A command is a single
+ * register write, so anything above this is overhead on the hot path.
+ */
+#define UT_I2C_APP_CMD_SYSCALL_BUDGET 1
+
+/*
+ * Initializer for a valid configuration table matching the built-in
+ * defaults.  Setup points CFE_TBL_GetAddress at one, so a test that loads
+ * the table runs with a usable image unless it supplies its own.
+ */
+#define UT_I2C_APP_DEFAULT_TABLE                                                                               \
+    {                                                                                                          \
+        .NumDevices = 1, .Discover = I2C_APP_DISCOVER,                                                       \
+        .Devices = {{.BusNum = I2C_APP_BUS_NUM, .Address = I2C_ADDRESS}}, .PollDivider = 1,                 \
+        .TransferFeatures = I2C_APP_SUPPORTED_FEATURES, .CountsPerM = I2C_APP_COUNTS_PER_M,                  \
+        .WheelBaseMm = I2C_APP_WHEEL_BASE_MM, .MaxWheelSpeed = I2C_APP_MAX_WHEEL_SPEED                        \
+    }
 
 /*
  * Setup function prior to every test
  */
-void Sample_UT_Setup(void);
+void I2C_UT_Setup(void);
 
 /*
  * Teardown function after every test
  */
-void Sample_UT_TearDown(void);
+void I2C_UT_TearDown(void);
 
-#endif /* SAMPLE_APP_COVERAGETEST_COMMON_H */
+#endif /* I2C_APP_COVERAGETEST_COMMON_H */
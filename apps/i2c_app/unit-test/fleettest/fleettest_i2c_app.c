@@ -0,0 +1,399 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+** File: fleettest_i2c_app.c
+**
+** Purpose:
+** Fleet scaling benchmark for the I2C Application
+**
+** Notes:
+** Puts N simulated robots on the simulated bus in ../sim and runs the
+** per-robot control cycle through the app: one motion command through
+** the real dispatch (I2C_APP_ProcessCommandPacket -> bus write) and one
+** telemetry poll (I2C_APP_Receive) for every robot, every cycle.  For
+** each control rate N is ramped until the rate can no longer be held.
+**
+** Each cycle is costed from three sources:
+**
+**   - bus time, from the simulator's virtual clock (wire time at the
+**     configured SCL rate, slave byte delay, syscall overhead);
+**   - app CPU time, measured on this host with the thread CPU clock.
+**     It includes the UT stub overhead, so treat it as an upper bound,
+**     and run the benchmark on the target for real numbers;
+**   - software bus routing, a fixed cost per command message, because
+**     the SB itself is stubbed out here.
+**
+** The app does all of this synchronously in one thread, so the app
+** thread is always the first thing to saturate; the report says whether
+** it was waiting on the bus or busy on the CPU at that point, and gives
+** per-bus and CPU utilization so the next limit is visible too.  The
+** command pipe depth is checked separately, since one command per robot
+** arrives per cycle.
+**
+** Environment:
+**
+**   I2C_APP_FLEET_RATES       comma separated control rates in Hz (default 10,20,50,100)
+**   I2C_APP_FLEET_MAX_ROBOTS  largest fleet to try (default 32)
+**   I2C_APP_FLEET_BUSES       number of I2C buses robots are spread over (default 1)
+**   I2C_APP_FLEET_BUS_HZ      SCL rate (default 100000)
+**   I2C_APP_FLEET_SB_NS       SB routing cost per command (default 25000)
+*/
+
+/*
+ * Includes
+ */
+
+#include "i2c_app_coveragetest_common.h"
+#include "ut_i2c_app.h"
+#include "ut_i2c_bus_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define UT_FLEET_DEFAULT_RATES      "10,20,50,100"
+#define UT_FLEET_DEFAULT_MAX_ROBOTS 32
+#define UT_FLEET_DEFAULT_BUSES      1
+#define UT_FLEET_DEFAULT_SB_NS      25000
+#define UT_FLEET_MAX_RATES          16
+
+/* Control cycles simulated per (rate, N) point */
+#define UT_FLEET_CYCLES 50
+
+/* Robots take consecutive addresses from the firmware default on each bus */
+#define UT_FLEET_FIRST_BUS 1
+
+/* Kernel entry plus i2c-dev cost of one syscall on the target */
+#define UT_FLEET_SYSCALL_NS 5000
+
+/* Firmware PololuRPiSlave delay before each transmitted byte */
+#define UT_FLEET_SLAVE_BYTE_DELAY_NS 5000
+
+/* A rate counts as held if the achieved rate is within this of the target */
+#define UT_FLEET_RATE_TOLERANCE_PCT 1
+
+typedef struct
+{
+    uint8 Regs[I2C_PACKET_SIZE];
+    int   Fd;
+    int   Bus;
+} UT_Fleet_Robot_t;
+
+typedef struct
+{
+    double AchievedHz;   /* per robot */
+    double CpuNsPerRobot;
+    double CpuUtil;
+    double ThreadUtil;
+    double BusUtil[UT_I2C_BUS_SIM_MAX_BUSES];
+    double BusWaitShare; /* of the app thread's time, how much was bus */
+    uint32 BadFdCalls;
+    uint32 Failures;
+} UT_Fleet_Result_t;
+
+static UT_Fleet_Robot_t UT_Fleet_Robots[UT_I2C_BUS_SIM_MAX_SLAVES];
+
+static uint32 UT_Fleet_GetEnv(const char *Name, uint32 Default)
+{
+    const char *Value = getenv(Name);
+
+    return (Value != NULL && atol(Value) > 0) ? (uint32)atol(Value) : Default;
+}
+
+static uint32 UT_Fleet_ParseRates(uint32 *Rates)
+{
+    const char *Spec  = getenv("I2C_APP_FLEET_RATES");
+    char *      End;
+    uint32      Count = 0;
+    unsigned long Value;
+
+    if (Spec == NULL || *Spec == 0)
+    {
+        Spec = UT_FLEET_DEFAULT_RATES;
+    }
+
+    while (*Spec != 0 && Count < UT_FLEET_MAX_RATES)
+    {
+        Value = strtoul(Spec, &End, 10);
+        if (End == Spec)
+        {
+            break;
+        }
+        if (Value > 0)
+        {
+            Rates[Count++] = (uint32)Value;
+        }
+        Spec = (*End == ',') ? End + 1 : End;
+    }
+
+    return Count;
+}
+
+static uint64 UT_Fleet_CpuNow(void)
+{
+    struct timespec Ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Ts);
+
+    return (uint64)Ts.tv_sec * 1000000000 + Ts.tv_nsec;
+}
+
+/*
+ * Run UT_FLEET_CYCLES control cycles of NumRobots robots at RateHz
+ */
+static void UT_Fleet_Run(uint32 RateHz, uint32 NumRobots, uint32 NumBuses, uint32 BusHz, uint32 SbNs,
+                         UT_Fleet_Result_t *Result)
+{
+    union
+    {
+        CFE_SB_Buffer_t             SBBuf;
+        I2C_APP_SetWheelSpeedsCmd_t Speeds;
+    } TestMsg;
+    CFE_SB_MsgId_t        TestMsgId = CFE_SB_ValueToMsgId(I2C_APP_CMD_MID);
+    CFE_MSG_FcnCode_t     FcnCode   = I2C_APP_SET_WHEEL_SPEEDS_CC;
+    size_t                MsgSize   = sizeof(TestMsg.Speeds);
+    I2C_Telem_Packet      Telem;
+    UT_I2CBusSim_Config_t SimConfig;
+    UT_I2CBusSim_Stats_t  SimStats;
+    uint64                PeriodNs = 1000000000ULL / RateHz;
+    uint64                FirstStart;
+    uint64                End    = 0;
+    uint64                CpuNs  = 0;
+    uint64                WallNs = 0;
+    uint64                KernelNs;
+    uint32                SetupSyscalls;
+    uint32                c;
+    uint32                r;
+    uint32                b;
+
+    memset(Result, 0, sizeof(*Result));
+    memset(&TestMsg, 0, sizeof(TestMsg));
+
+    UT_ResetState(0);
+    memset(&SimConfig, 0, sizeof(SimConfig));
+    SimConfig.BusHz             = BusHz;
+    SimConfig.SyscallOverheadNs = UT_FLEET_SYSCALL_NS;
+    UT_I2CBusSim_Init(&SimConfig);
+
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &MsgSize, sizeof(MsgSize), false);
+
+    for (r = 0; r < NumRobots; ++r)
+    {
+        UT_Fleet_Robot_t *Robot   = &UT_Fleet_Robots[r];
+        int               Address = I2C_ADDRESS + (int)(r / NumBuses);
+
+        memset(Robot, 0, sizeof(*Robot));
+        Robot->Bus = UT_FLEET_FIRST_BUS + (r % NumBuses);
+        UT_I2CBusSim_AddSlave(Robot->Bus, Address, Robot->Regs, sizeof(Robot->Regs), UT_FLEET_SLAVE_BYTE_DELAY_NS);
+        if (I2C_OPEN_BUS(Robot->Bus, Address, &Robot->Fd) != CFE_SUCCESS)
+        {
+            ++Result->Failures;
+        }
+    }
+
+    UT_I2CBusSim_GetStats(&SimStats);
+    SetupSyscalls = SimStats.Opens + UT_GetStubCount(UT_KEY(OCS_ioctl));
+
+    I2C_APP_Data.BusFaulted = false;
+    FirstStart              = UT_I2CBusSim_GetTime();
+
+    for (c = 0; c < UT_FLEET_CYCLES; ++c)
+    {
+        uint64 Start    = FirstStart + c * PeriodNs;
+        uint64 CycleCpu = 0;
+        uint64 Cpu0;
+
+        /* a cycle that overran pushes the next one back */
+        if (End > Start)
+        {
+            Start = End;
+        }
+        UT_I2CBusSim_SetTime(Start);
+
+        for (r = 0; r < NumRobots; ++r)
+        {
+            UT_Fleet_Robot_t *Robot = &UT_Fleet_Robots[r];
+
+            Cpu0 = UT_Fleet_CpuNow();
+
+            I2C_APP_Data.i2c_fd = Robot->Fd;
+            I2C_APP_ProcessCommandPacket(&TestMsg.SBBuf);
+            Robot->Fd = I2C_APP_Data.i2c_fd;
+
+            if (I2C_APP_Receive(Robot->Fd, &Telem) != CFE_SUCCESS)
+            {
+                ++Result->Failures;
+            }
+
+            CycleCpu += UT_Fleet_CpuNow() - Cpu0;
+        }
+
+        /* the simulator clock covers the syscalls; app CPU and SB routing come on top */
+        WallNs += UT_I2CBusSim_GetTime() - Start;
+        CycleCpu += (uint64)SbNs * NumRobots;
+        CpuNs += CycleCpu;
+        End = UT_I2CBusSim_GetTime() + CycleCpu;
+    }
+
+    /*
+     * Per cycle averages.  The kernel side of each syscall is CPU time,
+     * the rest of the simulated time is the thread blocked on the bus.
+     */
+    UT_I2CBusSim_GetStats(&SimStats);
+    KernelNs = (uint64)(SimStats.Opens + SimStats.Closes + SimStats.Transfers + UT_GetStubCount(UT_KEY(OCS_ioctl)) -
+                        SetupSyscalls) *
+               UT_FLEET_SYSCALL_NS;
+    CpuNs  = (CpuNs + KernelNs) / UT_FLEET_CYCLES;
+    WallNs = (WallNs - KernelNs) / UT_FLEET_CYCLES;
+
+    Result->AchievedHz    = 1e9 * UT_FLEET_CYCLES / (double)(End - FirstStart);
+    if (Result->AchievedHz > RateHz)
+    {
+        Result->AchievedHz = RateHz;
+    }
+    Result->CpuNsPerRobot = (double)CpuNs / NumRobots;
+    Result->CpuUtil       = (double)CpuNs / PeriodNs;
+    Result->ThreadUtil    = (double)(WallNs + CpuNs) / PeriodNs;
+    Result->BusWaitShare  = (double)WallNs / (double)(WallNs + CpuNs);
+    Result->BadFdCalls    = SimStats.BadFdCalls;
+
+    for (b = 0; b < NumBuses; ++b)
+    {
+        Result->BusUtil[b] =
+            (double)UT_I2CBusSim_GetBusyTime(UT_FLEET_FIRST_BUS + b) / UT_FLEET_CYCLES / PeriodNs;
+    }
+}
+
+static void UT_Fleet_Report(uint32 RateHz, uint32 NumRobots, uint32 NumBuses, const UT_Fleet_Result_t *Result)
+{
+    char   BusCol[64];
+    size_t Len = 0;
+    uint32 b;
+
+    BusCol[0] = 0;
+    for (b = 0; b < NumBuses && Len < sizeof(BusCol); ++b)
+    {
+        Len += snprintf(BusCol + Len, sizeof(BusCol) - Len, " %5.1f", 100.0 * Result->BusUtil[b]);
+    }
+
+    UtPrintf("FLEET %4luHz %4lu %11.1f Hz %8.1f us %6.1f %8.1f %s", (unsigned long)RateHz, (unsigned long)NumRobots,
+             Result->AchievedHz, Result->CpuNsPerRobot / 1000.0, 100.0 * Result->CpuUtil, 100.0 * Result->ThreadUtil,
+             BusCol);
+}
+
+void Test_I2C_APP_Fleet(void)
+{
+    uint32            Rates[UT_FLEET_MAX_RATES];
+    uint32            NumRates   = UT_Fleet_ParseRates(Rates);
+    uint32            MaxRobots  = UT_Fleet_GetEnv("I2C_APP_FLEET_MAX_ROBOTS", UT_FLEET_DEFAULT_MAX_ROBOTS);
+    uint32            NumBuses   = UT_Fleet_GetEnv("I2C_APP_FLEET_BUSES", UT_FLEET_DEFAULT_BUSES);
+    uint32            BusHz      = UT_Fleet_GetEnv("I2C_APP_FLEET_BUS_HZ", 100000);
+    uint32            SbNs       = UT_Fleet_GetEnv("I2C_APP_FLEET_SB_NS", UT_FLEET_DEFAULT_SB_NS);
+    UT_Fleet_Result_t Result;
+    uint32            i;
+    uint32            n;
+
+    if (MaxRobots > UT_I2C_BUS_SIM_MAX_SLAVES)
+    {
+        MaxRobots = UT_I2C_BUS_SIM_MAX_SLAVES;
+    }
+    if (NumBuses > UT_I2C_BUS_SIM_MAX_BUSES - UT_FLEET_FIRST_BUS)
+    {
+        NumBuses = UT_I2C_BUS_SIM_MAX_BUSES - UT_FLEET_FIRST_BUS;
+    }
+
+    UtPrintf("FLEET %lu bus(es) at %lu Hz, SB %lu ns/cmd, pipe depth %d, up to %lu robots",
+             (unsigned long)NumBuses, (unsigned long)BusHz, (unsigned long)SbNs, I2C_APP_PIPE_DEPTH,
+             (unsigned long)MaxRobots);
+    UtPrintf("FLEET  rate    N  achieved/robot  cpu/robot   cpu%%  thread%%  bus%% (per bus)");
+
+    for (i = 0; i < NumRates; ++i)
+    {
+        const char *      Bottleneck = NULL;
+        uint32            Sustained  = 0;
+        uint32            Printed    = 0;
+        UT_Fleet_Result_t Previous;
+
+        memset(&Previous, 0, sizeof(Previous));
+
+        for (n = 1; n <= MaxRobots && Bottleneck == NULL; ++n)
+        {
+            UT_Fleet_Run(Rates[i], n, NumBuses, BusHz, SbNs, &Result);
+
+            UtAssert_UINT32_EQ(Result.BadFdCalls, 0);
+            UtAssert_UINT32_EQ(Result.Failures, 0);
+
+            if (n > I2C_APP_PIPE_DEPTH)
+            {
+                Bottleneck = "command pipe depth (one command per robot per cycle)";
+            }
+            else if (Result.AchievedHz * 100 < (double)Rates[i] * (100 - UT_FLEET_RATE_TOLERANCE_PCT))
+            {
+                Bottleneck = (Result.BusWaitShare >= 0.5) ? "app thread, waiting on the bus" : "app thread, CPU";
+            }
+            else
+            {
+                Sustained = n;
+            }
+
+            /* powers of two, plus the knee */
+            if (Bottleneck != NULL && n > 1 && (n - 1) != Printed)
+            {
+                UT_Fleet_Report(Rates[i], n - 1, NumBuses, &Previous);
+            }
+            if (Bottleneck != NULL || (n & (n - 1)) == 0)
+            {
+                UT_Fleet_Report(Rates[i], n, NumBuses, &Result);
+                Printed = n;
+            }
+            Previous = Result;
+        }
+
+        UtPrintf("FLEET %4luHz: %lu robot(s) sustained; first bottleneck: %s", (unsigned long)Rates[i],
+                 (unsigned long)Sustained, Bottleneck ? Bottleneck : "none within the fleet sizes tried");
+    }
+
+    /* one robot at the slowest rate is always within reach */
+    UT_Fleet_Run(Rates[0], 1, NumBuses, BusHz, SbNs, &Result);
+    UtAssert_True(Result.AchievedHz * 100 >= (double)Rates[0] * (100 - UT_FLEET_RATE_TOLERANCE_PCT),
+                  "single robot holds %lu Hz (%.1f Hz)", (unsigned long)Rates[0], Result.AchievedHz);
+}
+
+/*
+ * Setup function prior to every test
+ */
+void I2C_UT_Setup(void)
+{
+    UT_ResetState(0);
+}
+
+/*
+ * Teardown function after every test
+ */
+void I2C_UT_TearDown(void) {}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(I2C_APP_Fleet);
+}
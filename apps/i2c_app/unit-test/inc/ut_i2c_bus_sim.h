@@ -0,0 +1,114 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Purpose:
+ * Simulated Linux I2C bus behind the POSIX stubs
+ *
+ * Notes:
+ * The simulator attaches hooks to the OCS_ open/close/ioctl/read/write
+ * stubs and behaves like i2c-dev: "/dev/i2c-N" opens an adapter, the
+ * I2C_SLAVE ioctl selects an address, and each read/write is one bus
+ * transaction against a register block owned by the test.
+ *
+ * Time is virtual.  Every transaction advances the simulator clock by
+ * its wire time (9 bits per byte including the address byte, at the
+ * configured SCL rate), the slave's per-byte delay, and a fixed syscall
+ * overhead, so long runs complete in host seconds and are reproducible.
+ *
+ * Faults can be injected per slave (NACK, SCL hang until the adapter
+ * times out) or per adapter (device node gone), and transient NACKs are
+ * drawn from a seeded PRNG.  The simulator also tracks descriptor use so
+ * tests can assert that nothing leaks or is used after close().
+ */
+
+#ifndef UT_I2C_BUS_SIM_H
+#define UT_I2C_BUS_SIM_H
+
+#include "common_types.h"
+
+#include <stddef.h>
+
+#define UT_I2C_BUS_SIM_MAX_BUSES  8
+#define UT_I2C_BUS_SIM_MAX_SLAVES 32
+#define UT_I2C_BUS_SIM_MAX_FDS    64
+
+/* First descriptor number handed out, after stdin/stdout/stderr */
+#define UT_I2C_BUS_SIM_FIRST_FD 3
+
+typedef enum
+{
+    UT_I2C_BUS_SIM_FAULT_NONE = 0,
+    UT_I2C_BUS_SIM_FAULT_NACK,   /**< Slave does not acknowledge its address (unplugged, browned out) */
+    UT_I2C_BUS_SIM_FAULT_TIMEOUT /**< Slave holds SCL low; every transfer waits out the adapter timeout */
+} UT_I2CBusSim_Fault_t;
+
+typedef struct
+{
+    uint32 BusHz;             /**< SCL clock rate */
+    uint32 SyscallOverheadNs; /**< Kernel entry and i2c-dev cost of one call */
+    uint32 AdapterTimeoutNs;  /**< How long a transfer to a hung slave blocks */
+    uint32 Seed;              /**< PRNG seed for transient faults */
+} UT_I2CBusSim_Config_t;
+
+typedef struct
+{
+    uint32 Opens;
+    uint32 FailedOpens;
+    uint32 Closes;
+    uint32 Transfers;       /**< read/write calls that reached an adapter */
+    uint32 FailedTransfers; /**< of which did not complete */
+    uint32 BadFdCalls;      /**< calls on a descriptor that was never opened or already closed */
+    uint32 OpenFds;
+    uint32 PeakOpenFds;
+    uint64 BytesOnWire;
+} UT_I2CBusSim_Stats_t;
+
+/*
+ * Reset the simulator and attach it to the POSIX stubs.  Must be called
+ * after UT_ResetState(), which removes the hooks.  A NULL config selects
+ * the defaults (100 kHz, 5 us syscall overhead, 25 ms adapter timeout).
+ */
+void UT_I2CBusSim_Init(const UT_I2CBusSim_Config_t *Config);
+
+/*
+ * Attach a slave at Address on /dev/i2c-Bus, backed by the test's
+ * register block.  ByteDelayNs models a slave that stretches the clock
+ * on every byte it transmits.  Returns the slave id, or -1 if full.
+ */
+int32 UT_I2CBusSim_AddSlave(uint32 Bus, uint16 Address, uint8 *Regs, size_t RegSize, uint32 ByteDelayNs);
+
+void UT_I2CBusSim_SetSlaveFault(int32 SlaveId, UT_I2CBusSim_Fault_t Fault);
+void UT_I2CBusSim_SetNackRate(int32 SlaveId, uint32 PerMillion);
+void UT_I2CBusSim_SetAdapterDown(uint32 Bus, bool Down);
+
+/*
+ * Virtual clock, in nanoseconds.  SetTime only moves forward; use it to
+ * idle the bus until the next scheduled event.
+ */
+uint64 UT_I2CBusSim_GetTime(void);
+void   UT_I2CBusSim_SetTime(uint64 TimeNs);
+
+/* Total time the given adapter spent on the wire or waiting on a slave */
+uint64 UT_I2CBusSim_GetBusyTime(uint32 Bus);
+
+void UT_I2CBusSim_GetStats(UT_I2CBusSim_Stats_t *Stats);
+
+#endif /* UT_I2C_BUS_SIM_H */
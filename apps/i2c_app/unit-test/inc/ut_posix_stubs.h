@@ -0,0 +1,78 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Purpose:
+ * Stub declarations for the POSIX calls used by the i2c_app bus code
+ *
+ * Notes:
+ * The headers in override_inc map open/ioctl/read/write/... onto these
+ * OCS_ ("override C standard") names when compiling the unit under test,
+ * so the coverage test can control and count every bus syscall.
+ */
+
+#ifndef UT_POSIX_STUBS_H
+#define UT_POSIX_STUBS_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#define OCS_O_RDWR 0x02
+
+#define OCS_I2C_SLAVE 0x0703
+#define OCS_I2C_RDWR  0x0707
+#define OCS_I2C_M_RD  0x0001
+
+struct OCS_i2c_msg
+{
+    unsigned short addr;
+    unsigned short flags;
+    unsigned short len;
+    unsigned char *buf;
+};
+
+struct OCS_i2c_rdwr_ioctl_data
+{
+    struct OCS_i2c_msg *msgs;
+    unsigned int        nmsgs;
+};
+
+int     OCS_open(const char *pathname, int flags, ...);
+int     OCS_close(int fd);
+int     OCS_ioctl(int fd, unsigned long request, ...);
+ssize_t OCS_read(int fd, void *buf, size_t count);
+ssize_t OCS_write(int fd, const void *buf, size_t count);
+int     OCS_fsync(int fd);
+unsigned int OCS_sleep(unsigned int seconds);
+int          OCS_usleep(unsigned int usec);
+
+/*
+ * Total number of bus syscalls (open/close/ioctl/read/write/fsync)
+ * made through the stubs since the last UT_ResetState()
+ */
+unsigned int UT_PosixStubs_GetSyscallCount(void);
+
+/*
+ * Total number of blocking sleep calls (sleep/usleep) made through
+ * the stubs since the last UT_ResetState()
+ */
+unsigned int UT_PosixStubs_GetSleepCount(void);
+
+#endif /* UT_POSIX_STUBS_H */
@@ -0,0 +1,35 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Override of <linux/i2c-dev.h> for the i2c_app coverage test
+ */
+
+#ifndef OVERRIDE_LINUX_I2C_DEV_H
+#define OVERRIDE_LINUX_I2C_DEV_H
+
+#include "ut_posix_stubs.h"
+
+#define I2C_SLAVE OCS_I2C_SLAVE
+#define I2C_RDWR  OCS_I2C_RDWR
+
+#define i2c_rdwr_ioctl_data OCS_i2c_rdwr_ioctl_data
+
+#endif /* OVERRIDE_LINUX_I2C_DEV_H */
@@ -0,0 +1,37 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Override of <unistd.h> for the i2c_app coverage test
+ */
+
+#ifndef OVERRIDE_UNISTD_H
+#define OVERRIDE_UNISTD_H
+
+#include "ut_posix_stubs.h"
+
+#define close  OCS_close
+#define read   OCS_read
+#define write  OCS_write
+#define fsync  OCS_fsync
+#define sleep  OCS_sleep
+#define usleep OCS_usleep
+
+#endif /* OVERRIDE_UNISTD_H */
@@ -0,0 +1,487 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Simulated Linux I2C bus, implemented as hooks on the POSIX stubs
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "utstubs.h"
+#include "ut_posix_stubs.h"
+#include "ut_i2c_bus_sim.h"
+
+#define UT_I2C_BUS_SIM_DEFAULT_HZ         100000
+#define UT_I2C_BUS_SIM_DEFAULT_SYSCALL_NS 5000
+#define UT_I2C_BUS_SIM_DEFAULT_TIMEOUT_NS 25000000
+
+/* Bits on the wire per byte (8 data + ACK), plus START/STOP per transfer */
+#define UT_I2C_BUS_SIM_BITS_PER_BYTE 9
+#define UT_I2C_BUS_SIM_FRAME_BITS    2
+
+typedef struct
+{
+    bool                 InUse;
+    uint32               Bus;
+    uint16               Address;
+    uint8 *              Regs;
+    size_t               RegSize;
+    size_t               RegPtr;
+    uint32               ByteDelayNs;
+    UT_I2CBusSim_Fault_t Fault;
+    uint32               NackPerMillion;
+} UT_I2CBusSim_Slave_t;
+
+typedef struct
+{
+    bool   IsOpen;
+    uint32 Bus;
+    bool   AddressSet;
+    uint16 Address;
+} UT_I2CBusSim_Fd_t;
+
+static struct
+{
+    UT_I2CBusSim_Config_t Config;
+    UT_I2CBusSim_Slave_t  Slaves[UT_I2C_BUS_SIM_MAX_SLAVES];
+    UT_I2CBusSim_Fd_t     Fds[UT_I2C_BUS_SIM_MAX_FDS];
+    bool                  AdapterDown[UT_I2C_BUS_SIM_MAX_BUSES];
+    uint64                BusyNs[UT_I2C_BUS_SIM_MAX_BUSES];
+    uint64                Now;
+    uint32                Rng;
+    UT_I2CBusSim_Stats_t  Stats;
+} UT_I2CBusSim;
+
+/* xorshift32: small, fast, and identical on every host */
+static uint32 UT_I2CBusSim_Random(void)
+{
+    uint32 x = UT_I2CBusSim.Rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    UT_I2CBusSim.Rng = x;
+
+    return x;
+}
+
+static UT_I2CBusSim_Fd_t *UT_I2CBusSim_LookupFd(int fd)
+{
+    int Idx = fd - UT_I2C_BUS_SIM_FIRST_FD;
+
+    if (Idx < 0 || Idx >= UT_I2C_BUS_SIM_MAX_FDS || !UT_I2CBusSim.Fds[Idx].IsOpen)
+    {
+        ++UT_I2CBusSim.Stats.BadFdCalls;
+        return NULL;
+    }
+
+    return &UT_I2CBusSim.Fds[Idx];
+}
+
+static UT_I2CBusSim_Slave_t *UT_I2CBusSim_LookupSlave(uint32 Bus, uint16 Address)
+{
+    uint32 i;
+
+    for (i = 0; i < UT_I2C_BUS_SIM_MAX_SLAVES; ++i)
+    {
+        if (UT_I2CBusSim.Slaves[i].InUse && UT_I2CBusSim.Slaves[i].Bus == Bus &&
+            UT_I2CBusSim.Slaves[i].Address == Address)
+        {
+            return &UT_I2CBusSim.Slaves[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void UT_I2CBusSim_Spend(uint32 Bus, uint64 BusNs)
+{
+    UT_I2CBusSim.Now += UT_I2CBusSim.Config.SyscallOverheadNs + BusNs;
+    UT_I2CBusSim.BusyNs[Bus] += BusNs;
+}
+
+static uint64 UT_I2CBusSim_WireNs(size_t Bytes)
+{
+    uint64 Bits = (uint64)Bytes * UT_I2C_BUS_SIM_BITS_PER_BYTE + UT_I2C_BUS_SIM_FRAME_BITS;
+
+    UT_I2CBusSim.Stats.BytesOnWire += Bytes;
+
+    return (Bits * 1000000000) / UT_I2CBusSim.Config.BusHz;
+}
+
+/*
+ * Common front half of every transfer: resolve the descriptor and target
+ * address to a responsive slave, charging the bus for whatever part of the
+ * transfer happened before it failed.  Returns NULL (with errno set) on
+ * failure.
+ */
+static UT_I2CBusSim_Slave_t *UT_I2CBusSim_StartTransferTo(int fd, bool AddressSet, uint16 Address)
+{
+    UT_I2CBusSim_Fd_t *   Fd = UT_I2CBusSim_LookupFd(fd);
+    UT_I2CBusSim_Slave_t *Slave;
+
+    if (Fd == NULL)
+    {
+        UT_I2CBusSim.Now += UT_I2CBusSim.Config.SyscallOverheadNs;
+        errno = EBADF;
+        return NULL;
+    }
+
+    ++UT_I2CBusSim.Stats.Transfers;
+
+    if (UT_I2CBusSim.AdapterDown[Fd->Bus])
+    {
+        ++UT_I2CBusSim.Stats.FailedTransfers;
+        UT_I2CBusSim.Now += UT_I2CBusSim.Config.SyscallOverheadNs;
+        errno = ENODEV;
+        return NULL;
+    }
+
+    Slave = AddressSet ? UT_I2CBusSim_LookupSlave(Fd->Bus, Address) : NULL;
+
+    if (Slave != NULL && Slave->Fault == UT_I2C_BUS_SIM_FAULT_TIMEOUT)
+    {
+        ++UT_I2CBusSim.Stats.FailedTransfers;
+        UT_I2CBusSim_Spend(Fd->Bus, UT_I2CBusSim.Config.AdapterTimeoutNs);
+        errno = ETIMEDOUT;
+        return NULL;
+    }
+
+    if (Slave == NULL || Slave->Fault == UT_I2C_BUS_SIM_FAULT_NACK ||
+        (Slave->NackPerMillion != 0 && (UT_I2CBusSim_Random() % 1000000) < Slave->NackPerMillion))
+    {
+        /* the address byte goes out and nobody acknowledges it */
+        ++UT_I2CBusSim.Stats.FailedTransfers;
+        UT_I2CBusSim_Spend(Fd->Bus, UT_I2CBusSim_WireNs(1));
+        errno = EREMOTEIO;
+        return NULL;
+    }
+
+    return Slave;
+}
+
+/* read() and write() go to the address picked with I2C_SLAVE */
+static UT_I2CBusSim_Slave_t *UT_I2CBusSim_StartTransfer(int fd)
+{
+    UT_I2CBusSim_Fd_t *Fd = UT_I2CBusSim_LookupFd(fd);
+
+    return UT_I2CBusSim_StartTransferTo(fd, Fd != NULL && Fd->AddressSet, (Fd != NULL) ? Fd->Address : 0);
+}
+
+static int32 UT_I2CBusSim_OpenHook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    const char *Path = UT_Hook_GetArgValueByName(Context, "pathname", const char *);
+    unsigned    Bus;
+    int         Idx;
+
+    UT_I2CBusSim.Now += UT_I2CBusSim.Config.SyscallOverheadNs;
+
+    if (sscanf(Path, "/dev/i2c-%u", &Bus) != 1 || Bus >= UT_I2C_BUS_SIM_MAX_BUSES || UT_I2CBusSim.AdapterDown[Bus])
+    {
+        ++UT_I2CBusSim.Stats.FailedOpens;
+        errno = ENOENT;
+        return -1;
+    }
+
+    for (Idx = 0; Idx < UT_I2C_BUS_SIM_MAX_FDS; ++Idx)
+    {
+        if (!UT_I2CBusSim.Fds[Idx].IsOpen)
+        {
+            break;
+        }
+    }
+
+    if (Idx == UT_I2C_BUS_SIM_MAX_FDS)
+    {
+        ++UT_I2CBusSim.Stats.FailedOpens;
+        errno = EMFILE;
+        return -1;
+    }
+
+    memset(&UT_I2CBusSim.Fds[Idx], 0, sizeof(UT_I2CBusSim.Fds[Idx]));
+    UT_I2CBusSim.Fds[Idx].IsOpen = true;
+    UT_I2CBusSim.Fds[Idx].Bus    = Bus;
+
+    ++UT_I2CBusSim.Stats.Opens;
+    ++UT_I2CBusSim.Stats.OpenFds;
+    if (UT_I2CBusSim.Stats.OpenFds > UT_I2CBusSim.Stats.PeakOpenFds)
+    {
+        UT_I2CBusSim.Stats.PeakOpenFds = UT_I2CBusSim.Stats.OpenFds;
+    }
+
+    return Idx + UT_I2C_BUS_SIM_FIRST_FD;
+}
+
+static int32 UT_I2CBusSim_CloseHook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    UT_I2CBusSim_Fd_t *Fd = UT_I2CBusSim_LookupFd(UT_Hook_GetArgValueByName(Context, "fd", int));
+
+    UT_I2CBusSim.Now += UT_I2CBusSim.Config.SyscallOverheadNs;
+
+    if (Fd == NULL)
+    {
+        errno = EBADF;
+        return -1;
+    }
+
+    Fd->IsOpen = false;
+    ++UT_I2CBusSim.Stats.Closes;
+    --UT_I2CBusSim.Stats.OpenFds;
+
+    return 0;
+}
+
+/*
+ * I2C_RDWR: the messages go out as one transfer joined by repeated starts,
+ * so a register pointer write and the read behind it cannot be split by
+ * another master.  Only the write-then-read pair the app uses is modelled,
+ * each message carrying its own address like the real ioctl.
+ */
+static int32 UT_I2CBusSim_Combined(int fd, const struct OCS_i2c_rdwr_ioctl_data *Xfer)
+{
+    const struct OCS_i2c_msg *Wr;
+    const struct OCS_i2c_msg *Rd;
+    UT_I2CBusSim_Slave_t *    Slave;
+    size_t                    i;
+
+    if (Xfer == NULL || Xfer->nmsgs != 2 || (Xfer->msgs[0].flags & OCS_I2C_M_RD) != 0 ||
+        (Xfer->msgs[1].flags & OCS_I2C_M_RD) == 0 || Xfer->msgs[0].len != 1 ||
+        Xfer->msgs[0].addr != Xfer->msgs[1].addr)
+    {
+        UT_I2CBusSim.Now += UT_I2CBusSim.Config.SyscallOverheadNs;
+        errno = EINVAL;
+        return -1;
+    }
+    Wr = &Xfer->msgs[0];
+    Rd = &Xfer->msgs[1];
+
+    Slave = UT_I2CBusSim_StartTransferTo(fd, true, Wr->addr);
+    if (Slave == NULL)
+    {
+        return -1;
+    }
+
+    /* one START and STOP for both halves; the repeated start adds an address byte */
+    UT_I2CBusSim_Spend(Slave->Bus, UT_I2CBusSim_WireNs(1 + Wr->len + 1 + Rd->len) +
+                                       (uint64)Rd->len * Slave->ByteDelayNs);
+
+    Slave->RegPtr = Wr->buf[0];
+    for (i = 0; i < Rd->len; ++i)
+    {
+        Rd->buf[i] = (Slave->RegPtr < Slave->RegSize) ? Slave->Regs[Slave->RegPtr] : 0xFF;
+        ++Slave->RegPtr;
+    }
+
+    return 2;
+}
+
+static int32 UT_I2CBusSim_IoctlHook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    UT_I2CBusSim_Fd_t *Fd      = UT_I2CBusSim_LookupFd(UT_Hook_GetArgValueByName(Context, "fd", int));
+    unsigned long      Request = UT_Hook_GetArgValueByName(Context, "request", unsigned long);
+    unsigned long      Arg     = UT_Hook_GetArgValueByName(Context, "arg", unsigned long);
+
+    UT_I2CBusSim.Now += UT_I2CBusSim.Config.SyscallOverheadNs;
+
+    if (Fd == NULL)
+    {
+        errno = EBADF;
+        return -1;
+    }
+
+    if (Request == OCS_I2C_RDWR)
+    {
+        return UT_I2CBusSim_Combined(UT_Hook_GetArgValueByName(Context, "fd", int),
+                                     (const struct OCS_i2c_rdwr_ioctl_data *)Arg);
+    }
+
+    if (Request != OCS_I2C_SLAVE || Arg > 0x7F)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* like i2c-dev, selecting an address does not touch the bus */
+    Fd->AddressSet = true;
+    Fd->Address    = (uint16)Arg;
+
+    return 0;
+}
+
+static int32 UT_I2CBusSim_WriteHook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    const uint8 *         Buf   = UT_Hook_GetArgValueByName(Context, "buf", const uint8 *);
+    size_t                Count = UT_Hook_GetArgValueByName(Context, "count", size_t);
+    UT_I2CBusSim_Slave_t *Slave = UT_I2CBusSim_StartTransfer(UT_Hook_GetArgValueByName(Context, "fd", int));
+    size_t                i;
+
+    if (Slave == NULL)
+    {
+        return -1;
+    }
+
+    UT_I2CBusSim_Spend(Slave->Bus, UT_I2CBusSim_WireNs(1 + Count));
+
+    /* first byte sets the register pointer, the rest auto-increment */
+    if (Count > 0)
+    {
+        Slave->RegPtr = Buf[0];
+        for (i = 1; i < Count; ++i)
+        {
+            if (Slave->RegPtr < Slave->RegSize)
+            {
+                Slave->Regs[Slave->RegPtr] = Buf[i];
+            }
+            ++Slave->RegPtr;
+        }
+    }
+
+    return (int32)Count;
+}
+
+static int32 UT_I2CBusSim_ReadHook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    uint8 *               Buf   = UT_Hook_GetArgValueByName(Context, "buf", uint8 *);
+    size_t                Count = UT_Hook_GetArgValueByName(Context, "count", size_t);
+    UT_I2CBusSim_Slave_t *Slave = UT_I2CBusSim_StartTransfer(UT_Hook_GetArgValueByName(Context, "fd", int));
+    size_t                i;
+
+    if (Slave == NULL)
+    {
+        return -1;
+    }
+
+    UT_I2CBusSim_Spend(Slave->Bus, UT_I2CBusSim_WireNs(1 + Count) + (uint64)Count * Slave->ByteDelayNs);
+
+    for (i = 0; i < Count; ++i)
+    {
+        Buf[i] = (Slave->RegPtr < Slave->RegSize) ? Slave->Regs[Slave->RegPtr] : 0xFF;
+        ++Slave->RegPtr;
+    }
+
+    return (int32)Count;
+}
+
+void UT_I2CBusSim_Init(const UT_I2CBusSim_Config_t *Config)
+{
+    memset(&UT_I2CBusSim, 0, sizeof(UT_I2CBusSim));
+
+    if (Config != NULL)
+    {
+        UT_I2CBusSim.Config = *Config;
+    }
+    if (UT_I2CBusSim.Config.BusHz == 0)
+    {
+        UT_I2CBusSim.Config.BusHz = UT_I2C_BUS_SIM_DEFAULT_HZ;
+    }
+    if (UT_I2CBusSim.Config.SyscallOverheadNs == 0)
+    {
+        UT_I2CBusSim.Config.SyscallOverheadNs = UT_I2C_BUS_SIM_DEFAULT_SYSCALL_NS;
+    }
+    if (UT_I2CBusSim.Config.AdapterTimeoutNs == 0)
+    {
+        UT_I2CBusSim.Config.AdapterTimeoutNs = UT_I2C_BUS_SIM_DEFAULT_TIMEOUT_NS;
+    }
+
+    /* xorshift must not start from zero */
+    UT_I2CBusSim.Rng = (UT_I2CBusSim.Config.Seed != 0) ? UT_I2CBusSim.Config.Seed : 0x2545F491;
+
+    UT_SetHookFunction(UT_KEY(OCS_open), UT_I2CBusSim_OpenHook, NULL);
+    UT_SetHookFunction(UT_KEY(OCS_close), UT_I2CBusSim_CloseHook, NULL);
+    UT_SetHookFunction(UT_KEY(OCS_ioctl), UT_I2CBusSim_IoctlHook, NULL);
+    UT_SetHookFunction(UT_KEY(OCS_write), UT_I2CBusSim_WriteHook, NULL);
+    UT_SetHookFunction(UT_KEY(OCS_read), UT_I2CBusSim_ReadHook, NULL);
+}
+
+int32 UT_I2CBusSim_AddSlave(uint32 Bus, uint16 Address, uint8 *Regs, size_t RegSize, uint32 ByteDelayNs)
+{
+    int32 i;
+
+    if (Bus >= UT_I2C_BUS_SIM_MAX_BUSES)
+    {
+        return -1;
+    }
+
+    for (i = 0; i < UT_I2C_BUS_SIM_MAX_SLAVES; ++i)
+    {
+        if (!UT_I2CBusSim.Slaves[i].InUse)
+        {
+            memset(&UT_I2CBusSim.Slaves[i], 0, sizeof(UT_I2CBusSim.Slaves[i]));
+            UT_I2CBusSim.Slaves[i].InUse       = true;
+            UT_I2CBusSim.Slaves[i].Bus         = Bus;
+            UT_I2CBusSim.Slaves[i].Address     = Address;
+            UT_I2CBusSim.Slaves[i].Regs        = Regs;
+            UT_I2CBusSim.Slaves[i].RegSize     = RegSize;
+            UT_I2CBusSim.Slaves[i].ByteDelayNs = ByteDelayNs;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void UT_I2CBusSim_SetSlaveFault(int32 SlaveId, UT_I2CBusSim_Fault_t Fault)
+{
+    if (SlaveId >= 0 && SlaveId < UT_I2C_BUS_SIM_MAX_SLAVES)
+    {
+        UT_I2CBusSim.Slaves[SlaveId].Fault = Fault;
+    }
+}
+
+void UT_I2CBusSim_SetNackRate(int32 SlaveId, uint32 PerMillion)
+{
+    if (SlaveId >= 0 && SlaveId < UT_I2C_BUS_SIM_MAX_SLAVES)
+    {
+        UT_I2CBusSim.Slaves[SlaveId].NackPerMillion = PerMillion;
+    }
+}
+
+void UT_I2CBusSim_SetAdapterDown(uint32 Bus, bool Down)
+{
+    if (Bus < UT_I2C_BUS_SIM_MAX_BUSES)
+    {
+        UT_I2CBusSim.AdapterDown[Bus] = Down;
+    }
+}
+
+uint64 UT_I2CBusSim_GetTime(void)
+{
+    return UT_I2CBusSim.Now;
+}
+
+void UT_I2CBusSim_SetTime(uint64 TimeNs)
+{
+    if (TimeNs > UT_I2CBusSim.Now)
+    {
+        UT_I2CBusSim.Now = TimeNs;
+    }
+}
+
+uint64 UT_I2CBusSim_GetBusyTime(uint32 Bus)
+{
+    return (Bus < UT_I2C_BUS_SIM_MAX_BUSES) ? UT_I2CBusSim.BusyNs[Bus] : 0;
+}
+
+void UT_I2CBusSim_GetStats(UT_I2CBusSim_Stats_t *Stats)
+{
+    *Stats = UT_I2CBusSim.Stats;
+}
@@ -0,0 +1,502 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/*
+** File: soaktest_i2c_app.c
+**
+** Purpose:
+** Soak test of the I2C Application command path
+**
+** Notes:
+** Drives the real command dispatch (I2C_APP_ProcessCommandPacket) at a
+** fixed rate against the simulated bus in ../sim for a long stretch of
+** virtual time, with a housekeeping request every second.  Each window
+** injects the same set of bus faults (slave NACK, slave holding SCL,
+** adapter gone) on top of a low rate of transient NACKs, so windows are
+** directly comparable and any drift shows up as a trend.
+**
+** Per window it reports command latency percentiles (virtual time:
+** queueing + bus + a fixed dispatch cost), host CPU time per command,
+** process RSS, the peak software bus buffer use implied by the command
+** backlog, and how long the app took to recover from each fault.
+**
+** The run length and rate come from the environment so the same test
+** can be left running for hours:
+**
+**   I2C_APP_SOAK_SECONDS   virtual seconds to run (default 600)
+**   I2C_APP_SOAK_RATE_HZ   command rate (default 50)
+**   I2C_APP_SOAK_SEED      seed for transient faults (default 1)
+*/
+
+/*
+ * Includes
+ */
+
+#include "i2c_app_coveragetest_common.h"
+#include "ut_i2c_app.h"
+#include "ut_i2c_bus_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define UT_SOAK_DEFAULT_SECONDS 600
+#define UT_SOAK_DEFAULT_RATE_HZ 50
+#define UT_SOAK_MAX_RATE_HZ     1000
+#define UT_SOAK_WINDOW_SECONDS  60
+
+/* Every window sees one fault of each kind, this long, at these points */
+#define UT_SOAK_FAULT_DURATION_NS   500000000ULL
+#define UT_SOAK_TRANSIENT_NACK_PPM  100
+#define UT_SOAK_NUM_FAULT_KINDS     3
+
+/* Time spent receiving and dispatching one command outside of the bus calls */
+#define UT_SOAK_DISPATCH_NS 20000
+
+/* How long the adapter waits on a slave holding SCL before failing the transfer */
+#define UT_SOAK_ADAPTER_TIMEOUT_NS 25000000ULL
+
+/* Firmware PololuRPiSlave delay before each transmitted byte */
+#define UT_SOAK_SLAVE_BYTE_DELAY_NS 5000
+
+/*
+ * Software bus pool the backlog is measured against.  The per-buffer
+ * overhead approximates the SB buffer descriptor kept with each message.
+ */
+#ifdef CFE_PLATFORM_SB_BUF_MEMORY_BYTES
+#define UT_SOAK_SB_BUF_MEMORY_BYTES CFE_PLATFORM_SB_BUF_MEMORY_BYTES
+#else
+#define UT_SOAK_SB_BUF_MEMORY_BYTES 524288 /* sample_defs/example_platform_cfg.h */
+#endif
+#define UT_SOAK_SB_BUFFER_OVERHEAD 64
+
+/* Allowed RSS growth after the first window has warmed everything up */
+#define UT_SOAK_RSS_GROWTH_LIMIT_KIB 1024
+
+#define UT_SOAK_WINDOW_SAMPLES (UT_SOAK_WINDOW_SECONDS * UT_SOAK_MAX_RATE_HZ)
+
+typedef enum
+{
+    UT_SOAK_FAULT_NACK = 0,
+    UT_SOAK_FAULT_HANG,
+    UT_SOAK_FAULT_ADAPTER
+} UT_Soak_FaultKind_t;
+
+static const char *const UT_Soak_FaultNames[UT_SOAK_NUM_FAULT_KINDS] = {"nack", "hang", "adapter"};
+
+typedef struct
+{
+    uint32 Injected;
+    uint32 Recovered;
+    uint64 MaxOutageNs;   /* fault start until the first good command */
+    uint64 MaxRecoveryNs; /* fault cleared until the first good command */
+} UT_Soak_FaultStats_t;
+
+typedef struct
+{
+    uint64 LatP50, LatP99, LatMax;
+    uint64 CpuP50, CpuP99;
+    uint64 RssKiB;
+    uint64 SbPeakBytes;
+} UT_Soak_Window_t;
+
+static uint64 UT_Soak_Latency[UT_SOAK_WINDOW_SAMPLES];
+static uint64 UT_Soak_CpuTime[UT_SOAK_WINDOW_SAMPLES];
+
+/*
+ * Completion times of commands still sitting in the pipe, oldest first
+ */
+static uint64 UT_Soak_Pipe[I2C_APP_PIPE_DEPTH];
+
+static uint32 UT_Soak_GetEnv(const char *Name, uint32 Default)
+{
+    const char *Value = getenv(Name);
+
+    return (Value != NULL && atol(Value) > 0) ? (uint32)atol(Value) : Default;
+}
+
+static uint64 UT_Soak_CpuNow(void)
+{
+    struct timespec Ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Ts);
+
+    return (uint64)Ts.tv_sec * 1000000000 + Ts.tv_nsec;
+}
+
+static uint64 UT_Soak_RssKiB(void)
+{
+    FILE *        Fp       = fopen("/proc/self/statm", "r");
+    unsigned long Size     = 0;
+    unsigned long Resident = 0;
+
+    if (Fp != NULL)
+    {
+        if (fscanf(Fp, "%lu %lu", &Size, &Resident) != 2)
+        {
+            Resident = 0;
+        }
+        fclose(Fp);
+    }
+
+    return (uint64)Resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+static int UT_Soak_Compare(const void *A, const void *B)
+{
+    uint64 X = *(const uint64 *)A;
+    uint64 Y = *(const uint64 *)B;
+
+    return (X > Y) - (X < Y);
+}
+
+static uint64 UT_Soak_Percentile(uint64 *Sorted, uint32 Count, uint32 Pct)
+{
+    return (Count == 0) ? 0 : Sorted[((uint64)Count * Pct - 1) / 100];
+}
+
+static void UT_Soak_SetFault(UT_Soak_FaultKind_t Kind, int32 SlaveId, bool Active)
+{
+    switch (Kind)
+    {
+        case UT_SOAK_FAULT_NACK:
+            UT_I2CBusSim_SetSlaveFault(SlaveId, Active ? UT_I2C_BUS_SIM_FAULT_NACK : UT_I2C_BUS_SIM_FAULT_NONE);
+            break;
+        case UT_SOAK_FAULT_HANG:
+            UT_I2CBusSim_SetSlaveFault(SlaveId, Active ? UT_I2C_BUS_SIM_FAULT_TIMEOUT : UT_I2C_BUS_SIM_FAULT_NONE);
+            break;
+        default:
+            UT_I2CBusSim_SetAdapterDown(I2C_APP_BUS_NUM, Active);
+            break;
+    }
+}
+
+void Test_I2C_APP_Soak(void)
+{
+    union
+    {
+        CFE_SB_Buffer_t             SBBuf;
+        I2C_APP_SetWheelSpeedsCmd_t Speeds;
+    } TestMsg;
+    CFE_MSG_CommandHeader_t HkReq;
+    CFE_SB_MsgId_t          TestMsgId = CFE_SB_ValueToMsgId(I2C_APP_CMD_MID);
+    CFE_MSG_FcnCode_t       FcnCode   = I2C_APP_SET_WHEEL_SPEEDS_CC;
+    size_t                  MsgSize   = sizeof(TestMsg.Speeds);
+    uint8                   Regs[I2C_PACKET_SIZE];
+    int32                   SlaveId;
+
+    uint32 Seconds  = UT_Soak_GetEnv("I2C_APP_SOAK_SECONDS", UT_SOAK_DEFAULT_SECONDS);
+    uint32 RateHz   = UT_Soak_GetEnv("I2C_APP_SOAK_RATE_HZ", UT_SOAK_DEFAULT_RATE_HZ);
+    uint32 Seed     = UT_Soak_GetEnv("I2C_APP_SOAK_SEED", 1);
+    uint32 WindowS  = (Seconds < UT_SOAK_WINDOW_SECONDS) ? Seconds : UT_SOAK_WINDOW_SECONDS;
+    uint64 PeriodNs;
+    uint64 WindowNs;
+    uint32 PerWindow;
+    uint32 NumWindows;
+
+    UT_I2CBusSim_Config_t SimConfig;
+    UT_I2CBusSim_Stats_t  SimStats;
+    UT_Soak_FaultStats_t  Faults[UT_SOAK_NUM_FAULT_KINDS];
+    UT_Soak_Window_t      First;
+    UT_Soak_Window_t      Last;
+    UT_Soak_Window_t      Cur;
+
+    /* fault currently being tracked, if any */
+    bool                FaultActive[UT_SOAK_NUM_FAULT_KINDS] = {false, false, false};
+    bool                FaultPending = false;
+    UT_Soak_FaultKind_t FaultKind    = UT_SOAK_FAULT_NACK;
+    uint64              FaultStart   = 0;
+    uint64              FaultClear   = 0;
+    bool                FaultCleared = false;
+
+    uint32 TransientRecoveries = 0;
+    uint32 PipeOverflows       = 0;
+    uint32 PipeHead            = 0;
+    uint32 PipeCount           = 0;
+    uint64 LastCompletion      = 0;
+    uint64 SbPeakBytes         = 0;
+    uint64 Syscalls;
+    uint64 Commands = 0;
+    uint32 w;
+    uint32 n;
+    uint32 k;
+
+    if (RateHz > UT_SOAK_MAX_RATE_HZ)
+    {
+        RateHz = UT_SOAK_MAX_RATE_HZ;
+    }
+    PeriodNs   = 1000000000ULL / RateHz;
+    WindowNs   = (uint64)WindowS * 1000000000ULL;
+    PerWindow  = WindowS * RateHz;
+    NumWindows = Seconds / WindowS;
+
+    memset(&TestMsg, 0, sizeof(TestMsg));
+    memset(&HkReq, 0, sizeof(HkReq));
+    memset(Regs, 0, sizeof(Regs));
+    memset(Faults, 0, sizeof(Faults));
+    memset(&First, 0, sizeof(First));
+    memset(&Last, 0, sizeof(Last));
+
+    memset(&SimConfig, 0, sizeof(SimConfig));
+    SimConfig.Seed             = Seed;
+    SimConfig.AdapterTimeoutNs = UT_SOAK_ADAPTER_TIMEOUT_NS;
+    UT_I2CBusSim_Init(&SimConfig);
+    SlaveId = UT_I2CBusSim_AddSlave(I2C_APP_BUS_NUM, I2C_ADDRESS, Regs, sizeof(Regs), UT_SOAK_SLAVE_BYTE_DELAY_NS);
+    UT_I2CBusSim_SetNackRate(SlaveId, UT_SOAK_TRANSIENT_NACK_PPM);
+
+    UtAssert_INT32_EQ(I2C_APP_Init(), CFE_SUCCESS);
+    UtAssert_BOOL_FALSE(I2C_APP_Data.BusFaulted);
+
+    /* the data buffers repeat, so every packet reads back as a wheel speed command */
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetMsgId), &TestMsgId, sizeof(TestMsgId), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetFcnCode), &FcnCode, sizeof(FcnCode), false);
+    UT_SetDataBuffer(UT_KEY(CFE_MSG_GetSize), &MsgSize, sizeof(MsgSize), false);
+
+    UtPrintf("SOAK %lus virtual at %lu Hz, %lu windows of %lus, seed %lu", (unsigned long)Seconds,
+             (unsigned long)RateHz, (unsigned long)NumWindows, (unsigned long)WindowS, (unsigned long)Seed);
+
+    for (w = 0; w < NumWindows; ++w)
+    {
+        uint64 WindowStart = (uint64)w * WindowNs;
+        uint64 WindowSbPeak = 0;
+
+        for (n = 0; n < PerWindow; ++n)
+        {
+            uint64 Arrival = WindowStart + (uint64)n * PeriodNs;
+            uint64 Offset;
+            uint64 Start;
+            uint64 Completion;
+            uint64 SbBytes;
+            uint64 Cpu0;
+            uint8  Recoveries;
+
+            /* commands completed before this one arrived have left the pipe */
+            while (PipeCount > 0 && UT_Soak_Pipe[PipeHead] <= Arrival)
+            {
+                PipeHead = (PipeHead + 1) % I2C_APP_PIPE_DEPTH;
+                --PipeCount;
+            }
+
+            if (PipeCount == I2C_APP_PIPE_DEPTH)
+            {
+                ++PipeOverflows;
+                continue;
+            }
+
+            SbBytes = (uint64)(PipeCount + 1) * (sizeof(TestMsg.Speeds) + UT_SOAK_SB_BUFFER_OVERHEAD);
+
+            /* once a second the housekeeping request and its reply share the pool */
+            if (n % RateHz == 0)
+            {
+                SbBytes += sizeof(HkReq) + sizeof(I2C_APP_Data.HkTlm) + 2 * UT_SOAK_SB_BUFFER_OVERHEAD;
+            }
+            if (SbBytes > WindowSbPeak)
+            {
+                WindowSbPeak = SbBytes;
+            }
+
+            Start = (Arrival > LastCompletion) ? Arrival : LastCompletion;
+            UT_I2CBusSim_SetTime(Start);
+
+            /*
+             * Fault schedule, applied as of when the app gets to the command
+             * rather than when it arrived: kind k is active from (k+1)/4 of
+             * the way through each window for UT_SOAK_FAULT_DURATION_NS.
+             */
+            Offset = Start % WindowNs;
+            for (k = 0; k < UT_SOAK_NUM_FAULT_KINDS; ++k)
+            {
+                uint64 At   = (WindowNs / (UT_SOAK_NUM_FAULT_KINDS + 1)) * (k + 1);
+                bool   Want = (Offset >= At && Offset < At + UT_SOAK_FAULT_DURATION_NS);
+
+                if (Want && !FaultActive[k])
+                {
+                    UT_Soak_SetFault((UT_Soak_FaultKind_t)k, SlaveId, true);
+                    FaultActive[k] = true;
+                    FaultPending   = true;
+                    FaultCleared   = false;
+                    FaultKind      = (UT_Soak_FaultKind_t)k;
+                    FaultStart     = Start - Offset + At;
+                    ++Faults[k].Injected;
+                }
+                else if (!Want && FaultActive[k])
+                {
+                    UT_Soak_SetFault((UT_Soak_FaultKind_t)k, SlaveId, false);
+                    FaultActive[k] = false;
+                    FaultCleared   = true;
+                    FaultClear     = FaultStart + UT_SOAK_FAULT_DURATION_NS;
+                }
+            }
+
+            Recoveries = I2C_APP_Data.BusRecoveryCounter;
+
+            Cpu0 = UT_Soak_CpuNow();
+            I2C_APP_ProcessCommandPacket(&TestMsg.SBBuf);
+            if (n % RateHz == 0)
+            {
+                I2C_APP_ReportHousekeeping(&HkReq);
+            }
+            UT_Soak_CpuTime[n] = UT_Soak_CpuNow() - Cpu0;
+
+            Completion = UT_I2CBusSim_GetTime() + UT_SOAK_DISPATCH_NS;
+            UT_I2CBusSim_SetTime(Completion);
+            LastCompletion = Completion;
+
+            UT_Soak_Pipe[(PipeHead + PipeCount) % I2C_APP_PIPE_DEPTH] = Completion;
+            ++PipeCount;
+
+            UT_Soak_Latency[n] = Completion - Arrival;
+            ++Commands;
+
+            if ((uint8)(I2C_APP_Data.BusRecoveryCounter - Recoveries) != 0)
+            {
+                if (FaultPending && FaultCleared)
+                {
+                    if (Completion - FaultStart > Faults[FaultKind].MaxOutageNs)
+                    {
+                        Faults[FaultKind].MaxOutageNs = Completion - FaultStart;
+                    }
+                    if (Completion - FaultClear > Faults[FaultKind].MaxRecoveryNs)
+                    {
+                        Faults[FaultKind].MaxRecoveryNs = Completion - FaultClear;
+                    }
+                    ++Faults[FaultKind].Recovered;
+                    FaultPending = false;
+                }
+                else
+                {
+                    ++TransientRecoveries;
+                }
+            }
+        }
+
+        qsort(UT_Soak_Latency, PerWindow, sizeof(UT_Soak_Latency[0]), UT_Soak_Compare);
+        qsort(UT_Soak_CpuTime, PerWindow, sizeof(UT_Soak_CpuTime[0]), UT_Soak_Compare);
+
+        Cur.LatP50      = UT_Soak_Percentile(UT_Soak_Latency, PerWindow, 50);
+        Cur.LatP99      = UT_Soak_Percentile(UT_Soak_Latency, PerWindow, 99);
+        Cur.LatMax      = UT_Soak_Latency[PerWindow - 1];
+        Cur.CpuP50      = UT_Soak_Percentile(UT_Soak_CpuTime, PerWindow, 50);
+        Cur.CpuP99      = UT_Soak_Percentile(UT_Soak_CpuTime, PerWindow, 99);
+        Cur.RssKiB      = UT_Soak_RssKiB();
+        Cur.SbPeakBytes = WindowSbPeak;
+
+        if (w == 0)
+        {
+            First = Cur;
+        }
+        Last = Cur;
+        if (WindowSbPeak > SbPeakBytes)
+        {
+            SbPeakBytes = WindowSbPeak;
+        }
+
+        UtPrintf("SOAK t=%5lus lat p50=%6luus p99=%6luus max=%6luus | cpu p50=%6luns p99=%6luns | rss=%6lukB "
+                 "| sb peak=%5lu B | bus err=%3u rec=%3u",
+                 (unsigned long)((w + 1) * WindowS), (unsigned long)(Cur.LatP50 / 1000),
+                 (unsigned long)(Cur.LatP99 / 1000), (unsigned long)(Cur.LatMax / 1000), (unsigned long)Cur.CpuP50,
+                 (unsigned long)Cur.CpuP99, (unsigned long)Cur.RssKiB, (unsigned long)Cur.SbPeakBytes,
+                 (unsigned int)I2C_APP_Data.BusErrCounter, (unsigned int)I2C_APP_Data.BusRecoveryCounter);
+    }
+
+    UT_I2CBusSim_GetStats(&SimStats);
+    Syscalls = (uint64)SimStats.Opens + SimStats.FailedOpens + SimStats.Closes + SimStats.Transfers +
+               UT_GetStubCount(UT_KEY(OCS_ioctl));
+
+    for (k = 0; k < UT_SOAK_NUM_FAULT_KINDS; ++k)
+    {
+        UtPrintf("SOAK fault %-7s injected=%lu recovered=%lu max outage=%lums max recovery=%luus",
+                 UT_Soak_FaultNames[k], (unsigned long)Faults[k].Injected, (unsigned long)Faults[k].Recovered,
+                 (unsigned long)(Faults[k].MaxOutageNs / 1000000), (unsigned long)(Faults[k].MaxRecoveryNs / 1000));
+    }
+    UtPrintf("SOAK commands=%lu syscalls/cmd=%.2f transient recoveries=%lu pipe overflows=%lu sb peak=%lu/%lu B",
+             (unsigned long)Commands, Commands ? (double)Syscalls / Commands : 0.0,
+             (unsigned long)TransientRecoveries, (unsigned long)PipeOverflows, (unsigned long)SbPeakBytes,
+             (unsigned long)UT_SOAK_SB_BUF_MEMORY_BYTES);
+
+    /* descriptors: nothing leaked, nothing used after close */
+    UtAssert_UINT32_EQ(SimStats.BadFdCalls, 0);
+    UtAssert_UINT32_EQ(SimStats.OpenFds, 1);
+    UtAssert_UINT32_EQ(SimStats.PeakOpenFds, 1);
+
+    /* every fault was recovered from, within a timeout plus a command period of clearing */
+    for (k = 0; k < UT_SOAK_NUM_FAULT_KINDS; ++k)
+    {
+        UtAssert_UINT32_EQ(Faults[k].Recovered, Faults[k].Injected);
+        UtAssert_True(Faults[k].MaxRecoveryNs <= UT_SOAK_ADAPTER_TIMEOUT_NS + 2 * PeriodNs, "%s recovery %lu us within bound",
+                      UT_Soak_FaultNames[k], (unsigned long)(Faults[k].MaxRecoveryNs / 1000));
+    }
+    UtAssert_BOOL_FALSE(I2C_APP_Data.BusFaulted);
+
+    /* the backlog never outgrew the pipe or the SB pool */
+    UtAssert_UINT32_EQ(PipeOverflows, 0);
+    UtAssert_True(SbPeakBytes <= UT_SOAK_SB_BUF_MEMORY_BYTES, "SB peak %lu B within pool",
+                  (unsigned long)SbPeakBytes);
+
+    /* and nothing trends: memory flat, tail latency where it started */
+    UtAssert_True(Last.RssKiB <= First.RssKiB + UT_SOAK_RSS_GROWTH_LIMIT_KIB, "RSS %lu kB -> %lu kB",
+                  (unsigned long)First.RssKiB, (unsigned long)Last.RssKiB);
+    UtAssert_True(Last.LatP99 <= First.LatP99 + First.LatP99 / 4 + PeriodNs, "p99 latency %lu us -> %lu us",
+                  (unsigned long)(First.LatP99 / 1000), (unsigned long)(Last.LatP99 / 1000));
+}
+
+/*
+ * Hook that runs a child task to the end as soon as it is created, as if
+ * it had finished before its parent next looked
+ */
+static int32 UT_ChildTask_Hook(void *UserObj, int32 StubRetcode, uint32 CallCount, const UT_StubContext_t *Context)
+{
+    CFE_ES_ChildTaskMainFuncPtr_t FunctionPtr =
+        UT_Hook_GetArgValueByName(Context, "FunctionPtr", CFE_ES_ChildTaskMainFuncPtr_t);
+
+    if (StubRetcode == CFE_SUCCESS)
+    {
+        FunctionPtr();
+    }
+
+    return StubRetcode;
+}
+
+/*
+ * Setup function prior to every test
+ */
+void I2C_UT_Setup(void)
+{
+    static I2C_APP_Table_t  DefaultTable = UT_I2C_APP_DEFAULT_TABLE;
+    static I2C_APP_Table_t *DefaultTablePtr;
+
+    UT_ResetState(0);
+
+    DefaultTablePtr = &DefaultTable;
+    UT_SetDataBuffer(UT_KEY(CFE_TBL_GetAddress), &DefaultTablePtr, sizeof(DefaultTablePtr), false);
+    UT_SetHookFunction(UT_KEY(CFE_ES_CreateChildTask), UT_ChildTask_Hook, NULL);
+}
+
+/*
+ * Teardown function after every test
+ */
+void I2C_UT_TearDown(void) {}
+
+/*
+ * Register the test cases to execute with the unit test tool
+ */
+void UtTest_Setup(void)
+{
+    ADD_TEST(I2C_APP_Soak);
+}
@@ -0,0 +1,133 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Stub implementations for the POSIX calls used by the i2c_app bus code
+ *
+ * Each stub registers its arguments as context (so hooks can inspect them)
+ * and returns the usual "success" result by default:
+ *
+ * - OCS_open returns a valid file descriptor (3)
+ * - OCS_read/OCS_write return the full requested count; OCS_read zero-fills
+ *   the caller's buffer first, then a hook or the UT data buffer (if any)
+ *   supplies the bytes
+ * - everything else returns 0
+ */
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "utstubs.h"
+#include "ut_posix_stubs.h"
+
+#define UT_POSIX_STUB_DEFAULT_FD 3
+
+int OCS_open(const char *pathname, int flags, ...)
+{
+    UT_Stub_RegisterContext(UT_KEY(OCS_open), pathname);
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_open), flags);
+
+    return UT_DEFAULT_IMPL_RC(OCS_open, UT_POSIX_STUB_DEFAULT_FD);
+}
+
+int OCS_close(int fd)
+{
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_close), fd);
+
+    return UT_DEFAULT_IMPL(OCS_close);
+}
+
+int OCS_ioctl(int fd, unsigned long request, ...)
+{
+    va_list       va;
+    unsigned long arg;
+
+    va_start(va, request);
+    arg = va_arg(va, unsigned long);
+    va_end(va);
+
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_ioctl), fd);
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_ioctl), request);
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_ioctl), arg);
+
+    return UT_DEFAULT_IMPL(OCS_ioctl);
+}
+
+ssize_t OCS_read(int fd, void *buf, size_t count)
+{
+    int32 Status;
+
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_read), fd);
+    UT_Stub_RegisterContext(UT_KEY(OCS_read), buf);
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_read), count);
+
+    memset(buf, 0, count);
+
+    Status = UT_DEFAULT_IMPL_RC(OCS_read, count);
+
+    if (Status > 0)
+    {
+        UT_Stub_CopyToLocal(UT_KEY(OCS_read), buf, Status);
+    }
+
+    return Status;
+}
+
+ssize_t OCS_write(int fd, const void *buf, size_t count)
+{
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_write), fd);
+    UT_Stub_RegisterContext(UT_KEY(OCS_write), buf);
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_write), count);
+
+    return UT_DEFAULT_IMPL_RC(OCS_write, count);
+}
+
+int OCS_fsync(int fd)
+{
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_fsync), fd);
+
+    return UT_DEFAULT_IMPL(OCS_fsync);
+}
+
+unsigned int OCS_sleep(unsigned int seconds)
+{
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_sleep), seconds);
+
+    return UT_DEFAULT_IMPL(OCS_sleep);
+}
+
+int OCS_usleep(unsigned int usec)
+{
+    UT_Stub_RegisterContextGenericArg(UT_KEY(OCS_usleep), usec);
+
+    return UT_DEFAULT_IMPL(OCS_usleep);
+}
+
+unsigned int UT_PosixStubs_GetSyscallCount(void)
+{
+    return UT_GetStubCount(UT_KEY(OCS_open)) + UT_GetStubCount(UT_KEY(OCS_close)) +
+           UT_GetStubCount(UT_KEY(OCS_ioctl)) + UT_GetStubCount(UT_KEY(OCS_read)) +
+           UT_GetStubCount(UT_KEY(OCS_write)) + UT_GetStubCount(UT_KEY(OCS_fsync));
+}
+
+unsigned int UT_PosixStubs_GetSleepCount(void)
+{
+    return UT_GetStubCount(UT_KEY(OCS_sleep)) + UT_GetStubCount(UT_KEY(OCS_usleep));
+}
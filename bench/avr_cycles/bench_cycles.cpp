@@ -0,0 +1,195 @@
+// Cycle-count benchmark for the Romi firmware control functions.
+//
+// Built for the ATmega32U4 together with Robot_Code.cpp and the stand-ins in
+// ../romi_stubs, then run under simavr.  Timer1 runs unprescaled so TCNT1
+// counts CPU cycles; each measured call is bracketed by a timer reset and
+// read, with the bracket overhead calibrated out.  Results are written to the
+// simavr console as one "CYCLES <name> ..." line per function and checked
+// against budgets.txt by check_budgets.sh.
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/avr_mcu_section.h>
+
+#include "romi_sim.h"
+
+AVR_MCU(F_CPU, "atmega32u4");
+AVR_MCU_SIMAVR_CONSOLE(&GPIOR0);
+
+int16_t update_left_motor(int16_t dist, int16_t speed);
+int16_t update_right_motor(int16_t dist, int16_t speed);
+void pack_telemetry(int16_t set_left, int16_t set_right);
+void bench_write_commands(int16_t left_speed, int16_t right_speed, int16_t left_dist, int16_t right_dist);
+void setup();
+void loop();
+
+struct CycleStats {
+  const char *name;
+  uint32_t min;
+  uint32_t max;
+  uint32_t sum;
+  uint16_t n;
+};
+
+static CycleStats stats_left = {"update_left_motor", 0xFFFFFFFFUL, 0, 0, 0};
+static CycleStats stats_right = {"update_right_motor", 0xFFFFFFFFUL, 0, 0, 0};
+static CycleStats stats_pack = {"pack_telemetry", 0xFFFFFFFFUL, 0, 0, 0};
+static CycleStats stats_loop = {"loop", 0xFFFFFFFFUL, 0, 0, 0};
+
+static uint16_t overhead;
+
+static inline void cycles_start() {
+  TCCR1B = 0;
+  TCNT1 = 0;
+  TIFR1 = _BV(TOV1);
+  TCCR1B = _BV(CS10);
+}
+
+static inline uint32_t cycles_stop() {
+  TCCR1B = 0;
+  uint32_t c = TCNT1;
+  if (TIFR1 & _BV(TOV1)) {
+    c += 65536UL;
+  }
+  return c;
+}
+
+static void record(CycleStats &s, uint32_t c) {
+  c = (c > overhead) ? c - overhead : 0;
+  if (c < s.min) s.min = c;
+  if (c > s.max) s.max = c;
+  s.sum += c;
+  s.n++;
+}
+
+static void put_str(const char *s) {
+  while (*s) {
+    GPIOR0 = *s++;
+  }
+}
+
+static void put_u32(uint32_t v) {
+  char buf[11];
+  uint8_t i = sizeof(buf) - 1;
+  buf[i] = 0;
+  do {
+    buf[--i] = '0' + (v % 10);
+    v /= 10;
+  } while (v && i);
+  put_str(&buf[i]);
+}
+
+static void report(const CycleStats &s) {
+  put_str("CYCLES ");
+  put_str(s.name);
+  put_str(" n=");
+  put_u32(s.n);
+  put_str(" min=");
+  put_u32(s.n ? s.min : 0);
+  put_str(" avg=");
+  put_u32(s.n ? s.sum / s.n : 0);
+  put_str(" max=");
+  put_u32(s.max);
+  put_str("\n");
+}
+
+/*
+ * One scenario per branch of the distance ladder: a fresh move, a move with
+ * the remaining distance in each speed band, a direct speed command and idle.
+ * Each scenario latches the move at encoder count 0 and then positions the
+ * encoder so the remaining distance lands in the wanted band.
+ */
+struct Scenario {
+  int16_t dist;
+  int16_t speed;
+  int16_t remaining;
+};
+
+static const Scenario scenarios[] = {
+  {0, 0, 0},        /* idle */
+  {0, 150, 0},      /* direct speed command */
+  {1000, 0, 1000},  /* fresh move, top of ladder */
+  {1000, 0, 500},   /* clamped at 300 */
+  {1000, 0, 200},   /* proportional band */
+  {1000, 0, 50},    /* 100 band */
+  {1000, 0, 20},    /* 50 band */
+  {1000, 0, 5},     /* 30 band */
+  {1000, 0, 0},     /* arrived */
+  {-1000, 0, -200}, /* reverse, proportional band */
+  {-1000, 0, -5},   /* reverse, 30 band */
+};
+
+#define SAMPLES_PER_SCENARIO 8
+
+static void bench_motor(CycleStats &s, int16_t (*fn)(int16_t, int16_t), volatile int16_t &counts) {
+  for (uint8_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+    const Scenario &sc = scenarios[i];
+
+    /* Reset the latch so every scenario starts as a new move */
+    counts = 0;
+    fn((int16_t)(sc.dist + 1), sc.speed);
+
+    cycles_start();
+    fn(sc.dist, sc.speed);
+    record(s, cycles_stop());
+
+    counts = (int16_t)(sc.dist - sc.remaining);
+    for (uint8_t k = 0; k < SAMPLES_PER_SCENARIO; k++) {
+      cycles_start();
+      fn(sc.dist, sc.speed);
+      record(s, cycles_stop());
+    }
+  }
+}
+
+static void bench_loop() {
+  for (uint8_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++) {
+    const Scenario &sc = scenarios[i];
+
+    romi_sim_left_counts = 0;
+    romi_sim_right_counts = 0;
+    bench_write_commands(sc.speed, sc.speed, sc.dist, sc.dist);
+
+    for (uint8_t k = 0; k < SAMPLES_PER_SCENARIO; k++) {
+      if (k == 1) {
+        romi_sim_left_counts = (int16_t)(sc.dist - sc.remaining);
+        romi_sim_right_counts = (int16_t)(sc.dist - sc.remaining);
+      }
+      cycles_start();
+      loop();
+      record(stats_loop, cycles_stop());
+    }
+
+    for (uint8_t k = 0; k < SAMPLES_PER_SCENARIO; k++) {
+      cycles_start();
+      pack_telemetry(sc.speed, sc.speed);
+      record(stats_pack, cycles_stop());
+    }
+  }
+}
+
+int main() {
+  cli();
+  setup();
+
+  cycles_start();
+  overhead = cycles_stop();
+
+  bench_motor(stats_left, update_left_motor, romi_sim_left_counts);
+  bench_motor(stats_right, update_right_motor, romi_sim_right_counts);
+  bench_loop();
+
+  report(stats_left);
+  report(stats_right);
+  report(stats_pack);
+  report(stats_loop);
+  put_str("DONE f_cpu=");
+  put_u32(F_CPU);
+  put_str("\n");
+
+  sleep_enable();
+  sleep_cpu();
+  for (;;) {
+  }
+}
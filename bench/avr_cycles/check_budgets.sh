@@ -0,0 +1,57 @@
+#!/bin/bash
+#
+# Compare the CYCLES lines printed by bench_cycles against budgets.txt.
+# Prints a per-function table plus the worst-case loop time and exits
+# non-zero if any function exceeds its budget or a budgeted function is
+# missing from the log.
+#
+# Usage: check_budgets.sh <simavr log> <budgets file>
+
+if [ $# -ne 2 ]; then
+  echo "Usage: $0 <simavr log> <budgets file>"
+  exit 2
+fi
+
+awk '
+  FNR == NR {
+    if ($0 ~ /^[[:space:]]*(#|$)/) next
+    budget[$1] = $2
+    order[++count] = $1
+    next
+  }
+  /DONE f_cpu=/ {
+    split($0, d, "f_cpu=")
+    fcpu = d[2] + 0
+  }
+  /CYCLES / {
+    sub(/.*CYCLES /, "")
+    name = $1
+    for (i = 2; i <= NF; i++) {
+      split($i, kv, "=")
+      val[name, kv[1]] = kv[2] + 0
+    }
+    seen[name] = 1
+  }
+  END {
+    status = 0
+    printf "%-20s %8s %8s %8s %8s  %s\n", "function", "min", "avg", "max", "budget", "result"
+    for (i = 1; i <= count; i++) {
+      name = order[i]
+      if (!(name in seen)) {
+        printf "%-20s %8s %8s %8s %8d  MISSING\n", name, "-", "-", "-", budget[name]
+        status = 1
+        continue
+      }
+      result = "ok"
+      if (val[name, "max"] > budget[name]) {
+        result = "OVER BUDGET"
+        status = 1
+      }
+      printf "%-20s %8d %8d %8d %8d  %s\n", name, val[name, "min"], val[name, "avg"], val[name, "max"], budget[name], result
+    }
+    if (fcpu > 0 && ("loop" in seen)) {
+      printf "worst-case loop time: %.1f us at %d Hz\n", val["loop", "max"] * 1e6 / fcpu, fcpu
+    }
+    exit status
+  }
+' "$2" "$1"
@@ -0,0 +1,44 @@
+#!/bin/bash
+#
+# Write a budgets file from the CYCLES lines printed by bench_cycles.  Each
+# budget is the measured worst case ("max=") plus <margin> percent, rounded
+# up, so the check leaves room for simulator noise but still fails on a real
+# regression in the control path.
+#
+# Usage: make_budgets.sh <simavr log> <margin percent> > budgets.txt
+
+if [ $# -ne 2 ]; then
+  echo "Usage: $0 <simavr log> <margin percent>" >&2
+  exit 2
+fi
+
+awk -v margin="$2" '
+  /CYCLES / {
+    sub(/.*CYCLES /, "")
+    name = $1
+    for (i = 2; i <= NF; i++) {
+      split($i, kv, "=")
+      if (kv[1] == "max") max[name] = kv[2] + 0
+    }
+    if (!(name in seen)) order[++count] = name
+    seen[name] = 1
+  }
+  END {
+    if (count == 0) {
+      print "no CYCLES lines in log" > "/dev/stderr"
+      exit 1
+    }
+    print "# Cycle budgets for bench_cycles, checked against the worst case (\"max=\")"
+    print "# reported for each function.  One entry per line: <name> <max cycles>."
+    print "#"
+    print "# Regenerate with \"make baseline\": each budget is the measured maximum"
+    printf "# plus %d%%.  The loop and pack_telemetry budgets include the\n", margin
+    print "# ROMI_STUB_ADC_CYCLES that stand in for the battery ADC read."
+    for (i = 1; i <= count; i++) {
+      name = order[i]
+      b = max[name] * (100 + margin) / 100
+      if (b > int(b)) b = int(b) + 1
+      printf "%-19s %d\n", name, b
+    }
+  }
+' "$1"
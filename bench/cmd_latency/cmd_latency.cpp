@@ -0,0 +1,129 @@
+// Command-to-motor latency of the firmware's command latch.
+//
+// Runs Robot_Code.cpp on the host with the battery read taking ADC_US of
+// simulated time and the rest of the loop lumped into REST_US after it.  A
+// command write is scheduled at every microsecond offset across one loop
+// period; the slave stand-in delivers it from romi_sim_advance() the way
+// the TWI interrupt would, and the latency is read back from the diag
+// registers the firmware fills in.  The reference column is what the same
+// write would wait if commands were only picked up at the top of loop(),
+// i.e. until the next iteration starts.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "../../protocol/romi_protocol.h"
+#include "romi_sim.h"
+
+void setup();
+void loop();
+void bench_write_commands(int16_t left_speed, int16_t right_speed, int16_t left_dist, int16_t right_dist);
+void bench_master_read(uint8_t offset, void *dst, uint8_t len);
+
+namespace {
+
+uint32_t rest_us = 170;
+int16_t next_speed = 100;
+
+I2C_Diag_Packet read_diag() {
+  uint8_t raw[ROMI_DIAG_SIZE];
+  I2C_Diag_Packet d;
+
+  bench_master_read(ROMI_DIAG_OFFSET, raw, sizeof(raw));
+  romi_diag_unpack(&d, raw);
+  return d;
+}
+
+void write_command() {
+  bench_write_commands(next_speed, next_speed, 0, 0);
+  next_speed = next_speed == 100 ? -100 : 100;
+}
+
+void run_loop() {
+  loop();
+  romi_sim_advance(rest_us);
+}
+
+struct Summary {
+  double mean;
+  uint32_t p50, p99, max;
+};
+
+Summary summarize(std::vector<uint32_t> v) {
+  Summary s = {0, 0, 0, 0};
+  std::sort(v.begin(), v.end());
+  for (uint32_t x : v) {
+    s.mean += x;
+  }
+  s.mean /= v.size();
+  s.p50 = v[v.size() / 2];
+  s.p99 = v[(v.size() * 99) / 100];
+  s.max = v.back();
+  return s;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  bool csv = false;
+  romi_sim_adc_us = 112;
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--csv") == 0) {
+      csv = true;
+    } else if (std::strcmp(argv[i], "--adc-us") == 0 && i + 1 < argc) {
+      romi_sim_adc_us = (uint32_t)std::atoi(argv[++i]);
+    } else if (std::strcmp(argv[i], "--rest-us") == 0 && i + 1 < argc) {
+      rest_us = (uint32_t)std::atoi(argv[++i]);
+    } else {
+      std::fprintf(stderr, "usage: %s [--adc-us US] [--rest-us US] [--csv]\n", argv[0]);
+      return 2;
+    }
+  }
+  const uint32_t period = romi_sim_adc_us + rest_us;
+
+  setup();
+  run_loop();
+
+  std::vector<uint32_t> latched, reference;
+  if (csv) {
+    std::printf("offset_us,latency_us,loop_top_us\n");
+  }
+  for (uint32_t offset = 0; offset < period; offset++) {
+    uint16_t before = read_diag().cmd_count;
+    uint32_t start = romi_sim_micros;
+
+    romi_sim_event_at = start + offset;
+    romi_sim_event = write_command;
+    run_loop();
+    if (romi_sim_event != 0) {
+      std::fprintf(stderr, "write at offset %u was not delivered\n", offset);
+      return 1;
+    }
+    run_loop();
+
+    I2C_Diag_Packet d = read_diag();
+    if ((uint16_t)(d.cmd_count - before) != 1) {
+      std::fprintf(stderr, "write at offset %u applied %u times\n", offset, (unsigned)(uint16_t)(d.cmd_count - before));
+      return 1;
+    }
+    latched.push_back(d.cmd_latency_us);
+    reference.push_back(period - offset);
+    if (csv) {
+      std::printf("%u,%u,%u\n", offset, d.cmd_latency_us, period - offset);
+    }
+  }
+
+  if (!csv) {
+    Summary l = summarize(latched);
+    Summary r = summarize(reference);
+    std::printf("loop: %u us battery read + %u us other work, one write per us offset\n\n", romi_sim_adc_us, rest_us);
+    std::printf("%-10s %8s %8s %8s %8s\n", "pickup", "mean_us", "p50_us", "p99_us", "max_us");
+    std::printf("%-10s %8.1f %8u %8u %8u\n", "latched", l.mean, l.p50, l.p99, l.max);
+    std::printf("%-10s %8.1f %8u %8u %8u\n", "loop top", r.mean, r.p50, r.p99, r.max);
+    std::printf("\nfirmware worst case (diag.cmd_latency_max_us): %u us\n", read_diag().cmd_latency_max_us);
+  }
+  return 0;
+}
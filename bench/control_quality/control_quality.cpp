@@ -0,0 +1,238 @@
+// Control-quality benchmark for the Romi firmware distance moves.
+//
+// Runs Robot_Code.cpp on the host against the stand-ins in ../romi_stubs and
+// closes the loop through a simple wheel model: each wheel is a first-order
+// lag from the commanded PWM to encoder velocity, with a deadband, faster
+// decay when braking at zero speed, and a few percent of gain mismatch
+// between the two sides.  A fixed battery of moves is commanded exactly the
+// way the host would (a 0x00-offset command write) and each one is scored on
+// time-to-target, overshoot, settle time, final error and straightness (the
+// worst left/right divergence seen during the move).
+//
+// The model parameters are rough Romi figures (about 12 counts/s per PWM unit
+// at 300, 1440 counts per wheel revolution); they are meant to compare
+// controller changes against each other, not to predict the robot exactly.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "romi_sim.h"
+
+void setup();
+void loop();
+void bench_write_commands(int16_t left_speed, int16_t right_speed, int16_t left_dist, int16_t right_dist);
+
+extern int16_t rem_l_dist;
+extern int16_t rem_r_dist;
+
+namespace {
+
+struct WheelModel {
+  double counts_per_pwm; /* steady-state counts/s per PWM unit */
+  double deadband;       /* |pwm| below this does not move the wheel */
+  double tau_drive_s;    /* time constant while driven */
+  double tau_brake_s;    /* time constant while braking at pwm 0 */
+
+  double velocity;       /* counts/s */
+  double position;       /* counts, fractional */
+
+  void reset() {
+    velocity = 0.0;
+    position = 0.0;
+  }
+
+  void step(int16_t pwm, double dt) {
+    double target = (std::fabs((double)pwm) < deadband) ? 0.0 : pwm * counts_per_pwm;
+    double tau = (pwm == 0) ? tau_brake_s : tau_drive_s;
+    velocity += (target - velocity) * (dt / tau);
+    position += velocity * dt;
+  }
+};
+
+struct Move {
+  const char *name;
+  int16_t left_dist;
+  int16_t right_dist;
+};
+
+const Move battery[] = {
+  {"short", 100, 100},
+  {"long", 2880, 2880},
+  {"reverse", -720, -720},
+  {"spin", -500, 500},
+};
+
+struct MoveResult {
+  double time_to_target_ms;
+  double settle_ms;
+  int overshoot;
+  int final_error;
+  int straightness;
+};
+
+constexpr double kSubstepS = 100e-6;      /* wheel model integration step */
+constexpr double kHorizonS = 6.0;         /* simulated time per move */
+constexpr double kStillCountsPerS = 2.0;  /* "stopped" velocity threshold */
+
+WheelModel left_wheel = {12.0, 20.0, 0.060, 0.025, 0, 0};
+WheelModel right_wheel = {11.6, 22.0, 0.065, 0.025, 0, 0};
+
+void sync_encoders() {
+  romi_sim_left_counts = (int16_t)std::lround(left_wheel.position);
+  romi_sim_right_counts = (int16_t)std::lround(right_wheel.position);
+}
+
+/*
+ * Run one loop() and then advance the wheels for loop_us of simulated time,
+ * so the sketch sees encoder counts that are one loop period old, as on the
+ * robot.
+ */
+void tick(uint32_t loop_us) {
+  loop();
+
+  double remaining = loop_us * 1e-6;
+  while (remaining > 0) {
+    double dt = remaining < kSubstepS ? remaining : kSubstepS;
+    left_wheel.step(romi_sim_left_speed, dt);
+    right_wheel.step(romi_sim_right_speed, dt);
+    remaining -= dt;
+  }
+  sync_encoders();
+  romi_sim_micros += loop_us;
+}
+
+int signed_excess(double traveled, int target) {
+  /* Distance past the target in the direction of travel, 0 if short of it */
+  double excess = (target >= 0) ? traveled - target : target - traveled;
+  return excess > 0 ? (int)std::lround(excess) : 0;
+}
+
+MoveResult run_move(const Move &m, uint32_t loop_us) {
+  MoveResult r = {-1.0, -1.0, 0, 0, 0};
+
+  /* Start each move from rest with a zero command latched */
+  left_wheel.reset();
+  right_wheel.reset();
+  sync_encoders();
+  bench_write_commands(0, 0, 0, 0);
+  for (int i = 0; i < 10; i++) {
+    tick(loop_us);
+  }
+  left_wheel.reset();
+  right_wheel.reset();
+  sync_encoders();
+  tick(loop_us);
+
+  bench_write_commands(0, 0, m.left_dist, m.right_dist);
+
+  double t = 0.0;
+  double last_moving = 0.0;
+  const double dt = loop_us * 1e-6;
+  const bool same_sign = (m.left_dist >= 0) == (m.right_dist >= 0);
+  while (t < kHorizonS) {
+    tick(loop_us);
+    t += dt;
+
+    if (r.time_to_target_ms < 0 && rem_l_dist == 0 && rem_r_dist == 0) {
+      r.time_to_target_ms = t * 1e3;
+    }
+
+    int over = signed_excess(left_wheel.position, m.left_dist);
+    int over_r = signed_excess(right_wheel.position, m.right_dist);
+    if (over_r > over) {
+      over = over_r;
+    }
+    if (over > r.overshoot) {
+      r.overshoot = over;
+    }
+
+    /* Straight moves should travel equally, spins equally and opposite */
+    double skew = same_sign ? left_wheel.position - right_wheel.position
+                            : left_wheel.position + right_wheel.position;
+    int straightness = (int)std::lround(std::fabs(skew));
+    if (straightness > r.straightness) {
+      r.straightness = straightness;
+    }
+
+    if (std::fabs(left_wheel.velocity) > kStillCountsPerS || std::fabs(right_wheel.velocity) > kStillCountsPerS) {
+      last_moving = t;
+    }
+  }
+
+  r.settle_ms = last_moving * 1e3;
+
+  int err_l = (int)std::lround(left_wheel.position) - m.left_dist;
+  int err_r = (int)std::lround(right_wheel.position) - m.right_dist;
+  r.final_error = std::abs(err_l) > std::abs(err_r) ? err_l : err_r;
+
+  return r;
+}
+
+void usage(const char *argv0) {
+  std::fprintf(stderr, "Usage: %s [--loop-us N] [--csv]\n", argv0);
+  std::fprintf(stderr, "  --loop-us N  firmware loop period in microseconds (default 1000)\n");
+  std::fprintf(stderr, "  --csv        print results as CSV\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  uint32_t loop_us = 1000;
+  bool csv = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::strcmp(argv[i], "--loop-us") == 0 && i + 1 < argc) {
+      loop_us = (uint32_t)std::strtoul(argv[++i], nullptr, 0);
+    } else if (std::strcmp(argv[i], "--csv") == 0) {
+      csv = true;
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+  if (loop_us == 0) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  setup();
+
+  if (csv) {
+    std::printf("move,left_dist,right_dist,time_to_target_ms,overshoot_counts,settle_ms,final_error_counts,"
+                "straightness_counts\n");
+  } else {
+    std::printf("loop period: %u us\n\n", (unsigned)loop_us);
+    std::printf("%-8s %6s %6s %10s %9s %9s %9s %9s\n", "move", "left", "right", "target_ms", "overshoot", "settle_ms",
+                "final_err", "straight");
+  }
+
+  double total_settle_s = 0.0;
+  int unfinished = 0;
+  for (const Move &m : battery) {
+    MoveResult r = run_move(m, loop_us);
+    if (r.time_to_target_ms < 0) {
+      unfinished++;
+    }
+    total_settle_s += r.settle_ms / 1e3;
+
+    if (csv) {
+      std::printf("%s,%d,%d,%.1f,%d,%.1f,%d,%d\n", m.name, m.left_dist, m.right_dist, r.time_to_target_ms,
+                  r.overshoot, r.settle_ms, r.final_error, r.straightness);
+    } else {
+      std::printf("%-8s %6d %6d %10.1f %9d %9.1f %9d %9d\n", m.name, m.left_dist, m.right_dist, r.time_to_target_ms,
+                  r.overshoot, r.settle_ms, r.final_error, r.straightness);
+    }
+  }
+
+  if (!csv) {
+    size_t n = sizeof(battery) / sizeof(battery[0]);
+    std::printf("\nthroughput: %.1f moves/min (back-to-back, settle to settle)\n", 60.0 * n / total_settle_s);
+    if (unfinished) {
+      std::printf("%d move(s) never reached the target within %.0f s\n", unfinished, kHorizonS);
+    }
+  }
+
+  return unfinished ? 1 : 0;
+}
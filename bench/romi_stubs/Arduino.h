@@ -0,0 +1,52 @@
+// Minimal stand-in for the Arduino core, used when Robot_Code.cpp is built
+// outside the Arduino IDE for the benchmarks under bench/.
+//
+// Only what the sketch and the Pololu library stand-ins need is provided.
+// The min/max/abs helpers are macros on purpose: that is what the real
+// Arduino.h defines, so the sketch compiles to the same expressions.
+
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __AVR__
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#endif
+
+#include "romi_sim.h"
+
+#ifdef abs
+#undef abs
+#endif
+
+#define min(a,b) ((a)<(b)?(a):(b))
+#define max(a,b) ((a)>(b)?(a):(b))
+#define abs(x) ((x)>0?(x):-(x))
+
+// Simulated time base.  The host benchmarks advance it explicitly; on AVR it
+// only moves if the harness moves it.
+static inline uint32_t micros() { return romi_sim_micros; }
+static inline uint32_t millis() { return romi_sim_micros / 1000; }
+
+static inline void delayMicroseconds(unsigned int us) {
+#ifdef __AVR__
+  while (us--) {
+    __builtin_avr_delay_cycles(F_CPU / 1000000UL);
+  }
+#else
+  romi_sim_advance(us);
+#endif
+}
+
+#ifdef __AVR__
+#define noInterrupts() cli()
+#define interrupts() sei()
+#else
+// The host benchmarks deliver "interrupts" from romi_sim_advance(), which
+// the sketch only reaches through delays and the ADC read.
+static inline void noInterrupts() {}
+static inline void interrupts() {}
+#endif
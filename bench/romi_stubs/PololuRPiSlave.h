@@ -0,0 +1,95 @@
+// Stand-in for PololuRPiSlave from the Pololu Raspberry Pi slave library,
+// used by the benchmarks under bench/.
+//
+// It keeps the real library's buffering model: the master reads and writes a
+// staging copy from the TWI interrupt, updateBuffer() snapshots it into
+// `buffer`, and finalizeWrites() copies back only the bytes the sketch
+// changed, so a master write that lands between the two is not clobbered.
+// transmit() applies the same per-byte pi_delay_us workaround delay.
+//
+// masterWrite()/masterRead() replay what the TWI interrupt would see for one
+// master transaction; they exist only in this stand-in.
+
+#pragma once
+
+#include "Arduino.h"
+
+template <class BufferType, unsigned int pi_delay_us>
+class PololuRPiSlave {
+public:
+  BufferType buffer;
+
+  void init(uint8_t address) {
+    (void)address;
+    memset(&buffer, 0, sizeof(buffer));
+    memset(&staging, 0, sizeof(staging));
+    memset(&old, 0, sizeof(old));
+  }
+
+  void updateBuffer() {
+    memcpy(&buffer, &staging, sizeof(BufferType));
+    memcpy(&old, &staging, sizeof(BufferType));
+  }
+
+  void finalizeWrites() {
+    uint8_t *b = (uint8_t *)&buffer;
+    uint8_t *o = (uint8_t *)&old;
+    uint8_t *s = (uint8_t *)&staging;
+    for (uint8_t i = 0; i < sizeof(BufferType); i++) {
+      if (b[i] != o[i]) {
+        s[i] = b[i];
+      }
+    }
+  }
+
+  virtual void start() {
+    index_set = false;
+  }
+
+  virtual void receive(uint8_t b) {
+    if (!index_set) {
+      index = b;
+      index_set = true;
+      return;
+    }
+    if (index < sizeof(BufferType)) {
+      ((uint8_t *)&staging)[index++] = b;
+    }
+  }
+
+  virtual uint8_t transmit() {
+    delayMicroseconds(pi_delay_us);
+    if (index < sizeof(BufferType)) {
+      return ((uint8_t *)&staging)[index++];
+    }
+    return 0;
+  }
+
+  virtual void stop() {}
+
+  void masterWrite(uint8_t offset, const void *data, uint8_t len) {
+    start();
+    receive(offset);
+    for (uint8_t i = 0; i < len; i++) {
+      receive(((const uint8_t *)data)[i]);
+    }
+    stop();
+  }
+
+  void masterRead(uint8_t offset, void *data, uint8_t len) {
+    start();
+    receive(offset);
+    stop();
+    start();
+    for (uint8_t i = 0; i < len; i++) {
+      ((uint8_t *)data)[i] = transmit();
+    }
+    stop();
+  }
+
+protected:
+  BufferType staging;
+  BufferType old;
+  uint8_t index = 0;
+  bool index_set = false;
+};
@@ -0,0 +1,63 @@
+// Stand-in for the Pololu Romi32U4 library used by the benchmarks under
+// bench/.  The hardware classes only read and write the romi_sim_* globals
+// below, so a harness can drive encoder counts and observe motor commands.
+//
+// The stand-ins are deliberately about as cheap as the real register
+// accesses, except readBatteryMillivolts() which burns ROMI_STUB_ADC_CYCLES
+// on AVR (romi_sim_adc_us on the host) to stand in for the ADC conversion
+// the real call waits on.
+
+#pragma once
+
+#include "Arduino.h"
+
+#ifndef ROMI_STUB_ADC_CYCLES
+#define ROMI_STUB_ADC_CYCLES 1800 /* ~112 us analogRead() at 16 MHz */
+#endif
+
+class Romi32U4Motors {
+public:
+  static void setLeftSpeed(int16_t speed) { romi_sim_left_speed = speed; }
+  static void setRightSpeed(int16_t speed) { romi_sim_right_speed = speed; }
+  static void setSpeeds(int16_t left, int16_t right) {
+    setLeftSpeed(left);
+    setRightSpeed(right);
+  }
+};
+
+class Romi32U4Encoders {
+public:
+  static int16_t getCountsLeft() { return romi_sim_left_counts; }
+  static int16_t getCountsRight() { return romi_sim_right_counts; }
+};
+
+template <uint8_t mask>
+class Romi32U4StubButton {
+public:
+  bool getSingleDebouncedPress() { return (romi_sim_buttons & mask) != 0; }
+};
+
+typedef Romi32U4StubButton<0x01> Romi32U4ButtonA;
+typedef Romi32U4StubButton<0x02> Romi32U4ButtonB;
+typedef Romi32U4StubButton<0x04> Romi32U4ButtonC;
+
+static inline void ledRed(bool on) {
+  romi_sim_leds = on ? (romi_sim_leds | 0x01) : (romi_sim_leds & ~0x01);
+}
+
+static inline void ledGreen(bool on) {
+  romi_sim_leds = on ? (romi_sim_leds | 0x02) : (romi_sim_leds & ~0x02);
+}
+
+static inline void ledYellow(bool on) {
+  romi_sim_leds = on ? (romi_sim_leds | 0x04) : (romi_sim_leds & ~0x04);
+}
+
+static inline uint16_t readBatteryMillivolts() {
+#ifdef __AVR__
+  __builtin_avr_delay_cycles(ROMI_STUB_ADC_CYCLES);
+#else
+  romi_sim_advance(romi_sim_adc_us);
+#endif
+  return romi_sim_battery_mv;
+}
@@ -0,0 +1,27 @@
+// Builds Robot_Code.cpp as one translation unit for the benchmarks and adds
+// the few entry points a harness needs to reach the sketch's file-scope
+// objects.  Kept apart from the harness so the measured functions stay real
+// out-of-line calls.
+
+#include "../../Robot_Code.cpp"
+
+void bench_write_commands(int16_t left_speed, int16_t right_speed, int16_t left_dist, int16_t right_dist) {
+  Commands c = {};
+  c.left_speed = left_speed;
+  c.right_speed = right_speed;
+  c.left_dist = left_dist;
+  c.right_dist = right_dist;
+  slave.masterWrite(0, &c, sizeof(c));
+}
+
+void bench_read_telemetry(void *dst, uint8_t len) {
+  slave.masterRead(sizeof(Commands), dst, len);
+}
+
+void bench_master_read(uint8_t offset, void *dst, uint8_t len) {
+  slave.masterRead(offset, dst, len);
+}
+
+unsigned int bench_slave_byte_delay_us() {
+  return ROMI_SLAVE_BYTE_DELAY_US;
+}
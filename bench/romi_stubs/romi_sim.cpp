@@ -0,0 +1,30 @@
+#include "romi_sim.h"
+
+volatile uint32_t romi_sim_micros = 0;
+
+volatile int16_t  romi_sim_left_counts = 0;
+volatile int16_t  romi_sim_right_counts = 0;
+volatile int16_t  romi_sim_left_speed = 0;
+volatile int16_t  romi_sim_right_speed = 0;
+volatile uint16_t romi_sim_battery_mv = 7200;
+volatile uint8_t  romi_sim_leds = 0;
+volatile uint8_t  romi_sim_buttons = 0;
+
+uint32_t romi_sim_adc_us = 0;
+
+void (*romi_sim_event)() = 0;
+uint32_t romi_sim_event_at = 0;
+
+void romi_sim_advance(uint32_t us) {
+  uint32_t end = romi_sim_micros + us;
+
+  if (romi_sim_event != 0 && (int32_t)(romi_sim_event_at - end) <= 0) {
+    void (*event)() = romi_sim_event;
+    romi_sim_event = 0;
+    if ((int32_t)(romi_sim_event_at - romi_sim_micros) > 0) {
+      romi_sim_micros = romi_sim_event_at;
+    }
+    event();
+  }
+  romi_sim_micros = end;
+}
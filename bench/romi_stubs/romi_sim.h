@@ -0,0 +1,30 @@
+// State shared between the Arduino/Pololu stand-ins in this directory and
+// the benchmark harnesses that drive them.  This header defines no macros,
+// so harness code can include it next to the C++ standard library.
+
+#pragma once
+
+#include <stdint.h>
+
+extern volatile uint32_t romi_sim_micros;
+
+extern volatile int16_t  romi_sim_left_counts;
+extern volatile int16_t  romi_sim_right_counts;
+extern volatile int16_t  romi_sim_left_speed;
+extern volatile int16_t  romi_sim_right_speed;
+extern volatile uint16_t romi_sim_battery_mv;
+extern volatile uint8_t  romi_sim_leds;
+extern volatile uint8_t  romi_sim_buttons;
+
+// Simulated time spent in readBatteryMillivolts() on the host, 0 unless a
+// harness sets it; on AVR the stand-in burns ROMI_STUB_ADC_CYCLES instead.
+extern uint32_t romi_sim_adc_us;
+
+// Scheduled master activity.  romi_sim_advance() moves the clock forward and,
+// once it reaches romi_sim_event_at, runs romi_sim_event (cleared first) at
+// that exact time, the way a TWI interrupt would land in the middle of a
+// delay or the ADC read.
+extern void (*romi_sim_event)();
+extern uint32_t romi_sim_event_at;
+
+void romi_sim_advance(uint32_t us);
@@ -0,0 +1,85 @@
+// Per-transfer cost of the PololuRPiSlave byte delay for each host profile.
+//
+// Builds Robot_Code.cpp with one ROMI_HOST_PROFILE and replays the host's
+// register reads against the slave stand-in, which applies the same
+// per-byte delay as the real library.  The delay is measured on the
+// simulated clock; the wire time of a pointer write plus repeated-start read
+// is added from the bit count (START, address, offset, Sr, address, data,
+// STOP at nine clocks per byte), so the table shows how long each read holds
+// the bus and how much of that the Raspberry Pi workaround costs.  Kernel
+// and adapter overhead are not modelled; `romictl sweep` measures those on
+// the robot.
+
+#include <cstdio>
+#include <cstring>
+
+#include "../../protocol/romi_protocol.h"
+#include "romi_sim.h"
+
+void setup();
+void bench_master_read(uint8_t offset, void *dst, uint8_t len);
+unsigned int bench_slave_byte_delay_us();
+
+namespace {
+
+// PololuRPiSlave's documented setting for the Raspberry Pi
+const unsigned int kRaspberryPiDelayUs = 5;
+
+struct Read {
+  const char *name;
+  uint8_t offset;
+  uint8_t len;
+};
+
+const Read reads[] = {
+  {"battery", ROMI_TELEM_BATTERYMILLIVOLTS_OFFSET, ROMI_TELEM_BATTERYMILLIVOLTS_SIZE},
+  {"encoders", ROMI_TELEM_L_ENC_OFFSET, 2 * ROMI_TELEM_L_ENC_SIZE},
+  {"command", ROMI_CMD_OFFSET, ROMI_CMD_SIZE},
+  {"telemetry", ROMI_TELEM_OFFSET, ROMI_TELEM_SIZE},
+  {"all", 0, ROMI_DATA_SIZE},
+};
+
+const unsigned int bus_khz[] = {100, 400};
+
+double wire_us(unsigned int khz, uint8_t len) {
+  unsigned int bits = 1 + 9 + 9 + 1 + 9 + 9u * len + 1;
+  return bits * 1000.0 / khz;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  bool csv = argc > 1 && std::strcmp(argv[1], "--csv") == 0;
+  unsigned int delay_us = bench_slave_byte_delay_us();
+
+  setup();
+
+  if (csv) {
+    std::printf("delay_us,bus_khz,read,bytes,stretch_us,transfer_us,transfers_per_s,saved_us,saved_pct\n");
+  } else {
+    std::printf("PololuRPiSlave byte delay: %u us (Raspberry Pi setting %u us)\n\n", delay_us, kRaspberryPiDelayUs);
+    std::printf("%-4s %-10s %5s %10s %11s %10s %9s %7s\n", "kHz", "read", "bytes", "stretch_us", "transfer_us",
+                "per_s", "saved_us", "saved");
+  }
+
+  for (unsigned int khz : bus_khz) {
+    for (const Read &r : reads) {
+      uint8_t buf[ROMI_DATA_SIZE];
+      uint32_t t0 = romi_sim_micros;
+      bench_master_read(r.offset, buf, r.len);
+      double stretch = (double)(romi_sim_micros - t0);
+
+      double transfer = wire_us(khz, r.len) + stretch;
+      double pi_transfer = wire_us(khz, r.len) + (double)kRaspberryPiDelayUs * r.len;
+      double saved = pi_transfer - transfer;
+      if (csv) {
+        std::printf("%u,%u,%s,%u,%.0f,%.1f,%.0f,%.1f,%.1f\n", delay_us, khz, r.name, r.len, stretch, transfer,
+                    1e6 / transfer, saved, 100.0 * saved / pi_transfer);
+      } else {
+        std::printf("%-4u %-10s %5u %10.0f %11.1f %10.0f %9.1f %6.1f%%\n", khz, r.name, r.len, stretch, transfer,
+                    1e6 / transfer, saved, 100.0 * saved / pi_transfer);
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,66 @@
+/*
+** C interface to the Romi driver, for C callers.  i2c_app does not use it
+** yet; it keeps its own i2c-dev calls.
+**
+** Thin wrapper over romi::RomiDevice (romi_driver.hpp).  Every call returns
+** 0 or a negative errno value.  A device handle may be shared between
+** threads; asynchronous tickets belong to the handle that issued them.
+*/
+#ifndef ROMI_DRIVER_H
+#define ROMI_DRIVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "romi_protocol.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct romi_device romi_device_t;
+typedef uint64_t           romi_ticket_t;
+
+/* Open /dev/i2c-<bus> for the robot at addr.  read_gap_us: see romi::Options. */
+int  romi_open(int bus, uint8_t addr, uint32_t read_gap_us, romi_device_t **dev);
+void romi_close(romi_device_t *dev);
+
+/* Whole-block transfers, one bus transaction each (two for a gapped read) */
+int romi_send_command(romi_device_t *dev, const I2C_Command_Packet *cmd);
+int romi_read_telemetry(romi_device_t *dev, I2C_Telem_Packet *telem);
+
+/* Raw register access at an absolute offset */
+int romi_write_reg(romi_device_t *dev, uint8_t offset, const void *data, size_t len);
+int romi_read_reg(romi_device_t *dev, uint8_t offset, void *data, size_t len);
+
+/*
+** Non-blocking variants.  The command is copied at submit; telem must stay
+** valid until the ticket completes.
+*/
+int romi_submit_command(romi_device_t *dev, const I2C_Command_Packet *cmd, romi_ticket_t *ticket);
+int romi_submit_telemetry(romi_device_t *dev, I2C_Telem_Packet *telem, romi_ticket_t *ticket);
+
+/*
+** Start a move of left/right encoder counts; see RomiDevice::start_move.
+** romi_mm_to_counts/romi_deg_to_counts convert with the stock Romi chassis.
+*/
+int     romi_start_move(romi_device_t *dev, int16_t left, int16_t right, int timeout_ms);
+int16_t romi_mm_to_counts(double mm);
+int16_t romi_deg_to_counts(double degrees);
+
+/*
+** Block until the current move finishes (rem_left/rem_right zero, wheels
+** stopped), polling telemetry sparsely while far from the target and every
+** 2 ms close to it.  Returns 0, -ETIMEDOUT, or the bus error.
+*/
+int romi_wait_motion_done(romi_device_t *dev, int timeout_ms);
+
+/* -EINPROGRESS while pending, else the result; see RomiDevice::poll/wait */
+int romi_poll(romi_device_t *dev, romi_ticket_t ticket);
+int romi_wait(romi_device_t *dev, romi_ticket_t ticket, int timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ROMI_DRIVER_H */
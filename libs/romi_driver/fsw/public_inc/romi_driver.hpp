@@ -0,0 +1,360 @@
+// Host-side driver for the Romi 32U4 I2C slave (Robot_Code.cpp).
+//
+// Used directly by the standalone tools, and through the C shim in
+// romi_driver.h by C callers.  The flight app does not use it yet: i2c_app
+// still makes its own i2c-dev calls, which its coverage, soak and fleet
+// tests stub, and moving it onto the shim is a change of its own.  The
+// register map comes from protocol/romi_protocol.h, so offsets and
+// encodings cannot drift from the firmware.
+//
+//   RomiDevice       one robot (bus + slave address) behind a Transport
+//   Register<O, T>   a typed register: absolute offset O, value type T
+//   Batch            several register accesses run back to back, with
+//                    contiguous accesses of the same direction merged into
+//                    one bus transaction
+//   submit/poll/wait non-blocking execution of a Batch on the device's
+//                    worker thread
+//
+// Errors are returned as 0 or a negative errno value, the same convention
+// as the Linux i2c-dev calls underneath, so the C shim can pass them
+// through unchanged.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "romi_protocol.h"
+
+namespace romi {
+
+// One I2C message; a transfer is a sequence of these joined by repeated
+// starts, like struct i2c_msg.
+struct I2cMsg {
+  uint8_t *data;
+  uint16_t len;
+  bool read;
+};
+
+class Transport {
+ public:
+  virtual ~Transport() = default;
+
+  // Run msgs[0..count) as one bus transaction to the 7-bit address addr.
+  virtual int transfer(uint8_t addr, I2cMsg *msgs, size_t count) = 0;
+};
+
+// /dev/i2c-N through the I2C_RDWR ioctl: one syscall per transaction.
+class LinuxI2cTransport : public Transport {
+ public:
+  ~LinuxI2cTransport() override;
+
+  static int open(int bus, std::unique_ptr<Transport> *out);
+
+  int transfer(uint8_t addr, I2cMsg *msgs, size_t count) override;
+
+ private:
+  explicit LinuxI2cTransport(int fd) : fd_(fd) {}
+
+  int fd_;
+};
+
+// Value encodings on the wire.  Scalars are little-endian; the command and
+// telemetry blocks use the generated pack/unpack functions.
+template <typename T>
+struct Codec;
+
+template <>
+struct Codec<bool> {
+  static void encode(uint8_t *p, bool v) { romi_put_bool(p, v); }
+  static bool decode(const uint8_t *p) { return romi_get_bool(p); }
+};
+template <>
+struct Codec<uint8_t> {
+  static void encode(uint8_t *p, uint8_t v) { romi_put_u8(p, v); }
+  static uint8_t decode(const uint8_t *p) { return romi_get_u8(p); }
+};
+template <>
+struct Codec<int16_t> {
+  static void encode(uint8_t *p, int16_t v) { romi_put_i16(p, v); }
+  static int16_t decode(const uint8_t *p) { return romi_get_i16(p); }
+};
+template <>
+struct Codec<uint16_t> {
+  static void encode(uint8_t *p, uint16_t v) { romi_put_u16(p, v); }
+  static uint16_t decode(const uint8_t *p) { return romi_get_u16(p); }
+};
+template <>
+struct Codec<I2C_Command_Packet> {
+  static void encode(uint8_t *p, const I2C_Command_Packet &v) { romi_cmd_pack(p, &v); }
+  static I2C_Command_Packet decode(const uint8_t *p) {
+    I2C_Command_Packet v;
+    romi_cmd_unpack(&v, p);
+    return v;
+  }
+};
+template <>
+struct Codec<I2C_Telem_Packet> {
+  static void encode(uint8_t *p, const I2C_Telem_Packet &v) { romi_telem_pack(p, &v); }
+  static I2C_Telem_Packet decode(const uint8_t *p) {
+    I2C_Telem_Packet v;
+    romi_telem_unpack(&v, p);
+    return v;
+  }
+};
+template <>
+struct Codec<I2C_Ident_Packet> {
+  static void encode(uint8_t *p, const I2C_Ident_Packet &v) { romi_ident_pack(p, &v); }
+  static I2C_Ident_Packet decode(const uint8_t *p) {
+    I2C_Ident_Packet v;
+    romi_ident_unpack(&v, p);
+    return v;
+  }
+};
+template <>
+struct Codec<I2C_Diag_Packet> {
+  static void encode(uint8_t *p, const I2C_Diag_Packet &v) { romi_diag_pack(p, &v); }
+  static I2C_Diag_Packet decode(const uint8_t *p) {
+    I2C_Diag_Packet v;
+    romi_diag_unpack(&v, p);
+    return v;
+  }
+};
+template <>
+struct Codec<I2C_Snap_Packet> {
+  static void encode(uint8_t *p, const I2C_Snap_Packet &v) { romi_snap_pack(p, &v); }
+  static I2C_Snap_Packet decode(const uint8_t *p) {
+    I2C_Snap_Packet v;
+    romi_snap_unpack(&v, p);
+    return v;
+  }
+};
+
+template <uint8_t Offset, typename T>
+struct Register {
+  using type = T;
+  static constexpr uint8_t offset = Offset;
+  static constexpr uint8_t size = sizeof(T);
+
+  static_assert(Offset + sizeof(T) <= reg::data_size, "register outside the slave buffer");
+};
+
+// The Romi register map, typed.
+namespace regs {
+using Command = Register<reg::cmd, I2C_Command_Packet>;
+using LeftSpeed = Register<reg::cmd_left_speed, int16_t>;
+using RightSpeed = Register<reg::cmd_right_speed, int16_t>;
+using LeftDist = Register<reg::cmd_left_dist, int16_t>;
+using RightDist = Register<reg::cmd_right_dist, int16_t>;
+using RedLed = Register<reg::cmd_r_led, bool>;
+using GreenLed = Register<reg::cmd_g_led, bool>;
+using YellowLed = Register<reg::cmd_y_led, bool>;
+
+using Telemetry = Register<reg::telem, I2C_Telem_Packet>;
+using LeftEncoder = Register<reg::telem_l_enc, int16_t>;
+using RightEncoder = Register<reg::telem_r_enc, int16_t>;
+using RemLeft = Register<reg::telem_rem_left, int16_t>;
+using RemRight = Register<reg::telem_rem_right, int16_t>;
+using BatteryMillivolts = Register<reg::telem_batteryMillivolts, uint16_t>;
+
+// Read-only; firmware before protocol version 2 has no identity block and
+// answers with whatever lies past its buffer, so check the magic.
+using Identity = Register<reg::ident, I2C_Ident_Packet>;
+// Read-only, protocol version 3 on.
+using Diagnostics = Register<reg::diag, I2C_Diag_Packet>;
+// Encoders and remaining distances captured as the read starts, with the
+// robot's clock; needs ROMI_FEATURE_FRESH_SNAPSHOT.
+using Snapshot = Register<reg::snap, I2C_Snap_Packet>;
+}  // namespace regs
+
+// A sequence of register accesses executed in order.  Writes are encoded
+// when they are added, so the caller's values need not outlive the call;
+// read destinations must stay valid until the batch completes.
+class Batch {
+ public:
+  template <typename R>
+  Batch &write(R, const typename R::type &value) {
+    uint8_t bytes[R::size];
+    Codec<typename R::type>::encode(bytes, value);
+    return write_bytes(R::offset, bytes, R::size);
+  }
+
+  template <typename R>
+  Batch &read(R, typename R::type *out) {
+    return add_read(R::offset, R::size, [out](const uint8_t *p) { *out = Codec<typename R::type>::decode(p); });
+  }
+
+  // An access that runs past the end of the slave buffer is not added;
+  // the batch then fails with -EINVAL when it is executed or submitted.
+  Batch &write_bytes(uint8_t offset, const uint8_t *data, size_t len);
+  Batch &read_bytes(uint8_t offset, uint8_t *out, size_t len);
+
+  bool empty() const { return ops_.empty(); }
+  void clear() {
+    ops_.clear();
+    error_ = 0;
+  }
+
+ private:
+  friend class RomiDevice;
+
+  struct Op {
+    bool read;
+    uint8_t offset;
+    uint8_t len;
+    std::vector<uint8_t> bytes;  // write payload
+    // read sinks, each with its start within the op
+    std::vector<std::pair<uint8_t, std::function<void(const uint8_t *)>>> sinks;
+  };
+
+  Batch &add_read(uint8_t offset, size_t len, std::function<void(const uint8_t *)> sink);
+
+  std::vector<Op> ops_;
+  int error_ = 0;  // -EINVAL once an access was rejected
+};
+
+struct Options {
+  // Pause between setting the register pointer and reading it back.
+  // PololuRPiSlave needs one on the Raspberry Pi / BeagleBone; with 0 the
+  // pointer write and the read go out as one repeated-start transaction.
+  uint32_t read_gap_us = 100;
+};
+
+struct Stats {
+  uint64_t transactions = 0;  // Transport::transfer calls
+  uint64_t bytes = 0;         // payload bytes, both directions
+  uint64_t errors = 0;
+  uint64_t batches = 0;
+};
+
+// Romi chassis: 70 mm wheels, 1440 encoder counts per wheel turn, 141 mm
+// between the wheels.
+struct Geometry {
+  double counts_per_mm = 1440.0 / (70.0 * 3.14159265358979);
+  double wheel_base_mm = 141.0;
+
+  // Per-wheel distance in encoder counts, saturated to int16_t.
+  int16_t drive_counts(double mm) const;
+  // Left wheel -n, right wheel +n; positive degrees turn counter-clockwise.
+  int16_t spin_counts(double degrees) const;
+};
+
+// How wait_motion_done() spaces its telemetry polls.  The next poll comes
+// after `fraction` of the predicted time to finish, clamped to
+// [min_interval_us, max_interval_us]: sparse while the robot is far from the
+// target, one control tick apart as it gets close.
+struct WaitPolicy {
+  uint32_t min_interval_us = 2000;    // one host control tick
+  uint32_t max_interval_us = 200000;  // still notice a stall within this long
+  double counts_per_s_per_speed = 12.0;  // wheel speed per unit of set_*_speed
+  double fraction = 0.5;
+  int max_read_errors = 3;  // consecutive failed polls before giving up
+};
+
+struct WaitStats {
+  uint32_t polls = 0;
+  uint32_t read_errors = 0;
+};
+
+// Delay until the next poll for a move in the state `t`.
+uint32_t next_poll_interval_us(const I2C_Telem_Packet &t, const WaitPolicy &policy);
+
+using Ticket = uint64_t;
+
+class RomiDevice {
+ public:
+  RomiDevice(std::unique_ptr<Transport> transport, uint8_t addr = ROMI_I2C_ADDRESS, Options options = Options());
+  ~RomiDevice();
+
+  RomiDevice(const RomiDevice &) = delete;
+  RomiDevice &operator=(const RomiDevice &) = delete;
+
+  // Open /dev/i2c-<bus> and bind a device to addr.
+  static int open(int bus, uint8_t addr, std::unique_ptr<RomiDevice> *out, Options options = Options());
+
+  template <typename R>
+  int write(R r, const typename R::type &value) {
+    Batch b;
+    b.write(r, value);
+    return execute(b);
+  }
+
+  template <typename R>
+  int read(R r, typename R::type *out) {
+    Batch b;
+    b.read(r, out);
+    return execute(b);
+  }
+
+  // Run a batch on the calling thread.  Stops at the first failed
+  // transaction and returns its error.
+  int execute(const Batch &batch);
+
+  // Queue a batch for the worker thread and return at once.  Batches run in
+  // submission order; a synchronous execute() may run between them.
+  Ticket submit(Batch batch);
+
+  // -EINPROGRESS while the batch is queued or running; otherwise its result,
+  // after which the ticket is forgotten.  Unknown tickets give -ENOENT.
+  int poll(Ticket ticket);
+
+  // Block until the batch completes (timeout_ms < 0: no limit).  Returns its
+  // result, or -ETIMEDOUT with the ticket still pending.
+  int wait(Ticket ticket, int timeout_ms = -1);
+
+  // Start a move of left/right encoder counts (speeds 0, so the firmware's
+  // distance ladder picks them).  The firmware only starts a move when a
+  // distance register changes, so if it still holds a requested nonzero
+  // distance this first writes zeros and waits up to `timeout` for them to
+  // be seen.  LEDs are left alone.
+  int start_move(int16_t left, int16_t right, std::chrono::milliseconds timeout = std::chrono::milliseconds(500));
+
+  // Block until the current move is finished: rem_left and rem_right are
+  // zero, both wheels are stopped, and, if distances were written through
+  // this device, the firmware echoes the last ones (so a poll racing the
+  // command is not taken for completion).  Returns 0, -ETIMEDOUT, or the
+  // bus error after policy.max_read_errors failed polls in a row.
+  int wait_motion_done(std::chrono::milliseconds timeout, const WaitPolicy &policy = WaitPolicy(),
+                       I2C_Telem_Packet *last = nullptr, WaitStats *stats = nullptr);
+
+  Stats stats() const;
+  const Options &options() const { return options_; }
+  uint8_t address() const { return addr_; }
+
+ private:
+  int run(const Batch &batch);
+  void note_distances(const Batch::Op &op);
+  bool pending_locked(Ticket ticket) const;
+  void worker_main();
+
+  std::unique_ptr<Transport> transport_;
+  uint8_t addr_;
+  Options options_;
+
+  // Serializes bus access between execute() and the worker.
+  mutable std::mutex bus_mutex_;
+  Stats stats_;
+  int16_t last_dist_[2] = {0, 0};  // last left/right distances written
+  bool dist_known_[2] = {false, false};
+
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::condition_variable done_cv_;
+  std::deque<std::pair<Ticket, Batch>> queue_;
+  std::unordered_map<Ticket, int> done_;
+  Ticket next_ticket_ = 1;
+  Ticket running_ = 0;
+  bool stopping_ = false;
+  std::thread worker_;
+};
+
+}  // namespace romi
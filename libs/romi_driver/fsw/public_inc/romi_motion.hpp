@@ -0,0 +1,203 @@
+// Coroutine motion API on top of RomiDevice (C++20).
+//
+//   romi::motion::Task square(romi::motion::Robot &r) {
+//     for (int i = 0; i < 4; ++i) {
+//       co_await r.drive(300);
+//       co_await r.spin(90);
+//     }
+//   }
+//
+//   EventLoop loop;
+//   Robot a(loop, dev_a), b(loop, dev_b);
+//   loop.spawn(square(a));
+//   loop.spawn(square(b));
+//   loop.run();
+//
+// drive/spin/stop send one command and return an awaitable that resumes
+// when the firmware reports the move finished: its telemetry echoes the
+// commanded distances and rem_left/rem_right are both zero.  co_await
+// yields 0, or a negative errno if the command or the telemetry reads fail,
+// the move times out, or another motion on the same robot replaced it
+// (-ECANCELED).
+//
+// All coroutines run on the thread calling run().  Each round the loop
+// submits a telemetry read to every robot with a motion in flight, so
+// robots on different buses are read in parallel by their device workers,
+// then resumes whatever finished.
+
+#pragma once
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <vector>
+
+#include "romi_driver.hpp"
+
+namespace romi {
+namespace motion {
+
+struct LoopOptions {
+  std::chrono::microseconds poll_period{20000};  // between telemetry rounds
+  std::chrono::milliseconds motion_timeout{30000};
+  int max_read_errors = 5;  // consecutive failed polls before a motion fails
+};
+
+// A coroutine run by the EventLoop, or awaited from another Task.
+class Task {
+ public:
+  struct promise_type {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    auto final_suspend() noexcept {
+      struct Final {
+        bool await_ready() noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+          auto next = h.promise().continuation;
+          return next ? next : std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+      };
+      return Final{};
+    }
+    void return_void() {}
+    void unhandled_exception() { error = std::current_exception(); }
+  };
+
+  Task(Task &&other) noexcept : handle_(other.handle_) { other.handle_ = nullptr; }
+  Task &operator=(Task &&other) noexcept;
+  Task(const Task &) = delete;
+  Task &operator=(const Task &) = delete;
+  ~Task();
+
+  bool done() const { return !handle_ || handle_.done(); }
+
+  // Awaiting a Task runs it to completion before the caller continues.
+  bool await_ready() const { return done(); }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) {
+    handle_.promise().continuation = caller;
+    return handle_;
+  }
+  void await_resume();
+
+ private:
+  friend class EventLoop;
+  explicit Task(std::coroutine_handle<promise_type> h) : handle_(h) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+class EventLoop;
+
+class Robot {
+ public:
+  Robot(EventLoop &loop, RomiDevice &dev, Geometry geometry = Geometry());
+  ~Robot();
+
+  Robot(const Robot &) = delete;
+  Robot &operator=(const Robot &) = delete;
+
+  class Motion {
+   public:
+    bool await_ready() const { return false; }
+    void await_suspend(std::coroutine_handle<> h) { robot_->begin(this, h); }
+    int await_resume() const { return result_; }
+
+   private:
+    friend class Robot;
+    Motion(Robot *robot, int16_t left, int16_t right, bool stop)
+        : robot_(robot), left_(left), right_(right), stop_(stop) {}
+
+    Robot *robot_;
+    int16_t left_;
+    int16_t right_;
+    bool stop_;
+    int result_ = 0;
+  };
+
+  Motion drive(double mm);
+  Motion spin(double degrees);  // positive turns counter-clockwise
+  Motion stop();
+
+  // Distances in encoder counts, for callers that work in counts already.
+  Motion move_counts(int16_t left, int16_t right) { return Motion(this, left, right, false); }
+
+  // Last telemetry read by the loop.
+  const I2C_Telem_Packet &telemetry() const { return telem_; }
+  bool busy() const { return waiter_ != nullptr; }
+
+ private:
+  friend class EventLoop;
+
+  enum class Phase { Idle, Clearing, Moving };
+
+  void begin(Motion *m, std::coroutine_handle<> h);
+  void send(int16_t left, int16_t right);
+  void submit_poll();
+  // Collect this round's results; returns the coroutine to resume, if any.
+  std::coroutine_handle<> collect(std::chrono::steady_clock::time_point now);
+  std::coroutine_handle<> finish(int result);
+
+  EventLoop &loop_;
+  RomiDevice &dev_;
+  Geometry geometry_;
+
+  Phase phase_ = Phase::Idle;
+  Motion *current_ = nullptr;  // lives in the suspended coroutine's frame
+  std::coroutine_handle<> waiter_;
+  int16_t target_left_ = 0;
+  int16_t target_right_ = 0;
+  bool target_stop_ = false;
+  int16_t sent_left_ = 0;  // last distances written to the firmware
+  int16_t sent_right_ = 0;
+  bool sent_any_ = false;
+  std::chrono::steady_clock::time_point deadline_;
+  int read_errors_ = 0;
+
+  Ticket cmd_ticket_ = 0;
+  Ticket poll_ticket_ = 0;
+  I2C_Telem_Packet poll_buf_ = {};  // written by the device worker
+  I2C_Telem_Packet telem_ = {};
+};
+
+class EventLoop {
+ public:
+  explicit EventLoop(LoopOptions options = LoopOptions()) : options_(options) {}
+
+  // Start a task now; the loop owns it until it finishes.
+  void spawn(Task task);
+
+  // Run until every spawned task has finished, or none can make progress
+  // (every task is waiting on something other than a robot).  Rethrows the
+  // first exception a task let escape.  Declare the loop before the robots
+  // that use it.
+  void run();
+
+  // One polling round, without sleeping.  Returns false once nothing is
+  // left to run.
+  bool run_once();
+
+  const LoopOptions &options() const { return options_; }
+  uint64_t rounds() const { return rounds_; }
+
+ private:
+  friend class Robot;
+
+  void attach(Robot *robot);
+  void detach(Robot *robot);
+  void resume_ready();
+  void reap();
+
+  LoopOptions options_;
+  std::vector<Robot *> robots_;
+  std::vector<Task> tasks_;
+  std::vector<std::coroutine_handle<>> ready_;
+  uint64_t rounds_ = 0;
+};
+
+}  // namespace motion
+}  // namespace romi
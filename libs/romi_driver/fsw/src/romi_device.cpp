@@ -0,0 +1,237 @@
+// RomiDevice: batching, register-pointer handling and the async worker.
+
+#include "romi_driver.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace romi {
+
+Batch &Batch::write_bytes(uint8_t offset, const uint8_t *data, size_t len) {
+  if ((size_t)offset + len > reg::data_size) {
+    error_ = -EINVAL;
+    return *this;
+  }
+  // Contiguous writes become one transaction: the slave auto-increments
+  // its register pointer, so left_speed + right_speed is a single 5-byte
+  // write instead of two 3-byte ones.
+  if (!ops_.empty()) {
+    Op &last = ops_.back();
+    if (!last.read && last.offset + last.len == offset && last.len + len <= reg::data_size) {
+      last.bytes.insert(last.bytes.end(), data, data + len);
+      last.len = (uint8_t)(last.len + len);
+      return *this;
+    }
+  }
+  Op op;
+  op.read = false;
+  op.offset = offset;
+  op.len = (uint8_t)len;
+  op.bytes.assign(data, data + len);
+  ops_.push_back(std::move(op));
+  return *this;
+}
+
+Batch &Batch::read_bytes(uint8_t offset, uint8_t *out, size_t len) {
+  return add_read(offset, len, [out, len](const uint8_t *p) { std::memcpy(out, p, len); });
+}
+
+Batch &Batch::add_read(uint8_t offset, size_t len, std::function<void(const uint8_t *)> sink) {
+  // the op length is a uint8_t and the read lands in a data_size buffer
+  if ((size_t)offset + len > reg::data_size) {
+    error_ = -EINVAL;
+    return *this;
+  }
+  if (!ops_.empty()) {
+    Op &last = ops_.back();
+    if (last.read && last.offset + last.len == offset && last.len + len <= reg::data_size) {
+      last.sinks.emplace_back(last.len, std::move(sink));
+      last.len = (uint8_t)(last.len + len);
+      return *this;
+    }
+  }
+  Op op;
+  op.read = true;
+  op.offset = offset;
+  op.len = (uint8_t)len;
+  op.sinks.emplace_back(0, std::move(sink));
+  ops_.push_back(std::move(op));
+  return *this;
+}
+
+RomiDevice::RomiDevice(std::unique_ptr<Transport> transport, uint8_t addr, Options options)
+    : transport_(std::move(transport)), addr_(addr), options_(options) {}
+
+RomiDevice::~RomiDevice() {
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    stopping_ = true;
+  }
+  queue_cv_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+int RomiDevice::open(int bus, uint8_t addr, std::unique_ptr<RomiDevice> *out, Options options) {
+  std::unique_ptr<Transport> transport;
+  int status = LinuxI2cTransport::open(bus, &transport);
+  if (status != 0) {
+    return status;
+  }
+  out->reset(new RomiDevice(std::move(transport), addr, options));
+  return 0;
+}
+
+int RomiDevice::execute(const Batch &batch) {
+  std::lock_guard<std::mutex> lock(bus_mutex_);
+  return run(batch);
+}
+
+// Caller holds bus_mutex_.
+int RomiDevice::run(const Batch &batch) {
+  uint8_t buf[1 + reg::data_size];
+
+  stats_.batches++;
+  if (batch.error_ != 0) {
+    stats_.errors++;
+    return batch.error_;
+  }
+  for (const Batch::Op &op : batch.ops_) {
+    int status;
+
+    buf[0] = op.offset;
+    if (!op.read) {
+      std::memcpy(buf + 1, op.bytes.data(), op.len);
+      I2cMsg msg = {buf, (uint16_t)(op.len + 1), false};
+      status = transport_->transfer(addr_, &msg, 1);
+      stats_.transactions++;
+      stats_.bytes += op.len + 1u;
+    } else if (options_.read_gap_us == 0) {
+      I2cMsg msgs[2] = {{buf, 1, false}, {buf + 1, op.len, true}};
+      status = transport_->transfer(addr_, msgs, 2);
+      stats_.transactions++;
+      stats_.bytes += op.len + 1u;
+    } else {
+      I2cMsg ptr = {buf, 1, false};
+      I2cMsg data = {buf + 1, op.len, true};
+      status = transport_->transfer(addr_, &ptr, 1);
+      stats_.transactions++;
+      if (status == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(options_.read_gap_us));
+        status = transport_->transfer(addr_, &data, 1);
+        stats_.transactions++;
+      }
+      stats_.bytes += op.len + 1u;
+    }
+
+    if (status != 0) {
+      stats_.errors++;
+      return status;
+    }
+    if (op.read) {
+      for (const auto &sink : op.sinks) {
+        sink.second(buf + 1 + sink.first);
+      }
+    } else {
+      note_distances(op);
+    }
+  }
+  return 0;
+}
+
+// Remember distances written, for wait_motion_done()'s echo check.
+void RomiDevice::note_distances(const Batch::Op &op) {
+  static const uint8_t field[2] = {ROMI_CMD_LEFT_DIST_OFFSET, ROMI_CMD_RIGHT_DIST_OFFSET};
+
+  for (int w = 0; w < 2; ++w) {
+    if (op.offset <= field[w] && field[w] + ROMI_CMD_LEFT_DIST_SIZE <= op.offset + op.len) {
+      last_dist_[w] = romi_get_i16(op.bytes.data() + (field[w] - op.offset));
+      dist_known_[w] = true;
+    }
+  }
+}
+
+Ticket RomiDevice::submit(Batch batch) {
+  Ticket ticket;
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    ticket = next_ticket_++;
+    queue_.emplace_back(ticket, std::move(batch));
+    if (!worker_.joinable()) {
+      worker_ = std::thread(&RomiDevice::worker_main, this);
+    }
+  }
+  queue_cv_.notify_one();
+  return ticket;
+}
+
+int RomiDevice::poll(Ticket ticket) {
+  std::lock_guard<std::mutex> lock(queue_mutex_);
+  auto it = done_.find(ticket);
+  if (it != done_.end()) {
+    int status = it->second;
+    done_.erase(it);
+    return status;
+  }
+  return pending_locked(ticket) ? -EINPROGRESS : -ENOENT;
+}
+
+// Caller holds queue_mutex_.
+bool RomiDevice::pending_locked(Ticket ticket) const {
+  if (ticket != 0 && ticket == running_) {
+    return true;
+  }
+  for (const auto &queued : queue_) {
+    if (queued.first == ticket) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int RomiDevice::wait(Ticket ticket, int timeout_ms) {
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  auto ready = [&] { return done_.count(ticket) != 0; };
+
+  if (!ready() && !pending_locked(ticket)) {
+    return -ENOENT;
+  }
+  if (timeout_ms < 0) {
+    done_cv_.wait(lock, ready);
+  } else if (!done_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready)) {
+    return -ETIMEDOUT;
+  }
+  int status = done_[ticket];
+  done_.erase(ticket);
+  return status;
+}
+
+Stats RomiDevice::stats() const {
+  std::lock_guard<std::mutex> lock(bus_mutex_);
+  return stats_;
+}
+
+void RomiDevice::worker_main() {
+  std::unique_lock<std::mutex> lock(queue_mutex_);
+  for (;;) {
+    queue_cv_.wait(lock, [this] { return stopping_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;  // stopping, and everything submitted has run
+    }
+    std::pair<Ticket, Batch> job = std::move(queue_.front());
+    queue_.pop_front();
+    running_ = job.first;
+    lock.unlock();
+
+    int status = execute(job.second);
+
+    lock.lock();
+    running_ = 0;
+    done_[job.first] = status;
+    done_cv_.notify_all();
+  }
+}
+
+}  // namespace romi
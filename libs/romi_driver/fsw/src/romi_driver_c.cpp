@@ -0,0 +1,144 @@
+// C shim over RomiDevice.  No exception may cross into C, so allocation
+// failures are turned into -ENOMEM here.
+
+#include "romi_driver.h"
+#include "romi_driver.hpp"
+
+#include <cerrno>
+#include <new>
+
+struct romi_device {
+  std::unique_ptr<romi::RomiDevice> dev;
+};
+
+extern "C" {
+
+int romi_open(int bus, uint8_t addr, uint32_t read_gap_us, romi_device_t **dev) {
+  romi::Options options;
+  options.read_gap_us = read_gap_us;
+
+  romi_device_t *handle = new (std::nothrow) romi_device_t;
+  if (handle == nullptr) {
+    return -ENOMEM;
+  }
+  int status;
+  try {
+    status = romi::RomiDevice::open(bus, addr, &handle->dev, options);
+  } catch (const std::bad_alloc &) {
+    status = -ENOMEM;
+  }
+  if (status != 0) {
+    delete handle;
+    return status;
+  }
+  *dev = handle;
+  return 0;
+}
+
+void romi_close(romi_device_t *dev) {
+  delete dev;
+}
+
+int romi_send_command(romi_device_t *dev, const I2C_Command_Packet *cmd) {
+  try {
+    return dev->dev->write(romi::regs::Command(), *cmd);
+  } catch (const std::bad_alloc &) {
+    return -ENOMEM;
+  }
+}
+
+int romi_read_telemetry(romi_device_t *dev, I2C_Telem_Packet *telem) {
+  try {
+    return dev->dev->read(romi::regs::Telemetry(), telem);
+  } catch (const std::bad_alloc &) {
+    return -ENOMEM;
+  }
+}
+
+int romi_write_reg(romi_device_t *dev, uint8_t offset, const void *data, size_t len) {
+  if (len == 0 || offset + len > ROMI_DATA_SIZE) {
+    return -EINVAL;
+  }
+  try {
+    romi::Batch b;
+    b.write_bytes(offset, static_cast<const uint8_t *>(data), len);
+    return dev->dev->execute(b);
+  } catch (const std::bad_alloc &) {
+    return -ENOMEM;
+  }
+}
+
+int romi_read_reg(romi_device_t *dev, uint8_t offset, void *data, size_t len) {
+  if (len == 0 || offset + len > ROMI_DATA_SIZE) {
+    return -EINVAL;
+  }
+  try {
+    romi::Batch b;
+    b.read_bytes(offset, static_cast<uint8_t *>(data), len);
+    return dev->dev->execute(b);
+  } catch (const std::bad_alloc &) {
+    return -ENOMEM;
+  }
+}
+
+int romi_submit_command(romi_device_t *dev, const I2C_Command_Packet *cmd, romi_ticket_t *ticket) {
+  try {
+    romi::Batch b;
+    b.write(romi::regs::Command(), *cmd);
+    *ticket = dev->dev->submit(std::move(b));
+    return 0;
+  } catch (const std::exception &) {
+    return -ENOMEM;
+  }
+}
+
+int romi_submit_telemetry(romi_device_t *dev, I2C_Telem_Packet *telem, romi_ticket_t *ticket) {
+  try {
+    romi::Batch b;
+    b.read(romi::regs::Telemetry(), telem);
+    *ticket = dev->dev->submit(std::move(b));
+    return 0;
+  } catch (const std::exception &) {
+    return -ENOMEM;
+  }
+}
+
+int romi_start_move(romi_device_t *dev, int16_t left, int16_t right, int timeout_ms) {
+  if (timeout_ms < 0) {
+    return -EINVAL;
+  }
+  try {
+    return dev->dev->start_move(left, right, std::chrono::milliseconds(timeout_ms));
+  } catch (const std::bad_alloc &) {
+    return -ENOMEM;
+  }
+}
+
+int16_t romi_mm_to_counts(double mm) {
+  return romi::Geometry().drive_counts(mm);
+}
+
+int16_t romi_deg_to_counts(double degrees) {
+  return romi::Geometry().spin_counts(degrees);
+}
+
+int romi_wait_motion_done(romi_device_t *dev, int timeout_ms) {
+  if (timeout_ms < 0) {
+    return -EINVAL;
+  }
+  try {
+    return dev->dev->wait_motion_done(std::chrono::milliseconds(timeout_ms));
+  } catch (const std::bad_alloc &) {
+    return -ENOMEM;
+  }
+}
+
+int romi_poll(romi_device_t *dev, romi_ticket_t ticket) {
+  return dev->dev->poll(ticket);
+}
+
+int romi_wait(romi_device_t *dev, romi_ticket_t ticket, int timeout_ms) {
+  return dev->dev->wait(ticket, timeout_ms);
+}
+
+}  // extern "C"
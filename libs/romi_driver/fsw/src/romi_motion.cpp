@@ -0,0 +1,259 @@
+// Coroutine motion API: Task, Robot state machine and the polling loop.
+
+#include "romi_motion.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <thread>
+
+namespace romi {
+namespace motion {
+
+Task &Task::operator=(Task &&other) noexcept {
+  if (this != &other) {
+    if (handle_) {
+      handle_.destroy();
+    }
+    handle_ = other.handle_;
+    other.handle_ = nullptr;
+  }
+  return *this;
+}
+
+Task::~Task() {
+  if (handle_) {
+    handle_.destroy();
+  }
+}
+
+void Task::await_resume() {
+  if (handle_ && handle_.promise().error) {
+    std::rethrow_exception(handle_.promise().error);
+  }
+}
+
+Robot::Robot(EventLoop &loop, RomiDevice &dev, Geometry geometry) : loop_(loop), dev_(dev), geometry_(geometry) {
+  loop_.attach(this);
+}
+
+Robot::~Robot() {
+  loop_.detach(this);
+  // the worker may still be filling poll_buf_
+  if (cmd_ticket_ != 0) {
+    dev_.wait(cmd_ticket_);
+  }
+  if (poll_ticket_ != 0) {
+    dev_.wait(poll_ticket_);
+  }
+}
+
+Robot::Motion Robot::drive(double mm) {
+  int16_t counts = geometry_.drive_counts(mm);
+  return Motion(this, counts, counts, false);
+}
+
+Robot::Motion Robot::spin(double degrees) {
+  int16_t counts = geometry_.spin_counts(degrees);
+  return Motion(this, (int16_t)-counts, counts, false);
+}
+
+Robot::Motion Robot::stop() {
+  return Motion(this, 0, 0, true);
+}
+
+void Robot::begin(Motion *m, std::coroutine_handle<> h) {
+  if (waiter_) {
+    current_->result_ = -ECANCELED;
+    loop_.ready_.push_back(waiter_);
+  }
+  current_ = m;
+  waiter_ = h;
+  target_left_ = m->left_;
+  target_right_ = m->right_;
+  target_stop_ = m->stop_;
+  deadline_ = std::chrono::steady_clock::now() + loop_.options_.motion_timeout;
+  read_errors_ = 0;
+
+  // The firmware starts a move when a distance register changes, so
+  // repeating the last distance on a wheel needs a zero written (and seen)
+  // first.  Until something has been sent, the firmware's last distance is
+  // unknown.
+  bool repeat = (target_left_ != 0 && (!sent_any_ || target_left_ == sent_left_)) ||
+                (target_right_ != 0 && (!sent_any_ || target_right_ == sent_right_));
+  if (repeat && !target_stop_) {
+    phase_ = Phase::Clearing;
+    send(0, 0);
+  } else {
+    phase_ = Phase::Moving;
+    send(target_left_, target_right_);
+  }
+}
+
+void Robot::send(int16_t left, int16_t right) {
+  if (cmd_ticket_ != 0) {
+    dev_.wait(cmd_ticket_);  // superseded; only the latest result matters
+  }
+  // speeds 0: the firmware's distance ladder picks the speed.  One
+  // contiguous write of registers 0..7, leaving the LEDs alone.
+  Batch b;
+  b.write(regs::LeftSpeed(), (int16_t)0)
+      .write(regs::RightSpeed(), (int16_t)0)
+      .write(regs::LeftDist(), left)
+      .write(regs::RightDist(), right);
+  cmd_ticket_ = dev_.submit(std::move(b));
+  sent_left_ = left;
+  sent_right_ = right;
+  sent_any_ = true;
+}
+
+void Robot::submit_poll() {
+  if (poll_ticket_ == 0) {
+    Batch b;
+    b.read(regs::Telemetry(), &poll_buf_);
+    poll_ticket_ = dev_.submit(std::move(b));
+  }
+}
+
+std::coroutine_handle<> Robot::collect(std::chrono::steady_clock::time_point now) {
+  int cmd_status = 0;
+  int poll_status = -EAGAIN;
+
+  if (cmd_ticket_ != 0) {
+    cmd_status = dev_.wait(cmd_ticket_);
+    cmd_ticket_ = 0;
+  }
+  if (poll_ticket_ != 0) {
+    poll_status = dev_.wait(poll_ticket_);
+    poll_ticket_ = 0;
+    if (poll_status == 0) {
+      telem_ = poll_buf_;
+    }
+  }
+  if (!waiter_) {
+    return nullptr;
+  }
+  if (cmd_status != 0) {
+    return finish(cmd_status);
+  }
+
+  if (poll_status == 0) {
+    read_errors_ = 0;
+    if (phase_ == Phase::Clearing) {
+      if (telem_.cmd_left_dist == 0 && telem_.cmd_right_dist == 0) {
+        phase_ = Phase::Moving;
+        send(target_left_, target_right_);
+      }
+    } else if (telem_.cmd_left_dist == target_left_ && telem_.cmd_right_dist == target_right_ &&
+               telem_.rem_left == 0 && telem_.rem_right == 0 &&
+               (!target_stop_ || (telem_.set_left_speed == 0 && telem_.set_right_speed == 0))) {
+      return finish(0);
+    }
+  } else if (poll_status != -EAGAIN && ++read_errors_ >= loop_.options_.max_read_errors) {
+    return finish(poll_status);
+  }
+
+  if (now >= deadline_) {
+    return finish(-ETIMEDOUT);
+  }
+  return nullptr;
+}
+
+std::coroutine_handle<> Robot::finish(int result) {
+  std::coroutine_handle<> h = waiter_;
+  current_->result_ = result;
+  current_ = nullptr;
+  waiter_ = nullptr;
+  phase_ = Phase::Idle;
+  return h;
+}
+
+void EventLoop::attach(Robot *robot) {
+  robots_.push_back(robot);
+}
+
+void EventLoop::detach(Robot *robot) {
+  robots_.erase(std::remove(robots_.begin(), robots_.end(), robot), robots_.end());
+}
+
+void EventLoop::spawn(Task task) {
+  std::coroutine_handle<> h = task.handle_;
+  tasks_.push_back(std::move(task));
+  h.resume();
+  resume_ready();
+  reap();
+}
+
+void EventLoop::resume_ready() {
+  while (!ready_.empty()) {
+    std::vector<std::coroutine_handle<>> now;
+    now.swap(ready_);
+    for (auto h : now) {
+      h.resume();
+    }
+  }
+}
+
+void EventLoop::reap() {
+  std::exception_ptr error;
+  for (auto it = tasks_.begin(); it != tasks_.end();) {
+    if (it->done()) {
+      if (!error && it->handle_ && it->handle_.promise().error) {
+        error = it->handle_.promise().error;
+      }
+      it = tasks_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+bool EventLoop::run_once() {
+  rounds_++;
+
+  // Submit every read before collecting any, so devices on different
+  // buses poll in parallel.
+  std::vector<Robot *> active;
+  for (Robot *r : robots_) {
+    if (r->busy()) {
+      r->submit_poll();
+      active.push_back(r);
+    }
+  }
+  auto now = std::chrono::steady_clock::now();
+  for (Robot *r : active) {
+    std::coroutine_handle<> h = r->collect(now);
+    if (h) {
+      ready_.push_back(h);
+    }
+  }
+  resume_ready();
+  reap();
+
+  if (tasks_.empty()) {
+    return false;
+  }
+  for (Robot *r : robots_) {
+    if (r->busy()) {
+      return true;
+    }
+  }
+  return false;  // tasks left, but none is waiting on a robot
+}
+
+void EventLoop::run() {
+  resume_ready();
+  reap();
+  while (!tasks_.empty()) {
+    auto next = std::chrono::steady_clock::now() + options_.poll_period;
+    if (!run_once()) {
+      break;
+    }
+    std::this_thread::sleep_until(next);
+  }
+}
+
+}  // namespace motion
+}  // namespace romi
@@ -0,0 +1,147 @@
+// Moves: geometry, starting a move, and waiting for it to finish with
+// telemetry polls spaced by how far the robot still has to go.
+
+#include "romi_driver.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+
+namespace romi {
+
+namespace {
+
+int16_t saturate(double counts) {
+  double r = std::round(counts);
+  return (int16_t)std::max(-32767.0, std::min(32767.0, r));
+}
+
+}  // namespace
+
+int16_t Geometry::drive_counts(double mm) const {
+  return saturate(mm * counts_per_mm);
+}
+
+int16_t Geometry::spin_counts(double degrees) const {
+  return saturate(degrees / 360.0 * 3.14159265358979 * wheel_base_mm * counts_per_mm);
+}
+
+int RomiDevice::start_move(int16_t left, int16_t right, std::chrono::milliseconds timeout) {
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point deadline = Clock::now() + timeout;
+  I2C_Telem_Packet t;
+
+  int status = read(regs::Telemetry(), &t);
+  if (status != 0) {
+    return status;
+  }
+  if ((left != 0 && t.cmd_left_dist == left) || (right != 0 && t.cmd_right_dist == right)) {
+    Batch clear;
+    clear.write(regs::LeftDist(), (int16_t)0).write(regs::RightDist(), (int16_t)0);
+    if ((status = execute(clear)) != 0) {
+      return status;
+    }
+    // wait for the firmware to run a loop with the zeros in place
+    do {
+      if (Clock::now() >= deadline) {
+        return -ETIMEDOUT;
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(WaitPolicy().min_interval_us));
+      if ((status = read(regs::Telemetry(), &t)) != 0) {
+        return status;
+      }
+    } while (t.cmd_left_dist != 0 || t.cmd_right_dist != 0);
+  }
+
+  Batch move;
+  move.write(regs::LeftSpeed(), (int16_t)0)
+      .write(regs::RightSpeed(), (int16_t)0)
+      .write(regs::LeftDist(), left)
+      .write(regs::RightDist(), right);
+  return execute(move);
+}
+
+uint32_t next_poll_interval_us(const I2C_Telem_Packet &t, const WaitPolicy &policy) {
+  double eta_s = 0.0;
+  int16_t rem[2] = {t.rem_left, t.rem_right};
+  int16_t speed[2] = {t.set_left_speed, t.set_right_speed};
+
+  for (int w = 0; w < 2; ++w) {
+    if (rem[w] == 0) {
+      continue;
+    }
+    double counts_per_s = std::abs(speed[w]) * policy.counts_per_s_per_speed;
+    if (counts_per_s <= 0.0) {
+      // distance left but the wheel not driven yet: the firmware has not
+      // picked the move up, so look again soon
+      return policy.min_interval_us;
+    }
+    eta_s = std::max(eta_s, std::abs(rem[w]) / counts_per_s);
+  }
+
+  double us = eta_s * policy.fraction * 1e6;
+  return (uint32_t)std::max((double)policy.min_interval_us, std::min((double)policy.max_interval_us, us));
+}
+
+int RomiDevice::wait_motion_done(std::chrono::milliseconds timeout, const WaitPolicy &policy,
+                                 I2C_Telem_Packet *last, WaitStats *stats) {
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point deadline = Clock::now() + timeout;
+  int16_t expect[2];
+  bool known[2];
+  WaitStats local;
+  I2C_Telem_Packet t;
+  int errors = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(bus_mutex_);
+    for (int w = 0; w < 2; ++w) {
+      expect[w] = last_dist_[w];
+      known[w] = dist_known_[w];
+    }
+  }
+
+  for (;;) {
+    int status = read(regs::Telemetry(), &t);
+    local.polls++;
+
+    uint32_t interval_us = policy.min_interval_us;
+    if (status != 0) {
+      local.read_errors++;
+      if (++errors >= policy.max_read_errors) {
+        if (stats != nullptr) {
+          *stats = local;
+        }
+        return status;
+      }
+    } else {
+      errors = 0;
+      if (last != nullptr) {
+        *last = t;
+      }
+      bool echoed = (!known[0] || t.cmd_left_dist == expect[0]) && (!known[1] || t.cmd_right_dist == expect[1]);
+      if (echoed && t.rem_left == 0 && t.rem_right == 0 && t.set_left_speed == 0 && t.set_right_speed == 0) {
+        if (stats != nullptr) {
+          *stats = local;
+        }
+        return 0;
+      }
+      if (echoed) {
+        interval_us = next_poll_interval_us(t, policy);
+      }
+    }
+
+    Clock::time_point now = Clock::now();
+    if (now >= deadline) {
+      if (stats != nullptr) {
+        *stats = local;
+      }
+      return -ETIMEDOUT;
+    }
+    // the last poll lands on the deadline rather than past it
+    std::this_thread::sleep_until(std::min(deadline, now + std::chrono::microseconds(interval_us)));
+  }
+}
+
+}  // namespace romi
@@ -0,0 +1,66 @@
+// Linux i2c-dev transport.
+//
+// I2C_RDWR takes the slave address per message, so one descriptor serves
+// every robot on the bus and there is no I2C_SLAVE ioctl per switch.
+
+#include "romi_driver.hpp"
+
+#include <cerrno>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <linux/i2c.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+namespace romi {
+
+namespace {
+constexpr size_t kMaxMsgs = 4;  // the driver never needs more per transaction
+}
+
+LinuxI2cTransport::~LinuxI2cTransport() {
+  ::close(fd_);
+}
+
+int LinuxI2cTransport::open(int bus, std::unique_ptr<Transport> *out) {
+  char path[32];
+  std::snprintf(path, sizeof(path), "/dev/i2c-%d", bus);
+
+  int fd = ::open(path, O_RDWR | O_CLOEXEC);
+  if (fd < 0) {
+    return -errno;
+  }
+  out->reset(new LinuxI2cTransport(fd));
+  return 0;
+}
+
+int LinuxI2cTransport::transfer(uint8_t addr, I2cMsg *msgs, size_t count) {
+  struct i2c_msg kmsgs[kMaxMsgs];
+  struct i2c_rdwr_ioctl_data rdwr;
+
+  if (count == 0 || count > kMaxMsgs) {
+    return -EINVAL;
+  }
+  for (size_t i = 0; i < count; ++i) {
+    kmsgs[i].addr = addr;
+    kmsgs[i].flags = msgs[i].read ? I2C_M_RD : 0;
+    kmsgs[i].len = msgs[i].len;
+    kmsgs[i].buf = msgs[i].data;
+  }
+  rdwr.msgs = kmsgs;
+  rdwr.nmsgs = (uint32_t)count;
+
+  int ret = ioctl(fd_, I2C_RDWR, &rdwr);
+  if (ret < 0) {
+    return -errno;
+  }
+  // A short count leaves errno untouched, so report it as an I/O error.
+  if (ret != (int)count) {
+    return -EIO;
+  }
+  return 0;
+}
+
+}  // namespace romi
@@ -0,0 +1,327 @@
+// Unit tests for the Romi driver against the in-memory slave.
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+#include "romi_driver.h"
+#include "romi_fake_slave.hpp"
+
+using romi::Batch;
+using romi::RomiDevice;
+using romi::test::FakeBus;
+using romi::test::FakeFirmware;
+using romi::test::FakeTransport;
+namespace regs = romi::regs;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                               \
+  do {                                                            \
+    if (!(cond)) {                                                \
+      std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                 \
+    }                                                             \
+  } while (0)
+
+std::unique_ptr<RomiDevice> make_device(FakeBus *bus, uint32_t read_gap_us) {
+  romi::Options options;
+  options.read_gap_us = read_gap_us;
+  return std::unique_ptr<RomiDevice>(new RomiDevice(std::unique_ptr<romi::Transport>(new FakeTransport(bus)),
+                                                    ROMI_I2C_ADDRESS, options));
+}
+
+void test_typed_registers() {
+  FakeBus bus;
+  auto dev = make_device(&bus, 0);
+
+  CHECK(dev->write(regs::LeftDist(), (int16_t)-720) == 0);
+  CHECK(bus.writes.size() == 1);
+  CHECK(bus.writes[0].size() == 3);
+  CHECK(bus.writes[0][0] == ROMI_CMD_LEFT_DIST_OFFSET);
+  CHECK(bus.writes[0][1] == 0x30 && bus.writes[0][2] == 0xFD);  // -720 little-endian
+
+  bus.regs[ROMI_TELEM_BATTERYMILLIVOLTS_OFFSET] = 0x10;
+  bus.regs[ROMI_TELEM_BATTERYMILLIVOLTS_OFFSET + 1] = 0x27;
+  uint16_t mv = 0;
+  CHECK(dev->read(regs::BatteryMillivolts(), &mv) == 0);
+  CHECK(mv == 10000);
+  // pointer write and read joined by a repeated start
+  CHECK(bus.msgs_per_transfer.back() == 2);
+
+  I2C_Command_Packet cmd = {};
+  cmd.left_speed = 100;
+  cmd.right_speed = -100;
+  cmd.y_led = true;
+  CHECK(dev->write(regs::Command(), cmd) == 0);
+  CHECK(bus.writes.back().size() == ROMI_CMD_SIZE + 1);
+  CHECK(bus.regs[ROMI_CMD_Y_LED_OFFSET] == 1);
+
+  I2C_Command_Packet back;
+  CHECK(dev->read(regs::Command(), &back) == 0);
+  CHECK(back.left_speed == 100 && back.right_speed == -100 && back.y_led && !back.r_led);
+}
+
+void test_batch_coalescing() {
+  FakeBus bus;
+  auto dev = make_device(&bus, 0);
+
+  // four contiguous writes -> one transaction
+  Batch b;
+  b.write(regs::LeftSpeed(), (int16_t)50)
+      .write(regs::RightSpeed(), (int16_t)60)
+      .write(regs::LeftDist(), (int16_t)70)
+      .write(regs::RightDist(), (int16_t)80);
+  CHECK(dev->execute(b) == 0);
+  CHECK(bus.transfers == 1);
+  CHECK(bus.writes.size() == 1 && bus.writes[0].size() == 9);
+
+  // contiguous reads -> one span; a gap starts a new transaction
+  bus.regs[ROMI_TELEM_REM_LEFT_OFFSET] = 5;
+  bus.regs[ROMI_TELEM_REM_RIGHT_OFFSET] = 6;
+  int16_t l_enc = 1, r_enc = 1, rem_l = 0, rem_r = 0;
+  uint16_t mv = 1;
+  Batch r;
+  r.read(regs::LeftEncoder(), &l_enc)
+      .read(regs::RightEncoder(), &r_enc)
+      .read(regs::RemLeft(), &rem_l)
+      .read(regs::RemRight(), &rem_r)
+      .read(regs::BatteryMillivolts(), &mv);
+  bus.transfers = 0;
+  bus.reads.clear();
+  CHECK(dev->execute(r) == 0);
+  CHECK(bus.transfers == 2);
+  CHECK(bus.reads.size() == 2 && bus.reads[0] == 8 && bus.reads[1] == 2);
+  CHECK(l_enc == 0 && r_enc == 0 && rem_l == 5 && rem_r == 6 && mv == 0);
+
+  // a write then a read of the same block is two transactions, in order
+  I2C_Command_Packet cmd;
+  Batch wr;
+  wr.write(regs::RedLed(), true).read(regs::Command(), &cmd);
+  bus.transfers = 0;
+  CHECK(dev->execute(wr) == 0);
+  CHECK(bus.transfers == 2);
+  CHECK(cmd.r_led && cmd.left_speed == 50);
+  CHECK(dev->stats().batches == 3);
+}
+
+void test_read_gap_splits_transaction() {
+  FakeBus bus;
+  auto dev = make_device(&bus, 1);
+  I2C_Telem_Packet t;
+
+  CHECK(dev->read(regs::Telemetry(), &t) == 0);
+  CHECK(bus.transfers == 2);
+  CHECK(bus.msgs_per_transfer[0] == 1 && bus.msgs_per_transfer[1] == 1);
+  CHECK(bus.writes[0].size() == 1 && bus.writes[0][0] == ROMI_TELEM_OFFSET);
+}
+
+void test_errors() {
+  FakeBus bus;
+  auto dev = make_device(&bus, 0);
+
+  bus.fail_next = -EREMOTEIO;
+  Batch b;
+  b.write(regs::LeftSpeed(), (int16_t)1).write(regs::GreenLed(), true);
+  CHECK(dev->execute(b) == -EREMOTEIO);
+  CHECK(bus.transfers == 1);  // stopped at the failed transaction
+  CHECK(dev->stats().errors == 1);
+
+  bus.addr = 0x15;
+  CHECK(dev->write(regs::LeftSpeed(), (int16_t)1) == -EREMOTEIO);
+  bus.addr = ROMI_I2C_ADDRESS;
+
+  // an access past the end of the slave buffer fails the whole batch
+  uint8_t big[2 * ROMI_DATA_SIZE];
+  bus.transfers = 0;
+  Batch over;
+  over.read_bytes(0, big, ROMI_DATA_SIZE + 1);
+  CHECK(over.empty());
+  CHECK(dev->execute(over) == -EINVAL);
+  Batch past;
+  past.write(regs::GreenLed(), true).read_bytes(ROMI_TELEM_OFFSET, big, ROMI_DATA_SIZE);
+  CHECK(dev->execute(past) == -EINVAL);
+  Batch wide;
+  wide.write_bytes(0, big, sizeof(big));
+  CHECK(dev->execute(wide) == -EINVAL);
+  CHECK(bus.transfers == 0);
+
+  // the full buffer is fine, and clear() makes the batch usable again
+  past.clear();
+  past.read_bytes(0, big, ROMI_DATA_SIZE);
+  CHECK(dev->execute(past) == 0);
+  CHECK(bus.transfers == 1);
+}
+
+void test_async() {
+  FakeBus bus;
+  auto dev = make_device(&bus, 0);
+  const int kJobs = 64;
+  int16_t results[kJobs];
+  romi::Ticket tickets[kJobs];
+
+  for (int i = 0; i < kJobs; ++i) {
+    Batch job;
+    job.write(regs::LeftDist(), (int16_t)(i * 3));
+    job.read(regs::LeftDist(), &results[i]);
+    tickets[i] = dev->submit(std::move(job));
+  }
+  // in order: each read sees its own write
+  for (int i = 0; i < kJobs; ++i) {
+    CHECK(dev->wait(tickets[i], 5000) == 0);
+    CHECK(results[i] == i * 3);
+  }
+  CHECK(dev->poll(tickets[0]) == -ENOENT);  // already collected
+  CHECK(dev->wait(tickets[0], 0) == -ENOENT);
+  CHECK(dev->poll(12345) == -ENOENT);
+
+  // poll reports completion once
+  bus.fail_next = -ETIMEDOUT;
+  Batch fail;
+  fail.write(regs::RedLed(), true);
+  romi::Ticket t = dev->submit(std::move(fail));
+  int status;
+  while ((status = dev->poll(t)) == -EINPROGRESS) {
+    std::this_thread::yield();
+  }
+  CHECK(status == -ETIMEDOUT);
+  CHECK(dev->poll(t) == -ENOENT);
+}
+
+// Real-time firmware for one straight move: after it first sees a new
+// distance, rem falls at kCountsPerS (set speed 300 at 12 counts/s each).
+struct TimedFirmware {
+  static constexpr double kCountsPerS = 3600.0;
+  using Clock = std::chrono::steady_clock;
+
+  int16_t prev = 0;
+  int16_t target = 0;
+  Clock::time_point start;
+  Clock::time_point finish;
+
+  void operator()(FakeBus &bus) {
+    I2C_Command_Packet c;
+    I2C_Telem_Packet t = {};
+    romi_cmd_unpack(&c, bus.regs + ROMI_CMD_OFFSET);
+    Clock::time_point now = Clock::now();
+
+    if (c.left_dist != prev) {
+      prev = c.left_dist;
+      target = c.left_dist;
+      start = now;
+      finish = start + std::chrono::microseconds((int64_t)(target / kCountsPerS * 1e6));
+    }
+    double done = std::chrono::duration<double>(now - start).count() * kCountsPerS;
+    int16_t rem = done >= target ? 0 : (int16_t)(target - done);
+    t.rem_left = t.rem_right = rem;
+    t.set_left_speed = t.set_right_speed = rem == 0 ? 0 : 300;
+    t.cmd_left_dist = t.cmd_right_dist = c.left_dist;
+    romi_telem_pack(bus.regs + ROMI_TELEM_OFFSET, &t);
+  }
+};
+
+void test_poll_interval() {
+  romi::WaitPolicy p;
+  I2C_Telem_Packet t = {};
+
+  t.rem_left = 3600;
+  t.set_left_speed = 300;  // 1 s to go: poll after 0.5 s, capped
+  CHECK(romi::next_poll_interval_us(t, p) == p.max_interval_us);
+  t.rem_left = 360;  // 100 ms to go
+  CHECK(romi::next_poll_interval_us(t, p) == 50000);
+  t.rem_left = 10;  // nearly there: one tick
+  CHECK(romi::next_poll_interval_us(t, p) == p.min_interval_us);
+  t.rem_right = 720;
+  t.set_right_speed = 0;  // not picked up yet
+  CHECK(romi::next_poll_interval_us(t, p) == p.min_interval_us);
+}
+
+void test_wait_motion_done() {
+  FakeBus bus;
+  TimedFirmware fw;
+  bus.firmware = std::ref(fw);
+  auto dev = make_device(&bus, 0);
+  romi::WaitPolicy policy;
+  romi::WaitStats ws;
+  I2C_Telem_Packet t;
+
+  Batch b;
+  b.write(regs::LeftDist(), (int16_t)1800).write(regs::RightDist(), (int16_t)1800);  // 0.5 s
+  CHECK(dev->execute(b) == 0);
+  CHECK(dev->wait_motion_done(std::chrono::milliseconds(2000), policy, &t, &ws) == 0);
+  auto late = std::chrono::steady_clock::now() - fw.finish;
+
+  CHECK(t.rem_left == 0 && t.cmd_left_dist == 1800);
+  // completion seen within a tick (plus scheduling slack), with far fewer
+  // polls than the 250 a fixed 2 ms poll would need
+  CHECK(late < std::chrono::microseconds(2 * policy.min_interval_us + 8000));
+  CHECK(ws.polls < 40);
+  std::printf("wait_motion_done: %u polls, done %.1f ms after the move\n", ws.polls,
+              std::chrono::duration<double, std::milli>(late).count());
+}
+
+void test_wait_needs_echo() {
+  FakeBus bus;  // no firmware: telemetry stays all zero
+  auto dev = make_device(&bus, 0);
+
+  // rem is 0 but the firmware never echoed the new distance
+  CHECK(dev->write(regs::LeftDist(), (int16_t)500) == 0);
+  CHECK(dev->wait_motion_done(std::chrono::milliseconds(20)) == -ETIMEDOUT);
+
+  bus.addr = 0x15;
+  romi::WaitStats ws;
+  CHECK(dev->wait_motion_done(std::chrono::milliseconds(1000), romi::WaitPolicy(), nullptr, &ws) == -EREMOTEIO);
+  CHECK(ws.read_errors == 3);
+}
+
+void test_start_move_repeats() {
+  FakeBus bus;
+  FakeFirmware fw;
+  bus.firmware = std::ref(fw);
+  auto dev = make_device(&bus, 0);
+  I2C_Telem_Packet t;
+
+  // twice the same distance: the second needs zeros seen in between
+  for (int i = 0; i < 2; ++i) {
+    CHECK(dev->start_move(200, 200) == 0);
+    CHECK(dev->wait_motion_done(std::chrono::milliseconds(1000), romi::WaitPolicy(), &t) == 0);
+  }
+  CHECK(t.l_enc == 400 && t.r_enc == 400);
+
+  romi::Geometry g;
+  CHECK(g.drive_counts(100) == 655);
+  CHECK(g.spin_counts(90) == 725);
+  CHECK(g.drive_counts(1e6) == 32767 && g.drive_counts(-1e6) == -32767);
+  CHECK(romi_mm_to_counts(-50) == -327);
+}
+
+void test_c_shim() {
+  romi_device_t *dev = nullptr;
+  CHECK(romi_open(9999, ROMI_I2C_ADDRESS, 100, &dev) == -ENOENT);
+  CHECK(dev == nullptr);
+}
+
+}  // namespace
+
+int main() {
+  test_typed_registers();
+  test_batch_coalescing();
+  test_read_gap_splits_transaction();
+  test_errors();
+  test_async();
+  test_poll_interval();
+  test_wait_motion_done();
+  test_wait_needs_echo();
+  test_start_move_repeats();
+  test_c_shim();
+
+  if (failures != 0) {
+    std::printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("romi_driver: all tests passed\n");
+  return 0;
+}
@@ -0,0 +1,127 @@
+// In-memory stand-in for the Romi slave, behind the Transport interface.
+//
+// Behaves like PololuRPiSlave: the first byte of a write sets the register
+// pointer and any further bytes are stored from there; a read returns bytes
+// from the pointer on.  Every message is recorded so tests can check what
+// went out on the bus.
+
+#pragma once
+
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "romi_driver.hpp"
+
+namespace romi {
+namespace test {
+
+struct FakeBus {
+  std::mutex mutex;
+  uint8_t regs[ROMI_DATA_SIZE] = {};
+  uint8_t pointer = 0;
+  uint8_t addr = ROMI_I2C_ADDRESS;
+
+  size_t transfers = 0;
+  std::vector<size_t> msgs_per_transfer;
+  std::vector<std::vector<uint8_t>> writes;  // each write message, pointer byte first
+  std::vector<size_t> reads;                 // length of each read message
+
+  int fail_next = 0;  // -errno to return from the next transfer
+
+  // Called with the bus locked before each transfer, standing in for the
+  // firmware's loop() running between transactions.
+  std::function<void(FakeBus &)> firmware;
+};
+
+// A crude Robot_Code.cpp: a new distance restarts that wheel's move, each
+// loop() moves a wheel `step` counts toward its target, and the telemetry
+// block echoes the command.  Use as FakeBus::firmware.
+struct FakeFirmware {
+  int16_t step = 40;
+  int16_t prev[2] = {0, 0};
+  int16_t rem[2] = {0, 0};
+  int16_t enc[2] = {0, 0};
+  uint64_t loops = 0;
+
+  void operator()(FakeBus &bus) {
+    I2C_Command_Packet c;
+    I2C_Telem_Packet t;
+    romi_cmd_unpack(&c, bus.regs + ROMI_CMD_OFFSET);
+    romi_telem_unpack(&t, bus.regs + ROMI_TELEM_OFFSET);
+    loops++;
+
+    int16_t dist[2] = {c.left_dist, c.right_dist};
+    int16_t set[2];
+    for (int w = 0; w < 2; ++w) {
+      if (dist[w] != prev[w]) {
+        prev[w] = dist[w];
+        rem[w] = dist[w];
+      }
+      int16_t move = rem[w] > step ? step : rem[w] < -step ? (int16_t)-step : rem[w];
+      rem[w] = (int16_t)(rem[w] - move);
+      enc[w] = (int16_t)(enc[w] + move);
+      set[w] = rem[w] == 0 ? 0 : (rem[w] > 0 ? 100 : -100);
+    }
+    t.l_enc = enc[0];
+    t.r_enc = enc[1];
+    t.rem_left = rem[0];
+    t.rem_right = rem[1];
+    t.cmd_left_dist = c.left_dist;
+    t.cmd_right_dist = c.right_dist;
+    t.cmd_left_speed = c.left_speed;
+    t.cmd_right_speed = c.right_speed;
+    t.set_left_speed = set[0];
+    t.set_right_speed = set[1];
+    romi_telem_pack(bus.regs + ROMI_TELEM_OFFSET, &t);
+  }
+};
+
+class FakeTransport : public Transport {
+ public:
+  explicit FakeTransport(FakeBus *bus) : bus_(bus) {}
+
+  int transfer(uint8_t addr, I2cMsg *msgs, size_t count) override {
+    std::lock_guard<std::mutex> lock(bus_->mutex);
+    bus_->transfers++;
+    bus_->msgs_per_transfer.push_back(count);
+    if (bus_->firmware) {
+      bus_->firmware(*bus_);
+    }
+    if (bus_->fail_next != 0) {
+      int status = bus_->fail_next;
+      bus_->fail_next = 0;
+      return status;
+    }
+    if (addr != bus_->addr) {
+      return -EREMOTEIO;
+    }
+    for (size_t i = 0; i < count; ++i) {
+      I2cMsg &m = msgs[i];
+      if (m.read) {
+        bus_->reads.push_back(m.len);
+        for (uint16_t j = 0; j < m.len; ++j) {
+          size_t at = bus_->pointer + j;
+          m.data[j] = at < sizeof(bus_->regs) ? bus_->regs[at] : 0xFF;
+        }
+      } else {
+        bus_->writes.emplace_back(m.data, m.data + m.len);
+        if (m.len > 0) {
+          bus_->pointer = m.data[0];
+          for (uint16_t j = 1; j < m.len && bus_->pointer + j - 1 < (int)sizeof(bus_->regs); ++j) {
+            bus_->regs[bus_->pointer + j - 1] = m.data[j];
+          }
+        }
+      }
+    }
+    return 0;
+  }
+
+ private:
+  FakeBus *bus_;
+};
+
+}  // namespace test
+}  // namespace romi
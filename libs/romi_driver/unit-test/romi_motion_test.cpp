@@ -0,0 +1,217 @@
+// Unit tests for the coroutine motion API against the in-memory slave and
+// its firmware model.
+
+#include <cerrno>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "romi_fake_slave.hpp"
+#include "romi_motion.hpp"
+
+using romi::RomiDevice;
+using romi::motion::EventLoop;
+using romi::motion::LoopOptions;
+using romi::motion::Robot;
+using romi::motion::Task;
+using romi::test::FakeBus;
+using romi::test::FakeFirmware;
+using romi::test::FakeTransport;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                               \
+  do {                                                            \
+    if (!(cond)) {                                                \
+      std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                 \
+    }                                                             \
+  } while (0)
+
+struct Rig {
+  FakeBus bus;
+  FakeFirmware fw;
+  std::unique_ptr<RomiDevice> dev;
+
+  explicit Rig(bool with_firmware = true) {
+    if (with_firmware) {
+      bus.firmware = std::ref(fw);
+    }
+    romi::Options options;
+    options.read_gap_us = 0;
+    dev.reset(new RomiDevice(std::unique_ptr<romi::Transport>(new FakeTransport(&bus)), ROMI_I2C_ADDRESS, options));
+  }
+};
+
+LoopOptions fast() {
+  LoopOptions o;
+  o.poll_period = std::chrono::microseconds(0);
+  return o;
+}
+
+Task sequence(Robot &r, std::vector<int> *results) {
+  results->push_back(co_await r.drive(100));
+  results->push_back(co_await r.spin(90));
+  results->push_back(co_await r.spin(90));  // same distances again
+  results->push_back(co_await r.drive(-50));
+  results->push_back(co_await r.stop());
+}
+
+void test_sequence() {
+  EventLoop loop(fast());
+  Rig rig;
+  Robot robot(loop, *rig.dev);
+  std::vector<int> results;
+
+  loop.spawn(sequence(robot, &results));
+  loop.run();
+
+  CHECK(results.size() == 5);
+  for (int r : results) {
+    CHECK(r == 0);
+  }
+  // 100 mm = 655 counts, -50 mm = -327; a 90 degree spin is 725 counts
+  // per wheel in opposite directions.  The repeated spin really moved.
+  const I2C_Telem_Packet &t = robot.telemetry();
+  CHECK(t.l_enc + t.r_enc == 2 * (655 - 327));
+  CHECK(t.r_enc - t.l_enc == 2 * 2 * 725);
+  CHECK(t.rem_left == 0 && t.rem_right == 0);
+  CHECK(!robot.busy());
+}
+
+Task drive_times(Robot &r, int n, int *done) {
+  for (int i = 0; i < n; ++i) {
+    if (co_await r.drive(50) == 0) {
+      (*done)++;
+    }
+  }
+}
+
+void test_many_robots_one_loop() {
+  const int kRobots = 16;
+  EventLoop loop(fast());
+  std::vector<std::unique_ptr<Rig>> rigs;
+  std::vector<std::unique_ptr<Robot>> robots;
+  int done = 0;
+
+  for (int i = 0; i < kRobots; ++i) {
+    rigs.emplace_back(new Rig());
+    rigs.back()->fw.step = (int16_t)(10 + 5 * i);  // robots finish at different times
+    robots.emplace_back(new Robot(loop, *rigs.back()->dev));
+  }
+  for (auto &r : robots) {
+    loop.spawn(drive_times(*r, 3, &done));
+  }
+  loop.run();
+
+  CHECK(done == 3 * kRobots);
+  // the slowest robot sets the pace: 3 moves of 327 counts at 10 per loop,
+  // plus the clearing round each move needs
+  CHECK(loop.rounds() < 3 * (327 / 10 + 4));
+}
+
+Task long_drive(Robot &r, int *result) {
+  *result = co_await r.drive(1000);
+}
+
+Task stop_now(Robot &r, int *result) {
+  *result = co_await r.stop();
+}
+
+void test_cancel() {
+  EventLoop loop(fast());
+  Rig rig;
+  Robot robot(loop, *rig.dev);
+  int first = 1, second = 1;
+
+  loop.spawn(long_drive(robot, &first));
+  loop.run_once();
+  loop.run_once();
+  loop.spawn(stop_now(robot, &second));  // replaces the drive
+  loop.run();
+
+  CHECK(first == -ECANCELED);
+  CHECK(second == 0);
+  CHECK(robot.telemetry().set_left_speed == 0 && robot.telemetry().set_right_speed == 0);
+}
+
+void test_timeout() {
+  LoopOptions o = fast();
+  o.motion_timeout = std::chrono::milliseconds(30);
+  EventLoop loop(o);
+  Rig rig(false);  // nobody home: the echo never changes
+  Robot robot(loop, *rig.dev);
+  int result = 0;
+
+  loop.spawn(long_drive(robot, &result));
+  loop.run();
+  CHECK(result == -ETIMEDOUT);
+}
+
+void test_bus_errors() {
+  EventLoop loop(fast());
+  Rig rig;
+  Robot robot(loop, *rig.dev);
+  int result = 0;
+
+  rig.bus.addr = 0x15;  // every transaction NACKed
+  loop.spawn(long_drive(robot, &result));
+  loop.run();
+  CHECK(result == -EREMOTEIO);
+}
+
+Task nested_inner(Robot &r, int *count) {
+  co_await r.drive(10);
+  (*count)++;
+  throw std::runtime_error("inner");
+}
+
+Task nested_outer(Robot &r, int *count) {
+  try {
+    co_await nested_inner(r, count);
+  } catch (const std::runtime_error &) {
+    (*count) += 10;
+  }
+  co_await r.drive(10);
+  (*count) += 100;
+  throw std::logic_error("outer");
+}
+
+void test_nested_and_exceptions() {
+  EventLoop loop(fast());
+  Rig rig;
+  Robot robot(loop, *rig.dev);
+  int count = 0;
+  bool thrown = false;
+
+  loop.spawn(nested_outer(robot, &count));
+  try {
+    loop.run();
+  } catch (const std::logic_error &) {
+    thrown = true;
+  }
+  CHECK(count == 111);
+  CHECK(thrown);
+}
+
+}  // namespace
+
+int main() {
+  test_sequence();
+  test_many_robots_one_loop();
+  test_cancel();
+  test_timeout();
+  test_bus_errors();
+  test_nested_and_exceptions();
+
+  if (failures != 0) {
+    std::printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("romi_motion: all tests passed\n");
+  return 0;
+}
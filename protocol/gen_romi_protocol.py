@@ -0,0 +1,274 @@
+#!/usr/bin/env python3
+#
+# Generate romi_protocol.h from romi_protocol.json.
+#
+# The schema is the single definition of the Romi I2C register map.  The
+# generated header is shared by the firmware (Robot_Code.cpp), the flight
+# app (apps/i2c_app) and the host tools, and contains:
+#
+#  - absolute register offsets and sizes for every block and field, as
+#    macros (usable in C, C++ and #if) and as C++ constexpr constants;
+#  - packed structs with compile-time checks of every size and offset;
+#  - little-endian pack/unpack functions that do not depend on the
+#    host's byte order or struct layout.
+#
+# usage: gen_romi_protocol.py [--check] [schema.json] [output.h]
+#
+# --check regenerates in memory and exits non-zero if the committed header
+# differs, so a schema edit without a regenerated header fails the build.
+#
+
+import json
+import os
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+
+# schema type -> (C type, size, put/get suffix)
+TYPES = {
+    "bool": ("bool", 1, "bool"),
+    "int8": ("int8_t", 1, "i8"),
+    "uint8": ("uint8_t", 1, "u8"),
+    "int16": ("int16_t", 2, "i16"),
+    "uint16": ("uint16_t", 2, "u16"),
+    "int32": ("int32_t", 4, "i32"),
+    "uint32": ("uint32_t", 4, "u32"),
+}
+
+
+def fail(msg):
+    sys.stderr.write("gen_romi_protocol: %s\n" % msg)
+    sys.exit(2)
+
+
+def layout(schema):
+    """Assign offsets: blocks follow each other in buffer order, fields are packed."""
+    blocks = {b["name"]: b for b in schema["blocks"]}
+    offset = 0
+    ordered = []
+    for name in schema["buffer"]["blocks"]:
+        if name not in blocks:
+            fail("buffer refers to unknown block '%s'" % name)
+        block = blocks[name]
+        block["offset"] = offset
+        pos = offset
+        for field in block["fields"]:
+            fname, ftype = field[0], field[1]
+            if ftype not in TYPES:
+                fail("%s.%s: unknown type '%s'" % (name, fname, ftype))
+            field.append(pos)
+            pos += TYPES[ftype][1]
+        block["size"] = pos - offset
+        offset = pos
+        ordered.append(block)
+    if offset > 255:
+        fail("register map is %d bytes; offsets must fit in one byte" % offset)
+    return ordered, offset
+
+
+def generate(schema):
+    blocks, total = layout(schema)
+    out = []
+    w = out.append
+
+    w("/*")
+    w(" * romi_protocol.h -- GENERATED by protocol/gen_romi_protocol.py from")
+    w(" * protocol/romi_protocol.json.  Do not edit; change the schema and run")
+    w(" *")
+    w(" *     python3 protocol/gen_romi_protocol.py")
+    w(" *")
+    for line in wrap(schema.get("doc", ""), 72):
+        w(" * " + line)
+    w(" */")
+    w("")
+    w("#ifndef ROMI_PROTOCOL_H")
+    w("#define ROMI_PROTOCOL_H")
+    w("")
+    w("#include <stddef.h>")
+    w("#include <stdint.h>")
+    w("#ifndef __cplusplus")
+    w("#include <stdbool.h>")
+    w("#endif")
+    w("")
+    w("#define ROMI_PROTOCOL_VERSION %d" % schema["version"])
+    w("#define ROMI_I2C_ADDRESS      %s" % schema["i2c_address"])
+    w("")
+    if schema.get("constants"):
+        for name, value, doc in schema["constants"]:
+            w("#define %-36s %s /* %s */" % ("ROMI_" + name, value, doc))
+        w("")
+    w("#if defined(__GNUC__)")
+    w("#define ROMI_PACKED __attribute__((packed))")
+    w("#else")
+    w('#error "romi_protocol.h needs __attribute__((packed))"')
+    w("#endif")
+    w("")
+    w("/* Compile-time check usable from C99 as well as C++11 */")
+    w("#if defined(__cplusplus) && __cplusplus >= 201103L")
+    w("#define ROMI_STATIC_ASSERT(cond, tag) static_assert(cond, #tag)")
+    w("#else")
+    w("#define ROMI_STATIC_ASSERT(cond, tag) typedef char romi_static_assert_##tag[(cond) ? 1 : -1]")
+    w("#endif")
+    w("")
+    w("/*")
+    w(" * Register map.  *_OFFSET values are absolute register addresses, i.e.")
+    w(" * the byte the host writes first to point the slave at a field.")
+    w(" */")
+    for b in blocks:
+        B = "ROMI_" + b["name"].upper()
+        w("#define %-36s %d" % (B + "_OFFSET", b["offset"]))
+        w("#define %-36s %d" % (B + "_SIZE", b["size"]))
+        for fname, ftype, _doc, off in b["fields"]:
+            F = B + "_" + fname.upper()
+            w("#define %-36s %d" % (F + "_OFFSET", off))
+            w("#define %-36s %d" % (F + "_SIZE", TYPES[ftype][1]))
+        w("")
+    w("#define %-36s %d" % ("ROMI_DATA_SIZE", total))
+    w("")
+    w("/*")
+    w(" * Bytes from the start of field FIRST to the end of field LAST, for a")
+    w(" * partial transfer, e.g. ROMI_SPAN(ROMI_TELEM_L_ENC, ROMI_TELEM_REM_RIGHT)")
+    w(" */")
+    w("#define ROMI_SPAN(first, last) ((last##_OFFSET) + (last##_SIZE) - (first##_OFFSET))")
+    w("")
+
+    for b in blocks:
+        w("/* %s */" % b.get("doc", b["name"]))
+        w("typedef struct")
+        w("{")
+        width = max(len(TYPES[f[1]][0]) for f in b["fields"])
+        for fname, ftype, doc, _off in b["fields"]:
+            w("    %-*s %s; /* %s */" % (width, TYPES[ftype][0], fname, doc))
+        w("} ROMI_PACKED %s;" % b["type"])
+        w("")
+
+    buf = schema["buffer"]
+    w("/* %s */" % buf.get("doc", "Slave buffer"))
+    w("typedef struct")
+    w("{")
+    width = max(len(b["type"]) for b in blocks)
+    for b in blocks:
+        w("    %-*s %s;" % (width, b["type"], b["name"]))
+    w("} ROMI_PACKED %s;" % buf["type"])
+    w("")
+
+    w("ROMI_STATIC_ASSERT(sizeof(bool) == 1, bool_is_one_byte);")
+    for b in blocks:
+        B = "ROMI_" + b["name"].upper()
+        w("ROMI_STATIC_ASSERT(sizeof(%s) == %s_SIZE, %s_size);" % (b["type"], B, b["name"]))
+        w("ROMI_STATIC_ASSERT(offsetof(%s, %s) == %s_OFFSET, %s_offset);" % (buf["type"], b["name"], B, b["name"]))
+        for fname, _ftype, _doc, _off in b["fields"]:
+            F = B + "_" + fname.upper()
+            w("ROMI_STATIC_ASSERT(offsetof(%s, %s) == %s_OFFSET - %s_OFFSET, %s_%s_offset);"
+              % (b["type"], fname, F, B, b["name"], fname))
+    w("ROMI_STATIC_ASSERT(sizeof(%s) == ROMI_DATA_SIZE, data_size);" % buf["type"])
+    w("")
+
+    w("/* Little-endian field access, independent of the host's byte order */")
+    w("static inline void romi_put_u8(uint8_t *p, uint8_t v) { p[0] = v; }")
+    w("static inline void romi_put_i8(uint8_t *p, int8_t v) { p[0] = (uint8_t)v; }")
+    w("static inline void romi_put_bool(uint8_t *p, bool v) { p[0] = v ? 1 : 0; }")
+    w("static inline void romi_put_u16(uint8_t *p, uint16_t v)")
+    w("{")
+    w("    p[0] = (uint8_t)v;")
+    w("    p[1] = (uint8_t)(v >> 8);")
+    w("}")
+    w("static inline void romi_put_i16(uint8_t *p, int16_t v) { romi_put_u16(p, (uint16_t)v); }")
+    w("static inline void romi_put_u32(uint8_t *p, uint32_t v)")
+    w("{")
+    w("    romi_put_u16(p, (uint16_t)v);")
+    w("    romi_put_u16(p + 2, (uint16_t)(v >> 16));")
+    w("}")
+    w("static inline void romi_put_i32(uint8_t *p, int32_t v) { romi_put_u32(p, (uint32_t)v); }")
+    w("")
+    w("static inline uint8_t  romi_get_u8(const uint8_t *p) { return p[0]; }")
+    w("static inline int8_t   romi_get_i8(const uint8_t *p) { return (int8_t)p[0]; }")
+    w("static inline bool     romi_get_bool(const uint8_t *p) { return p[0] != 0; }")
+    w("static inline uint16_t romi_get_u16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }")
+    w("static inline int16_t  romi_get_i16(const uint8_t *p) { return (int16_t)romi_get_u16(p); }")
+    w("static inline uint32_t romi_get_u32(const uint8_t *p)")
+    w("{")
+    w("    return (uint32_t)romi_get_u16(p) | ((uint32_t)romi_get_u16(p + 2) << 16);")
+    w("}")
+    w("static inline int32_t romi_get_i32(const uint8_t *p) { return (int32_t)romi_get_u32(p); }")
+    w("")
+
+    for b in blocks:
+        B = "ROMI_" + b["name"].upper()
+        n = b["name"]
+        w("/* Serialize a %s block into %s_SIZE bytes of wire format */" % (n, B))
+        w("static inline void romi_%s_pack(uint8_t *dst, const %s *src)" % (n, b["type"]))
+        w("{")
+        for fname, ftype, _doc, off in b["fields"]:
+            w("    romi_put_%s(dst + %d, src->%s);" % (TYPES[ftype][2], off - b["offset"], fname))
+        w("}")
+        w("")
+        w("/* Deserialize %s_SIZE bytes of wire format into a %s block */" % (B, n))
+        w("static inline void romi_%s_unpack(%s *dst, const uint8_t *src)" % (n, b["type"]))
+        w("{")
+        for fname, ftype, _doc, off in b["fields"]:
+            w("    dst->%s = romi_get_%s(src + %d);" % (fname, TYPES[ftype][2], off - b["offset"]))
+        w("}")
+        w("")
+
+    w("#ifdef __cplusplus")
+    w("namespace romi")
+    w("{")
+    w("namespace reg")
+    w("{")
+    w("/* Absolute register offsets and sizes, for compile-time transfer ranges */")
+    for b in blocks:
+        w("constexpr uint8_t %s      = %d;" % (b["name"], b["offset"]))
+        w("constexpr uint8_t %s_size = %d;" % (b["name"], b["size"]))
+        for fname, ftype, _doc, off in b["fields"]:
+            w("constexpr uint8_t %s_%s      = %d;" % (b["name"], fname, off))
+            w("constexpr uint8_t %s_%s_size = %d;" % (b["name"], fname, TYPES[ftype][1]))
+    w("constexpr uint8_t data_size = %d;" % total)
+    w("} // namespace reg")
+    w("} // namespace romi")
+    w("#endif")
+    w("")
+    w("#endif /* ROMI_PROTOCOL_H */")
+    return "\n".join(out) + "\n"
+
+
+def wrap(text, width):
+    lines, cur = [], ""
+    for word in text.split():
+        if cur and len(cur) + 1 + len(word) > width:
+            lines.append(cur)
+            cur = word
+        else:
+            cur = (cur + " " + word).strip()
+    if cur:
+        lines.append(cur)
+    return lines
+
+
+def main(argv):
+    check = "--check" in argv
+    args = [a for a in argv if a != "--check"]
+    schema_path = args[0] if len(args) > 0 else os.path.join(HERE, "romi_protocol.json")
+    out_path = args[1] if len(args) > 1 else os.path.join(HERE, "romi_protocol.h")
+
+    with open(schema_path) as f:
+        text = generate(json.load(f))
+
+    if check:
+        try:
+            with open(out_path) as f:
+                current = f.read()
+        except IOError:
+            current = None
+        if current != text:
+            sys.stderr.write("%s is out of date with %s; rerun gen_romi_protocol.py\n" % (out_path, schema_path))
+            return 1
+        return 0
+
+    with open(out_path, "w") as f:
+        f.write(text)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv[1:]))
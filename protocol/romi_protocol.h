@@ -0,0 +1,488 @@
+/*
+ * romi_protocol.h -- GENERATED by protocol/gen_romi_protocol.py from
+ * protocol/romi_protocol.json.  Do not edit; change the schema and run
+ *
+ *     python3 protocol/gen_romi_protocol.py
+ *
+ * Register map of the Romi 32U4 I2C slave (Robot_Code.cpp). The host
+ * writes the command block and reads the telemetry, identity, diagnostics
+ * and snapshot blocks; all live in one PololuRPiSlave buffer, addressed by
+ * byte offset.
+ */
+
+#ifndef ROMI_PROTOCOL_H
+#define ROMI_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#define ROMI_PROTOCOL_VERSION 4
+#define ROMI_I2C_ADDRESS      0x14
+
+#define ROMI_IDENT_MAGIC                     0x524D /* ident.magic on firmware that has an identity block */
+#define ROMI_FEATURE_COMBINED_XFER           0x0001 /* Pointer write and read may be one repeated-start transaction */
+#define ROMI_FEATURE_FRESH_SNAPSHOT          0x0002 /* Encoders and remaining distances are captured when a read starts */
+
+#if defined(__GNUC__)
+#define ROMI_PACKED __attribute__((packed))
+#else
+#error "romi_protocol.h needs __attribute__((packed))"
+#endif
+
+/* Compile-time check usable from C99 as well as C++11 */
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#define ROMI_STATIC_ASSERT(cond, tag) static_assert(cond, #tag)
+#else
+#define ROMI_STATIC_ASSERT(cond, tag) typedef char romi_static_assert_##tag[(cond) ? 1 : -1]
+#endif
+
+/*
+ * Register map.  *_OFFSET values are absolute register addresses, i.e.
+ * the byte the host writes first to point the slave at a field.
+ */
+#define ROMI_CMD_OFFSET                      0
+#define ROMI_CMD_SIZE                        11
+#define ROMI_CMD_LEFT_SPEED_OFFSET           0
+#define ROMI_CMD_LEFT_SPEED_SIZE             2
+#define ROMI_CMD_RIGHT_SPEED_OFFSET          2
+#define ROMI_CMD_RIGHT_SPEED_SIZE            2
+#define ROMI_CMD_LEFT_DIST_OFFSET            4
+#define ROMI_CMD_LEFT_DIST_SIZE              2
+#define ROMI_CMD_RIGHT_DIST_OFFSET           6
+#define ROMI_CMD_RIGHT_DIST_SIZE             2
+#define ROMI_CMD_R_LED_OFFSET                8
+#define ROMI_CMD_R_LED_SIZE                  1
+#define ROMI_CMD_G_LED_OFFSET                9
+#define ROMI_CMD_G_LED_SIZE                  1
+#define ROMI_CMD_Y_LED_OFFSET                10
+#define ROMI_CMD_Y_LED_SIZE                  1
+
+#define ROMI_TELEM_OFFSET                    11
+#define ROMI_TELEM_SIZE                      25
+#define ROMI_TELEM_L_ENC_OFFSET              11
+#define ROMI_TELEM_L_ENC_SIZE                2
+#define ROMI_TELEM_R_ENC_OFFSET              13
+#define ROMI_TELEM_R_ENC_SIZE                2
+#define ROMI_TELEM_REM_LEFT_OFFSET           15
+#define ROMI_TELEM_REM_LEFT_SIZE             2
+#define ROMI_TELEM_REM_RIGHT_OFFSET          17
+#define ROMI_TELEM_REM_RIGHT_SIZE            2
+#define ROMI_TELEM_CMD_LEFT_DIST_OFFSET      19
+#define ROMI_TELEM_CMD_LEFT_DIST_SIZE        2
+#define ROMI_TELEM_CMD_RIGHT_DIST_OFFSET     21
+#define ROMI_TELEM_CMD_RIGHT_DIST_SIZE       2
+#define ROMI_TELEM_CMD_LEFT_SPEED_OFFSET     23
+#define ROMI_TELEM_CMD_LEFT_SPEED_SIZE       2
+#define ROMI_TELEM_CMD_RIGHT_SPEED_OFFSET    25
+#define ROMI_TELEM_CMD_RIGHT_SPEED_SIZE      2
+#define ROMI_TELEM_SET_LEFT_SPEED_OFFSET     27
+#define ROMI_TELEM_SET_LEFT_SPEED_SIZE       2
+#define ROMI_TELEM_SET_RIGHT_SPEED_OFFSET    29
+#define ROMI_TELEM_SET_RIGHT_SPEED_SIZE      2
+#define ROMI_TELEM_BATTERYMILLIVOLTS_OFFSET  31
+#define ROMI_TELEM_BATTERYMILLIVOLTS_SIZE    2
+#define ROMI_TELEM_BUTTON_A_OFFSET           33
+#define ROMI_TELEM_BUTTON_A_SIZE             1
+#define ROMI_TELEM_BUTTON_B_OFFSET           34
+#define ROMI_TELEM_BUTTON_B_SIZE             1
+#define ROMI_TELEM_BUTTON_C_OFFSET           35
+#define ROMI_TELEM_BUTTON_C_SIZE             1
+
+#define ROMI_IDENT_OFFSET                    36
+#define ROMI_IDENT_SIZE                      10
+#define ROMI_IDENT_MAGIC_OFFSET              36
+#define ROMI_IDENT_MAGIC_SIZE                2
+#define ROMI_IDENT_PROTOCOL_VERSION_OFFSET   38
+#define ROMI_IDENT_PROTOCOL_VERSION_SIZE     1
+#define ROMI_IDENT_DATA_SIZE_OFFSET          39
+#define ROMI_IDENT_DATA_SIZE_SIZE            1
+#define ROMI_IDENT_FEATURES_OFFSET           40
+#define ROMI_IDENT_FEATURES_SIZE             2
+#define ROMI_IDENT_BUILD_ID_OFFSET           42
+#define ROMI_IDENT_BUILD_ID_SIZE             4
+
+#define ROMI_DIAG_OFFSET                     46
+#define ROMI_DIAG_SIZE                       6
+#define ROMI_DIAG_CMD_LATENCY_US_OFFSET      46
+#define ROMI_DIAG_CMD_LATENCY_US_SIZE        2
+#define ROMI_DIAG_CMD_LATENCY_MAX_US_OFFSET  48
+#define ROMI_DIAG_CMD_LATENCY_MAX_US_SIZE    2
+#define ROMI_DIAG_CMD_COUNT_OFFSET           50
+#define ROMI_DIAG_CMD_COUNT_SIZE             2
+
+#define ROMI_SNAP_OFFSET                     52
+#define ROMI_SNAP_SIZE                       12
+#define ROMI_SNAP_CAPTURE_US_OFFSET          52
+#define ROMI_SNAP_CAPTURE_US_SIZE            4
+#define ROMI_SNAP_L_ENC_OFFSET               56
+#define ROMI_SNAP_L_ENC_SIZE                 2
+#define ROMI_SNAP_R_ENC_OFFSET               58
+#define ROMI_SNAP_R_ENC_SIZE                 2
+#define ROMI_SNAP_REM_LEFT_OFFSET            60
+#define ROMI_SNAP_REM_LEFT_SIZE              2
+#define ROMI_SNAP_REM_RIGHT_OFFSET           62
+#define ROMI_SNAP_REM_RIGHT_SIZE             2
+
+#define ROMI_DATA_SIZE                       64
+
+/*
+ * Bytes from the start of field FIRST to the end of field LAST, for a
+ * partial transfer, e.g. ROMI_SPAN(ROMI_TELEM_L_ENC, ROMI_TELEM_REM_RIGHT)
+ */
+#define ROMI_SPAN(first, last) ((last##_OFFSET) + (last##_SIZE) - (first##_OFFSET))
+
+/* Written by the host */
+typedef struct
+{
+    int16_t left_speed; /* Left wheel speed, 0 = let the distance ladder choose */
+    int16_t right_speed; /* Right wheel speed, 0 = let the distance ladder choose */
+    int16_t left_dist; /* Left wheel move in encoder counts; a new value starts a move */
+    int16_t right_dist; /* Right wheel move in encoder counts; a new value starts a move */
+    bool    r_led; /* Red LED */
+    bool    g_led; /* Green LED */
+    bool    y_led; /* Yellow LED */
+} ROMI_PACKED I2C_Command_Packet;
+
+/* Written by the robot every loop */
+typedef struct
+{
+    int16_t  l_enc; /* Left encoder count */
+    int16_t  r_enc; /* Right encoder count */
+    int16_t  rem_left; /* Left distance still to travel */
+    int16_t  rem_right; /* Right distance still to travel */
+    int16_t  cmd_left_dist; /* Echo of cmd.left_dist */
+    int16_t  cmd_right_dist; /* Echo of cmd.right_dist */
+    int16_t  cmd_left_speed; /* Echo of cmd.left_speed */
+    int16_t  cmd_right_speed; /* Echo of cmd.right_speed */
+    int16_t  set_left_speed; /* Speed actually applied to the left motor */
+    int16_t  set_right_speed; /* Speed actually applied to the right motor */
+    uint16_t batteryMillivolts; /* Battery voltage */
+    bool     button_A; /* Button A pressed since the last loop */
+    bool     button_B; /* Button B pressed since the last loop */
+    bool     button_C; /* Button C pressed since the last loop */
+} ROMI_PACKED I2C_Telem_Packet;
+
+/* Set by the robot, read-only for the host; missing before protocol version 2 */
+typedef struct
+{
+    uint16_t magic; /* ROMI_IDENT_MAGIC */
+    uint8_t  protocol_version; /* ROMI_PROTOCOL_VERSION the firmware was built with */
+    uint8_t  data_size; /* Size of the slave buffer in bytes */
+    uint16_t features; /* ROMI_FEATURE_* bits */
+    uint32_t build_id; /* Firmware build identifier, 0 if not set */
+} ROMI_PACKED I2C_Ident_Packet;
+
+/* Set by the robot, read-only for the host; missing before protocol version 3 */
+typedef struct
+{
+    uint16_t cmd_latency_us; /* Last command write to motor update, saturating */
+    uint16_t cmd_latency_max_us; /* Worst cmd_latency_us since power-up */
+    uint16_t cmd_count; /* Command writes applied since power-up, wrapping */
+} ROMI_PACKED I2C_Diag_Packet;
+
+/* Captured when the register pointer is set to this block or to telem, read-only; missing before protocol version 4 */
+typedef struct
+{
+    uint32_t capture_us; /* Robot clock when the pointer write arrived */
+    int16_t  l_enc; /* Left encoder count at capture_us */
+    int16_t  r_enc; /* Right encoder count at capture_us */
+    int16_t  rem_left; /* Left distance still to travel at capture_us */
+    int16_t  rem_right; /* Right distance still to travel at capture_us */
+} ROMI_PACKED I2C_Snap_Packet;
+
+/* The whole slave buffer */
+typedef struct
+{
+    I2C_Command_Packet cmd;
+    I2C_Telem_Packet   telem;
+    I2C_Ident_Packet   ident;
+    I2C_Diag_Packet    diag;
+    I2C_Snap_Packet    snap;
+} ROMI_PACKED I2C_Data;
+
+ROMI_STATIC_ASSERT(sizeof(bool) == 1, bool_is_one_byte);
+ROMI_STATIC_ASSERT(sizeof(I2C_Command_Packet) == ROMI_CMD_SIZE, cmd_size);
+ROMI_STATIC_ASSERT(offsetof(I2C_Data, cmd) == ROMI_CMD_OFFSET, cmd_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Command_Packet, left_speed) == ROMI_CMD_LEFT_SPEED_OFFSET - ROMI_CMD_OFFSET, cmd_left_speed_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Command_Packet, right_speed) == ROMI_CMD_RIGHT_SPEED_OFFSET - ROMI_CMD_OFFSET, cmd_right_speed_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Command_Packet, left_dist) == ROMI_CMD_LEFT_DIST_OFFSET - ROMI_CMD_OFFSET, cmd_left_dist_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Command_Packet, right_dist) == ROMI_CMD_RIGHT_DIST_OFFSET - ROMI_CMD_OFFSET, cmd_right_dist_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Command_Packet, r_led) == ROMI_CMD_R_LED_OFFSET - ROMI_CMD_OFFSET, cmd_r_led_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Command_Packet, g_led) == ROMI_CMD_G_LED_OFFSET - ROMI_CMD_OFFSET, cmd_g_led_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Command_Packet, y_led) == ROMI_CMD_Y_LED_OFFSET - ROMI_CMD_OFFSET, cmd_y_led_offset);
+ROMI_STATIC_ASSERT(sizeof(I2C_Telem_Packet) == ROMI_TELEM_SIZE, telem_size);
+ROMI_STATIC_ASSERT(offsetof(I2C_Data, telem) == ROMI_TELEM_OFFSET, telem_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, l_enc) == ROMI_TELEM_L_ENC_OFFSET - ROMI_TELEM_OFFSET, telem_l_enc_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, r_enc) == ROMI_TELEM_R_ENC_OFFSET - ROMI_TELEM_OFFSET, telem_r_enc_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, rem_left) == ROMI_TELEM_REM_LEFT_OFFSET - ROMI_TELEM_OFFSET, telem_rem_left_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, rem_right) == ROMI_TELEM_REM_RIGHT_OFFSET - ROMI_TELEM_OFFSET, telem_rem_right_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, cmd_left_dist) == ROMI_TELEM_CMD_LEFT_DIST_OFFSET - ROMI_TELEM_OFFSET, telem_cmd_left_dist_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, cmd_right_dist) == ROMI_TELEM_CMD_RIGHT_DIST_OFFSET - ROMI_TELEM_OFFSET, telem_cmd_right_dist_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, cmd_left_speed) == ROMI_TELEM_CMD_LEFT_SPEED_OFFSET - ROMI_TELEM_OFFSET, telem_cmd_left_speed_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, cmd_right_speed) == ROMI_TELEM_CMD_RIGHT_SPEED_OFFSET - ROMI_TELEM_OFFSET, telem_cmd_right_speed_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, set_left_speed) == ROMI_TELEM_SET_LEFT_SPEED_OFFSET - ROMI_TELEM_OFFSET, telem_set_left_speed_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, set_right_speed) == ROMI_TELEM_SET_RIGHT_SPEED_OFFSET - ROMI_TELEM_OFFSET, telem_set_right_speed_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, batteryMillivolts) == ROMI_TELEM_BATTERYMILLIVOLTS_OFFSET - ROMI_TELEM_OFFSET, telem_batteryMillivolts_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, button_A) == ROMI_TELEM_BUTTON_A_OFFSET - ROMI_TELEM_OFFSET, telem_button_A_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, button_B) == ROMI_TELEM_BUTTON_B_OFFSET - ROMI_TELEM_OFFSET, telem_button_B_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Telem_Packet, button_C) == ROMI_TELEM_BUTTON_C_OFFSET - ROMI_TELEM_OFFSET, telem_button_C_offset);
+ROMI_STATIC_ASSERT(sizeof(I2C_Ident_Packet) == ROMI_IDENT_SIZE, ident_size);
+ROMI_STATIC_ASSERT(offsetof(I2C_Data, ident) == ROMI_IDENT_OFFSET, ident_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Ident_Packet, magic) == ROMI_IDENT_MAGIC_OFFSET - ROMI_IDENT_OFFSET, ident_magic_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Ident_Packet, protocol_version) == ROMI_IDENT_PROTOCOL_VERSION_OFFSET - ROMI_IDENT_OFFSET, ident_protocol_version_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Ident_Packet, data_size) == ROMI_IDENT_DATA_SIZE_OFFSET - ROMI_IDENT_OFFSET, ident_data_size_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Ident_Packet, features) == ROMI_IDENT_FEATURES_OFFSET - ROMI_IDENT_OFFSET, ident_features_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Ident_Packet, build_id) == ROMI_IDENT_BUILD_ID_OFFSET - ROMI_IDENT_OFFSET, ident_build_id_offset);
+ROMI_STATIC_ASSERT(sizeof(I2C_Diag_Packet) == ROMI_DIAG_SIZE, diag_size);
+ROMI_STATIC_ASSERT(offsetof(I2C_Data, diag) == ROMI_DIAG_OFFSET, diag_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Diag_Packet, cmd_latency_us) == ROMI_DIAG_CMD_LATENCY_US_OFFSET - ROMI_DIAG_OFFSET, diag_cmd_latency_us_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Diag_Packet, cmd_latency_max_us) == ROMI_DIAG_CMD_LATENCY_MAX_US_OFFSET - ROMI_DIAG_OFFSET, diag_cmd_latency_max_us_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Diag_Packet, cmd_count) == ROMI_DIAG_CMD_COUNT_OFFSET - ROMI_DIAG_OFFSET, diag_cmd_count_offset);
+ROMI_STATIC_ASSERT(sizeof(I2C_Snap_Packet) == ROMI_SNAP_SIZE, snap_size);
+ROMI_STATIC_ASSERT(offsetof(I2C_Data, snap) == ROMI_SNAP_OFFSET, snap_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Snap_Packet, capture_us) == ROMI_SNAP_CAPTURE_US_OFFSET - ROMI_SNAP_OFFSET, snap_capture_us_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Snap_Packet, l_enc) == ROMI_SNAP_L_ENC_OFFSET - ROMI_SNAP_OFFSET, snap_l_enc_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Snap_Packet, r_enc) == ROMI_SNAP_R_ENC_OFFSET - ROMI_SNAP_OFFSET, snap_r_enc_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Snap_Packet, rem_left) == ROMI_SNAP_REM_LEFT_OFFSET - ROMI_SNAP_OFFSET, snap_rem_left_offset);
+ROMI_STATIC_ASSERT(offsetof(I2C_Snap_Packet, rem_right) == ROMI_SNAP_REM_RIGHT_OFFSET - ROMI_SNAP_OFFSET, snap_rem_right_offset);
+ROMI_STATIC_ASSERT(sizeof(I2C_Data) == ROMI_DATA_SIZE, data_size);
+
+/* Little-endian field access, independent of the host's byte order */
+static inline void romi_put_u8(uint8_t *p, uint8_t v) { p[0] = v; }
+static inline void romi_put_i8(uint8_t *p, int8_t v) { p[0] = (uint8_t)v; }
+static inline void romi_put_bool(uint8_t *p, bool v) { p[0] = v ? 1 : 0; }
+static inline void romi_put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+static inline void romi_put_i16(uint8_t *p, int16_t v) { romi_put_u16(p, (uint16_t)v); }
+static inline void romi_put_u32(uint8_t *p, uint32_t v)
+{
+    romi_put_u16(p, (uint16_t)v);
+    romi_put_u16(p + 2, (uint16_t)(v >> 16));
+}
+static inline void romi_put_i32(uint8_t *p, int32_t v) { romi_put_u32(p, (uint32_t)v); }
+
+static inline uint8_t  romi_get_u8(const uint8_t *p) { return p[0]; }
+static inline int8_t   romi_get_i8(const uint8_t *p) { return (int8_t)p[0]; }
+static inline bool     romi_get_bool(const uint8_t *p) { return p[0] != 0; }
+static inline uint16_t romi_get_u16(const uint8_t *p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline int16_t  romi_get_i16(const uint8_t *p) { return (int16_t)romi_get_u16(p); }
+static inline uint32_t romi_get_u32(const uint8_t *p)
+{
+    return (uint32_t)romi_get_u16(p) | ((uint32_t)romi_get_u16(p + 2) << 16);
+}
+static inline int32_t romi_get_i32(const uint8_t *p) { return (int32_t)romi_get_u32(p); }
+
+/* Serialize a cmd block into ROMI_CMD_SIZE bytes of wire format */
+static inline void romi_cmd_pack(uint8_t *dst, const I2C_Command_Packet *src)
+{
+    romi_put_i16(dst + 0, src->left_speed);
+    romi_put_i16(dst + 2, src->right_speed);
+    romi_put_i16(dst + 4, src->left_dist);
+    romi_put_i16(dst + 6, src->right_dist);
+    romi_put_bool(dst + 8, src->r_led);
+    romi_put_bool(dst + 9, src->g_led);
+    romi_put_bool(dst + 10, src->y_led);
+}
+
+/* Deserialize ROMI_CMD_SIZE bytes of wire format into a cmd block */
+static inline void romi_cmd_unpack(I2C_Command_Packet *dst, const uint8_t *src)
+{
+    dst->left_speed = romi_get_i16(src + 0);
+    dst->right_speed = romi_get_i16(src + 2);
+    dst->left_dist = romi_get_i16(src + 4);
+    dst->right_dist = romi_get_i16(src + 6);
+    dst->r_led = romi_get_bool(src + 8);
+    dst->g_led = romi_get_bool(src + 9);
+    dst->y_led = romi_get_bool(src + 10);
+}
+
+/* Serialize a telem block into ROMI_TELEM_SIZE bytes of wire format */
+static inline void romi_telem_pack(uint8_t *dst, const I2C_Telem_Packet *src)
+{
+    romi_put_i16(dst + 0, src->l_enc);
+    romi_put_i16(dst + 2, src->r_enc);
+    romi_put_i16(dst + 4, src->rem_left);
+    romi_put_i16(dst + 6, src->rem_right);
+    romi_put_i16(dst + 8, src->cmd_left_dist);
+    romi_put_i16(dst + 10, src->cmd_right_dist);
+    romi_put_i16(dst + 12, src->cmd_left_speed);
+    romi_put_i16(dst + 14, src->cmd_right_speed);
+    romi_put_i16(dst + 16, src->set_left_speed);
+    romi_put_i16(dst + 18, src->set_right_speed);
+    romi_put_u16(dst + 20, src->batteryMillivolts);
+    romi_put_bool(dst + 22, src->button_A);
+    romi_put_bool(dst + 23, src->button_B);
+    romi_put_bool(dst + 24, src->button_C);
+}
+
+/* Deserialize ROMI_TELEM_SIZE bytes of wire format into a telem block */
+static inline void romi_telem_unpack(I2C_Telem_Packet *dst, const uint8_t *src)
+{
+    dst->l_enc = romi_get_i16(src + 0);
+    dst->r_enc = romi_get_i16(src + 2);
+    dst->rem_left = romi_get_i16(src + 4);
+    dst->rem_right = romi_get_i16(src + 6);
+    dst->cmd_left_dist = romi_get_i16(src + 8);
+    dst->cmd_right_dist = romi_get_i16(src + 10);
+    dst->cmd_left_speed = romi_get_i16(src + 12);
+    dst->cmd_right_speed = romi_get_i16(src + 14);
+    dst->set_left_speed = romi_get_i16(src + 16);
+    dst->set_right_speed = romi_get_i16(src + 18);
+    dst->batteryMillivolts = romi_get_u16(src + 20);
+    dst->button_A = romi_get_bool(src + 22);
+    dst->button_B = romi_get_bool(src + 23);
+    dst->button_C = romi_get_bool(src + 24);
+}
+
+/* Serialize a ident block into ROMI_IDENT_SIZE bytes of wire format */
+static inline void romi_ident_pack(uint8_t *dst, const I2C_Ident_Packet *src)
+{
+    romi_put_u16(dst + 0, src->magic);
+    romi_put_u8(dst + 2, src->protocol_version);
+    romi_put_u8(dst + 3, src->data_size);
+    romi_put_u16(dst + 4, src->features);
+    romi_put_u32(dst + 6, src->build_id);
+}
+
+/* Deserialize ROMI_IDENT_SIZE bytes of wire format into a ident block */
+static inline void romi_ident_unpack(I2C_Ident_Packet *dst, const uint8_t *src)
+{
+    dst->magic = romi_get_u16(src + 0);
+    dst->protocol_version = romi_get_u8(src + 2);
+    dst->data_size = romi_get_u8(src + 3);
+    dst->features = romi_get_u16(src + 4);
+    dst->build_id = romi_get_u32(src + 6);
+}
+
+/* Serialize a diag block into ROMI_DIAG_SIZE bytes of wire format */
+static inline void romi_diag_pack(uint8_t *dst, const I2C_Diag_Packet *src)
+{
+    romi_put_u16(dst + 0, src->cmd_latency_us);
+    romi_put_u16(dst + 2, src->cmd_latency_max_us);
+    romi_put_u16(dst + 4, src->cmd_count);
+}
+
+/* Deserialize ROMI_DIAG_SIZE bytes of wire format into a diag block */
+static inline void romi_diag_unpack(I2C_Diag_Packet *dst, const uint8_t *src)
+{
+    dst->cmd_latency_us = romi_get_u16(src + 0);
+    dst->cmd_latency_max_us = romi_get_u16(src + 2);
+    dst->cmd_count = romi_get_u16(src + 4);
+}
+
+/* Serialize a snap block into ROMI_SNAP_SIZE bytes of wire format */
+static inline void romi_snap_pack(uint8_t *dst, const I2C_Snap_Packet *src)
+{
+    romi_put_u32(dst + 0, src->capture_us);
+    romi_put_i16(dst + 4, src->l_enc);
+    romi_put_i16(dst + 6, src->r_enc);
+    romi_put_i16(dst + 8, src->rem_left);
+    romi_put_i16(dst + 10, src->rem_right);
+}
+
+/* Deserialize ROMI_SNAP_SIZE bytes of wire format into a snap block */
+static inline void romi_snap_unpack(I2C_Snap_Packet *dst, const uint8_t *src)
+{
+    dst->capture_us = romi_get_u32(src + 0);
+    dst->l_enc = romi_get_i16(src + 4);
+    dst->r_enc = romi_get_i16(src + 6);
+    dst->rem_left = romi_get_i16(src + 8);
+    dst->rem_right = romi_get_i16(src + 10);
+}
+
+#ifdef __cplusplus
+namespace romi
+{
+namespace reg
+{
+/* Absolute register offsets and sizes, for compile-time transfer ranges */
+constexpr uint8_t cmd      = 0;
+constexpr uint8_t cmd_size = 11;
+constexpr uint8_t cmd_left_speed      = 0;
+constexpr uint8_t cmd_left_speed_size = 2;
+constexpr uint8_t cmd_right_speed      = 2;
+constexpr uint8_t cmd_right_speed_size = 2;
+constexpr uint8_t cmd_left_dist      = 4;
+constexpr uint8_t cmd_left_dist_size = 2;
+constexpr uint8_t cmd_right_dist      = 6;
+constexpr uint8_t cmd_right_dist_size = 2;
+constexpr uint8_t cmd_r_led      = 8;
+constexpr uint8_t cmd_r_led_size = 1;
+constexpr uint8_t cmd_g_led      = 9;
+constexpr uint8_t cmd_g_led_size = 1;
+constexpr uint8_t cmd_y_led      = 10;
+constexpr uint8_t cmd_y_led_size = 1;
+constexpr uint8_t telem      = 11;
+constexpr uint8_t telem_size = 25;
+constexpr uint8_t telem_l_enc      = 11;
+constexpr uint8_t telem_l_enc_size = 2;
+constexpr uint8_t telem_r_enc      = 13;
+constexpr uint8_t telem_r_enc_size = 2;
+constexpr uint8_t telem_rem_left      = 15;
+constexpr uint8_t telem_rem_left_size = 2;
+constexpr uint8_t telem_rem_right      = 17;
+constexpr uint8_t telem_rem_right_size = 2;
+constexpr uint8_t telem_cmd_left_dist      = 19;
+constexpr uint8_t telem_cmd_left_dist_size = 2;
+constexpr uint8_t telem_cmd_right_dist      = 21;
+constexpr uint8_t telem_cmd_right_dist_size = 2;
+constexpr uint8_t telem_cmd_left_speed      = 23;
+constexpr uint8_t telem_cmd_left_speed_size = 2;
+constexpr uint8_t telem_cmd_right_speed      = 25;
+constexpr uint8_t telem_cmd_right_speed_size = 2;
+constexpr uint8_t telem_set_left_speed      = 27;
+constexpr uint8_t telem_set_left_speed_size = 2;
+constexpr uint8_t telem_set_right_speed      = 29;
+constexpr uint8_t telem_set_right_speed_size = 2;
+constexpr uint8_t telem_batteryMillivolts      = 31;
+constexpr uint8_t telem_batteryMillivolts_size = 2;
+constexpr uint8_t telem_button_A      = 33;
+constexpr uint8_t telem_button_A_size = 1;
+constexpr uint8_t telem_button_B      = 34;
+constexpr uint8_t telem_button_B_size = 1;
+constexpr uint8_t telem_button_C      = 35;
+constexpr uint8_t telem_button_C_size = 1;
+constexpr uint8_t ident      = 36;
+constexpr uint8_t ident_size = 10;
+constexpr uint8_t ident_magic      = 36;
+constexpr uint8_t ident_magic_size = 2;
+constexpr uint8_t ident_protocol_version      = 38;
+constexpr uint8_t ident_protocol_version_size = 1;
+constexpr uint8_t ident_data_size      = 39;
+constexpr uint8_t ident_data_size_size = 1;
+constexpr uint8_t ident_features      = 40;
+constexpr uint8_t ident_features_size = 2;
+constexpr uint8_t ident_build_id      = 42;
+constexpr uint8_t ident_build_id_size = 4;
+constexpr uint8_t diag      = 46;
+constexpr uint8_t diag_size = 6;
+constexpr uint8_t diag_cmd_latency_us      = 46;
+constexpr uint8_t diag_cmd_latency_us_size = 2;
+constexpr uint8_t diag_cmd_latency_max_us      = 48;
+constexpr uint8_t diag_cmd_latency_max_us_size = 2;
+constexpr uint8_t diag_cmd_count      = 50;
+constexpr uint8_t diag_cmd_count_size = 2;
+constexpr uint8_t snap      = 52;
+constexpr uint8_t snap_size = 12;
+constexpr uint8_t snap_capture_us      = 52;
+constexpr uint8_t snap_capture_us_size = 4;
+constexpr uint8_t snap_l_enc      = 56;
+constexpr uint8_t snap_l_enc_size = 2;
+constexpr uint8_t snap_r_enc      = 58;
+constexpr uint8_t snap_r_enc_size = 2;
+constexpr uint8_t snap_rem_left      = 60;
+constexpr uint8_t snap_rem_left_size = 2;
+constexpr uint8_t snap_rem_right      = 62;
+constexpr uint8_t snap_rem_right_size = 2;
+constexpr uint8_t data_size = 64;
+} // namespace reg
+} // namespace romi
+#endif
+
+#endif /* ROMI_PROTOCOL_H */
@@ -37,3 +37,10 @@ add_compile_options(
     -Wno-stringop-truncation    # Inhibit string operation truncation warnings
 )
 
+
+#
+# The mission's sch_lab schedule table (tables/sch_lab_table.c) sends the
+# i2c_app housekeeping request and wakeup, so the table build needs the
+# i2c_app message IDs and wakeup rate from its platform_inc.
+#
+include_directories(${i2c_app_MISSION_DIR}/fsw/platform_inc)
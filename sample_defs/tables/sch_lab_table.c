@@ -0,0 +1,74 @@
+/************************************************************************
+ * NASA Docket No. GSC-18,719-1, and identified as “core Flight System: Bootes”
+ *
+ * Copyright (c) 2020 United States Government as represented by the
+ * Administrator of the National Aeronautics and Space Administration.
+ * All Rights Reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may
+ * not use this file except in compliance with the License. You may obtain
+ * a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ ************************************************************************/
+
+/**
+ * @file
+ *
+ * Mission override of the sch_lab schedule table
+ *
+ * Same format and housekeeping entries as the table shipped with sch_lab,
+ * plus the i2c_app housekeeping request and the wakeup that drives its
+ * control cycle.  The build picks this file up in place of
+ * apps/sch_lab/fsw/tables/sch_lab_table.c.
+ */
+
+#include "cfe_tbl_filedef.h"
+#include "sch_lab_table.h"
+#include "cfe_sb_api_typedefs.h"
+
+/*
+** Include headers for message IDs here
+*/
+#include "cfe_msgids.h"
+#include "ci_lab_msgids.h"
+#include "to_lab_msgids.h"
+#include "i2c_app_msgids.h"
+
+/*
+** Ticks per second; PacketRate below is the number of ticks between sends
+*/
+#define SCH_LAB_TICK_RATE 100
+
+SCH_LAB_ScheduleTable_t SCH_TBL_Structure = {
+    .TickRate = SCH_LAB_TICK_RATE,
+    .Config   = {
+        {CFE_SB_MSGID_WRAP_VALUE(CFE_ES_SEND_HK_MID), 100, 0},
+        {CFE_SB_MSGID_WRAP_VALUE(CFE_EVS_SEND_HK_MID), 100, 0},
+        {CFE_SB_MSGID_WRAP_VALUE(CFE_TIME_SEND_HK_MID), 100, 0},
+        {CFE_SB_MSGID_WRAP_VALUE(CFE_SB_SEND_HK_MID), 100, 0},
+        {CFE_SB_MSGID_WRAP_VALUE(CFE_TBL_SEND_HK_MID), 100, 0},
+        {CFE_SB_MSGID_WRAP_VALUE(CI_LAB_SEND_HK_MID), 400, 0},
+        {CFE_SB_MSGID_WRAP_VALUE(TO_LAB_SEND_HK_MID), 400, 0},
+        {CFE_SB_MSGID_WRAP_VALUE(I2C_APP_SEND_HK_MID), 100, 0},
+        /* one i2c_app control cycle per wakeup */
+        {CFE_SB_MSGID_WRAP_VALUE(I2C_APP_WAKEUP_MID), SCH_LAB_TICK_RATE / I2C_APP_WAKEUP_RATE_HZ, 0},
+    }};
+
+/*
+** The wakeup can only run at a whole number of ticks
+*/
+CompileTimeAssert(SCH_LAB_TICK_RATE % I2C_APP_WAKEUP_RATE_HZ == 0, I2cAppWakeupRateNotTickMultiple);
+
+/*
+** The macro below identifies:
+**    1) the data structure type to use as the table image format
+**    2) the name of the table to be placed into the cFE Table File Header
+**    3) a brief description of the contents of the file image
+**    4) the desired name of the table image binary file that is cFE compatible
+*/
+CFE_TBL_FILEDEF(SCH_TBL_Structure, SCH_LAB_APP.SCH_LAB_SchTbl, Schedule Lab MsgID Table, sch_lab_table.tbl)
@@ -0,0 +1,112 @@
+// romictl entry point: global options, device open, signal handling.
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "romictl.hpp"
+
+namespace {
+
+void on_signal(int) {
+  romictl::request_stop();
+}
+
+bool parse_int(const char *s, long lo, long hi, long *out) {
+  char *end;
+  long v = std::strtol(s, &end, 0);
+  if (*s == '\0' || *end != '\0' || v < lo || v > hi) {
+    return false;
+  }
+  *out = v;
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  long bus = 2;
+  long addr = ROMI_I2C_ADDRESS;
+  long gap_us = 100;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "+b:a:g:h")) != -1) {
+    bool ok = true;
+    switch (opt) {
+      case 'b':
+        ok = parse_int(optarg, 0, 255, &bus);
+        break;
+      case 'a':
+        ok = parse_int(optarg, 0x03, 0x77, &addr);
+        break;
+      case 'g':
+        ok = parse_int(optarg, 0, 1000000, &gap_us);
+        break;
+      case 'h':
+        romictl::print_usage(stdout);
+        return 0;
+      default:
+        ok = false;
+        break;
+    }
+    if (!ok) {
+      romictl::print_usage(stderr);
+      return 2;
+    }
+  }
+  if (optind >= argc) {
+    romictl::print_usage(stderr);
+    return 2;
+  }
+  std::vector<std::string> args(argv + optind, argv + argc);
+
+  romi::Options options;
+  options.read_gap_us = (uint32_t)gap_us;
+  std::unique_ptr<romi::RomiDevice> dev;
+  int status = romi::RomiDevice::open((int)bus, (uint8_t)addr, &dev, options);
+  if (status != 0) {
+    std::fprintf(stderr, "romictl: /dev/i2c-%ld: %s\n", bus, std::strerror(-status));
+    return 1;
+  }
+
+  std::signal(SIGINT, on_signal);
+  std::signal(SIGTERM, on_signal);
+
+  // streams go out in large blocks; the writer flushes when it idles
+  static char outbuf[1 << 16];
+  std::setvbuf(stdout, outbuf, _IOFBF, sizeof(outbuf));
+
+  if (args[0] == "script") {
+    if (args.size() != 2) {
+      romictl::print_usage(stderr);
+      return 2;
+    }
+    FILE *in = args[1] == "-" ? stdin : std::fopen(args[1].c_str(), "r");
+    if (in == nullptr) {
+      std::fprintf(stderr, "romictl: %s: %s\n", args[1].c_str(), std::strerror(errno));
+      return 1;
+    }
+    status = romictl::run_script(*dev, in, stdout, stderr);
+    if (in != stdin) {
+      std::fclose(in);
+    }
+  } else {
+    status = romictl::run_command(*dev, args, stdout, stderr);
+    if (status < 0) {
+      std::fprintf(stderr, "romictl: %s: %s\n", args[0].c_str(), std::strerror(-status));
+    }
+  }
+  std::fflush(stdout);
+
+  if (status == 2) {
+    romictl::print_usage(stderr);
+    return 2;
+  }
+  return status == 0 ? 0 : 1;
+}
@@ -0,0 +1,530 @@
+// romictl commands, scripts and telemetry streaming.
+
+#include "romictl.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+namespace romictl {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kUsage = 2;
+constexpr int kDefaultWaitMs = 30000;
+
+std::atomic<bool> stop_flag(false);
+
+bool parse_long(const std::string &s, long lo, long hi, long *out) {
+  char *end;
+  errno = 0;
+  long v = std::strtol(s.c_str(), &end, 0);
+  if (s.empty() || *end != '\0' || errno != 0 || v < lo || v > hi) {
+    return false;
+  }
+  *out = v;
+  return true;
+}
+
+bool parse_double(const std::string &s, double *out) {
+  char *end;
+  errno = 0;
+  double v = std::strtod(s.c_str(), &end);
+  if (s.empty() || *end != '\0' || errno != 0) {
+    return false;
+  }
+  *out = v;
+  return true;
+}
+
+// "1-4,8,36" -> {1,2,3,4,8,36}
+bool parse_list(const std::string &s, long lo, long hi, std::vector<int> *out) {
+  out->clear();
+  size_t start = 0;
+  while (start <= s.size()) {
+    size_t comma = s.find(',', start);
+    std::string item = s.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+    size_t dash = item.find('-', 1);
+    long a, b;
+    if (dash == std::string::npos) {
+      if (!parse_long(item, lo, hi, &a)) {
+        return false;
+      }
+      b = a;
+    } else if (!parse_long(item.substr(0, dash), lo, hi, &a) || !parse_long(item.substr(dash + 1), lo, hi, &b) ||
+               b < a) {
+      return false;
+    }
+    for (long v = a; v <= b; ++v) {
+      out->push_back((int)v);
+    }
+    if (comma == std::string::npos) {
+      break;
+    }
+    start = comma + 1;
+  }
+  return !out->empty();
+}
+
+void print_telemetry(const I2C_Telem_Packet &t, FILE *out) {
+  std::fprintf(out, "encoders      %6d %6d\n", t.l_enc, t.r_enc);
+  std::fprintf(out, "remaining     %6d %6d\n", t.rem_left, t.rem_right);
+  std::fprintf(out, "cmd distance  %6d %6d\n", t.cmd_left_dist, t.cmd_right_dist);
+  std::fprintf(out, "cmd speed     %6d %6d\n", t.cmd_left_speed, t.cmd_right_speed);
+  std::fprintf(out, "set speed     %6d %6d\n", t.set_left_speed, t.set_right_speed);
+  std::fprintf(out, "battery       %.3f V\n", t.batteryMillivolts / 1000.0);
+  std::fprintf(out, "buttons       A=%d B=%d C=%d\n", t.button_A, t.button_B, t.button_C);
+}
+
+// Lock-free single-producer / single-consumer ring between the sampler
+// and the writer.
+struct Sample {
+  uint64_t t_ns;
+  uint32_t seq;
+  uint8_t raw[ROMI_TELEM_SIZE];
+};
+
+class Ring {
+ public:
+  static constexpr size_t kSize = 4096;  // 40 s at 100 Hz of writer stall
+
+  bool push(const Sample &s) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == kSize) {
+      return false;
+    }
+    buf_[head % kSize] = s;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(Sample *s) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    *s = buf_[tail % kSize];
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  Sample buf_[kSize];
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+};
+
+void write_csv_header(FILE *out) {
+  std::fputs("t_us,seq,l_enc,r_enc,rem_left,rem_right,cmd_left_dist,cmd_right_dist,cmd_left_speed,"
+             "cmd_right_speed,set_left_speed,set_right_speed,battery_mv,button_a,button_b,button_c\n",
+             out);
+}
+
+void write_csv(const Sample &s, FILE *out) {
+  I2C_Telem_Packet t;
+  romi_telem_unpack(&t, s.raw);
+  std::fprintf(out, "%llu,%u,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%u,%d,%d,%d\n", (unsigned long long)(s.t_ns / 1000),
+               s.seq, t.l_enc, t.r_enc, t.rem_left, t.rem_right, t.cmd_left_dist, t.cmd_right_dist,
+               t.cmd_left_speed, t.cmd_right_speed, t.set_left_speed, t.set_right_speed, t.batteryMillivolts,
+               t.button_A, t.button_B, t.button_C);
+}
+
+void write_binary_header(FILE *out) {
+  uint8_t h[kBinaryHeaderSize] = {};
+  std::memcpy(h, kBinaryMagic, sizeof(kBinaryMagic));
+  romi_put_u16(h + 8, ROMI_PROTOCOL_VERSION);
+  romi_put_u16(h + 10, (uint16_t)kBinaryRecordSize);
+  std::fwrite(h, 1, sizeof(h), out);
+}
+
+void write_binary(const Sample &s, FILE *out) {
+  uint8_t r[kBinaryRecordSize];
+  romi_put_u32(r, (uint32_t)s.t_ns);
+  romi_put_u32(r + 4, (uint32_t)(s.t_ns >> 32));
+  romi_put_u32(r + 8, s.seq);
+  std::memcpy(r + 12, s.raw, ROMI_TELEM_SIZE);
+  std::fwrite(r, 1, sizeof(r), out);
+}
+
+int parse_stream(const std::vector<std::string> &args, StreamOptions *opts, FILE *err) {
+  for (size_t i = 1; i < args.size(); ++i) {
+    const std::string &a = args[i];
+    bool has_value = i + 1 < args.size();
+    long n;
+    if (a == "--rate" && has_value && parse_double(args[i + 1], &opts->rate_hz) && opts->rate_hz > 0) {
+      ++i;
+    } else if (a == "--count" && has_value && parse_long(args[i + 1], 1, 0x7FFFFFFF, &n)) {
+      opts->count = (uint64_t)n;
+      ++i;
+    } else if (a == "--duration" && has_value && parse_double(args[i + 1], &opts->duration_s) &&
+               opts->duration_s > 0) {
+      ++i;
+    } else if (a == "--format" && has_value && (args[i + 1] == "csv" || args[i + 1] == "bin")) {
+      opts->format = args[i + 1] == "csv" ? Format::Csv : Format::Binary;
+      ++i;
+    } else {
+      std::fprintf(err, "stream: bad option '%s'\n", a.c_str());
+      return kUsage;
+    }
+  }
+  return 0;
+}
+
+int parse_sweep(const std::vector<std::string> &args, SweepOptions *opts, FILE *err) {
+  opts->sizes.clear();
+  for (int n = 1; n <= ROMI_DATA_SIZE; ++n) {
+    opts->sizes.push_back(n);
+  }
+  opts->offsets = {ROMI_CMD_OFFSET, ROMI_TELEM_OFFSET};
+  opts->gaps_us = {0, 100, 1000};
+  for (size_t i = 1; i < args.size(); ++i) {
+    const std::string &a = args[i];
+    bool has_value = i + 1 < args.size();
+    long n;
+    if (a == "--sizes" && has_value && parse_list(args[i + 1], 1, ROMI_DATA_SIZE, &opts->sizes)) {
+      ++i;
+    } else if (a == "--offsets" && has_value && parse_list(args[i + 1], 0, ROMI_DATA_SIZE - 1, &opts->offsets)) {
+      ++i;
+    } else if (a == "--gaps" && has_value && parse_list(args[i + 1], 0, 1000000, &opts->gaps_us)) {
+      ++i;
+    } else if (a == "--count" && has_value && parse_long(args[i + 1], 1, 1000000, &n)) {
+      opts->count = (int)n;
+      ++i;
+    } else if (a == "--reads") {
+      opts->writes = false;
+    } else if (a == "--writes") {
+      opts->reads = false;
+    } else {
+      std::fprintf(err, "sweep: bad option '%s'\n", a.c_str());
+      return kUsage;
+    }
+  }
+  if (!opts->reads && !opts->writes) {
+    std::fputs("sweep: --reads and --writes are exclusive\n", err);
+    return kUsage;
+  }
+  return 0;
+}
+
+// Trailing "--wait [--timeout MS]" on a motion command.
+int parse_wait(const std::vector<std::string> &args, size_t first, bool *wait, long *timeout_ms, FILE *err) {
+  *wait = false;
+  *timeout_ms = kDefaultWaitMs;
+  for (size_t i = first; i < args.size(); ++i) {
+    if (args[i] == "--wait") {
+      *wait = true;
+    } else if (args[i] == "--timeout" && i + 1 < args.size() && parse_long(args[i + 1], 0, 3600000, timeout_ms)) {
+      ++i;
+    } else {
+      std::fprintf(err, "%s: bad option '%s'\n", args[0].c_str(), args[i].c_str());
+      return kUsage;
+    }
+  }
+  return 0;
+}
+
+int move_and_maybe_wait(romi::RomiDevice &dev, int16_t left, int16_t right, bool wait, long timeout_ms,
+                        FILE *out) {
+  int status = dev.start_move(left, right);
+  if (status == 0 && wait) {
+    I2C_Telem_Packet t;
+    romi::WaitStats ws;
+    auto start = Clock::now();
+    status = dev.wait_motion_done(std::chrono::milliseconds(timeout_ms), romi::WaitPolicy(), &t, &ws);
+    if (status == 0) {
+      double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+      std::fprintf(out, "done in %.0f ms (%u polls), encoders %d %d\n", ms, ws.polls, t.l_enc, t.r_enc);
+    }
+  }
+  return status;
+}
+
+}  // namespace
+
+void request_stop() {
+  stop_flag.store(true);
+}
+
+bool stop_requested() {
+  return stop_flag.load(std::memory_order_relaxed);
+}
+
+int stream(romi::RomiDevice &dev, const StreamOptions &opts, FILE *out, StreamStats *stats) {
+  std::unique_ptr<Ring> ring(new Ring);
+  std::atomic<bool> done(false);
+  StreamStats local;
+  const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / opts.rate_hz));
+  const Clock::time_point start = Clock::now();
+  const Clock::time_point end =
+      opts.duration_s > 0 ? start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(opts.duration_s))
+                          : Clock::time_point::max();
+
+  stop_flag.store(false);
+
+  // The sampler does nothing but the bus read and a copy into the ring.
+  std::thread sampler([&] {
+    uint8_t raw[ROMI_TELEM_SIZE];
+    romi::Batch read;
+    read.read_bytes(ROMI_TELEM_OFFSET, raw, sizeof(raw));
+
+    for (uint64_t seq = 0; opts.count == 0 || seq < opts.count; ++seq) {
+      Clock::time_point slot = start + period * (int64_t)seq;
+      if (slot >= end || stop_flag.load(std::memory_order_relaxed)) {
+        break;
+      }
+      std::this_thread::sleep_until(slot);
+      Clock::time_point now = Clock::now();
+      if (now - slot > period) {
+        local.late++;
+      }
+      if (dev.execute(read) != 0) {
+        local.read_errors++;
+        continue;
+      }
+      Sample s;
+      s.t_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(now - start).count();
+      s.seq = (uint32_t)seq;
+      std::memcpy(s.raw, raw, sizeof(raw));
+      if (!ring->push(s)) {
+        local.dropped++;
+      }
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  if (opts.format == Format::Csv) {
+    write_csv_header(out);
+  } else {
+    write_binary_header(out);
+  }
+  Sample s;
+  for (;;) {
+    if (ring->pop(&s)) {
+      opts.format == Format::Csv ? write_csv(s, out) : write_binary(s, out);
+      local.samples++;
+    } else if (done.load(std::memory_order_acquire)) {
+      if (!ring->pop(&s)) {
+        break;
+      }
+      opts.format == Format::Csv ? write_csv(s, out) : write_binary(s, out);
+      local.samples++;
+    } else {
+      std::fflush(out);
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  sampler.join();
+  std::fflush(out);
+
+  local.elapsed_s = std::chrono::duration<double>(Clock::now() - start).count();
+  if (stats != nullptr) {
+    *stats = local;
+  }
+  return local.samples == 0 && local.read_errors != 0 ? -EIO : 0;
+}
+
+int run_command(romi::RomiDevice &dev, const std::vector<std::string> &args, FILE *out, FILE *err) {
+  if (args.empty()) {
+    return kUsage;
+  }
+  const std::string &cmd = args[0];
+  romi::Geometry geometry;
+  bool wait;
+  long timeout_ms;
+  long l, r, g, y;
+  double v;
+
+  if ((cmd == "drive" || cmd == "spin") && args.size() >= 2 && parse_double(args[1], &v)) {
+    if (parse_wait(args, 2, &wait, &timeout_ms, err) != 0) {
+      return kUsage;
+    }
+    if (cmd == "drive") {
+      int16_t n = geometry.drive_counts(v);
+      return move_and_maybe_wait(dev, n, n, wait, timeout_ms, out);
+    }
+    int16_t n = geometry.spin_counts(v);
+    return move_and_maybe_wait(dev, (int16_t)-n, n, wait, timeout_ms, out);
+  }
+  if (cmd == "move" && args.size() >= 3 && parse_long(args[1], -32767, 32767, &l) &&
+      parse_long(args[2], -32767, 32767, &r)) {
+    if (parse_wait(args, 3, &wait, &timeout_ms, err) != 0) {
+      return kUsage;
+    }
+    return move_and_maybe_wait(dev, (int16_t)l, (int16_t)r, wait, timeout_ms, out);
+  }
+  if (cmd == "speed" && args.size() == 3 && parse_long(args[1], -300, 300, &l) && parse_long(args[2], -300, 300, &r)) {
+    romi::Batch b;
+    b.write(romi::regs::LeftSpeed(), (int16_t)l).write(romi::regs::RightSpeed(), (int16_t)r);
+    return dev.execute(b);
+  }
+  if (cmd == "stop" && args.size() == 1) {
+    romi::Batch b;
+    b.write(romi::regs::LeftSpeed(), (int16_t)0)
+        .write(romi::regs::RightSpeed(), (int16_t)0)
+        .write(romi::regs::LeftDist(), (int16_t)0)
+        .write(romi::regs::RightDist(), (int16_t)0);
+    return dev.execute(b);
+  }
+  if (cmd == "leds" && args.size() == 4 && parse_long(args[1], 0, 1, &r) && parse_long(args[2], 0, 1, &g) &&
+      parse_long(args[3], 0, 1, &y)) {
+    romi::Batch b;
+    b.write(romi::regs::RedLed(), r != 0).write(romi::regs::GreenLed(), g != 0).write(romi::regs::YellowLed(), y != 0);
+    return dev.execute(b);
+  }
+  if (cmd == "wait" && args.size() <= 2) {
+    timeout_ms = kDefaultWaitMs;
+    if (args.size() == 2 && !parse_long(args[1], 0, 3600000, &timeout_ms)) {
+      std::fprintf(err, "wait: bad timeout '%s'\n", args[1].c_str());
+      return kUsage;
+    }
+    return dev.wait_motion_done(std::chrono::milliseconds(timeout_ms));
+  }
+  if (cmd == "sleep" && args.size() == 2 && parse_long(args[1], 0, 3600000, &l)) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(l));
+    return 0;
+  }
+  if (cmd == "telem" && args.size() == 1) {
+    I2C_Telem_Packet t;
+    int status = dev.read(romi::regs::Telemetry(), &t);
+    if (status == 0) {
+      print_telemetry(t, out);
+    }
+    return status;
+  }
+  if (cmd == "ident" && args.size() == 1) {
+    I2C_Ident_Packet id;
+    int status = dev.read(romi::regs::Identity(), &id);
+    if (status != 0) {
+      return status;
+    }
+    if (id.magic != ROMI_IDENT_MAGIC) {
+      std::fputs("protocol 1 (no identity block)\n", out);
+    } else {
+      std::fprintf(out, "protocol %u, buffer %u bytes, features 0x%04x, build 0x%08lx\n", id.protocol_version,
+                   id.data_size, id.features, (unsigned long)id.build_id);
+    }
+    return 0;
+  }
+  if (cmd == "diag" && args.size() == 1) {
+    I2C_Ident_Packet id;
+    I2C_Diag_Packet d;
+    int status = dev.read(romi::regs::Identity(), &id);
+    if (status != 0) {
+      return status;
+    }
+    if (id.magic != ROMI_IDENT_MAGIC || id.data_size < ROMI_DIAG_OFFSET + ROMI_DIAG_SIZE) {
+      std::fputs("diag: firmware has no diagnostics block\n", err);
+      return -ENOTSUP;
+    }
+    status = dev.read(romi::regs::Diagnostics(), &d);
+    if (status == 0) {
+      std::fprintf(out, "command latency %u us (worst %u us), %u commands\n", d.cmd_latency_us, d.cmd_latency_max_us,
+                   d.cmd_count);
+    }
+    return status;
+  }
+  if (cmd == "stream") {
+    StreamOptions opts;
+    StreamStats st;
+    if (parse_stream(args, &opts, err) != 0) {
+      return kUsage;
+    }
+    int status = stream(dev, opts, out, &st);
+    std::fprintf(err, "stream: %llu samples in %.2f s (%.1f Hz), %llu read errors, %llu late, %llu dropped\n",
+                 (unsigned long long)st.samples, st.elapsed_s, st.elapsed_s > 0 ? st.samples / st.elapsed_s : 0.0,
+                 (unsigned long long)st.read_errors, (unsigned long long)st.late, (unsigned long long)st.dropped);
+    return status;
+  }
+  if (cmd == "sweep") {
+    SweepOptions opts;
+    if (parse_sweep(args, &opts, err) != 0) {
+      return kUsage;
+    }
+    return sweep(dev, opts, out, err);
+  }
+
+  std::fprintf(err, "romictl: bad command: %s", cmd.c_str());
+  for (size_t i = 1; i < args.size(); ++i) {
+    std::fprintf(err, " %s", args[i].c_str());
+  }
+  std::fputc('\n', err);
+  return kUsage;
+}
+
+int run_script(romi::RomiDevice &dev, FILE *in, FILE *out, FILE *err) {
+  char line[256];
+  int lineno = 0;
+  int commands = 0;
+  auto start = Clock::now();
+  romi::Stats before = dev.stats();
+
+  while (std::fgets(line, sizeof(line), in) != nullptr) {
+    lineno++;
+    char *hash = std::strchr(line, '#');
+    if (hash != nullptr) {
+      *hash = '\0';
+    }
+    std::vector<std::string> args;
+    for (char *tok = std::strtok(line, " \t\r\n"); tok != nullptr; tok = std::strtok(nullptr, " \t\r\n")) {
+      args.emplace_back(tok);
+    }
+    if (args.empty()) {
+      continue;
+    }
+    int status = run_command(dev, args, out, err);
+    if (status != 0) {
+      if (status < 0) {
+        std::fprintf(err, "line %d: %s: %s\n", lineno, args[0].c_str(), std::strerror(-status));
+      } else {
+        std::fprintf(err, "line %d: usage error\n", lineno);
+      }
+      return status;
+    }
+    commands++;
+  }
+
+  romi::Stats after = dev.stats();
+  std::fprintf(err, "script: %d commands in %.1f ms, %llu bus transactions\n", commands,
+               std::chrono::duration<double, std::milli>(Clock::now() - start).count(),
+               (unsigned long long)(after.transactions - before.transactions));
+  return 0;
+}
+
+void print_usage(FILE *out) {
+  std::fputs(
+      "usage: romictl [-b BUS] [-a ADDR] [-g GAP_US] COMMAND [ARGS]\n"
+      "\n"
+      "  drive MM [--wait] [--timeout MS]     straight move\n"
+      "  spin DEG [--wait] [--timeout MS]     turn in place, positive is counter-clockwise\n"
+      "  move LEFT RIGHT [--wait]             move each wheel by encoder counts\n"
+      "  speed LEFT RIGHT                     drive the wheels at a fixed speed (-300..300)\n"
+      "  stop                                 zero speeds and distances\n"
+      "  leds R G Y                           set the LEDs, 0 or 1 each\n"
+      "  wait [TIMEOUT_MS]                    block until the current move finishes\n"
+      "  sleep MS                             pause (scripts)\n"
+      "  telem                                print one telemetry block\n"
+      "  ident                                print the firmware's protocol version and features\n"
+      "  diag                                 print command-to-motor latency\n"
+      "  stream [--rate HZ] [--count N] [--duration S] [--format csv|bin]\n"
+      "                                       sample telemetry to stdout until done or ^C\n"
+      "  sweep [--sizes LIST] [--offsets LIST] [--gaps LIST] [--count N] [--reads|--writes]\n"
+      "                                       time transfers of each size/offset/gap, CSV\n"
+      "                                       report to stdout; defaults: all sizes, offsets\n"
+      "                                       0,11, gaps 0,100,1000, count 100.  Writes\n"
+      "                                       restore the current values\n"
+      "  script FILE                          run commands from FILE ('-' for stdin)\n"
+      "\n"
+      "  -b BUS      /dev/i2c-BUS (default 2)\n"
+      "  -a ADDR     slave address (default 0x14)\n"
+      "  -g GAP_US   pause between register pointer write and read (default 100;\n"
+      "              0 uses one repeated-start transaction)\n",
+      out);
+}
+
+}  // namespace romictl
@@ -0,0 +1,79 @@
+// romictl: command-line control and telemetry capture for one Romi.
+//
+// The commands work on an open RomiDevice and write to a FILE*, so the
+// tests can run them against the fake slave; main.cpp only parses the
+// global options and opens the bus.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "romi_driver.hpp"
+
+namespace romictl {
+
+enum class Format { Csv, Binary };
+
+struct StreamOptions {
+  double rate_hz = 100.0;
+  uint64_t count = 0;    // samples to take; 0 = until duration_s
+  double duration_s = 0; // 0 with count 0 = until interrupted
+  Format format = Format::Csv;
+};
+
+struct StreamStats {
+  uint64_t samples = 0;  // written out
+  uint64_t read_errors = 0;
+  uint64_t dropped = 0;  // writer fell behind and the ring was full
+  uint64_t late = 0;     // sample taken more than one period after its slot
+  double elapsed_s = 0;
+};
+
+// Binary stream layout, all little-endian:
+//   header  "ROMITLM1", u16 protocol version, u16 record size, u32 0
+//   record  u64 ns since the first sample, u32 sequence number,
+//           ROMI_TELEM_SIZE bytes of telemetry exactly as read off the bus
+constexpr char kBinaryMagic[8] = {'R', 'O', 'M', 'I', 'T', 'L', 'M', '1'};
+constexpr size_t kBinaryHeaderSize = 16;
+constexpr size_t kBinaryRecordSize = 8 + 4 + ROMI_TELEM_SIZE;
+
+// Sample telemetry at opts.rate_hz on a sampler thread; formatting and
+// output happen on the calling thread, so a slow terminal or disk costs
+// dropped samples (counted) rather than a late bus schedule.
+int stream(romi::RomiDevice &dev, const StreamOptions &opts, FILE *out, StreamStats *stats);
+
+struct SweepOptions {
+  std::vector<int> sizes;    // bytes per transfer, 1..ROMI_DATA_SIZE
+  std::vector<int> offsets;  // first register; cells past the block are skipped
+  std::vector<int> gaps_us;  // idle time between the end of one transfer and the next
+  int count = 100;           // transfers per cell
+  bool reads = true;
+  bool writes = true;
+};
+
+// Bus characterization: for every direction x offset x size x gap, time
+// opts.count transfers and write one CSV row with achieved rates, error
+// rate and the latency distribution; a per-direction summary goes to err.
+// Writes put back the register values read at the start, so run it on an
+// idle robot.  Returns 0 unless the initial snapshot read fails.
+int sweep(romi::RomiDevice &dev, const SweepOptions &opts, FILE *out, FILE *err);
+
+// Set by a signal handler to end an open-ended stream or a sweep.
+void request_stop();
+bool stop_requested();
+
+// Run one command, e.g. {"drive", "100", "--wait"}.  Returns 0, a negative
+// errno from the bus, or 2 for a usage error (message on err).
+int run_command(romi::RomiDevice &dev, const std::vector<std::string> &args, FILE *out, FILE *err);
+
+// Run a script: one command per line, '#' comments, blank lines ignored.
+// Lines run back to back with no padding; "wait" blocks until the current
+// move finishes.  Stops at the first failing line and reports it on err.
+int run_script(romi::RomiDevice &dev, FILE *in, FILE *out, FILE *err);
+
+void print_usage(FILE *out);
+
+}  // namespace romictl
@@ -0,0 +1,156 @@
+// romictl sweep: bus throughput and latency characterization.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "romictl.hpp"
+
+namespace romictl {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Cell {
+  bool read;
+  int offset;
+  int size;
+  int gap_us;
+};
+
+struct Result {
+  int errors = 0;
+  double elapsed_s = 0;
+  uint64_t transactions = 0;
+  double lat_us[5] = {};  // min, p50, p90, p99, max
+};
+
+// Nearest-rank percentile of a sorted sample.
+double percentile(const std::vector<double> &sorted, double p) {
+  size_t rank = (size_t)(p / 100.0 * sorted.size() + 0.5);
+  rank = std::min(std::max(rank, (size_t)1), sorted.size());
+  return sorted[rank - 1];
+}
+
+Result run_cell(romi::RomiDevice &dev, const Cell &cell, int count, const uint8_t *snapshot) {
+  Result r;
+  uint8_t buf[ROMI_DATA_SIZE];
+  romi::Batch batch;
+  if (cell.read) {
+    batch.read_bytes((uint8_t)cell.offset, buf, (size_t)cell.size);
+  } else {
+    batch.write_bytes((uint8_t)cell.offset, snapshot + cell.offset, (size_t)cell.size);
+  }
+  std::vector<double> lat;
+  lat.reserve((size_t)count);
+  const auto gap = std::chrono::microseconds(cell.gap_us);
+
+  romi::Stats before = dev.stats();
+  Clock::time_point start = Clock::now();
+  Clock::time_point last = start;
+  for (int i = 0; i < count; ++i) {
+    if (cell.gap_us > 0 && i > 0) {
+      std::this_thread::sleep_until(last + gap);
+    }
+    Clock::time_point t0 = Clock::now();
+    if (dev.execute(batch) != 0) {
+      r.errors++;
+    }
+    last = Clock::now();
+    lat.push_back(std::chrono::duration<double, std::micro>(last - t0).count());
+  }
+  r.elapsed_s = std::chrono::duration<double>(last - start).count();
+  r.transactions = dev.stats().transactions - before.transactions;
+
+  std::sort(lat.begin(), lat.end());
+  r.lat_us[0] = lat.front();
+  r.lat_us[1] = percentile(lat, 50);
+  r.lat_us[2] = percentile(lat, 90);
+  r.lat_us[3] = percentile(lat, 99);
+  r.lat_us[4] = lat.back();
+  return r;
+}
+
+}  // namespace
+
+int sweep(romi::RomiDevice &dev, const SweepOptions &opts, FILE *out, FILE *err) {
+  uint8_t snapshot[ROMI_DATA_SIZE];
+  romi::Batch read_all;
+  read_all.read_bytes(0, snapshot, sizeof(snapshot));
+  int status = dev.execute(read_all);
+  if (status != 0) {
+    std::fprintf(err, "sweep: snapshot read failed: %s\n", std::strerror(-status));
+    return status;
+  }
+
+  std::vector<Cell> cells;
+  for (int dir = 0; dir < 2; ++dir) {
+    bool read = dir == 0;
+    if ((read && !opts.reads) || (!read && !opts.writes)) {
+      continue;
+    }
+    for (int gap : opts.gaps_us) {
+      for (int offset : opts.offsets) {
+        for (int size : opts.sizes) {
+          if (offset >= 0 && size > 0 && offset + size <= ROMI_DATA_SIZE) {
+            cells.push_back(Cell{read, offset, size, gap});
+          }
+        }
+      }
+    }
+  }
+
+  std::fputs("dir,offset,size,gap_us,count,errors,error_rate,ops_per_s,transactions_per_s,payload_bytes_per_s,"
+             "lat_min_us,lat_p50_us,lat_p90_us,lat_p99_us,lat_max_us\n",
+             out);
+
+  struct Peak {
+    double ops_per_s = 0;
+    const Cell *cell = nullptr;
+    uint64_t ops = 0;
+    uint64_t errors = 0;
+  } peak[2];
+
+  for (const Cell &cell : cells) {
+    if (stop_requested()) {
+      std::fputs("sweep: interrupted\n", err);
+      break;
+    }
+    Result r = run_cell(dev, cell, opts.count, snapshot);
+    double ops_per_s = r.elapsed_s > 0 ? opts.count / r.elapsed_s : 0;
+    double tps = r.elapsed_s > 0 ? r.transactions / r.elapsed_s : 0;
+    double bps = r.elapsed_s > 0 ? (double)(opts.count - r.errors) * cell.size / r.elapsed_s : 0;
+    std::fprintf(out, "%s,%d,%d,%d,%d,%d,%.4f,%.1f,%.1f,%.0f,%.1f,%.1f,%.1f,%.1f,%.1f\n", cell.read ? "read" : "write",
+                 cell.offset, cell.size, cell.gap_us, opts.count, r.errors, (double)r.errors / opts.count, ops_per_s,
+                 tps, bps, r.lat_us[0], r.lat_us[1], r.lat_us[2], r.lat_us[3], r.lat_us[4]);
+    std::fflush(out);
+
+    Peak &p = peak[cell.read ? 0 : 1];
+    p.ops += (uint64_t)opts.count;
+    p.errors += (uint64_t)r.errors;
+    if (r.errors == 0 && ops_per_s > p.ops_per_s) {
+      p.ops_per_s = ops_per_s;
+      p.cell = &cell;
+    }
+  }
+
+  for (int dir = 0; dir < 2; ++dir) {
+    const Peak &p = peak[dir];
+    if (p.ops == 0) {
+      continue;
+    }
+    std::fprintf(err, "sweep: %-5s %llu transfers, error rate %.4f", dir == 0 ? "read" : "write",
+                 (unsigned long long)p.ops, (double)p.errors / p.ops);
+    if (p.cell != nullptr) {
+      std::fprintf(err, ", peak %.0f/s at %d bytes from %d, gap %d us", p.ops_per_s, p.cell->size, p.cell->offset,
+                   p.cell->gap_us);
+    }
+    std::fputc('\n', err);
+  }
+  return 0;
+}
+
+}  // namespace romictl
@@ -0,0 +1,267 @@
+// romictl tests: scripts and telemetry streams against the fake slave.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "romi_fake_slave.hpp"
+#include "romictl.hpp"
+
+using romi::RomiDevice;
+using romi::test::FakeBus;
+using romi::test::FakeFirmware;
+using romi::test::FakeTransport;
+
+namespace {
+
+int failures = 0;
+
+#define CHECK(cond)                                               \
+  do {                                                            \
+    if (!(cond)) {                                                \
+      std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); \
+      failures++;                                                 \
+    }                                                             \
+  } while (0)
+
+std::unique_ptr<RomiDevice> make_device(FakeBus *bus) {
+  romi::Options options;
+  options.read_gap_us = 0;
+  return std::unique_ptr<RomiDevice>(
+      new RomiDevice(std::unique_ptr<romi::Transport>(new FakeTransport(bus)), ROMI_I2C_ADDRESS, options));
+}
+
+FILE *file_with(const char *text) {
+  FILE *f = std::tmpfile();
+  std::fputs(text, f);
+  std::rewind(f);
+  return f;
+}
+
+std::string contents(FILE *f) {
+  std::string s;
+  char buf[4096];
+  size_t n;
+  std::rewind(f);
+  while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) {
+    s.append(buf, n);
+  }
+  return s;
+}
+
+void test_script() {
+  FakeBus bus;
+  FakeFirmware fw;
+  fw.step = 400;  // the waits poll at real-robot intervals; keep moves short
+  bus.firmware = std::ref(fw);
+  auto dev = make_device(&bus);
+
+  FILE *in = file_with(
+      "# square corner\n"
+      "leds 1 0 1\n"
+      "drive 100\n"
+      "wait 2000\n"
+      "\n"
+      "spin 90 --wait --timeout 2000   # left wheel back, right forward\n"
+      "drive 100 --wait\n"
+      "stop\n");
+  FILE *out = std::tmpfile();
+  FILE *err = std::tmpfile();
+
+  auto start = std::chrono::steady_clock::now();
+  CHECK(romictl::run_script(*dev, in, out, err) == 0);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+
+  CHECK(bus.regs[ROMI_CMD_R_LED_OFFSET] == 1 && bus.regs[ROMI_CMD_G_LED_OFFSET] == 0 &&
+        bus.regs[ROMI_CMD_Y_LED_OFFSET] == 1);
+  // 655 - 725 + 655 and 655 + 725 + 655
+  CHECK(fw.enc[0] == 585 && fw.enc[1] == 2035);
+  CHECK(bus.regs[ROMI_CMD_LEFT_DIST_OFFSET] == 0 && bus.regs[ROMI_CMD_RIGHT_DIST_OFFSET] == 0);
+  // no sleeps between lines: only polling, which is fast on the fake bus
+  CHECK(elapsed < std::chrono::seconds(2));
+  CHECK(contents(err).find("script: 6 commands") != std::string::npos);
+
+  std::fclose(in);
+  std::fclose(out);
+  std::fclose(err);
+}
+
+void test_script_errors() {
+  FakeBus bus;
+  auto dev = make_device(&bus);
+  FILE *out = std::tmpfile();
+  FILE *err = std::tmpfile();
+
+  FILE *in = file_with("stop\nleds 1 2 0\nstop\n");
+  CHECK(romictl::run_script(*dev, in, out, err) == 2);
+  CHECK(contents(err).find("line 2: usage error") != std::string::npos);
+  CHECK(bus.transfers == 1);  // stopped at the bad line
+  std::fclose(in);
+
+  in = file_with("telem\n");
+  bus.fail_next = -EREMOTEIO;
+  CHECK(romictl::run_script(*dev, in, out, err) == -EREMOTEIO);
+  CHECK(contents(err).find("line 1: telem") != std::string::npos);
+  std::fclose(in);
+
+  std::fclose(out);
+  std::fclose(err);
+}
+
+void test_stream_csv() {
+  FakeBus bus;
+  FakeFirmware fw;
+  bus.firmware = std::ref(fw);
+  auto dev = make_device(&bus);
+  CHECK(dev->write(romi::regs::LeftDist(), (int16_t)400) == 0);
+
+  romictl::StreamOptions opts;
+  opts.rate_hz = 500;
+  opts.count = 5;
+  romictl::StreamStats st;
+  FILE *out = std::tmpfile();
+  CHECK(romictl::stream(*dev, opts, out, &st) == 0);
+  CHECK(st.samples == 5 && st.read_errors == 0 && st.dropped == 0);
+
+  std::string csv = contents(out);
+  CHECK(csv.compare(0, 16, "t_us,seq,l_enc,r") == 0);
+  size_t lines = 0;
+  for (char c : csv) {
+    lines += c == '\n';
+  }
+  CHECK(lines == 6);
+  // each sample is one read transaction, and the encoder advances per loop
+  CHECK(bus.reads.size() == 5);
+  CHECK(csv.find(",4,200,0,200,0,400,0,") != std::string::npos);
+  std::fclose(out);
+}
+
+void test_stream_binary() {
+  FakeBus bus;
+  auto dev = make_device(&bus);
+  bus.regs[ROMI_TELEM_BATTERYMILLIVOLTS_OFFSET] = 0x10;
+  bus.regs[ROMI_TELEM_BATTERYMILLIVOLTS_OFFSET + 1] = 0x27;
+
+  romictl::StreamOptions opts;
+  opts.rate_hz = 1000;
+  opts.duration_s = 0.02;
+  opts.format = romictl::Format::Binary;
+  romictl::StreamStats st;
+  FILE *out = std::tmpfile();
+  CHECK(romictl::stream(*dev, opts, out, &st) == 0);
+  CHECK(st.samples >= 10 && st.samples <= 20);
+
+  std::string bin = contents(out);
+  CHECK(bin.size() == romictl::kBinaryHeaderSize + st.samples * romictl::kBinaryRecordSize);
+  CHECK(std::memcmp(bin.data(), romictl::kBinaryMagic, 8) == 0);
+  const uint8_t *p = reinterpret_cast<const uint8_t *>(bin.data());
+  CHECK(romi_get_u16(p + 10) == romictl::kBinaryRecordSize);
+
+  const uint8_t *last = p + romictl::kBinaryHeaderSize + (st.samples - 1) * romictl::kBinaryRecordSize;
+  CHECK(romi_get_u32(last + 8) == st.samples - 1);
+  I2C_Telem_Packet t;
+  romi_telem_unpack(&t, last + 12);
+  CHECK(t.batteryMillivolts == 10000);
+  std::fclose(out);
+}
+
+void test_sweep() {
+  FakeBus bus;
+  auto dev = make_device(&bus);
+  for (int i = 0; i < ROMI_DATA_SIZE; ++i) {
+    bus.regs[i] = (uint8_t)(i * 7);
+  }
+  FILE *out = std::tmpfile();
+  FILE *err = std::tmpfile();
+
+  // the last two registers only fit sizes 1 and 2
+  const std::string tail = std::to_string(ROMI_DATA_SIZE - 2);
+  std::vector<std::string> args = {"sweep", "--sizes", "1-4", "--offsets", "0," + tail, "--gaps", "0,50", "--count", "5"};
+  CHECK(romictl::run_command(*dev, args, out, err) == 0);
+
+  std::string csv = contents(out);
+  size_t rows = 0;
+  for (char c : csv) {
+    rows += c == '\n';
+  }
+  CHECK(rows == 1 + 2 * 2 * (4 + 2));
+  CHECK(csv.find("\nread,0,1,0,5,0,0.0000,") != std::string::npos);
+  CHECK(csv.find("\nwrite," + tail + ",2,50,5,0,") != std::string::npos);
+  CHECK(contents(err).find("sweep: read  60 transfers, error rate 0.0000, peak") != std::string::npos);
+  // snapshot + 60 reads, each with its pointer write, + 60 writes that put
+  // the values back
+  CHECK(bus.reads.size() == 61 && bus.writes.size() == 121);
+  for (int i = 0; i < ROMI_DATA_SIZE; ++i) {
+    CHECK(bus.regs[i] == (uint8_t)(i * 7));
+  }
+
+  args = {"sweep", "--sizes", "4-1"};
+  CHECK(romictl::run_command(*dev, args, out, err) == 2);
+  std::fclose(out);
+  std::fclose(err);
+}
+
+void test_ident() {
+  FakeBus bus;
+  auto dev = make_device(&bus);
+  FILE *out = std::tmpfile();
+  FILE *err = std::tmpfile();
+
+  std::vector<std::string> args = {"ident"};
+  CHECK(romictl::run_command(*dev, args, out, err) == 0);
+  CHECK(contents(out) == "protocol 1 (no identity block)\n");
+
+  I2C_Ident_Packet id = {ROMI_IDENT_MAGIC, ROMI_PROTOCOL_VERSION, ROMI_DATA_SIZE, ROMI_FEATURE_COMBINED_XFER, 0xbeef};
+  romi_ident_pack(&bus.regs[ROMI_IDENT_OFFSET], &id);
+  std::fclose(out);
+  out = std::tmpfile();
+  CHECK(romictl::run_command(*dev, args, out, err) == 0);
+  char expect[80];
+  std::snprintf(expect, sizeof(expect), "protocol %d, buffer %d bytes, features 0x0001, build 0x0000beef\n",
+                ROMI_PROTOCOL_VERSION, ROMI_DATA_SIZE);
+  CHECK(contents(out) == expect);
+  std::fclose(out);
+  std::fclose(err);
+}
+
+void test_diag() {
+  FakeBus bus;
+  auto dev = make_device(&bus);
+  FILE *out = std::tmpfile();
+  FILE *err = std::tmpfile();
+
+  std::vector<std::string> args = {"diag"};
+  CHECK(romictl::run_command(*dev, args, out, err) == -ENOTSUP);
+
+  I2C_Ident_Packet id = {ROMI_IDENT_MAGIC, ROMI_PROTOCOL_VERSION, ROMI_DATA_SIZE, 0, 0};
+  romi_ident_pack(&bus.regs[ROMI_IDENT_OFFSET], &id);
+  I2C_Diag_Packet d = {120, 260, 7};
+  romi_diag_pack(&bus.regs[ROMI_DIAG_OFFSET], &d);
+  CHECK(romictl::run_command(*dev, args, out, err) == 0);
+  CHECK(contents(out) == "command latency 120 us (worst 260 us), 7 commands\n");
+  std::fclose(out);
+  std::fclose(err);
+}
+
+}  // namespace
+
+int main() {
+  test_script();
+  test_script_errors();
+  test_stream_csv();
+  test_stream_binary();
+  test_sweep();
+  test_ident();
+  test_diag();
+
+  if (failures != 0) {
+    std::printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  std::printf("romictl: all tests passed\n");
+  return 0;
+}